@@ -0,0 +1,393 @@
+/**
+ *  @file       benchmark.c
+ *  @brief      Client source file for gcslib container benchmarks
+ *
+ *  @author     Gemuele Aludino
+ *  @date       07 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+
+#include "utils.h"
+#include "rbtree.h"
+#include "bptree.h"
+#include "vector.h"
+#include "vector_typed.h"
+
+#define BEN__DEFAULT_N 1000000
+#define BEN__SCAN_COUNT 10000
+#define BEN__SCAN_LENGTH 100
+#define BEN__VECTOR_LENGTH 256
+
+#define elapsed_time_ns(BEF, AFT)                                              \
+    (((double)((pow(10.0, 9.0) * AFT.tv_sec) + (AFT.tv_nsec))) -               \
+     ((double)((pow(10.0, 9.0) * BEF.tv_sec) + (BEF.tv_nsec))))
+
+/**
+ *  @struct     bench_tree
+ *  @brief      Operations common to rbtree and bptree (int set)
+ */
+struct bench_tree {
+    const char *name;
+
+    void *(*new)(void);
+    void (*delete)(void *tree);
+    void (*insert)(void *tree, const int *key);
+    bool (*contains)(void *tree, const int *key);
+    long (*scan)(void *tree, const int *key, int length);
+};
+
+static void *rb_new(void);
+static void rb_delete(void *tree);
+static void rb_insert(void *tree, const int *key);
+static bool rb_contains(void *tree, const int *key);
+static long rb_scan(void *tree, const int *key, int length);
+
+static void *bp_new(void);
+static void bp_delete(void *tree);
+static void bp_insert(void *tree, const int *key);
+static bool bp_contains(void *tree, const int *key);
+static long bp_scan(void *tree, const int *key, int length);
+
+static void bench_vectors(int n);
+
+static void shuffle(int *keys, int n);
+static void report(const char *tree, const char *test, double ns, long ops);
+
+/**
+ *  Compares rbtree and bptree (BPTREE_NODE_SIZE byte nodes) as sets of int:
+ *
+ *  insert: n distinct keys, in random order
+ *  find:   n successful lookups, in a different random order
+ *  scan:   BEN__SCAN_COUNT range scans of BEN__SCAN_LENGTH keys,
+ *          each beginning at the lower bound of a random key
+ *  bulk:   bptree_newsortedptr from n sorted keys (bptree only)
+ *
+ *  Then compares vector (_int_ typetable) and vector_int (DEFINE_VECTOR),
+ *  see bench_vectors.
+ *
+ *  Usage: ./benchmark [n]
+ */
+int main(int argc, const char *argv[]) {
+    struct bench_tree trees[2];
+    struct timespec x = { 0, 0 };      /* start time (secs, nsecs) */
+    struct timespec y = { 0, 0 };      /* end time (secs, nsecs) */
+
+    int *keys = NULL;
+    int *lookups = NULL;
+    void *tree = NULL;
+    bptree *bulk = NULL;
+
+    long visited = 0;
+    long found = 0;
+    int n = BEN__DEFAULT_N;
+    int i = 0;
+    int j = 0;
+
+    if (argc > 1) {
+        n = atoi(argv[1]);
+        n = n > 0 ? n : BEN__DEFAULT_N;
+    }
+
+    trees[0].name = "rbtree";
+    trees[0].new = rb_new;
+    trees[0].delete = rb_delete;
+    trees[0].insert = rb_insert;
+    trees[0].contains = rb_contains;
+    trees[0].scan = rb_scan;
+
+    trees[1].name = "bptree";
+    trees[1].new = bp_new;
+    trees[1].delete = bp_delete;
+    trees[1].insert = bp_insert;
+    trees[1].contains = bp_contains;
+    trees[1].scan = bp_scan;
+
+    keys = malloc(sizeof *keys * n);
+    massert_malloc(keys);
+
+    lookups = malloc(sizeof *lookups * n);
+    massert_malloc(lookups);
+
+    srand(2019);
+
+    for (i = 0; i < n; i++) {
+        keys[i] = i * 2;
+        lookups[i] = i * 2;
+    }
+
+    shuffle(keys, n);
+    shuffle(lookups, n);
+
+    printf("\n%-8s %-8s %14s %14s\n", "tree", "test", "ns/op", "Mops/s");
+
+    for (j = 0; j < 2; j++) {
+        tree = trees[j].new();
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        for (i = 0; i < n; i++) {
+            trees[j].insert(tree, &keys[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        report(trees[j].name, "insert", elapsed_time_ns(x, y), n);
+
+        found = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        for (i = 0; i < n; i++) {
+            found += trees[j].contains(tree, &lookups[i]) ? 1 : 0;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        report(trees[j].name, "find", elapsed_time_ns(x, y), n);
+
+        if (found != n) {
+            fprintf(stderr, "%s: found %ld of %d keys\n", trees[j].name, found, n);
+        }
+
+        visited = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        for (i = 0; i < BEN__SCAN_COUNT; i++) {
+            visited += trees[j].scan(tree, &lookups[i % n], BEN__SCAN_LENGTH);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        report(trees[j].name, "scan", elapsed_time_ns(x, y), visited);
+
+        trees[j].delete(tree);
+    }
+
+    for (i = 0; i < n; i++) {
+        keys[i] = i * 2;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &x);
+    bulk = bptree_newsortedptr(_int_, NULL, keys, NULL, n);
+    clock_gettime(CLOCK_MONOTONIC, &y);
+    report("bptree", "bulk", elapsed_time_ns(x, y), n);
+
+    bptree_delete(&bulk);
+
+    free(lookups);
+    free(keys);
+
+    bench_vectors(n);
+
+    printf("\n");
+    return EXIT_SUCCESS;
+}
+
+/**
+ *  @brief  Compares vector (_int_) and vector_int over n elements in total
+ *
+ *  @param[in]  n   number of elements
+ *
+ *  vector's storage comes from mymalloc's fixed block, so the work is done
+ *  as n / BEN__VECTOR_LENGTH rounds over vectors of BEN__VECTOR_LENGTH ints:
+ *
+ *  pushb:  BEN__VECTOR_LENGTH elements pushed onto a new vector
+ *  at:     every element read by index
+ *  sort:   the (shuffled) elements sorted by the default comparator
+ */
+static void bench_vectors(int n) {
+    struct timespec x = { 0, 0 };
+    struct timespec y = { 0, 0 };
+
+    double ns_pushb[2] = { 0.0, 0.0 };
+    double ns_at[2] = { 0.0, 0.0 };
+    double ns_sort[2] = { 0.0, 0.0 };
+
+    int values[BEN__VECTOR_LENGTH];
+    int rounds = n / BEN__VECTOR_LENGTH;
+    long sum[2] = { 0, 0 };
+    int r = 0;
+    int i = 0;
+
+    vector *v = NULL;
+    vector_int *vi = NULL;
+
+    rounds = rounds > 0 ? rounds : 1;
+
+    for (i = 0; i < BEN__VECTOR_LENGTH; i++) {
+        values[i] = i;
+    }
+
+    shuffle(values, BEN__VECTOR_LENGTH);
+
+    for (r = 0; r < rounds; r++) {
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        v = v_new(_int_);
+        for (i = 0; i < BEN__VECTOR_LENGTH; i++) {
+            v_pushb(v, &values[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        ns_pushb[0] += elapsed_time_ns(x, y);
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        for (i = 0; i < BEN__VECTOR_LENGTH; i++) {
+            sum[0] += *(int *)(v_at(v, i));
+        }
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        ns_at[0] += elapsed_time_ns(x, y);
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        v_sort(v);
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        ns_sort[0] += elapsed_time_ns(x, y);
+
+        v_delete(&v);
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        vi = vector_int_new();
+        for (i = 0; i < BEN__VECTOR_LENGTH; i++) {
+            vector_int_pushb(vi, &values[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        ns_pushb[1] += elapsed_time_ns(x, y);
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        for (i = 0; i < BEN__VECTOR_LENGTH; i++) {
+            sum[1] += *vector_int_at(vi, i);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        ns_at[1] += elapsed_time_ns(x, y);
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        vector_int_sort(vi);
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        ns_sort[1] += elapsed_time_ns(x, y);
+
+        vector_int_delete(&vi);
+    }
+
+    if (sum[0] != sum[1]) {
+        fprintf(stderr, "vector: sums differ (%ld, %ld)\n", sum[0], sum[1]);
+    }
+
+    printf("\n%-8s %-8s %14s %14s\n", "vector", "test", "ns/op", "Mops/s");
+
+    report("vector", "pushb", ns_pushb[0], (long)(rounds) * BEN__VECTOR_LENGTH);
+    report("vector", "at", ns_at[0], (long)(rounds) * BEN__VECTOR_LENGTH);
+    report("vector", "sort", ns_sort[0], (long)(rounds) * BEN__VECTOR_LENGTH);
+
+    report("v_int", "pushb", ns_pushb[1], (long)(rounds) * BEN__VECTOR_LENGTH);
+    report("v_int", "at", ns_at[1], (long)(rounds) * BEN__VECTOR_LENGTH);
+    report("v_int", "sort", ns_sort[1], (long)(rounds) * BEN__VECTOR_LENGTH);
+}
+
+static void *rb_new(void) {
+    return rbtree_new(_int_, NULL);
+}
+
+static void rb_delete(void *tree) {
+    rbtree *t = (rbtree *)(tree);
+    rbtree_delete(&t);
+}
+
+static void rb_insert(void *tree, const int *key) {
+    rbtree_insert((rbtree *)(tree), key, NULL);
+}
+
+static bool rb_contains(void *tree, const int *key) {
+    return rbtree_find((rbtree *)(tree), key) != NULL;
+}
+
+static long rb_scan(void *tree, const int *key, int length) {
+    iterator it = rbtree_lower_bound((rbtree *)(tree), key);
+    long sum = 0;
+
+    while (length-- > 0 && it_has_next(it)) {
+        sum += *(int *)(it_curr(it)) != -1;
+        it_incr(&it);
+    }
+
+    return sum;
+}
+
+static void *bp_new(void) {
+    return bptree_new(_int_, NULL);
+}
+
+static void bp_delete(void *tree) {
+    bptree *t = (bptree *)(tree);
+    bptree_delete(&t);
+}
+
+static void bp_insert(void *tree, const int *key) {
+    bptree_insert((bptree *)(tree), key, NULL);
+}
+
+static bool bp_contains(void *tree, const int *key) {
+    return bptree_find((bptree *)(tree), key) != NULL;
+}
+
+static long bp_scan(void *tree, const int *key, int length) {
+    iterator it = bptree_lower_bound((bptree *)(tree), key);
+    long sum = 0;
+
+    while (length-- > 0 && it_has_next(it)) {
+        sum += *(int *)(it_curr(it)) != -1;
+        it_incr(&it);
+    }
+
+    return sum;
+}
+
+/**
+ *  @brief  Fisher-Yates shuffle of keys
+ *
+ *  @param[out] keys    array of int
+ *  @param[in]  n       length of keys
+ */
+static void shuffle(int *keys, int n) {
+    int i = 0;
+    int j = 0;
+    int temp = 0;
+
+    for (i = n - 1; i > 0; i--) {
+        j = (int)(((double)(rand()) / ((double)(RAND_MAX) + 1.0)) * (i + 1));
+
+        temp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = temp;
+    }
+}
+
+/**
+ *  @brief  Prints one row of results
+ *
+ *  @param[in]  tree    name of the tree
+ *  @param[in]  test    name of the test
+ *  @param[in]  ns      elapsed nanoseconds
+ *  @param[in]  ops     number of operations (keys visited, for scans)
+ */
+static void report(const char *tree, const char *test, double ns, long ops) {
+    printf("%-8s %-8s %14.2f %14.2f\n", tree, test,
+           ops > 0 ? ns / ops : 0.0, ns > 0 ? (ops * 1000.0) / ns : 0.0);
+}
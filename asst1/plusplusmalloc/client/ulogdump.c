@@ -0,0 +1,73 @@
+/**
+ *  @file       ulogdump.c
+ *  @brief      Client source file that renders binary ulog files as text
+ *
+ *  @author     Gemuele Aludino
+ *  @date       19 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utils.h"
+#include "ulogb.h"
+
+/**
+ *  @brief  Program execution begins here
+ *
+ *  @param[in]  argc    argument count
+ *  @param[in]  argv    command line arguments (a binary log; stdin if omitted)
+ *
+ *  @return     exit status
+ */
+int main(int argc, const char *argv[]) {
+    FILE *in = stdin;
+    const char *name = "(stdin)";
+    long count = 0;
+
+    if (argc > 1) {
+        name = argv[1];
+
+        if ((in = fopen(name, "rb")) == NULL) {
+            fprintf(stderr, "USAGE: %s [binary ulog file]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    count = ulogb_decode(in, stdout);
+
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    if (count < 0) {
+        fprintf(stderr, "[ERROR] %s is truncated, or not a binary ulog "
+                        "written on a compatible machine\n", name);
+        exit(EXIT_FAILURE);
+    }
+
+    return EXIT_SUCCESS;
+}
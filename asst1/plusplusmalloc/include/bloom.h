@@ -0,0 +1,144 @@
+/**
+ *  @file       bloom.h
+ *  @brief      Header file for probabilistic membership/frequency ADTs
+ *              (blocked Bloom filter, count-min sketch)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       17 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BLOOM_H
+#define BLOOM_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for (struct typetable) and related functions
+ */
+#include "utils.h"
+
+#include <stdlib.h>
+
+/**
+ *  @def        BLOOM_BLOCK_SIZE
+ *  @brief      Size of a Bloom filter block in bytes (one cache line)
+ */
+#define BLOOM_BLOCK_SIZE 64
+
+/**
+ *  @def        BLOOM_MAX_HASHES
+ *  @brief      Upper bound for the number of bits set per element
+ */
+#define BLOOM_MAX_HASHES 16
+
+/**
+ *  @typedef    bloom
+ *  @brief      Alias for (struct bloom)
+ *
+ *  All instances of (struct bloom) will be addressed as (bloom).
+ */
+typedef struct bloom bloom;
+
+/**
+ *  @typedef    cmsketch
+ *  @brief      Alias for (struct cmsketch)
+ *
+ *  All instances of (struct cmsketch) will be addressed as (cmsketch).
+ */
+typedef struct cmsketch cmsketch;
+
+/**
+ *      Both structures store no elements -- only bits/counters selected
+ *      by the hash function of the typetable given at construction,
+ *      which must be non-NULL. Two elements that compare equal must
+ *      hash equal (true of all builtin typetables).
+ *
+ *      bloom answers "definitely absent" or "possibly present":
+ *      if bloom_contains is false, the element was never inserted,
+ *      and a search for it may be skipped. Every bit for one element
+ *      falls within a single BLOOM_BLOCK_SIZE block, so a lookup touches
+ *      one cache line. Elements cannot be removed.
+ *
+ *      cmsketch estimates how many times an element was added;
+ *      the estimate is never low, and is too high by at most
+ *      epsilon * cmsketch_total(s), with probability 1 - delta.
+ *      An estimate of 0 means "definitely absent". Unlike bloom,
+ *      counts may be removed (as long as they were added beforehand).
+ */
+
+/**< bloom: allocate and construct (n expected elements, false positive rate fpp) */
+bloom *bloom_new(struct typetable *ttbl, size_t n, double fpp);
+
+/**< bloom: destruct and deallocate */
+void bloom_delete(bloom **b);
+
+/**< bloom: length functions */
+size_t bloom_size(bloom *b);
+size_t bloom_bits(bloom *b);
+size_t bloom_hashes(bloom *b);
+double bloom_fpp(bloom *b);
+
+/**< bloom: insertion/lookup */
+void bloom_insert(bloom *b, const void *valaddr);
+bool bloom_contains(bloom *b, const void *valaddr);
+
+/**< bloom: modifiers - union/clear */
+void bloom_merge(bloom *b, bloom *other);
+void bloom_clear(bloom *b);
+
+/**< bloom: custom print functions - output to FILE stream */
+void bloom_puts(bloom *b);
+void bloom_fputs(bloom *b, FILE *dest);
+
+/**< bloom: retrieve typetable */
+struct typetable *bloom_get_ttbl(bloom *b);
+
+/**< cmsketch: allocate and construct (error epsilon, with probability 1 - delta) */
+cmsketch *cmsketch_new(struct typetable *ttbl, double epsilon, double delta);
+
+/**< cmsketch: destruct and deallocate */
+void cmsketch_delete(cmsketch **s);
+
+/**< cmsketch: length functions */
+unsigned long cmsketch_total(cmsketch *s);
+size_t cmsketch_width(cmsketch *s);
+size_t cmsketch_depth(cmsketch *s);
+
+/**< cmsketch: add/remove/estimate */
+void cmsketch_add(cmsketch *s, const void *valaddr, unsigned long count);
+void cmsketch_remove(cmsketch *s, const void *valaddr, unsigned long count);
+unsigned long cmsketch_estimate(cmsketch *s, const void *valaddr);
+bool cmsketch_contains(cmsketch *s, const void *valaddr);
+
+/**< cmsketch: modifiers - clear */
+void cmsketch_clear(cmsketch *s);
+
+/**< cmsketch: custom print functions - output to FILE stream */
+void cmsketch_puts(cmsketch *s);
+void cmsketch_fputs(cmsketch *s, FILE *dest);
+
+/**< cmsketch: retrieve typetable */
+struct typetable *cmsketch_get_ttbl(cmsketch *s);
+
+#endif /* BLOOM_H */
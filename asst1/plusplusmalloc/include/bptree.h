@@ -0,0 +1,150 @@
+/**
+ *  @file       bptree.h
+ *  @brief      Header file for an ordered map/set ADT (B+tree)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       07 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BPTREE_H
+#define BPTREE_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for (struct typetable) and related functions
+ */
+#include "utils.h"
+
+/**
+ *  @file       iterator.h
+ *  @brief      Required for iterator (struct iterator) and related functions
+ */
+#include "iterator.h"
+
+/**
+ *  @file       vector.h
+ *  @brief      Required for bulk loading from a sorted vector
+ */
+#include "vector.h"
+
+#include <stdlib.h>
+
+/**
+ *  @def        BPTREE_NODE_SIZE
+ *  @brief      Default size of a B+tree node, in bytes (one page)
+ *
+ *  bptree_newsz accepts any other node size --
+ *  e.g. 256 (four cache lines) favors inserts over scans.
+ */
+#define BPTREE_NODE_SIZE 4096
+
+/**
+ *  @def        BPTREE_MAX_HEIGHT
+ *  @brief      Maximum number of levels of a B+tree (fanout is at least 4)
+ */
+#define BPTREE_MAX_HEIGHT 48
+
+/**
+ *  @typedef    bptree
+ *  @brief      Alias for (struct bptree)
+ *
+ *  All instances of (struct bptree) will be addressed as (bptree).
+ */
+typedef struct bptree bptree;
+
+/**
+ *  @typedef    bptree_ptr
+ *  @brief      Alias for (struct bptree *) or (bptree *)
+ *
+ *  This typedef is to be used only for macros that perform token-pasting.
+ */
+typedef struct bptree *bptree_ptr;
+
+/**
+ *      bptree is an ordered map (or set, if no value typetable is given),
+ *      with the same interface as rbtree.
+ *
+ *      Every node is a fixed-size block holding as many keys as fit --
+ *      a search touches one node per level, and the keys within a node
+ *      are contiguous, so a lookup costs O(log_B n) cache misses
+ *      rather than rbtree's O(log_2 n).
+ *
+ *      Keys and values live only in the leaves; leaves are linked,
+ *      so range scans (lower_bound, then it_incr) walk the leaves
+ *      sequentially without revisiting internal nodes.
+ *
+ *      Erasure is lazy: a leaf is unlinked only once it is empty,
+ *      and nodes are never merged.
+ *
+ *      Iterators visit keys in order: it_curr yields the address of
+ *      a key, bptree_itvalue yields the address of its value.
+ *      The end iterator's current element is NULL.
+ */
+
+/**< bptree: allocate and construct */
+bptree *bptree_new(struct typetable *key_ttbl, struct typetable *val_ttbl);
+bptree *bptree_newsz(struct typetable *key_ttbl, struct typetable *val_ttbl, size_t node_size);
+bptree *bptree_newsorted(vector *keys, vector *values);
+bptree *bptree_newsortedptr(struct typetable *key_ttbl, struct typetable *val_ttbl,
+                            const void *keys, const void *values, size_t n);
+
+/**< bptree: destruct and deallocate */
+void bptree_delete(bptree **t);
+
+/**< bptree: iterator functions */
+iterator bptree_begin(bptree *t);
+iterator bptree_end(bptree *t);
+iterator bptree_lower_bound(bptree *t, const void *key);
+iterator bptree_upper_bound(bptree *t, const void *key);
+void *bptree_itvalue(iterator it);
+
+/**< bptree: length functions */
+size_t bptree_size(bptree *t);
+int bptree_height(bptree *t);
+bool bptree_empty(bptree *t);
+
+/**< bptree: element access functions */
+void *bptree_min(bptree *t);
+void *bptree_max(bptree *t);
+void *bptree_find(bptree *t, const void *key);
+bool bptree_contains(bptree *t, const void *key);
+
+/**< bptree: modifiers */
+void bptree_insert(bptree *t, const void *key, const void *value);
+void bptree_erase(bptree *t, const void *key);
+void bptree_clear(bptree *t);
+
+/**< bptree: custom print functions - output to FILE stream */
+void bptree_puts(bptree *t);
+void bptree_fputs(bptree *t, FILE *dest);
+
+/**< bptree: retrieve key/value typetables */
+struct typetable *bptree_get_key_ttbl(bptree *t);
+struct typetable *bptree_get_val_ttbl(bptree *t);
+
+/**< ptrs to vtables */
+extern struct iterator_table *_bptree_iterator_;
+
+#endif /* BPTREE_H */
@@ -0,0 +1,150 @@
+/**
+ *  @file       columns.h
+ *  @brief      Header file for a structure-of-arrays (columnar) ADT
+ *
+ *  @author     Gemuele Aludino
+ *  @date       02 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for (struct typetable) and related functions
+ */
+#include "utils.h"
+
+/**
+ *  @file       iterator.h
+ *  @brief      Required for iterator (struct iterator) and related functions
+ */
+#include "iterator.h"
+
+#include <stdlib.h>
+
+/**
+ *  @def        COLUMNS_DEFAULT_CAPACITY
+ *  @brief      Default capacity (in records) for each column's buffer
+ */
+#define COLUMNS_DEFAULT_CAPACITY 16
+
+/**
+ *  @def        COLUMNS_ALIGNMENT
+ *  @brief      Alignment (in bytes) of each column's base address --
+ *              one cache line, and wide enough for any SIMD load
+ */
+#define COLUMNS_ALIGNMENT 64
+
+/**
+ *  @typedef    columns
+ *  @brief      Alias for (struct columns)
+ *
+ *  All instances of (struct columns) will be addressed as (columns).
+ */
+typedef struct columns columns;
+
+/**
+ *  @typedef    columns_ptr
+ *  @brief      Alias for (struct columns *) or (columns *)
+ *
+ *  This typedef is to be used only for macros that perform token-pasting.
+ */
+typedef struct columns *columns_ptr;
+
+/**
+ *  @struct     column_field
+ *  @brief      Describes one field of a record schema
+ *
+ *  A schema is an array of column_field, one per field of a record type,
+ *  e.g. for struct point { int id; double x; double y; } --
+ *
+ *      struct column_field schema[] = {
+ *          { NULL, offsetof(struct point, id) },
+ *          { NULL, offsetof(struct point, x) },
+ *          { NULL, offsetof(struct point, y) }
+ *      };
+ *
+ *  with ttbl set to _int_, _double_, _double_ respectively.
+ */
+struct column_field {
+    struct typetable *ttbl; /**< width/copy/dtor/swap/compare/print of field */
+    size_t offset;          /**< offsetof(RECORD, field), for col_pushb/col_get */
+};
+
+/**
+ *      Each field is stored in its own contiguous buffer, aligned to
+ *      COLUMNS_ALIGNMENT -- a scan over one field touches only that field.
+ *
+ *      As with vector, fields are deep copied in by col_pushb iff the
+ *      field's typetable has a copy function, and are destroyed by
+ *      col_popb/col_clear/col_delete iff it has a dtor function.
+ *
+ *      The "kernels" (col_sum, col_filter_range, col_gather) run
+ *      tight loops over a column's primitive type, so the compiler
+ *      can vectorize them. col_sum and col_filter_range recognize the
+ *      primitive typetables (_int_, _double_, _uint32_, etc.) by address.
+ */
+
+/**< columns: allocate and construct (NULL if nfields is 0) */
+columns *col_new(const struct column_field *schema, size_t nfields);
+columns *col_newr(const struct column_field *schema, size_t nfields, size_t n);
+
+/**< columns: destruct and deallocate */
+void col_delete(columns **c);
+
+/**< columns: iterator functions (per column) */
+iterator col_begin(columns *c, size_t field);
+iterator col_end(columns *c, size_t field);
+
+/**< columns: length/capacity functions */
+size_t col_size(columns *c);
+size_t col_capacity(columns *c);
+size_t col_fields(columns *c);
+bool col_empty(columns *c);
+void col_reserve(columns *c, size_t n);
+
+/**< columns: element access functions */
+void *col_at(columns *c, size_t field, size_t index);
+void *col_data(columns *c, size_t field);
+void col_get(columns *c, size_t index, void *record);
+
+/**< columns: modifiers */
+void col_pushb(columns *c, const void *record);
+void col_popb(columns *c);
+void col_clear(columns *c);
+
+/**< columns: per-column kernels */
+double col_sum(columns *c, size_t field);
+size_t col_filter(columns *c, size_t field, unary_predicate_fn pred, size_t *out_idx);
+size_t col_filter_range(columns *c, size_t field, double lo, double hi, size_t *out_idx);
+void col_gather(columns *c, size_t field, const size_t *idx, size_t n, void *dest);
+
+/**< columns: retrieve typetable of a column */
+struct typetable *col_get_ttbl(columns *c, size_t field);
+
+extern struct iterator_table *_columns_iterator_;
+
+#endif /* COLUMNS_H */
@@ -0,0 +1,145 @@
+/**
+ *  @file       deque.h
+ *  @brief      Header file for a double-ended queue ADT
+ *
+ *  @author     Gemuele Aludino
+ *  @date       04 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DEQUE_H
+#define DEQUE_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for (struct typetable) and related functions
+ */
+#include "utils.h"
+
+/**
+ *  @file       iterator.h
+ *  @brief      Required for iterator (struct iterator) and related functions
+ */
+#include "iterator.h"
+
+#include <stdlib.h>
+
+/**
+ *  @def        DEQUE_CHUNK_SIZE
+ *  @brief      Size (in bytes) of each of deque's fixed-size chunks
+ *
+ *  A chunk holds (DEQUE_CHUNK_SIZE / width) elements,
+ *  or one element if width exceeds DEQUE_CHUNK_SIZE.
+ */
+#define DEQUE_CHUNK_SIZE 512
+
+/**
+ *  @typedef    deque
+ *  @brief      Alias for (struct deque)
+ *
+ *  All instances of (struct deque) will be addressed as (deque).
+ */
+typedef struct deque deque;
+
+/**
+ *  @typedef    deque_ptr
+ *  @brief      Alias for (struct deque *) or (deque *)
+ *
+ *  This typedef is to be used only for macros that perform token-pasting.
+ */
+typedef struct deque *deque_ptr;
+
+/**
+ *  @typedef    deque_dptr
+ *  @brief      Alias for (struct deque **) or (deque **)
+ *
+ *  This typedef is to be used only for macros that perform token-pasting.
+ */
+typedef struct deque **deque_dptr;
+
+/**
+ *      deque stores its elements in fixed-size chunks, addressed by
+ *      a map (array) of chunk pointers. Pushing/popping at either end
+ *      is O(1) amortized -- only the map (not the elements) is ever
+ *      reallocated, so the address of an element is stable
+ *      for as long as it remains in the deque.
+ *
+ *      Iterators (but not element addresses) are invalidated
+ *      by any push, since the map may be reallocated.
+ *
+ *      As with vector, elements are deep copied in iff the typetable
+ *      has a copy function, and destroyed iff it has a dtor function.
+ */
+
+/**< deque: allocate and construct */
+deque *d_new(struct typetable *ttbl);
+deque *d_newcopy(deque *d);
+
+/**< deque: destruct and deallocate */
+void d_delete(deque **d);
+
+/**< deque: iterator functions */
+iterator d_begin(deque *d);
+iterator d_end(deque *d);
+
+/**< deque: length functions */
+size_t d_size(deque *d);
+bool d_empty(deque *d);
+
+/**< deque: element access functions */
+void *d_at(deque *d, size_t n);
+void *d_front(deque *d);
+void *d_back(deque *d);
+
+/**< deque: modifiers - push/pop */
+void d_pushb(deque *d, const void *valaddr);
+void d_pushf(deque *d, const void *valaddr);
+void d_popb(deque *d);
+void d_popf(deque *d);
+
+/**< deque: modifiers - container swappage */
+void d_swap(deque **d, deque **other);
+
+/**< deque: modifiers - clear container */
+void d_clear(deque *d);
+
+/**< deque: custom print functions - output to FILE stream */
+void d_puts(deque *d);
+void d_fputs(deque *d, FILE *dest);
+
+/**< deque: required function prototypes for (struct typetable) */
+void *deque_copy(void *arg, const void *other);
+void deque_dtor(void *arg);
+void deque_swap(void *s1, void *s2);
+int deque_compare(const void *c1, const void *c2);
+void deque_print(const void *arg, FILE *dest);
+
+/**< deque: retrieve typetable */
+struct typetable *d_get_ttbl(deque *d);
+
+/**< ptrs to vtables */
+extern struct typetable *_deque_;
+extern struct iterator_table *_deque_iterator_;
+
+#endif /* DEQUE_H */
@@ -0,0 +1,138 @@
+/**
+ *  @file       hashmap.h
+ *  @brief      Header file for an unordered map/set ADT (open addressing)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       08 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for (struct typetable) and related functions
+ */
+#include "utils.h"
+
+/**
+ *  @file       iterator.h
+ *  @brief      Required for iterator (struct iterator) and related functions
+ */
+#include "iterator.h"
+
+#include <stdlib.h>
+
+/**
+ *  @def        HASHMAP_GROUP_WIDTH
+ *  @brief      Number of slots whose control bytes are probed at once
+ */
+#define HASHMAP_GROUP_WIDTH 16
+
+/**
+ *  @def        HASHMAP_MIGRATE_GROUPS
+ *  @brief      Groups moved from the old table per insert/erase, while resizing
+ */
+#define HASHMAP_MIGRATE_GROUPS 2
+
+/**
+ *  @typedef    hashmap
+ *  @brief      Alias for (struct hashmap)
+ *
+ *  All instances of (struct hashmap) will be addressed as (hashmap).
+ */
+typedef struct hashmap hashmap;
+
+/**
+ *  @typedef    hashmap_ptr
+ *  @brief      Alias for (struct hashmap *) or (hashmap *)
+ *
+ *  This typedef is to be used only for macros that perform token-pasting.
+ */
+typedef struct hashmap *hashmap_ptr;
+
+/**
+ *      hashmap is an unordered map (or set, if no value typetable is given).
+ *      Its key typetable must provide both hash and compare.
+ *
+ *      Slots are open addressed, in groups of HASHMAP_GROUP_WIDTH.
+ *      Each slot has a control byte: empty, deleted, or seven bits of
+ *      its key's hash. A probe compares a whole group's control bytes
+ *      against those seven bits at once (SSE2 where available),
+ *      so compare is only called on likely matches.
+ *
+ *      Resizing is incremental: a new table is allocated, and each
+ *      subsequent insert/erase moves HASHMAP_MIGRATE_GROUPS groups
+ *      from the old table. No single insert rehashes the whole map.
+ *
+ *      Keys of type _str_/_cstr_/_char_ptr_ are compared directly,
+ *      rather than through str_compare (which copies both strings).
+ *
+ *      Iterators are invalidated by insert/erase.
+ *      it_curr yields the address of a key, hashmap_itvalue the address
+ *      of its value. The end iterator's current element is NULL.
+ */
+
+/**< hashmap: allocate and construct */
+hashmap *hashmap_new(struct typetable *key_ttbl, struct typetable *val_ttbl);
+hashmap *hashmap_newr(struct typetable *key_ttbl, struct typetable *val_ttbl, size_t n);
+
+/**< hashmap: destruct and deallocate */
+void hashmap_delete(hashmap **m);
+
+/**< hashmap: iterator functions */
+iterator hashmap_begin(hashmap *m);
+iterator hashmap_end(hashmap *m);
+void *hashmap_itvalue(iterator it);
+
+/**< hashmap: length functions */
+size_t hashmap_size(hashmap *m);
+size_t hashmap_capacity(hashmap *m);
+bool hashmap_empty(hashmap *m);
+
+/**< hashmap: reserve functions */
+void hashmap_reserve(hashmap *m, size_t n);
+
+/**< hashmap: element access functions */
+void *hashmap_find(hashmap *m, const void *key);
+bool hashmap_contains(hashmap *m, const void *key);
+
+/**< hashmap: modifiers */
+void hashmap_insert(hashmap *m, const void *key, const void *value);
+void hashmap_erase(hashmap *m, const void *key);
+void hashmap_clear(hashmap *m);
+
+/**< hashmap: custom print functions - output to FILE stream */
+void hashmap_puts(hashmap *m);
+void hashmap_fputs(hashmap *m, FILE *dest);
+
+/**< hashmap: retrieve key/value typetables */
+struct typetable *hashmap_get_key_ttbl(hashmap *m);
+struct typetable *hashmap_get_val_ttbl(hashmap *m);
+
+/**< ptrs to vtables */
+extern struct iterator_table *_hashmap_iterator_;
+
+#endif /* HASHMAP_H */
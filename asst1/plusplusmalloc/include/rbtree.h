@@ -0,0 +1,139 @@
+/**
+ *  @file       rbtree.h
+ *  @brief      Header file for an ordered map/set ADT (left-leaning red-black tree)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       06 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef RBTREE_H
+#define RBTREE_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for (struct typetable) and related functions
+ */
+#include "utils.h"
+
+/**
+ *  @file       iterator.h
+ *  @brief      Required for iterator (struct iterator) and related functions
+ */
+#include "iterator.h"
+
+/**
+ *  @file       vector.h
+ *  @brief      Required for bulk construction from a sorted vector
+ */
+#include "vector.h"
+
+#include <stdlib.h>
+
+/**
+ *  @def        RBTREE_POOL_SLAB_LENGTH
+ *  @brief      Number of nodes allocated at once by rbtree's node pool
+ */
+#define RBTREE_POOL_SLAB_LENGTH 64
+
+/**
+ *  @typedef    rbtree
+ *  @brief      Alias for (struct rbtree)
+ *
+ *  All instances of (struct rbtree) will be addressed as (rbtree).
+ */
+typedef struct rbtree rbtree;
+
+/**
+ *  @typedef    rbtree_ptr
+ *  @brief      Alias for (struct rbtree *) or (rbtree *)
+ *
+ *  This typedef is to be used only for macros that perform token-pasting.
+ */
+typedef struct rbtree *rbtree_ptr;
+
+/**
+ *      rbtree is an ordered map, keyed by a typetable's compare function.
+ *      If no value typetable is provided (NULL), rbtree is an ordered set.
+ *
+ *      Each node holds its key (and value) inline -- nodes are carved out
+ *      of slabs of RBTREE_POOL_SLAB_LENGTH nodes, and erased nodes are
+ *      recycled through a free list, so there is no malloc per insert.
+ *
+ *      Keys and values are deep copied in iff their typetable has
+ *      a copy function, and destroyed iff it has a dtor function.
+ *
+ *      Iterators visit keys in order: it_curr yields the address of
+ *      a key, rbtree_itvalue yields the address of its value.
+ *      The end iterator's current element is NULL.
+ */
+
+/**< rbtree: allocate and construct */
+rbtree *rbtree_new(struct typetable *key_ttbl, struct typetable *val_ttbl);
+rbtree *rbtree_newsorted(vector *keys, vector *values);
+rbtree *rbtree_newcopy(rbtree *t);
+
+/**< rbtree: destruct and deallocate */
+void rbtree_delete(rbtree **t);
+
+/**< rbtree: iterator functions */
+iterator rbtree_begin(rbtree *t);
+iterator rbtree_end(rbtree *t);
+iterator rbtree_lower_bound(rbtree *t, const void *key);
+iterator rbtree_upper_bound(rbtree *t, const void *key);
+void *rbtree_itvalue(iterator it);
+
+/**< rbtree: length functions */
+size_t rbtree_size(rbtree *t);
+int rbtree_height(rbtree *t);
+bool rbtree_empty(rbtree *t);
+
+/**< rbtree: element access functions */
+void *rbtree_min(rbtree *t);
+void *rbtree_max(rbtree *t);
+void *rbtree_find(rbtree *t, const void *key);
+bool rbtree_contains(rbtree *t, const void *key);
+
+/**< rbtree: modifiers */
+void rbtree_insert(rbtree *t, const void *key, const void *value);
+void rbtree_erase(rbtree *t, const void *key);
+void rbtree_erase_min(rbtree *t);
+void rbtree_erase_max(rbtree *t);
+void rbtree_clear(rbtree *t);
+
+/**< rbtree: traversal */
+void rbtree_foreach(rbtree *t, consumer_fn consumer, enum node_traversal ttype);
+
+/**< rbtree: custom print functions - output to FILE stream */
+void rbtree_puts(rbtree *t);
+void rbtree_fputs(rbtree *t, FILE *dest);
+
+/**< rbtree: retrieve key/value typetables */
+struct typetable *rbtree_get_key_ttbl(rbtree *t);
+struct typetable *rbtree_get_val_ttbl(rbtree *t);
+
+/**< ptrs to vtables */
+extern struct iterator_table *_rbtree_iterator_;
+
+#endif /* RBTREE_H */
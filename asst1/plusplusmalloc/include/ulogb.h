@@ -0,0 +1,113 @@
+/**
+ *  @file       ulogb.h
+ *  @brief      Header file for a binary ulog encoder/decoder
+ *              (interned call sites, arguments serialized as is)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       19 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ULOGB_H
+#define ULOGB_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for ulog, ulog_encoder, and ulog_render
+ */
+#include "utils.h"
+
+#include <stdlib.h>
+
+/**
+ *  @def        ULOGB_SITES
+ *  @brief      Maximum number of distinct call sites (a power of 2)
+ */
+#define ULOGB_SITES 4096
+
+/**
+ *  @def        ULOGB_ARGS
+ *  @brief      Maximum number of arguments a site's format may consume
+ */
+#define ULOGB_ARGS 16
+
+/**
+ *  @def        ULOGB_RECORD_SIZE
+ *  @brief      Maximum size of an encoded message -- long strings are truncated
+ */
+#define ULOGB_RECORD_SIZE 4096
+
+/**
+ *  @def        ULOGB_BUFFER_SIZE
+ *  @brief      Size of the output stream's buffer
+ */
+#define ULOGB_BUFFER_SIZE 65536
+
+/**
+ *      While a binary log is open (ulogb_open), ulog does not format
+ *      its messages. Each call site -- its level, file, function, line,
+ *      and format string -- is written once, as a site record with an ID,
+ *      and its format string is parsed once. After that, a message is
+ *      an event record: the site's ID, the ulog attribute toggles,
+ *      and the arguments, copied as is (strings by value).
+ *
+ *      ulogb_decode renders a binary log as the text ulog would have
+ *      written (with the DATE/TIME of the program that wrote the log).
+ *      See client/ulogdump.c.
+ *
+ *      Layout (numbers are in the writer's byte order/sizes, which
+ *      the header records; ulogb_decode refuses a log whose header
+ *      does not match the reader):
+ *
+ *          header      "ULOGB1\n\0", sizes of short, int, long, size_t,
+ *                      double, long double, and void *, the int 0x01020304,
+ *                      then date and time (unsigned char length, characters)
+ *          site        'D', unsigned int id, long double line,
+ *                      level, file, func, fmt (unsigned short length, characters)
+ *          event       'E', unsigned int id, unsigned char attributes,
+ *                      unsigned short payload length, payload
+ *
+ *      If ULOGB_SITES is exhausted, or a format consumes more than
+ *      ULOGB_ARGS arguments, the message is formatted when logged, and
+ *      written (location first) through a fixed "%s" site for its level.
+ *      Messages are only dropped (see ulogb_dropped) if that fails too.
+ *      The %n conversion is ignored. ERROR messages flush the stream.
+ *      ulogb bypasses ulog_sink; output goes through a stdio stream.
+ */
+
+/**< ulogb: open/close a binary log (installs/removes ulog_encoder) */
+int ulogb_open(const char *path);
+void ulogb_close(void);
+
+/**< ulogb: status */
+unsigned long ulogb_dropped(void);
+
+/**< ulogb: ulog_encoder_fn installed by ulogb_open */
+int ulogb_encode(FILE *dest, const char *level, const char *file, const char *func,
+                 long double line, const char *fmt, va_list args);
+
+/**< ulogb: render a binary log as text (returns number of messages, or -1) */
+long ulogb_decode(FILE *in, FILE *out);
+
+#endif /* ULOGB_H */
@@ -72,6 +72,11 @@ typedef unsigned char bool;
  *          int foobar_compare(const void *c1, const void *c2);
  *          void foobar_print(const void *arg, FILE *dest);
  *
+ *  A hash function is optional, and only required by hash containers
+ *  (i.e. hashmap). Keys that compare equal must hash equally:
+ *
+ *          size_t foobar_hash(const void *arg);
+ *
  *  These prototypes may be in a public header if required to be,
  *  but are suggested to remain in a source file prior to their definitions
  *  only.
@@ -127,6 +132,7 @@ typedef void (*dtor_fn)(void *);
 typedef void (*swap_fn)(void *, void *);
 typedef int (*compare_fn)(const void *, const void *);
 typedef void (*print_fn)(const void *, FILE *);
+typedef size_t (*hash_fn)(const void *);
 
 /**
  *  @def        ADDR_AT
@@ -152,6 +158,8 @@ struct typetable {
 
     int (*compare)(const void *, const void *); /**< sorting/searching */
     void (*print)(const void *, FILE *dest);    /**< output to stream */
+
+    size_t (*hash)(const void *); /**< hash containers (optional) */
 };
 
 /**< Use these pointer variables to instantiate an ADT container (i.e. vector)
@@ -250,6 +258,19 @@ extern struct typetable *_pthread_t_;
                                                                                \
     struct typetable *_##TYPENAME##_ = &ttbl_##TYPENAME
 
+/**
+ *  @def        TYPETABLE_DEFINE_PTR_HASH
+ *  @brief      Like TYPETABLE_DEFINE_PTR, but includes TYPENAME##_hash,
+ *              for types that will be used as keys of a hash container
+ */
+#define TYPETABLE_DEFINE_PTR_HASH(TYPENAME)                                    \
+    struct typetable ttbl_##TYPENAME = {sizeof(TYPENAME),   TYPENAME##_copy,   \
+                                        TYPENAME##_dtor,    TYPENAME##_swap,   \
+                                        TYPENAME##_compare, TYPENAME##_print,  \
+                                        TYPENAME##_hash};                      \
+                                                                               \
+    struct typetable *_##TYPENAME##_ = &ttbl_##TYPENAME
+
 /**
  *  Stack allocated instances and heap allocated instances will need to be
  *  casted differently. You will need two different sets of
@@ -335,6 +356,7 @@ int cstr_compare(const void *c1, const void *c2);
 int cstr_compare_ignore_case(const void *c1, const void *c2);
 
 int void_ptr_compare(const void *c1, const void *c2);
+int void_ptr_value_compare(const void *c1, const void *c2);
 
 int int8_compare(const void *c1, const void *c2);
 int int16_compare(const void *c1, const void *c2);
@@ -352,6 +374,61 @@ int uint32_compare(const void *c1, const void *c2);
 int uint64_compare(const void *c1, const void *c2);
 #endif
 
+/**< Hash functions - casts arg to TYPE and hashes the pointee */
+size_t bytes_hash(const void *arg, size_t width);
+
+size_t char_hash(const void *arg);
+size_t signed_char_hash(const void *arg);
+size_t unsigned_char_hash(const void *arg);
+
+size_t short_int_hash(const void *arg);
+size_t signed_short_int_hash(const void *arg);
+size_t unsigned_short_int_hash(const void *arg);
+
+size_t int_hash(const void *arg);
+size_t signed_int_hash(const void *arg);
+size_t unsigned_int_hash(const void *arg);
+
+size_t long_int_hash(const void *arg);
+size_t signed_long_int_hash(const void *arg);
+size_t unsigned_long_int_hash(const void *arg);
+
+#if __STD_VERSION__ >= 199901L
+size_t long_long_int_hash(const void *arg);
+size_t signed_long_long_int_hash(const void *arg);
+size_t unsigned_long_long_int_hash(const void *arg);
+#endif
+
+size_t float_hash(const void *arg);
+size_t double_hash(const void *arg);
+
+size_t bool_hash(const void *arg);
+
+size_t char_ptr_hash(const void *arg);
+
+size_t str_hash(const void *arg);
+size_t str_hash_ignore_case(const void *arg);
+size_t cstr_hash(const void *arg);
+size_t cstr_hash_ignore_case(const void *arg);
+
+size_t void_ptr_hash(const void *arg);
+
+size_t int8_hash(const void *arg);
+size_t int16_hash(const void *arg);
+size_t int32_hash(const void *arg);
+
+#if __STD_VERSION__ >= 199901L
+size_t int64_hash(const void *arg);
+#endif
+
+size_t uint8_hash(const void *arg);
+size_t uint16_hash(const void *arg);
+size_t uint32_hash(const void *arg);
+
+#if __STD_VERSION__ >= 199901L
+size_t uint64_hash(const void *arg);
+#endif
+
 /**< Print functions - casts arg to TYPE and prints output to dest */
 void char_print(const void *arg, FILE *dest);
 void signed_char_print(const void *arg, FILE *dest);
@@ -760,6 +837,60 @@ int ulog(
     long double line,      /**< meant for use with the __LINE__ macro */
     const char *fmt, ...); /**< user's custom message */
 
+int ulog_raw(FILE *dest, int level, const char *fmt, ...);
+
+/**
+ *  @enum       ulog_level
+ *  @brief      Severities of ulog messages, in ascending order
+ *
+ *  A message is formatted and written only if its level is at or above
+ *  ulog_threshold -- the check happens before any formatting
+ *  (and, for the BUG/LOG/ERROR/WARNING macros, before their arguments
+ *  are evaluated). ULOG_LEVEL_NONE as the threshold silences ulog.
+ */
+enum ulog_level {
+    ULOG_LEVEL_BUG,
+    ULOG_LEVEL_LOG,
+    ULOG_LEVEL_WARNING,
+    ULOG_LEVEL_ERROR,
+    ULOG_LEVEL_NONE
+};
+
+extern int ulog_threshold;
+
+#define ULOG_ENABLED(ULOG_LEVEL) ((ULOG_LEVEL) >= ulog_threshold)
+
+/**
+ *  @typedef    ulog_sink_fn
+ *  @brief      Backend that receives one formatted ulog line
+ *
+ *  line is length bytes long, ends with a newline, and is not
+ *  guaranteed to outlive the call. If ulog_sink is NULL (the default),
+ *  lines are written to dest synchronously. See ulogq.h for
+ *  an asynchronous backend.
+ */
+typedef int (*ulog_sink_fn)(FILE *dest, int level, const char *line, size_t length);
+
+extern ulog_sink_fn ulog_sink;
+
+/**
+ *  @typedef    ulog_encoder_fn
+ *  @brief      Backend that receives ulog's arguments, unformatted
+ *
+ *  If ulog_encoder is non-NULL, ulog passes every message that passes
+ *  the level filter to it (as is) instead of formatting it.
+ *  See ulogb.h for a binary log encoder.
+ */
+typedef int (*ulog_encoder_fn)(FILE *dest, const char *level, const char *file,
+                               const char *func, long double line,
+                               const char *fmt, va_list args);
+
+extern ulog_encoder_fn ulog_encoder;
+
+size_t ulog_render(char *buffer, size_t size, const char *date, const char *time,
+                   const char *level, const char *file, const char *func,
+                   long double line, const char *fmt, ...);
+
 /**
  *  Unless you would like to create a customized
  *  debugging message, please use the following preprocessor directives.
@@ -831,15 +962,17 @@ ULOG_TOGGLE_ATTR(MESSAGE);
 #if __STDC_VERSION__ >= 199901L
 # ifndef ULOG_DISABLE_BUG
 #  define BUG(FILEMACRO, ...)                                                    \
+          (ULOG_ENABLED(ULOG_LEVEL_BUG) ?                                        \
           ulog(ULOG_STREAM_BUG, "[BUG]", FILEMACRO, __func__, (long int)__LINE__,    \
-              __VA_ARGS__)
+              __VA_ARGS__) : 0)
 # else
 #  define BUG(FILEMACRO, ...)
 # endif /* ULOG_DISABLE_BUG */
 #else
 # ifndef ULOG_DISABLE_BUG
 #  define BUG(FILEMACRO, MSG)                                                    \
-          ulog(ULOG_STREAM_BUG, "[BUG]", FILEMACRO, __func__, (long int)__LINE__, MSG)
+          (ULOG_ENABLED(ULOG_LEVEL_BUG) ?                                        \
+          ulog(ULOG_STREAM_BUG, "[BUG]", FILEMACRO, __func__, (long int)__LINE__, MSG) : 0)
 # else
 #  define BUG(FILEMACRO, MSG)
 # endif /* ULOG_DISABLE_BUG */
@@ -857,15 +990,17 @@ ULOG_TOGGLE_ATTR(MESSAGE);
 #if __STDC_VERSION__ >= 199901L
 # ifndef ULOG_DISABLE_LOG
 #  define LOG(FILEMACRO, ...)                                                    \
+          (ULOG_ENABLED(ULOG_LEVEL_LOG) ?                                        \
           ulog(ULOG_STREAM_LOG, "[LOG]", FILEMACRO, __func__, (long int)__LINE__,    \
-          __VA_ARGS__)
+          __VA_ARGS__) : 0)
 # else
 #  define LOG(FILEMACRO, ...)
 # endif /* ULOG_DISABLE_LOG */
 #else
 # ifndef ULOG_DISABLE_LOG
 #  define LOG(FILEMACRO, MSG)                                                    \
-          ulog(ULOG_STREAM_LOG, "[LOG]", FILEMACRO, __func__, (long int)__LINE__, MSG)
+          (ULOG_ENABLED(ULOG_LEVEL_LOG) ?                                        \
+          ulog(ULOG_STREAM_LOG, "[LOG]", FILEMACRO, __func__, (long int)__LINE__, MSG) : 0)
 # else
 #  define LOG(FILEMACRO, MSG)
 # endif /* ULOG_DISABLE_LOG */
@@ -883,14 +1018,16 @@ ULOG_TOGGLE_ATTR(MESSAGE);
 #if __STDC_VERSION__ >= 199901L
 # ifndef ULOG_DISABLE_ERROR
 #  define ERROR(FILEMACRO, ...)                                                  \
+          (ULOG_ENABLED(ULOG_LEVEL_ERROR) ?                                      \
           ulog(ULOG_STREAM_ERROR, "[ERROR]", FILEMACRO, __func__,                    \
-          (long int)__LINE__, __VA_ARGS__)
+          (long int)__LINE__, __VA_ARGS__) : 0)
 # endif /* ULOG_DISABLE_ERROR */
 #else
 # ifndef ULOG_DISABLE_ERROR
 #  define ERROR(FILEMACRO, MSG)                                                  \
+          (ULOG_ENABLED(ULOG_LEVEL_ERROR) ?                                      \
           ulog(ULOG_STREAM_ERROR, "[ERROR]", FILEMACRO, __func__,                    \
-          (long int)__LINE__, MSG)
+          (long int)__LINE__, MSG) : 0)
 # else
 #  define ERROR(FILEMACRO, MSG)
 # endif /* ULOG_DISABLE_ERROR */
@@ -903,14 +1040,16 @@ ULOG_TOGGLE_ATTR(MESSAGE);
 #if __STDC_VERSION__ >= 199901L
 # ifndef ULOG_DISABLE_WARNING
 #  define WARNING(FILEMACRO, ...)                                                \
+          (ULOG_ENABLED(ULOG_LEVEL_WARNING) ?                                    \
           ulog(ULOG_STREAM_WARNING, "[WARNING]", FILEMACRO, __func__,                \
-          (long int)__LINE__, __VA_ARGS__)
+          (long int)__LINE__, __VA_ARGS__) : 0)
 # endif /* ULOG_DISABLE_WARNING */
 #else
 # ifndef ULOG_DISABLE_WARNING
 #  define WARNING(FILEMACRO, MSG)                                                \
+          (ULOG_ENABLED(ULOG_LEVEL_WARNING) ?                                    \
           ulog(ULOG_STREAM_WARNING, "[WARNING]", FILEMACRO, __func__,                \
-          (long int)__LINE__, MSG)
+          (long int)__LINE__, MSG) : 0)
 # else
 #  define WARNING(FILEMACRO, MSG)
 # endif /* ULOG_DISABLE_WARNING */
@@ -51,6 +51,19 @@
  */
 #define VECTOR_DEFAULT_CAPACITY 16
 
+/**
+ *  @enum       vector_growth
+ *  @brief      Growth policies for vector's internal buffer
+ *
+ *  The policy determines the new capacity chosen when an insertion
+ *  would meet or exceed vector's current capacity.
+ */
+enum vector_growth {
+    VECTOR_GROWTH_DOUBLE,       /**< capacity * 2 (default) */
+    VECTOR_GROWTH_1_5X,         /**< capacity * 1.5 */
+    VECTOR_GROWTH_PAGE          /**< capacity * 2, rounded up to whole pages */
+};
+
 /**
  *  @typedef    vector
  *  @brief      Alias for (struct vector)
@@ -124,8 +137,13 @@ bool v_empty(vector *v);
 
 /**< vector: reserve/shrinking functions */
 void v_reserve(vector *v, size_t n);
+void v_reserve_exact(vector *v, size_t n);
 void v_shrink_to_fit(vector *v);
 
+/**< vector: growth policy functions */
+void v_set_growth(vector *v, enum vector_growth policy);
+enum vector_growth v_get_growth(vector *v);
+
 /**< vector: element access functions */
 void *v_at(vector *v, size_t n);
 void *v_front(vector *v);
@@ -146,6 +164,26 @@ void v_assignfill(vector *v, size_t n, const void *valaddr);
 void v_pushb(vector *v, const void *valaddr);
 void v_popb(vector *v);
 
+/**< vector: modifiers - bulk append */
+void v_append_bulk(vector *v, const void *src, size_t n);
+
+/**
+ *      "move" functions transfer ownership of an element into vector --
+ *      the element is never copied (deep or shallow copy function unused),
+ *      and the source is zeroed afterward, so a subsequent dtor/free
+ *      on the source by the client is harmless.
+ *
+ *      "emplace" functions open a zeroed block within vector and return
+ *      its address, so that the client may construct an element in place.
+ */
+
+/**< vector: modifiers - move/emplace */
+void v_pushbmove(vector *v, void *valaddr);
+void v_insert_atmove(vector *v, size_t index, void *valaddr);
+void v_assignmove(vector *v, void *base, size_t n);
+void *v_emplaceb(vector *v);
+void *v_emplace_at(vector *v, size_t index);
+
 /**< vector: modifiers - insertion */
 iterator v_insert(vector *v, iterator pos, const void *valaddr);
 iterator v_insertfill(vector *v, iterator pos, size_t n, const void *valaddr);
@@ -183,8 +221,35 @@ void v_reverse(vector *v);
 vector *v_arrtov(struct typetable *ttbl, void *base, size_t length);
 vector *v_ptrtov(struct typetable *ttbl, void *base, size_t length, size_t capacity);
 
+/**
+ *      v_mmap_open and v_load map a file instead of reading it --
+ *      startup is O(1) regardless of the file's size, and pages
+ *      are loaded on first access. The vectors they return are read-only
+ *      views (modifiers fail an massert); v_delete unmaps the file.
+ *      v_mmap_open views a headerless file of fixed-width records;
+ *      v_load views a file written by v_save, validating its width and count.
+ *      Only types without copy/dtor functions may be saved or mapped.
+ */
+
+/**< vector: custom utility functions - file mapping / save / load */
+vector *v_mmap_open(const char *path, struct typetable *ttbl);
+int v_save(vector *v, const char *path);
+vector *v_load(const char *path, struct typetable *ttbl);
+
+/**
+ *      v_search_parallel returns what v_search would (the index of the first
+ *      element that compares equal to valaddr, or -1), splitting the scan
+ *      across nthreads threads (0 for one per core) of a pool that is
+ *      created on first use and kept for later calls. Small vectors are
+ *      scanned by the caller alone. If the typetable's comparator is
+ *      one of the builtin integer/char/bool comparators, elements are
+ *      compared by value instead of by calling it. Concurrent calls
+ *      are serialized -- they share the one pool.
+ */
+
 /**< vector: custom utility functions - search / sort by default comparator */
 int v_search(vector *v, const void *valaddr);
+int v_search_parallel(vector *v, const void *valaddr, size_t nthreads);
 void v_sort(vector *v);
 
 /**< vector: custom print functions - output to FILE stream */
@@ -221,4 +286,26 @@ struct typetable *v_get_ttbl(vector *v);
 extern struct typetable *_vector_;
 extern struct iterator_table *_vector_iterator_;
 
+/**
+ *  @def        V_FOREACH
+ *  @brief      Visits each element of vector VEC, in order, as (TYPE *) POS
+ *
+ *  POS and FINISH are (TYPE *) variables declared by the caller;
+ *  FINISH is set to one block past VEC's rear element. The loop is a
+ *  plain pointer walk -- unlike the iterator functions, no calls are made
+ *  through _vector_iterator_ per element. VEC is evaluated twice,
+ *  and must not be resized within the loop.
+ *
+ *      int *pos = NULL;
+ *      int *finish = NULL;
+ *
+ *      V_FOREACH(int, pos, finish, v) {
+ *          sum += *pos;
+ *      }
+ */
+#define V_FOREACH(TYPE, POS, FINISH, VEC)                                      \
+for ((POS) = (TYPE *)(v_front(VEC)), (FINISH) = (POS) + v_size(VEC);           \
+     (POS) != (FINISH);                                                        \
+     ++(POS))
+
 #endif /* VECTOR_H */
@@ -0,0 +1,531 @@
+/**
+ *  @file       vector_typed.h
+ *  @brief      Header file for type-specialized vectors, generated by macro
+ *
+ *  @author     Gemuele Aludino
+ *  @date       16 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef VECTOR_TYPED_H
+#define VECTOR_TYPED_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for massert functions and ERROR
+ */
+#include "utils.h"
+
+/**
+ *  @file       vector.h
+ *  @brief      Required for VECTOR_DEFAULT_CAPACITY
+ */
+#include "vector.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ *      DECLARE_VECTOR(T, NAME) declares a vector of T, named NAME --
+ *      a struct NAME and the functions NAME_new, NAME_pushb, NAME_at, ...
+ *      that mirror the v_* functions of vector, with T * in place of void *.
+ *
+ *      DEFINE_VECTOR(T, NAME, COPY, DTOR, COMPARE, PRINT) defines them,
+ *      in exactly one source file. Instead of a typetable, the element
+ *      functions are macros (or functions) named at definition, called
+ *      directly, so the compiler may inline them:
+ *
+ *          COPY(T *dst, const T *src)      constructs *dst from *src
+ *          DTOR(T *arg)                    destroys *arg
+ *          COMPARE(const T *c1, const T *c2) returns <0, 0, >0
+ *          PRINT(const T *arg, FILE *dest) prints *arg
+ *
+ *      T must be a single type name -- pointer types must be aliased
+ *      by typedef first (e.g. char_ptr for char *), so that const T *
+ *      qualifies the element, rather than what it points to.
+ *
+ *      Unlike vector, struct NAME is not opaque -- [start, finish)
+ *      may be walked with a (T *), and elements are addressed without
+ *      a width multiply. Storage comes from the system allocator.
+ *      NAME_back returns NULL if the vector is empty.
+ *      NAME_sort is a stable merge sort generated for T,
+ *      so COMPARE is called directly, rather than through qsort.
+ *
+ *      For example (header, then source):
+ *
+ *          DECLARE_VECTOR(long, vector_long);
+ *
+ *          DEFINE_VECTOR(long, vector_long, VECTOR_COPY_ASSIGN,
+ *                        VECTOR_DTOR_NONE, VECTOR_COMPARE_VALUE,
+ *                        VECTOR_PRINT_LONG);
+ */
+
+/**< element functions: scalars (assignment, no-op destruction, <, >) */
+#define VECTOR_COPY_ASSIGN(DST, SRC) (*(DST) = *(SRC))
+#define VECTOR_DTOR_NONE(ARG) ((void)(ARG))
+#define VECTOR_COMPARE_VALUE(C1, C2) ((*(C1) > *(C2)) - (*(C1) < *(C2)))
+
+/**< element functions: (char *), deep copied -- compared with strcmp (untrimmed) */
+#define VECTOR_COPY_STR(DST, SRC)                                              \
+    (*(DST) = strcpy(malloc(strlen(*(SRC)) + 1), *(SRC)))
+#define VECTOR_DTOR_STR(ARG) (free(*(ARG)), *(ARG) = NULL)
+#define VECTOR_COMPARE_STR(C1, C2) strcmp(*(C1), *(C2))
+
+/**< NAME_sort: runs of this many elements are insertion sorted, then merged */
+#define VECTOR_TYPED_SORT_RUN 16
+
+/**< element functions: printing */
+#define VECTOR_PRINT_INT(ARG, DEST) fprintf(DEST, "%d", *(ARG))
+#define VECTOR_PRINT_LONG(ARG, DEST) fprintf(DEST, "%ld", *(ARG))
+#define VECTOR_PRINT_DOUBLE(ARG, DEST) fprintf(DEST, "%f", *(ARG))
+#define VECTOR_PRINT_STR(ARG, DEST) fprintf(DEST, "%s", *(ARG))
+
+/**
+ *  @def        DECLARE_VECTOR
+ *  @brief      For use in a header file, declares struct NAME (a vector of T)
+ *              and its functions
+ */
+#define DECLARE_VECTOR(T, NAME)                                                \
+    typedef struct NAME NAME;                                                  \
+                                                                               \
+    struct NAME {                                                              \
+        T *start;                                                              \
+        T *finish;                                                             \
+        T *end_of_storage;                                                     \
+    };                                                                         \
+                                                                               \
+    NAME *NAME##_new(void);                                                    \
+    NAME *NAME##_newr(size_t n);                                               \
+    NAME *NAME##_newcopy(NAME *v);                                             \
+    void NAME##_delete(NAME **v);                                              \
+                                                                               \
+    T *NAME##_begin(NAME *v);                                                  \
+    T *NAME##_end(NAME *v);                                                    \
+                                                                               \
+    size_t NAME##_size(NAME *v);                                               \
+    size_t NAME##_capacity(NAME *v);                                           \
+    bool NAME##_empty(NAME *v);                                                \
+                                                                               \
+    void NAME##_reserve(NAME *v, size_t n);                                    \
+    void NAME##_resize(NAME *v, size_t n);                                     \
+    void NAME##_shrink_to_fit(NAME *v);                                        \
+                                                                               \
+    T *NAME##_at(NAME *v, size_t n);                                           \
+    T *NAME##_front(NAME *v);                                                  \
+    T *NAME##_back(NAME *v);                                                   \
+    T *NAME##_data(NAME *v);                                                   \
+                                                                               \
+    void NAME##_pushb(NAME *v, const T *valaddr);                              \
+    void NAME##_popb(NAME *v);                                                 \
+    void NAME##_append_bulk(NAME *v, const T *src, size_t n);                  \
+                                                                               \
+    void NAME##_insert_at(NAME *v, size_t index, const T *valaddr);            \
+    void NAME##_erase_at(NAME *v, size_t index);                               \
+    void NAME##_replace_at(NAME *v, size_t index, const T *valaddr);           \
+    void NAME##_clear(NAME *v);                                                \
+                                                                               \
+    int NAME##_search(NAME *v, const T *valaddr);                              \
+    void NAME##_sort(NAME *v);                                                 \
+                                                                               \
+    void NAME##_puts(NAME *v);                                                 \
+    void NAME##_fputs(NAME *v, FILE *dest)
+
+/**
+ *  @def        DEFINE_VECTOR
+ *  @brief      For use in a source file, defines the functions of NAME
+ *              (declared by DECLARE_VECTOR), with the given element functions
+ */
+#define DEFINE_VECTOR(T, NAME, COPY, DTOR, COMPARE, PRINT)                     \
+    static void NAME##_grow(NAME *v, size_t n);                                \
+    static void NAME##_insertion_sort(T *base, size_t n);                      \
+    static void NAME##_merge(const T *src, size_t first, size_t middle,        \
+                             size_t last, T *dst);                             \
+                                                                               \
+    NAME *NAME##_new(void) {                                                   \
+        return NAME##_newr(VECTOR_DEFAULT_CAPACITY);                           \
+    }                                                                          \
+                                                                               \
+    NAME *NAME##_newr(size_t n) {                                              \
+        NAME *v = malloc(sizeof *v);                                           \
+        massert_malloc(v);                                                     \
+                                                                               \
+        n = n > 0 ? n : 1;                                                     \
+                                                                               \
+        v->start = malloc(sizeof *v->start * n);                               \
+        massert_malloc(v->start);                                              \
+                                                                               \
+        v->finish = v->start;                                                  \
+        v->end_of_storage = v->start + n;                                      \
+                                                                               \
+        return v;                                                              \
+    }                                                                          \
+                                                                               \
+    NAME *NAME##_newcopy(NAME *v) {                                            \
+        NAME *copy = NULL;                                                     \
+        T *curr = NULL;                                                        \
+                                                                               \
+        massert_container(v);                                                  \
+                                                                               \
+        copy = NAME##_newr(NAME##_size(v));                                    \
+                                                                               \
+        for (curr = v->start; curr != v->finish; ++curr, ++copy->finish) {     \
+            COPY(copy->finish, curr);                                          \
+        }                                                                      \
+                                                                               \
+        return copy;                                                           \
+    }                                                                          \
+                                                                               \
+    void NAME##_delete(NAME **v) {                                             \
+        massert_container((*v));                                               \
+                                                                               \
+        NAME##_clear((*v));                                                    \
+        free((*v)->start);                                                     \
+                                                                               \
+        free((*v));                                                            \
+        (*v) = NULL;                                                           \
+    }                                                                          \
+                                                                               \
+    T *NAME##_begin(NAME *v) {                                                 \
+        massert_container(v);                                                  \
+        return v->start;                                                       \
+    }                                                                          \
+                                                                               \
+    T *NAME##_end(NAME *v) {                                                   \
+        massert_container(v);                                                  \
+        return v->finish;                                                      \
+    }                                                                          \
+                                                                               \
+    size_t NAME##_size(NAME *v) {                                              \
+        massert_container(v);                                                  \
+        return v->finish - v->start;                                           \
+    }                                                                          \
+                                                                               \
+    size_t NAME##_capacity(NAME *v) {                                          \
+        massert_container(v);                                                  \
+        return v->end_of_storage - v->start;                                   \
+    }                                                                          \
+                                                                               \
+    bool NAME##_empty(NAME *v) {                                               \
+        massert_container(v);                                                  \
+        return v->start == v->finish;                                          \
+    }                                                                          \
+                                                                               \
+    void NAME##_reserve(NAME *v, size_t n) {                                   \
+        massert_container(v);                                                  \
+                                                                               \
+        if (n > NAME##_capacity(v)) {                                          \
+            NAME##_grow(v, n);                                                 \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    void NAME##_resize(NAME *v, size_t n) {                                    \
+        T *sentinel = NULL;                                                    \
+                                                                               \
+        massert_container(v);                                                  \
+                                                                               \
+        NAME##_reserve(v, n);                                                  \
+        sentinel = v->start + n;                                               \
+                                                                               \
+        while (v->finish > sentinel) {                                         \
+            --v->finish;                                                       \
+            DTOR(v->finish);                                                   \
+        }                                                                      \
+                                                                               \
+        if (v->finish < sentinel) {                                            \
+            memset(v->finish, 0, sizeof *v->finish * (sentinel - v->finish));  \
+            v->finish = sentinel;                                              \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    void NAME##_shrink_to_fit(NAME *v) {                                       \
+        massert_container(v);                                                  \
+        NAME##_grow(v, NAME##_size(v));                                        \
+    }                                                                          \
+                                                                               \
+    T *NAME##_at(NAME *v, size_t n) {                                          \
+        massert_container(v);                                                  \
+                                                                               \
+        if (n >= NAME##_size(v)) {                                             \
+            ERROR(__FILE__, "index out of bounds.");                           \
+            return NULL;                                                       \
+        }                                                                      \
+                                                                               \
+        return v->start + n;                                                   \
+    }                                                                          \
+                                                                               \
+    T *NAME##_front(NAME *v) {                                                 \
+        massert_container(v);                                                  \
+        return v->start;                                                       \
+    }                                                                          \
+                                                                               \
+    T *NAME##_back(NAME *v) {                                                  \
+        massert_container(v);                                                  \
+        return v->finish != v->start ? v->finish - 1 : NULL;                   \
+    }                                                                          \
+                                                                               \
+    T *NAME##_data(NAME *v) {                                                  \
+        massert_container(v);                                                  \
+        return v->start;                                                       \
+    }                                                                          \
+                                                                               \
+    void NAME##_pushb(NAME *v, const T *valaddr) {                             \
+        massert_container(v);                                                  \
+        massert_ptr(valaddr);                                                  \
+                                                                               \
+        if (v->finish == v->end_of_storage) {                                  \
+            NAME##_grow(v, NAME##_capacity(v) * 2);                            \
+        }                                                                      \
+                                                                               \
+        COPY(v->finish, valaddr);                                              \
+        ++v->finish;                                                           \
+    }                                                                          \
+                                                                               \
+    void NAME##_popb(NAME *v) {                                                \
+        massert_container(v);                                                  \
+                                                                               \
+        if (v->finish == v->start) {                                           \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        --v->finish;                                                           \
+        DTOR(v->finish);                                                       \
+    }                                                                          \
+                                                                               \
+    void NAME##_append_bulk(NAME *v, const T *src, size_t n) {                 \
+        const T *sentinel = src + n;                                           \
+                                                                               \
+        massert_container(v);                                                  \
+        massert_ptr(src);                                                      \
+                                                                               \
+        if (NAME##_size(v) + n > NAME##_capacity(v)) {                         \
+            NAME##_grow(v, NAME##_size(v) + n);                                \
+        }                                                                      \
+                                                                               \
+        for (; src != sentinel; ++src, ++v->finish) {                          \
+            COPY(v->finish, src);                                              \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    void NAME##_insert_at(NAME *v, size_t index, const T *valaddr) {           \
+        massert_container(v);                                                  \
+        massert_ptr(valaddr);                                                  \
+                                                                               \
+        if (index > NAME##_size(v)) {                                          \
+            ERROR(__FILE__, "index out of bounds.");                           \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        if (v->finish == v->end_of_storage) {                                  \
+            NAME##_grow(v, NAME##_capacity(v) * 2);                            \
+        }                                                                      \
+                                                                               \
+        memmove(v->start + index + 1, v->start + index,                        \
+                sizeof *v->start * (NAME##_size(v) - index));                  \
+                                                                               \
+        COPY(v->start + index, valaddr);                                       \
+        ++v->finish;                                                           \
+    }                                                                          \
+                                                                               \
+    void NAME##_erase_at(NAME *v, size_t index) {                              \
+        massert_container(v);                                                  \
+                                                                               \
+        if (index >= NAME##_size(v)) {                                         \
+            ERROR(__FILE__, "index out of bounds.");                           \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        DTOR(v->start + index);                                                \
+                                                                               \
+        memmove(v->start + index, v->start + index + 1,                        \
+                sizeof *v->start * (NAME##_size(v) - index - 1));              \
+                                                                               \
+        --v->finish;                                                           \
+    }                                                                          \
+                                                                               \
+    void NAME##_replace_at(NAME *v, size_t index, const T *valaddr) {          \
+        massert_container(v);                                                  \
+        massert_ptr(valaddr);                                                  \
+                                                                               \
+        if (index >= NAME##_size(v)) {                                         \
+            ERROR(__FILE__, "index out of bounds.");                           \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        DTOR(v->start + index);                                                \
+        COPY(v->start + index, valaddr);                                       \
+    }                                                                          \
+                                                                               \
+    void NAME##_clear(NAME *v) {                                               \
+        massert_container(v);                                                  \
+                                                                               \
+        while (v->finish != v->start) {                                        \
+            --v->finish;                                                       \
+            DTOR(v->finish);                                                   \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    int NAME##_search(NAME *v, const T *valaddr) {                             \
+        T *curr = NULL;                                                        \
+                                                                               \
+        massert_container(v);                                                  \
+        massert_ptr(valaddr);                                                  \
+                                                                               \
+        for (curr = v->start; curr != v->finish; ++curr) {                     \
+            if (COMPARE(curr, valaddr) == 0) {                                 \
+                return (int)(curr - v->start);                                 \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        return -1;                                                             \
+    }                                                                          \
+                                                                               \
+    void NAME##_sort(NAME *v) {                                                \
+        T *buffer = NULL;                                                      \
+        T *src = NULL;                                                         \
+        T *dst = NULL;                                                         \
+        T *temp = NULL;                                                        \
+        size_t size = 0;                                                       \
+        size_t width = 0;                                                      \
+        size_t i = 0;                                                          \
+                                                                               \
+        massert_container(v);                                                  \
+        size = NAME##_size(v);                                                 \
+                                                                               \
+        for (i = 0; i < size; i += VECTOR_TYPED_SORT_RUN) {                    \
+            width = size - i < VECTOR_TYPED_SORT_RUN ?                         \
+                    size - i : VECTOR_TYPED_SORT_RUN;                          \
+            NAME##_insertion_sort(v->start + i, width);                        \
+        }                                                                      \
+                                                                               \
+        if (size <= VECTOR_TYPED_SORT_RUN) {                                   \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        buffer = malloc(sizeof *buffer * size);                                \
+        massert_malloc(buffer);                                                \
+                                                                               \
+        /* bottom-up -- merge runs of width from src into dst, then swap */    \
+        src = v->start;                                                        \
+        dst = buffer;                                                          \
+                                                                               \
+        for (width = VECTOR_TYPED_SORT_RUN; width < size; width *= 2) {        \
+            for (i = 0; i < size; i += 2 * width) {                            \
+                NAME##_merge(src, i,                                           \
+                             i + width < size ? i + width : size,              \
+                             i + (2 * width) < size ? i + (2 * width) : size,  \
+                             dst);                                             \
+            }                                                                  \
+                                                                               \
+            temp = src;                                                        \
+            src = dst;                                                         \
+            dst = temp;                                                        \
+        }                                                                      \
+                                                                               \
+        if (src != v->start) {                                                 \
+            memcpy(v->start, src, sizeof *src * size);                         \
+        }                                                                      \
+                                                                               \
+        free(buffer);                                                          \
+    }                                                                          \
+                                                                               \
+    void NAME##_puts(NAME *v) {                                                \
+        NAME##_fputs(v, stdout);                                               \
+    }                                                                          \
+                                                                               \
+    void NAME##_fputs(NAME *v, FILE *dest) {                                   \
+        T *curr = NULL;                                                        \
+                                                                               \
+        massert_container(v);                                                  \
+        massert_ptr(dest);                                                     \
+                                                                               \
+        fprintf(dest, "[");                                                    \
+                                                                               \
+        for (curr = v->start; curr != v->finish; ++curr) {                     \
+            PRINT(curr, dest);                                                 \
+            fputs(curr + 1 != v->finish ? ", " : "", dest);                    \
+        }                                                                      \
+                                                                               \
+        fprintf(dest, "]\n");                                                  \
+    }                                                                          \
+                                                                               \
+    static void NAME##_grow(NAME *v, size_t n) {                               \
+        const size_t size = NAME##_size(v);                                    \
+        T *start = NULL;                                                       \
+                                                                               \
+        n = n > size ? n : size;                                               \
+        n = n > 0 ? n : 1;                                                     \
+                                                                               \
+        start = realloc(v->start, sizeof *v->start * n);                       \
+        massert_realloc(start);                                                \
+                                                                               \
+        v->start = start;                                                      \
+        v->finish = start + size;                                              \
+        v->end_of_storage = start + n;                                         \
+    }                                                                          \
+                                                                               \
+    static void NAME##_insertion_sort(T *base, size_t n) {                     \
+        T key;                                                                 \
+        size_t i = 0;                                                          \
+        size_t j = 0;                                                          \
+                                                                               \
+        for (i = 1; i < n; i++) {                                              \
+            key = base[i];                                                     \
+                                                                               \
+            for (j = i; j > 0 && COMPARE(&key, base + j - 1) < 0; j--) {       \
+                base[j] = base[j - 1];                                         \
+            }                                                                  \
+                                                                               \
+            base[j] = key;                                                     \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static void NAME##_merge(const T *src, size_t first, size_t middle,        \
+                             size_t last, T *dst) {                            \
+        size_t i = first;                                                      \
+        size_t j = middle;                                                     \
+        size_t k = first;                                                      \
+                                                                               \
+        /* ties take from the left run, so the sort is stable */               \
+        while (i < middle && j < last) {                                       \
+            dst[k++] = COMPARE(src + j, src + i) < 0 ? src[j++] : src[i++];    \
+        }                                                                      \
+                                                                               \
+        while (i < middle) {                                                   \
+            dst[k++] = src[i++];                                               \
+        }                                                                      \
+                                                                               \
+        while (j < last) {                                                     \
+            dst[k++] = src[j++];                                               \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    struct NAME
+
+/**< vector_int/vector_double/vector_str: defined in vector_typed.c */
+DECLARE_VECTOR(int, vector_int);
+DECLARE_VECTOR(double, vector_double);
+DECLARE_VECTOR(char_ptr, vector_str);
+
+#endif /* VECTOR_TYPED_H */
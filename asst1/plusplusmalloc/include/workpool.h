@@ -0,0 +1,88 @@
+/**
+ *  @file       workpool.h
+ *  @brief      Header file for a reusable work-stealing thread pool
+ *
+ *  @author     Gemuele Aludino
+ *  @date       17 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for bool
+ */
+#include "utils.h"
+
+#include <stdlib.h>
+
+/**
+ *  @typedef    workpool_t
+ *  @brief      Alias for (struct workpool)
+ *
+ *  All instances of (struct workpool) will be addressed as (workpool_t).
+ */
+typedef struct workpool workpool_t;
+
+/**
+ *  @typedef    workpool_task_fn
+ *  @brief      Task function -- called once per task index of a run
+ */
+typedef void (*workpool_task_fn)(void *arg, size_t task);
+
+/**
+ *      A workpool is a fixed set of worker threads, created once and reused --
+ *      workpool_run hands the pool count tasks, numbered [0, count),
+ *      and returns once every task has run (task(arg, i) for each i).
+ *
+ *      Tasks are dealt out in contiguous blocks, one block per worker.
+ *      A worker that runs dry steals from the other workers' blocks,
+ *      and the calling thread steals as well, rather than sleeping.
+ *      A task may end its run early with workpool_cancel -- tasks
+ *      not yet started are dropped, tasks already running finish.
+ *
+ *      One run at a time -- workpool_run is not reentrant,
+ *      and may not be called from within a task.
+ *
+ *      The pool's own memory comes from the system allocator,
+ *      not mymalloc -- its workers outlive any one container.
+ */
+
+/**< workpool: allocate and construct (nthreads workers, 0 for one per core) */
+workpool_t *workpool_new(size_t nthreads);
+
+/**< workpool: join workers, destruct and deallocate */
+void workpool_delete(workpool_t **pool);
+
+/**< workpool: run task(arg, i) for every i in [0, count) / drop unstarted tasks */
+void workpool_run(workpool_t *pool, size_t count, workpool_task_fn task, void *arg);
+void workpool_cancel(workpool_t *pool);
+
+/**< workpool: length functions */
+size_t workpool_size(workpool_t *pool);
+size_t workpool_cores(void);
+
+#endif /* WORKPOOL_H */
@@ -0,0 +1,644 @@
+/**
+ *  @file       bloom.c
+ *  @brief      Source file for probabilistic membership/frequency ADTs
+ *              (blocked Bloom filter, count-min sketch)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       17 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bloom.h"
+#include "utils.h"
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#define BLOOM_BLOCK_BITS        (BLOOM_BLOCK_SIZE * CHAR_BIT)
+#define BLOOM_DEFAULT_FPP       0.01
+
+/**< confining k bits to one block skews the load; pay for it in bits */
+#define BLOOM_BLOCK_OVERHEAD    1.1
+
+/**< second hash, derived from the typetable hash (Kirsch-Mitzenmacher) */
+#if ULONG_MAX > 0xffffffffUL
+#define BLOOM_SEED 0x9e3779b97f4a7c15UL
+#else
+#define BLOOM_SEED 0x9e3779b9UL
+#endif
+
+/**
+ *  @struct     bloom
+ *  @brief      Represents a blocked Bloom filter
+ *
+ *  Note that struct bloom is opaque.
+ */
+struct bloom {
+    unsigned char *blocks;      /**< nblocks * BLOOM_BLOCK_SIZE bytes of bits */
+    size_t nblocks;             /**< number of blocks */
+    size_t nhashes;             /**< bits set per element */
+    size_t count;               /**< number of insertions */
+
+    struct typetable *ttbl;     /**< hash function of elements */
+};
+
+/**
+ *  @struct     cmsketch
+ *  @brief      Represents a count-min sketch
+ *
+ *  Note that struct cmsketch is opaque.
+ */
+struct cmsketch {
+    unsigned long *counters;    /**< depth rows of width counters */
+    size_t width;               /**< counters per row, a power of two */
+    size_t depth;               /**< number of rows */
+    unsigned long total;        /**< sum of all counts added */
+
+    struct typetable *ttbl;     /**< hash function of elements */
+};
+
+static size_t bloom_mix(size_t x);
+static unsigned char *bloom_block(bloom *b, const void *valaddr, size_t *first, size_t *step);
+static size_t cmsketch_index(cmsketch *s, size_t row, size_t h1, size_t h2);
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to bloom,
+ *          sized for n elements at a false positive rate of fpp
+ *
+ *  @param[in]  ttbl    typetable for elements (hash is required)
+ *  @param[in]  n       expected number of elements
+ *  @param[in]  fpp     desired false positive rate, in (0, 1)
+ *
+ *  @return     pointer to bloom
+ */
+bloom *bloom_new(struct typetable *ttbl, size_t n, double fpp) {
+    bloom *b = NULL;
+    double bits = 0.0;
+    double hashes = 0.0;
+
+    massert_ptr(ttbl);
+
+    if (ttbl->hash == NULL) {
+        ERROR(__FILE__, "bloom requires a typetable with a hash function.");
+        return NULL;
+    }
+
+    n = n > 0 ? n : 1;
+    fpp = (fpp > 0.0 && fpp < 1.0) ? fpp : BLOOM_DEFAULT_FPP;
+
+    /* m = -n ln(p) / (ln 2)^2, k = (m / n) ln 2 */
+    bits = ceil(-((double)(n) * log(fpp)) / (log(2.0) * log(2.0)));
+    hashes = floor(((bits / (double)(n)) * log(2.0)) + 0.5);
+    bits *= BLOOM_BLOCK_OVERHEAD;
+
+    b = malloc(sizeof *b);
+    massert_malloc(b);
+
+    b->ttbl = ttbl;
+    b->count = 0;
+
+    b->nhashes = hashes < 1.0 ? 1 : hashes > BLOOM_MAX_HASHES ? BLOOM_MAX_HASHES : (size_t)(hashes);
+    b->nblocks = (size_t)(ceil(bits / BLOOM_BLOCK_BITS));
+    b->nblocks = b->nblocks > 0 ? b->nblocks : 1;
+
+    b->blocks = calloc(b->nblocks, BLOOM_BLOCK_SIZE);
+    massert_calloc(b->blocks);
+
+    return b;
+}
+
+/**
+ *  @brief  Deallocates the pointer b
+ *
+ *  @param[out] b   address of a pointer to bloom
+ */
+void bloom_delete(bloom **b) {
+    massert_container((*b));
+
+    free((*b)->blocks);
+    (*b)->blocks = NULL;
+
+    free((*b));
+    (*b) = NULL;
+}
+
+/**
+ *  @brief  Returns the number of insertions into b
+ *
+ *  @param[in]  b   pointer to bloom
+ *
+ *  @return     number of insertions (duplicates included)
+ */
+size_t bloom_size(bloom *b) {
+    massert_container(b);
+    return b->count;
+}
+
+/**
+ *  @brief  Returns the number of bits in b
+ *
+ *  @param[in]  b   pointer to bloom
+ *
+ *  @return     number of bits
+ */
+size_t bloom_bits(bloom *b) {
+    massert_container(b);
+    return b->nblocks * BLOOM_BLOCK_BITS;
+}
+
+/**
+ *  @brief  Returns the number of bits set per element
+ *
+ *  @param[in]  b   pointer to bloom
+ *
+ *  @return     number of hashes
+ */
+size_t bloom_hashes(bloom *b) {
+    massert_container(b);
+    return b->nhashes;
+}
+
+/**
+ *  @brief  Estimates b's current false positive rate
+ *
+ *  @param[in]  b   pointer to bloom
+ *
+ *  @return     (1 - e^(-kn/m))^k, for k hashes, n insertions, m bits
+ */
+double bloom_fpp(bloom *b) {
+    const double k = (double)(bloom_hashes(b));
+    const double n = (double)(bloom_size(b));
+    const double m = (double)(bloom_bits(b));
+
+    return pow(1.0 - exp(-(k * n) / m), k);
+}
+
+/**
+ *  @brief  Inserts valaddr into b
+ *
+ *  @param[in]  b           pointer to bloom
+ *  @param[in]  valaddr     address of an element
+ */
+void bloom_insert(bloom *b, const void *valaddr) {
+    unsigned char *block = NULL;
+    size_t first = 0;
+    size_t step = 0;
+    size_t bit = 0;
+    size_t i = 0;
+
+    massert_container(b);
+    massert_ptr(valaddr);
+
+    block = bloom_block(b, valaddr, &first, &step);
+
+    for (i = 0; i < b->nhashes; i++) {
+        bit = (first + (i * step)) % BLOOM_BLOCK_BITS;
+        block[bit / CHAR_BIT] |= (unsigned char)(1U << (bit % CHAR_BIT));
+    }
+
+    ++b->count;
+}
+
+/**
+ *  @brief  Determines if valaddr may have been inserted into b
+ *
+ *  @param[in]  b           pointer to bloom
+ *  @param[in]  valaddr     address of an element
+ *
+ *  @return     false if valaddr was definitely never inserted,
+ *              true if it possibly was
+ */
+bool bloom_contains(bloom *b, const void *valaddr) {
+    unsigned char *block = NULL;
+    size_t first = 0;
+    size_t step = 0;
+    size_t bit = 0;
+    size_t i = 0;
+
+    massert_container(b);
+    massert_ptr(valaddr);
+
+    block = bloom_block(b, valaddr, &first, &step);
+
+    for (i = 0; i < b->nhashes; i++) {
+        bit = (first + (i * step)) % BLOOM_BLOCK_BITS;
+
+        if ((block[bit / CHAR_BIT] & (1U << (bit % CHAR_BIT))) == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ *  @brief  Adds the elements of other into b (set union)
+ *
+ *  @param[in]  b       pointer to bloom
+ *  @param[in]  other   pointer to bloom, of the same size and typetable
+ */
+void bloom_merge(bloom *b, bloom *other) {
+    size_t i = 0;
+
+    massert_container(b);
+    massert_container(other);
+
+    if (b->nblocks != other->nblocks || b->nhashes != other->nhashes
+        || b->ttbl->hash != other->ttbl->hash) {
+        ERROR(__FILE__, "bloom filters must have matching sizes and hash functions.");
+        return;
+    }
+
+    for (i = 0; i < b->nblocks * BLOOM_BLOCK_SIZE; i++) {
+        b->blocks[i] |= other->blocks[i];
+    }
+
+    b->count += other->count;
+}
+
+/**
+ *  @brief  Removes all elements from b
+ *
+ *  @param[in]  b   pointer to bloom
+ */
+void bloom_clear(bloom *b) {
+    massert_container(b);
+
+    memset(b->blocks, 0, b->nblocks * BLOOM_BLOCK_SIZE);
+    b->count = 0;
+}
+
+/**
+ *  @brief  Prints a diagnostic of bloom to stdout
+ *
+ *  @param[in]  b   pointer to bloom
+ */
+void bloom_puts(bloom *b) {
+    bloom_fputs(b, stdout);
+}
+
+/**
+ *  @brief  Prints a diagnostic of bloom to file stream dest
+ *
+ *  @param[in]  b       pointer to bloom
+ *  @param[in]  dest    file stream (e.g stdout, stderr, a file)
+ */
+void bloom_fputs(bloom *b, FILE *dest) {
+    const char *link = "---------------------------";
+
+    massert_container(b);
+    massert_ptr(dest);
+
+    fprintf(dest, "\n%s\n%s\n%s\n", link, "Bloom Filter", link);
+    fprintf(dest, "%s\t\t%lu\n%s\t\t%lu\n%s\t\t%lu\n%s\t\t%lu\n%s\t\t%f\n%s\n",
+            "Insertions   ", bloom_size(b),
+            "Bits         ", bloom_bits(b),
+            "Blocks       ", b->nblocks,
+            "Hashes       ", bloom_hashes(b),
+            "Est. FPP     ", bloom_fpp(b),
+            link);
+}
+
+/**
+ *  @brief  Retrieves the typetable used by b
+ *
+ *  @param[in]  b   pointer to bloom
+ *
+ *  @return     pointer to typetable
+ */
+struct typetable *bloom_get_ttbl(bloom *b) {
+    massert_container(b);
+    return b->ttbl;
+}
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to cmsketch
+ *
+ *  @param[in]  ttbl        typetable for elements (hash is required)
+ *  @param[in]  epsilon     error bound (as a fraction of the total), in (0, 1)
+ *  @param[in]  delta       probability of exceeding the bound, in (0, 1)
+ *
+ *  @return     pointer to cmsketch
+ *
+ *  Rows are ceil(e / epsilon) counters wide (rounded up to a power of two),
+ *  and there are ceil(ln(1 / delta)) rows.
+ */
+cmsketch *cmsketch_new(struct typetable *ttbl, double epsilon, double delta) {
+    cmsketch *s = NULL;
+    size_t width = 0;
+
+    massert_ptr(ttbl);
+
+    if (ttbl->hash == NULL) {
+        ERROR(__FILE__, "cmsketch requires a typetable with a hash function.");
+        return NULL;
+    }
+
+    if (epsilon <= 0.0 || epsilon >= 1.0 || delta <= 0.0 || delta >= 1.0) {
+        ERROR(__FILE__, "epsilon and delta must be within (0, 1).");
+        return NULL;
+    }
+
+    s = malloc(sizeof *s);
+    massert_malloc(s);
+
+    width = (size_t)(ceil(exp(1.0) / epsilon));
+
+    for (s->width = 1; s->width < width; s->width *= 2) {
+        ;
+    }
+
+    s->depth = (size_t)(ceil(log(1.0 / delta)));
+    s->depth = s->depth > 0 ? s->depth : 1;
+
+    s->total = 0;
+    s->ttbl = ttbl;
+
+    s->counters = calloc(s->width * s->depth, sizeof *s->counters);
+    massert_calloc(s->counters);
+
+    return s;
+}
+
+/**
+ *  @brief  Deallocates the pointer s
+ *
+ *  @param[out] s   address of a pointer to cmsketch
+ */
+void cmsketch_delete(cmsketch **s) {
+    massert_container((*s));
+
+    free((*s)->counters);
+    (*s)->counters = NULL;
+
+    free((*s));
+    (*s) = NULL;
+}
+
+/**
+ *  @brief  Returns the sum of all counts in s
+ *
+ *  @param[in]  s   pointer to cmsketch
+ *
+ *  @return     total count
+ */
+unsigned long cmsketch_total(cmsketch *s) {
+    massert_container(s);
+    return s->total;
+}
+
+/**
+ *  @brief  Returns the number of counters per row of s
+ *
+ *  @param[in]  s   pointer to cmsketch
+ *
+ *  @return     width
+ */
+size_t cmsketch_width(cmsketch *s) {
+    massert_container(s);
+    return s->width;
+}
+
+/**
+ *  @brief  Returns the number of rows of s
+ *
+ *  @param[in]  s   pointer to cmsketch
+ *
+ *  @return     depth
+ */
+size_t cmsketch_depth(cmsketch *s) {
+    massert_container(s);
+    return s->depth;
+}
+
+/**
+ *  @brief  Adds count occurrences of valaddr to s
+ *
+ *  @param[in]  s           pointer to cmsketch
+ *  @param[in]  valaddr     address of an element
+ *  @param[in]  count       number of occurrences
+ */
+void cmsketch_add(cmsketch *s, const void *valaddr, unsigned long count) {
+    size_t h1 = 0;
+    size_t h2 = 0;
+    size_t i = 0;
+
+    massert_container(s);
+    massert_ptr(valaddr);
+
+    h1 = s->ttbl->hash(valaddr);
+    h2 = bloom_mix(h1 ^ BLOOM_SEED) | 1;
+
+    for (i = 0; i < s->depth; i++) {
+        s->counters[cmsketch_index(s, i, h1, h2)] += count;
+    }
+
+    s->total += count;
+}
+
+/**
+ *  @brief  Removes count occurrences of valaddr from s
+ *
+ *  @param[in]  s           pointer to cmsketch
+ *  @param[in]  valaddr     address of an element, previously added
+ *  @param[in]  count       number of occurrences
+ *
+ *  Removing occurrences that were never added
+ *  voids the guarantees of cmsketch_estimate.
+ */
+void cmsketch_remove(cmsketch *s, const void *valaddr, unsigned long count) {
+    unsigned long *counter = NULL;
+    size_t h1 = 0;
+    size_t h2 = 0;
+    size_t i = 0;
+
+    massert_container(s);
+    massert_ptr(valaddr);
+
+    h1 = s->ttbl->hash(valaddr);
+    h2 = bloom_mix(h1 ^ BLOOM_SEED) | 1;
+
+    for (i = 0; i < s->depth; i++) {
+        counter = &s->counters[cmsketch_index(s, i, h1, h2)];
+        (*counter) -= (*counter) < count ? (*counter) : count;
+    }
+
+    s->total -= s->total < count ? s->total : count;
+}
+
+/**
+ *  @brief  Estimates the number of occurrences of valaddr in s
+ *
+ *  @param[in]  s           pointer to cmsketch
+ *  @param[in]  valaddr     address of an element
+ *
+ *  @return     least counter among the rows -- never below the true count
+ */
+unsigned long cmsketch_estimate(cmsketch *s, const void *valaddr) {
+    unsigned long estimate = ULONG_MAX;
+    unsigned long counter = 0;
+    size_t h1 = 0;
+    size_t h2 = 0;
+    size_t i = 0;
+
+    massert_container(s);
+    massert_ptr(valaddr);
+
+    h1 = s->ttbl->hash(valaddr);
+    h2 = bloom_mix(h1 ^ BLOOM_SEED) | 1;
+
+    for (i = 0; i < s->depth && estimate > 0; i++) {
+        counter = s->counters[cmsketch_index(s, i, h1, h2)];
+        estimate = counter < estimate ? counter : estimate;
+    }
+
+    return estimate;
+}
+
+/**
+ *  @brief  Determines if valaddr may have been added to s
+ *
+ *  @param[in]  s           pointer to cmsketch
+ *  @param[in]  valaddr     address of an element
+ *
+ *  @return     false if valaddr is definitely absent, true if possibly present
+ */
+bool cmsketch_contains(cmsketch *s, const void *valaddr) {
+    return cmsketch_estimate(s, valaddr) > 0;
+}
+
+/**
+ *  @brief  Resets all counters of s
+ *
+ *  @param[in]  s   pointer to cmsketch
+ */
+void cmsketch_clear(cmsketch *s) {
+    massert_container(s);
+
+    memset(s->counters, 0, sizeof *s->counters * s->width * s->depth);
+    s->total = 0;
+}
+
+/**
+ *  @brief  Prints a diagnostic of cmsketch to stdout
+ *
+ *  @param[in]  s   pointer to cmsketch
+ */
+void cmsketch_puts(cmsketch *s) {
+    cmsketch_fputs(s, stdout);
+}
+
+/**
+ *  @brief  Prints a diagnostic of cmsketch to file stream dest
+ *
+ *  @param[in]  s       pointer to cmsketch
+ *  @param[in]  dest    file stream (e.g stdout, stderr, a file)
+ */
+void cmsketch_fputs(cmsketch *s, FILE *dest) {
+    const char *link = "---------------------------";
+
+    massert_container(s);
+    massert_ptr(dest);
+
+    fprintf(dest, "\n%s\n%s\n%s\n", link, "Count-Min Sketch", link);
+    fprintf(dest, "%s\t\t%lu\n%s\t\t%lu\n%s\t\t%lu\n%s\n",
+            "Total        ", cmsketch_total(s),
+            "Width        ", cmsketch_width(s),
+            "Depth        ", cmsketch_depth(s),
+            link);
+}
+
+/**
+ *  @brief  Retrieves the typetable used by s
+ *
+ *  @param[in]  s   pointer to cmsketch
+ *
+ *  @return     pointer to typetable
+ */
+struct typetable *cmsketch_get_ttbl(cmsketch *s) {
+    massert_container(s);
+    return s->ttbl;
+}
+
+/**
+ *  @brief  Finalizer (MurmurHash3 fmix), scrambles every bit of x
+ *
+ *  @param[in]  x   value to mix
+ *
+ *  @return     mixed value
+ */
+static size_t bloom_mix(size_t x) {
+    unsigned long h = (unsigned long)(x);
+
+#if ULONG_MAX > 0xffffffffUL
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdUL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53UL;
+    h ^= h >> 33;
+#else
+    h ^= h >> 16;
+    h *= 0x85ebca6bUL;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35UL;
+    h ^= h >> 16;
+#endif
+
+    return (size_t)(h);
+}
+
+/**
+ *  @brief  Selects valaddr's block, and the bit sequence within it
+ *
+ *  @param[in]  b           pointer to bloom
+ *  @param[in]  valaddr     address of an element
+ *  @param[out] first       first bit within the block
+ *  @param[out] step        stride between bits (odd, so k bits are distinct)
+ *
+ *  @return     address of the block
+ */
+static unsigned char *bloom_block(bloom *b, const void *valaddr, size_t *first, size_t *step) {
+    const size_t h1 = b->ttbl->hash(valaddr);
+    const size_t h2 = bloom_mix(h1 ^ BLOOM_SEED);
+
+    *(first) = h2 % BLOOM_BLOCK_BITS;
+    *(step) = ((h2 / BLOOM_BLOCK_BITS) % BLOOM_BLOCK_BITS) | 1;
+
+    return b->blocks + ((h1 % b->nblocks) * BLOOM_BLOCK_SIZE);
+}
+
+/**
+ *  @brief  Index of the counter for row, given an element's two hashes
+ *
+ *  @param[in]  s       pointer to cmsketch
+ *  @param[in]  row     row in [0, depth)
+ *  @param[in]  h1      typetable hash of the element
+ *  @param[in]  h2      second hash of the element (odd)
+ *
+ *  @return     index into s->counters
+ */
+static size_t cmsketch_index(cmsketch *s, size_t row, size_t h1, size_t h2) {
+    return (row * s->width) + ((h1 + (row * h2)) & (s->width - 1));
+}
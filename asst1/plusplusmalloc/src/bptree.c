@@ -0,0 +1,1497 @@
+/**
+ *  @file       bptree.c
+ *  @brief      Source file for an ordered map/set ADT (B+tree)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       07 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bptree.h"
+#include "iterator.h"
+#include "vector.h"
+#include "utils.h"
+
+#include <assert.h>
+#include <string.h>
+
+/**< rounds N up to a multiple of the strictest alignment for key/value */
+#define BPTREE_ALIGN(N)     ((((N) + sizeof(double) - 1) / sizeof(double)) * sizeof(double))
+
+/**< smallest node capacity (in keys) -- nodes grow past node_size if needed */
+#define BPTREE_MIN_CAPACITY 3
+
+/**< addresses of a node's keys, values (leaves), and children (internal) */
+#define KEYS(NODE)          ((char *)(NODE) + BPTREE_ALIGN(sizeof(bpnode)))
+#define KEY(T, NODE, I)     (KEYS(NODE) + ((I) * (T)->key_ttbl->width))
+#define VAL(T, NODE, I)     ((char *)(NODE) + (T)->val_offset + ((I) * (T)->val_ttbl->width))
+#define CHILDREN(T, NODE)   ((bpnode **)((char *)(NODE) + (T)->child_offset))
+
+typedef struct bpnode bpnode;
+
+/**
+ *  @struct     bpnode
+ *  @brief      Header of a B+tree node
+ *
+ *  A node is a single block of bptree->node_size bytes:
+ *  the header, then up to (capacity + 1) keys,
+ *  then up to (capacity + 1) values (leaf) or (capacity + 2) children
+ *  (internal). The extra slot holds the overflow key just before a split.
+ */
+struct bpnode {
+    bptree *owner;              /**< tree that owns this node (for iterators) */
+    bpnode *prev;               /**< previous leaf (leaves only) */
+    bpnode *next;               /**< next leaf (leaves only) */
+    size_t count;               /**< number of keys */
+    bool leaf;                  /**< true if leaf, false if internal */
+};
+
+/**
+ *  @struct     bptree
+ *  @brief      Represents an ordered map/set ADT
+ *
+ *  Note that struct bptree and struct bpnode are opaque.
+ */
+struct bptree {
+    bpnode *root;               /**< root node (a leaf when height is 0) */
+    size_t size;                /**< number of keys */
+    int height;                 /**< number of internal levels */
+
+    struct typetable *key_ttbl; /**< key width, copy, dtor, compare, print */
+    struct typetable *val_ttbl; /**< value width, copy, dtor, print -- or NULL */
+
+    size_t node_size;           /**< bytes per node */
+    size_t leaf_capacity;       /**< max keys per leaf */
+    size_t inner_capacity;      /**< max keys per internal node */
+    size_t val_offset;          /**< offset of a leaf's values */
+    size_t child_offset;        /**< offset of an internal node's children */
+
+    void *separator;            /**< scratch key, carried up by a split */
+};
+
+static bptree *bptree_allocate(void);
+static void bptree_init(bptree *t, struct typetable *key_ttbl,
+                        struct typetable *val_ttbl, size_t node_size);
+static void bptree_deinit(bptree *t);
+
+static bpnode *bpnode_new(bptree *t, bool leaf);
+static void bpnode_delete(bptree *t, bpnode *n);
+
+static void bpnode_assign(void *dst, const void *src, struct typetable *ttbl);
+static void bpnode_destroy(void *addr, struct typetable *ttbl);
+
+static size_t bpnode_search(bptree *t, bpnode *n, const void *key, bool upper);
+static bpnode *bpnode_leaf(bptree *t, const void *key, bpnode **path, size_t *index);
+static bpnode *bpnode_leftmost(bptree *t);
+static bpnode *bpnode_rightmost(bptree *t);
+
+static void bpnode_split(bptree *t, bpnode *n, bpnode **path, size_t *index, int depth);
+static void bpnode_remove(bptree *t, bpnode *n, bpnode **path, size_t *index, int depth);
+
+static void bpnode_fputs(bptree *t, bpnode *n, FILE *dest, int depth);
+
+static iterator bpti_begin(void *arg);
+static iterator bpti_end(void *arg);
+
+static iterator bpti_next(iterator it);
+static iterator bpti_next_n(iterator it, int n);
+
+static iterator bpti_prev(iterator it);
+static iterator bpti_prev_n(iterator it, int n);
+
+static int bpti_distance(iterator *first, iterator *last);
+
+static iterator *bpti_advance(iterator *it, int n);
+static iterator *bpti_incr(iterator *it);
+static iterator *bpti_decr(iterator *it);
+
+static void *bpti_curr(iterator it);
+static void *bpti_start(iterator it);
+static void *bpti_finish(iterator it);
+
+static bool bpti_has_next(iterator it);
+static bool bpti_has_prev(iterator it);
+
+static struct typetable *bpti_get_ttbl(void *arg);
+
+struct iterator_table itbl_bptree = {
+    bpti_begin,
+    bpti_end,
+    bpti_next,
+    bpti_next_n,
+    bpti_prev,
+    bpti_prev_n,
+    bpti_advance,
+    bpti_incr,
+    bpti_decr,
+    bpti_curr,
+    bpti_start,
+    bpti_finish,
+    bpti_distance,
+    bpti_has_next,
+    bpti_has_prev,
+    bpti_get_ttbl
+};
+
+struct iterator_table *_bptree_iterator_ = &itbl_bptree;
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to bptree
+ *
+ *  @param[in]  key_ttbl    typetable for keys (compare is required)
+ *  @param[in]  val_ttbl    typetable for values, or NULL for a set
+ *
+ *  @return     pointer to bptree, with BPTREE_NODE_SIZE byte nodes
+ */
+bptree *bptree_new(struct typetable *key_ttbl, struct typetable *val_ttbl) {
+    return bptree_newsz(key_ttbl, val_ttbl, BPTREE_NODE_SIZE);
+}
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to bptree
+ *
+ *  @param[in]  key_ttbl    typetable for keys (compare is required)
+ *  @param[in]  val_ttbl    typetable for values, or NULL for a set
+ *  @param[in]  node_size   bytes per node (e.g. a multiple of a cache line)
+ *
+ *  @return     pointer to bptree
+ */
+bptree *bptree_newsz(struct typetable *key_ttbl, struct typetable *val_ttbl, size_t node_size) {
+    bptree *t = bptree_allocate();                  /* allocate */
+    bptree_init(t, key_ttbl, val_ttbl, node_size);  /* construct */
+    return t;                                       /* return */
+}
+
+/**
+ *  @brief  Allocates and bulk loads a bptree from a sorted vector
+ *
+ *  @param[in]  keys    vector of keys, sorted ascending, without duplicates
+ *  @param[in]  values  vector of values (parallel to keys), or NULL for a set
+ *
+ *  @return     pointer to bptree
+ */
+bptree *bptree_newsorted(vector *keys, vector *values) {
+    massert_container(keys);
+
+    if (values && v_size(values) != v_size(keys)) {
+        ERROR(__FILE__, "keys and values must have the same length.");
+        return NULL;
+    }
+
+    return bptree_newsortedptr(v_get_ttbl(keys), values ? v_get_ttbl(values) : NULL,
+                               *(char **)(v_data(keys)),
+                               values ? *(char **)(v_data(values)) : NULL,
+                               v_size(keys));
+}
+
+/**
+ *  @brief  Allocates and bulk loads a bptree from a sorted array, in O(n)
+ *
+ *  @param[in]  key_ttbl    typetable for keys
+ *  @param[in]  val_ttbl    typetable for values, or NULL for a set
+ *  @param[in]  keys        base address of n keys, sorted ascending,
+ *                          without duplicates
+ *  @param[in]  values      base address of n values, or NULL
+ *  @param[in]  n           number of keys
+ *
+ *  @return     pointer to bptree
+ *
+ *  The leaves are filled left to right (keys spread evenly, so that every
+ *  leaf is nearly full), then each internal level is built over the one
+ *  below it, until a single root remains.
+ */
+bptree *bptree_newsortedptr(struct typetable *key_ttbl, struct typetable *val_ttbl,
+                            const void *keys, const void *values, size_t n) {
+    bptree *t = NULL;
+    bpnode **nodes = NULL;
+    const void **mins = NULL;
+    bpnode *node = NULL;
+    bpnode *prev = NULL;
+
+    size_t count = 0;
+    size_t groups = 0;
+    size_t group = 0;
+    size_t length = 0;
+    size_t next = 0;
+    size_t j = 0;
+
+    t = bptree_new(key_ttbl, val_ttbl);
+
+    if (n == 0) {
+        return t;
+    }
+
+    massert_ptr(keys);
+
+    /* nodes[i] is a node of the level being built, mins[i] its smallest key */
+    count = (n + t->leaf_capacity - 1) / t->leaf_capacity;
+
+    nodes = malloc(sizeof *nodes * count);
+    massert_malloc(nodes);
+
+    mins = malloc(sizeof *mins * count);
+    massert_malloc(mins);
+
+    bpnode_delete(t, t->root);
+
+    for (group = 0, next = 0; group < count; group++) {
+        length = (n / count) + (group < n % count ? 1 : 0);
+
+        node = bpnode_new(t, true);
+
+        for (j = 0; j < length; j++, next++) {
+            bpnode_assign(KEY(t, node, j),
+                          (char *)(keys) + (next * t->key_ttbl->width), t->key_ttbl);
+
+            if (t->val_ttbl && values) {
+                bpnode_assign(VAL(t, node, j),
+                              (char *)(values) + (next * t->val_ttbl->width), t->val_ttbl);
+            } else if (t->val_ttbl) {
+                memset(VAL(t, node, j), 0, t->val_ttbl->width);
+            }
+        }
+
+        node->count = length;
+        node->prev = prev;
+
+        if (prev) {
+            prev->next = node;
+        }
+
+        prev = node;
+
+        nodes[group] = node;
+        mins[group] = KEYS(node);
+    }
+
+    while (count > 1) {
+        /* each internal node adopts up to (inner_capacity + 1) children */
+        groups = (count + t->inner_capacity) / (t->inner_capacity + 1);
+
+        for (group = 0, next = 0; group < groups; group++) {
+            length = (count / groups) + (group < count % groups ? 1 : 0);
+
+            node = bpnode_new(t, false);
+
+            for (j = 0; j < length; j++) {
+                CHILDREN(t, node)[j] = nodes[next + j];
+
+                if (j > 0) {
+                    /* separator j - 1 is the smallest key of child j */
+                    bpnode_assign(KEY(t, node, j - 1), mins[next + j], t->key_ttbl);
+                }
+            }
+
+            node->count = length - 1;
+
+            /* group <= next, so the level is rewritten in place */
+            mins[group] = mins[next];
+            nodes[group] = node;
+
+            next += length;
+        }
+
+        count = groups;
+        ++t->height;
+    }
+
+    t->root = nodes[0];
+    t->size = n;
+
+    free(mins);
+    free(nodes);
+
+    return t;
+}
+
+/**
+ *  @brief  Calls bptree_deinit (bptree's destructor)
+ *          and deallocates the pointer t
+ *
+ *  @param[out] t   address of a pointer to bptree
+ */
+void bptree_delete(bptree **t) {
+    massert_container((*t));
+
+    bptree_deinit((*t));
+
+    free((*t));
+    (*t) = NULL;
+}
+
+/**
+ *  @brief  Returns an iterator at the smallest key of t
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     iterator that refers to t
+ */
+iterator bptree_begin(bptree *t) {
+    massert_container(t);
+    return bpti_begin(t->root);
+}
+
+/**
+ *  @brief  Returns an iterator one past the largest key of t
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     iterator that refers to t
+ */
+iterator bptree_end(bptree *t) {
+    massert_container(t);
+    return bpti_end(t->root);
+}
+
+/**
+ *  @brief  Returns an iterator at the first key not less than key
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     iterator that refers to t (end iterator if no such key)
+ */
+iterator bptree_lower_bound(bptree *t, const void *key) {
+    iterator it;
+    bpnode *leaf = NULL;
+    size_t i = 0;
+
+    massert_container(t);
+    massert_ptr(key);
+
+    leaf = bpnode_leaf(t, key, NULL, NULL);
+    i = bpnode_search(t, leaf, key, false);
+
+    if (i == leaf->count && leaf->next) {
+        /* every key of this leaf is smaller -- the bound begins the next */
+        leaf = leaf->next;
+        i = 0;
+    }
+
+    it.itbl = _bptree_iterator_;
+    it.container = leaf;
+    it.curr = KEY(t, leaf, i);
+
+    return it;
+}
+
+/**
+ *  @brief  Returns an iterator at the first key greater than key
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     iterator that refers to t (end iterator if no such key)
+ */
+iterator bptree_upper_bound(bptree *t, const void *key) {
+    iterator it;
+    bpnode *leaf = NULL;
+    size_t i = 0;
+
+    massert_container(t);
+    massert_ptr(key);
+
+    leaf = bpnode_leaf(t, key, NULL, NULL);
+    i = bpnode_search(t, leaf, key, true);
+
+    if (i == leaf->count && leaf->next) {
+        leaf = leaf->next;
+        i = 0;
+    }
+
+    it.itbl = _bptree_iterator_;
+    it.container = leaf;
+    it.curr = KEY(t, leaf, i);
+
+    return it;
+}
+
+/**
+ *  @brief  Retrieves the address of the value at it's current position
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *
+ *  @return     address of the value, or NULL for a set/the end iterator
+ */
+void *bptree_itvalue(iterator it) {
+    bpnode *leaf = (bpnode *)(it.container);
+    bptree *t = leaf->owner;
+    size_t i = 0;
+
+    if (t->val_ttbl == NULL) {
+        return NULL;
+    }
+
+    i = ((char *)(it.curr) - KEYS(leaf)) / t->key_ttbl->width;
+    return i < leaf->count ? VAL(t, leaf, i) : NULL;
+}
+
+/**
+ *  @brief  Returns the number of keys in t
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     number of keys
+ */
+size_t bptree_size(bptree *t) {
+    massert_container(t);
+    return t->size;
+}
+
+/**
+ *  @brief  Returns the height of t (0 if the root is a leaf)
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     number of internal levels
+ */
+int bptree_height(bptree *t) {
+    massert_container(t);
+    return t->height;
+}
+
+/**
+ *  @brief  Determines if t has no keys
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     true if empty, false otherwise
+ */
+bool bptree_empty(bptree *t) {
+    massert_container(t);
+    return t->size == 0;
+}
+
+/**
+ *  @brief  Retrieves the address of t's smallest key
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     address of the smallest key, NULL if empty
+ */
+void *bptree_min(bptree *t) {
+    massert_container(t);
+    return t->size > 0 ? KEYS(bpnode_leftmost(t)) : NULL;
+}
+
+/**
+ *  @brief  Retrieves the address of t's largest key
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     address of the largest key, NULL if empty
+ */
+void *bptree_max(bptree *t) {
+    bpnode *leaf = NULL;
+
+    massert_container(t);
+
+    if (t->size == 0) {
+        return NULL;
+    }
+
+    leaf = bpnode_rightmost(t);
+    return KEY(t, leaf, leaf->count - 1);
+}
+
+/**
+ *  @brief  Searches t for key
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     address of key's value (map), or of the stored key (set);
+ *              NULL if key is not found
+ */
+void *bptree_find(bptree *t, const void *key) {
+    bpnode *leaf = NULL;
+    size_t i = 0;
+
+    massert_container(t);
+    massert_ptr(key);
+
+    leaf = bpnode_leaf(t, key, NULL, NULL);
+    i = bpnode_search(t, leaf, key, false);
+
+    if (i == leaf->count || t->key_ttbl->compare(key, KEY(t, leaf, i)) != 0) {
+        return NULL;
+    }
+
+    return t->val_ttbl ? VAL(t, leaf, i) : KEY(t, leaf, i);
+}
+
+/**
+ *  @brief  Determines if t contains key
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     true if found, false otherwise
+ */
+bool bptree_contains(bptree *t, const void *key) {
+    return bptree_find(t, key) != NULL;
+}
+
+/**
+ *  @brief  Inserts key (and value) into t
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  key     address of a key
+ *  @param[in]  value   address of a value, or NULL (for a set)
+ *
+ *  If key is already present, its value is replaced.
+ */
+void bptree_insert(bptree *t, const void *key, const void *value) {
+    bpnode *path[BPTREE_MAX_HEIGHT];
+    size_t index[BPTREE_MAX_HEIGHT];
+    bpnode *leaf = NULL;
+    size_t kwidth = 0;
+    size_t vwidth = 0;
+    size_t i = 0;
+
+    massert_container(t);
+    massert_ptr(key);
+
+    kwidth = t->key_ttbl->width;
+    vwidth = t->val_ttbl ? t->val_ttbl->width : 0;
+
+    leaf = bpnode_leaf(t, key, path, index);
+    i = bpnode_search(t, leaf, key, false);
+
+    if (i < leaf->count && t->key_ttbl->compare(key, KEY(t, leaf, i)) == 0) {
+        /* key exists (no duplicates allowed) -- value is replaced */
+        if (t->val_ttbl && value) {
+            bpnode_destroy(VAL(t, leaf, i), t->val_ttbl);
+            bpnode_assign(VAL(t, leaf, i), value, t->val_ttbl);
+        }
+
+        return;
+    }
+
+    /* open slot i -- there is always room for one more (the overflow slot) */
+    memmove(KEY(t, leaf, i + 1), KEY(t, leaf, i), (leaf->count - i) * kwidth);
+    bpnode_assign(KEY(t, leaf, i), key, t->key_ttbl);
+
+    if (t->val_ttbl) {
+        memmove(VAL(t, leaf, i + 1), VAL(t, leaf, i), (leaf->count - i) * vwidth);
+
+        if (value) {
+            bpnode_assign(VAL(t, leaf, i), value, t->val_ttbl);
+        } else {
+            memset(VAL(t, leaf, i), 0, vwidth);
+        }
+    }
+
+    ++leaf->count;
+    ++t->size;
+
+    if (leaf->count > t->leaf_capacity) {
+        bpnode_split(t, leaf, path, index, t->height);
+    }
+}
+
+/**
+ *  @brief  Removes key (and its value) from t
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  key     address of a key
+ *
+ *  No-op if key is not found.
+ */
+void bptree_erase(bptree *t, const void *key) {
+    bpnode *path[BPTREE_MAX_HEIGHT];
+    size_t index[BPTREE_MAX_HEIGHT];
+    bpnode *leaf = NULL;
+    size_t kwidth = 0;
+    size_t vwidth = 0;
+    size_t i = 0;
+
+    massert_container(t);
+    massert_ptr(key);
+
+    kwidth = t->key_ttbl->width;
+    vwidth = t->val_ttbl ? t->val_ttbl->width : 0;
+
+    leaf = bpnode_leaf(t, key, path, index);
+    i = bpnode_search(t, leaf, key, false);
+
+    if (i == leaf->count || t->key_ttbl->compare(key, KEY(t, leaf, i)) != 0) {
+        return;
+    }
+
+    bpnode_destroy(KEY(t, leaf, i), t->key_ttbl);
+    memmove(KEY(t, leaf, i), KEY(t, leaf, i + 1), (leaf->count - i - 1) * kwidth);
+
+    if (t->val_ttbl) {
+        bpnode_destroy(VAL(t, leaf, i), t->val_ttbl);
+        memmove(VAL(t, leaf, i), VAL(t, leaf, i + 1), (leaf->count - i - 1) * vwidth);
+    }
+
+    --leaf->count;
+    --t->size;
+
+    /**
+     *  Separators equal to the erased key remain valid --
+     *  they still divide the keys of their neighboring subtrees.
+     */
+    if (leaf->count == 0 && leaf != t->root) {
+        bpnode_remove(t, leaf, path, index, t->height);
+    }
+}
+
+/**
+ *  @brief  Removes all keys (and values) from t
+ *
+ *  @param[in]  t   pointer to bptree
+ */
+void bptree_clear(bptree *t) {
+    massert_container(t);
+
+    bpnode_delete(t, t->root);
+
+    t->root = bpnode_new(t, true);
+    t->height = 0;
+    t->size = 0;
+}
+
+/**
+ *  @brief  Prints a diagnostic of bptree to stdout
+ *
+ *  @param[in]  t   pointer to bptree
+ */
+void bptree_puts(bptree *t) {
+    bptree_fputs(t, stdout);
+}
+
+/**
+ *  @brief  Prints a diagnostic of bptree to file stream dest
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  dest    file stream (e.g stdout, stderr, a file)
+ */
+void bptree_fputs(bptree *t, FILE *dest) {
+    const char *link = "---------------------------";
+
+    massert_container(t);
+    massert_ptr(dest);
+
+    if (t->size == 0) {
+        fprintf(dest, "\n{ empty tree }\n\n");
+        return;
+    }
+
+    fprintf(dest, "\n%s\n%s\n%s\n\n", link, "B+Tree Elements", link);
+    bpnode_fputs(t, t->root, dest, 0);
+
+    fprintf(dest, "\n%s\n%s\t\t%lu\n%s\t\t%d\n%s\t\t%lu\n%s\t\t%lu\n%s\t\t%lu\n%s\n", link,
+            "Size         ", t->size,
+            "Height       ", t->height,
+            "Node size    ", t->node_size,
+            "Leaf capacity", t->leaf_capacity,
+            "Inner capacity", t->inner_capacity,
+            link);
+}
+
+/**
+ *  @brief  Retrieves the key typetable used by t
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     pointer to typetable
+ */
+struct typetable *bptree_get_key_ttbl(bptree *t) {
+    massert_container(t);
+    return t->key_ttbl;
+}
+
+/**
+ *  @brief  Retrieves the value typetable used by t
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     pointer to typetable, NULL if t is a set
+ */
+struct typetable *bptree_get_val_ttbl(bptree *t) {
+    massert_container(t);
+    return t->val_ttbl;
+}
+
+/**
+ *  @brief  Calls malloc to allocate memory for a pointer to bptree
+ *
+ *  @return     pointer to bptree
+ */
+static bptree *bptree_allocate(void) {
+    bptree *t = NULL;
+    t = malloc(sizeof *t);
+    return t;
+}
+
+/**
+ *  @brief  "Constructor" function, initializes bptree
+ *
+ *  @param[in]  t           pointer to bptree
+ *  @param[in]  key_ttbl    typetable for keys
+ *  @param[in]  val_ttbl    typetable for values, or NULL
+ *  @param[in]  node_size   requested bytes per node
+ *
+ *  Capacities are the largest that fit node_size, counting the overflow
+ *  slot; if fewer than BPTREE_MIN_CAPACITY keys fit, the node grows.
+ */
+static void bptree_init(bptree *t, struct typetable *key_ttbl,
+                        struct typetable *val_ttbl, size_t node_size) {
+    size_t header = BPTREE_ALIGN(sizeof(bpnode));
+    size_t kwidth = 0;
+    size_t vwidth = 0;
+    size_t leaf_size = 0;
+    size_t inner_size = 0;
+
+    massert_container(t);
+
+    t->key_ttbl = key_ttbl ? key_ttbl : _void_ptr_;
+    t->val_ttbl = val_ttbl;
+
+    if (t->key_ttbl->compare == NULL) {
+        ERROR(__FILE__, "bptree requires a key typetable with a compare function.");
+    }
+
+    kwidth = t->key_ttbl->width;
+    vwidth = t->val_ttbl ? t->val_ttbl->width : 0;
+
+    /* leaf: (capacity + 1) keys and (capacity + 1) values */
+    t->leaf_capacity = node_size > header + (2 * sizeof(double))
+                     ? ((node_size - header - (2 * sizeof(double))) / (kwidth + vwidth)) - 1 : 0;
+
+    /* internal: (capacity + 1) keys and (capacity + 2) children */
+    t->inner_capacity = node_size > header + (3 * sizeof(bpnode *)) + sizeof(double)
+                      ? ((node_size - header - (3 * sizeof(bpnode *)) - sizeof(double))
+                         / (kwidth + sizeof(bpnode *))) - 1 : 0;
+
+    if (t->leaf_capacity < BPTREE_MIN_CAPACITY || t->leaf_capacity > node_size) {
+        t->leaf_capacity = BPTREE_MIN_CAPACITY;
+    }
+
+    if (t->inner_capacity < BPTREE_MIN_CAPACITY || t->inner_capacity > node_size) {
+        t->inner_capacity = BPTREE_MIN_CAPACITY;
+    }
+
+    t->val_offset = header + BPTREE_ALIGN((t->leaf_capacity + 1) * kwidth);
+    t->child_offset = header + BPTREE_ALIGN((t->inner_capacity + 1) * kwidth);
+
+    leaf_size = t->val_offset + ((t->leaf_capacity + 1) * vwidth);
+    inner_size = t->child_offset + ((t->inner_capacity + 2) * sizeof(bpnode *));
+
+    t->node_size = node_size;
+    t->node_size = leaf_size > t->node_size ? leaf_size : t->node_size;
+    t->node_size = inner_size > t->node_size ? inner_size : t->node_size;
+
+    t->separator = malloc(kwidth);
+    massert_malloc(t->separator);
+
+    t->size = 0;
+    t->height = 0;
+    t->root = bpnode_new(t, true);
+}
+
+/**
+ *  @brief  "Destructor" function, deinitializes bptree
+ *
+ *  @param[in]  t   pointer to bptree
+ */
+static void bptree_deinit(bptree *t) {
+    if (t == NULL) {
+        return;
+    }
+
+    bpnode_delete(t, t->root);
+    t->root = NULL;
+
+    free(t->separator);
+    t->separator = NULL;
+
+    t->size = 0;
+    t->height = 0;
+}
+
+/**
+ *  @brief  Allocates an empty node
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  leaf    true for a leaf, false for an internal node
+ *
+ *  @return     pointer to bpnode
+ */
+static bpnode *bpnode_new(bptree *t, bool leaf) {
+    bpnode *n = malloc(t->node_size);
+    massert_malloc(n);
+
+    n->owner = t;
+    n->prev = NULL;
+    n->next = NULL;
+    n->count = 0;
+    n->leaf = leaf;
+
+    return n;
+}
+
+/**
+ *  @brief  Destroys the keys/values of the subtree rooted at n, and frees it
+ *
+ *  @param[in]  t   pointer to bptree
+ *  @param[in]  n   root of a subtree
+ */
+static void bpnode_delete(bptree *t, bpnode *n) {
+    size_t i = 0;
+
+    if (n->leaf == false) {
+        for (i = 0; i <= n->count; i++) {
+            bpnode_delete(t, CHILDREN(t, n)[i]);
+        }
+    }
+
+    for (i = 0; i < n->count; i++) {
+        bpnode_destroy(KEY(t, n, i), t->key_ttbl);
+
+        if (n->leaf && t->val_ttbl) {
+            bpnode_destroy(VAL(t, n, i), t->val_ttbl);
+        }
+    }
+
+    free(n);
+}
+
+/**
+ *  @brief  Copies src into dst, as per ttbl
+ *
+ *  @param[out] dst     address of a key/value within a node
+ *  @param[in]  src     address of a key/value
+ *  @param[in]  ttbl    typetable of the key/value
+ */
+static void bpnode_assign(void *dst, const void *src, struct typetable *ttbl) {
+    if (ttbl->copy) {
+        /* if copy fn defined in ttbl, deep copy */
+        ttbl->copy(dst, src);
+    } else {
+        /* if no copy defined in ttbl, shallow copy */
+        memcpy(dst, src, ttbl->width);
+    }
+}
+
+/**
+ *  @brief  Destroys the key/value at addr, as per ttbl
+ *
+ *  @param[in]  addr    address of a key/value within a node
+ *  @param[in]  ttbl    typetable of the key/value
+ */
+static void bpnode_destroy(void *addr, struct typetable *ttbl) {
+    if (ttbl->dtor) {
+        ttbl->dtor(addr);
+    }
+}
+
+/**
+ *  @brief  Binary search of n's keys
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  n       node to search
+ *  @param[in]  key     address of a key
+ *  @param[in]  upper   false for the first key >= key,
+ *                      true for the first key > key
+ *
+ *  @return     index of that key (n->count if there is none)
+ */
+static size_t bpnode_search(bptree *t, bpnode *n, const void *key, bool upper) {
+    compare_fn compare = t->key_ttbl->compare;
+    size_t kwidth = t->key_ttbl->width;
+    char *keys = KEYS(n);
+    size_t lo = 0;
+    size_t hi = n->count;
+    size_t mid = 0;
+    int delta = 0;
+
+    while (lo < hi) {
+        mid = lo + ((hi - lo) / 2);
+        delta = compare(keys + (mid * kwidth), key);
+
+        if (delta < 0 || (upper && delta == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ *  @brief  Descends from the root to the leaf where key belongs
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  key     address of a key
+ *  @param[out] path    internal nodes visited, root first (or NULL)
+ *  @param[out] index   child index taken at each of path (or NULL)
+ *
+ *  @return     pointer to leaf
+ *
+ *  Separator i is the smallest key of child (i + 1) when it was created,
+ *  so keys equal to a separator are found to its right.
+ */
+static bpnode *bpnode_leaf(bptree *t, const void *key, bpnode **path, size_t *index) {
+    bpnode *n = t->root;
+    size_t i = 0;
+    int depth = 0;
+
+    while (n->leaf == false) {
+        i = bpnode_search(t, n, key, true);
+
+        if (path) {
+            path[depth] = n;
+            index[depth] = i;
+        }
+
+        n = CHILDREN(t, n)[i];
+        ++depth;
+    }
+
+    return n;
+}
+
+/**
+ *  @brief  Finds the first leaf of t
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     pointer to leaf
+ */
+static bpnode *bpnode_leftmost(bptree *t) {
+    bpnode *n = t->root;
+
+    while (n->leaf == false) {
+        n = CHILDREN(t, n)[0];
+    }
+
+    return n;
+}
+
+/**
+ *  @brief  Finds the last leaf of t
+ *
+ *  @param[in]  t   pointer to bptree
+ *
+ *  @return     pointer to leaf
+ */
+static bpnode *bpnode_rightmost(bptree *t) {
+    bpnode *n = t->root;
+
+    while (n->leaf == false) {
+        n = CHILDREN(t, n)[n->count];
+    }
+
+    return n;
+}
+
+/**
+ *  @brief  Splits an overflowing node, and inserts the separator
+ *          into its parent -- splitting ancestors as needed
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  n       node holding (capacity + 1) keys
+ *  @param[in]  path    ancestors of n, root first
+ *  @param[in]  index   child index taken at each ancestor
+ *  @param[in]  depth   number of ancestors of n
+ */
+static void bpnode_split(bptree *t, bpnode *n, bpnode **path, size_t *index, int depth) {
+    size_t kwidth = t->key_ttbl->width;
+    bpnode *right = NULL;
+    bpnode *parent = NULL;
+    size_t mid = 0;
+    size_t i = 0;
+
+    while (n->count > (n->leaf ? t->leaf_capacity : t->inner_capacity)) {
+        mid = n->count / 2;
+        right = bpnode_new(t, n->leaf);
+
+        if (n->leaf) {
+            /* right takes keys[mid, count); a copy of its first key moves up */
+            right->count = n->count - mid;
+            memcpy(KEYS(right), KEY(t, n, mid), right->count * kwidth);
+
+            if (t->val_ttbl) {
+                memcpy(VAL(t, right, 0), VAL(t, n, mid), right->count * t->val_ttbl->width);
+            }
+
+            bpnode_assign(t->separator, KEYS(right), t->key_ttbl);
+
+            right->prev = n;
+            right->next = n->next;
+
+            if (n->next) {
+                n->next->prev = right;
+            }
+
+            n->next = right;
+        } else {
+            /* right takes keys(mid, count); keys[mid] itself moves up */
+            right->count = n->count - mid - 1;
+            memcpy(KEYS(right), KEY(t, n, mid + 1), right->count * kwidth);
+            memcpy(CHILDREN(t, right), CHILDREN(t, n) + mid + 1,
+                   (right->count + 1) * sizeof(bpnode *));
+
+            memcpy(t->separator, KEY(t, n, mid), kwidth);
+        }
+
+        n->count = mid;
+
+        if (depth == 0) {
+            /* n was the root -- the tree grows by one level */
+            parent = bpnode_new(t, false);
+
+            memcpy(KEYS(parent), t->separator, kwidth);
+            CHILDREN(t, parent)[0] = n;
+            CHILDREN(t, parent)[1] = right;
+            parent->count = 1;
+
+            t->root = parent;
+            ++t->height;
+            return;
+        }
+
+        --depth;
+        parent = path[depth];
+        i = index[depth];
+
+        /* separator i goes between child i (n) and child (i + 1) (right) */
+        memmove(KEY(t, parent, i + 1), KEY(t, parent, i), (parent->count - i) * kwidth);
+        memcpy(KEY(t, parent, i), t->separator, kwidth);
+
+        memmove(CHILDREN(t, parent) + i + 2, CHILDREN(t, parent) + i + 1,
+                (parent->count - i) * sizeof(bpnode *));
+        CHILDREN(t, parent)[i + 1] = right;
+
+        ++parent->count;
+        n = parent;
+    }
+}
+
+/**
+ *  @brief  Unlinks and frees an empty node, removing it from its parent --
+ *          removing ancestors left without children, as needed
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  n       empty leaf (not the root)
+ *  @param[in]  path    ancestors of n, root first
+ *  @param[in]  index   child index taken at each ancestor
+ *  @param[in]  depth   number of ancestors of n
+ */
+static void bpnode_remove(bptree *t, bpnode *n, bpnode **path, size_t *index, int depth) {
+    size_t kwidth = t->key_ttbl->width;
+    bpnode *parent = NULL;
+    size_t i = 0;
+    size_t k = 0;
+
+    if (n->prev) {
+        n->prev->next = n->next;
+    }
+
+    if (n->next) {
+        n->next->prev = n->prev;
+    }
+
+    free(n);
+
+    while (depth > 0) {
+        --depth;
+        parent = path[depth];
+        i = index[depth];
+
+        if (parent->count == 0) {
+            /* parent's only child is gone -- parent goes with it */
+            if (depth == 0) {
+                free(parent);
+
+                t->root = bpnode_new(t, true);
+                t->height = 0;
+                return;
+            }
+
+            free(parent);
+            continue;
+        }
+
+        /* child i and the separator on one side of it are removed */
+        k = i > 0 ? i - 1 : 0;
+
+        bpnode_destroy(KEY(t, parent, k), t->key_ttbl);
+        memmove(KEY(t, parent, k), KEY(t, parent, k + 1), (parent->count - k - 1) * kwidth);
+
+        memmove(CHILDREN(t, parent) + i, CHILDREN(t, parent) + i + 1,
+                (parent->count - i) * sizeof(bpnode *));
+
+        --parent->count;
+        break;
+    }
+
+    while (t->root->leaf == false && t->root->count == 0) {
+        /* a root with a single child is redundant */
+        n = t->root;
+        t->root = CHILDREN(t, n)[0];
+        free(n);
+
+        --t->height;
+    }
+}
+
+/**
+ *  @brief  Prints the subtree rooted at n, one node per line
+ *
+ *  @param[in]  t       pointer to bptree
+ *  @param[in]  n       root of a subtree
+ *  @param[in]  dest    file stream (e.g stdout, stderr, a file)
+ *  @param[in]  depth   depth of n (for indentation)
+ */
+static void bpnode_fputs(bptree *t, bpnode *n, FILE *dest, int depth) {
+    size_t i = 0;
+    int d = 0;
+
+    for (d = 0; d < depth; d++) {
+        fprintf(dest, "|     ");
+    }
+
+    fprintf(dest, "%s[", n->leaf ? "L----" : "I----");
+
+    for (i = 0; i < n->count; i++) {
+        if (t->key_ttbl->print) {
+            t->key_ttbl->print(KEY(t, n, i), dest);
+        } else {
+            fprintf(dest, "%p", (void *)(KEY(t, n, i)));
+        }
+
+        fprintf(dest, "%s", i + 1 < n->count ? ", " : "");
+    }
+
+    fprintf(dest, "]\n");
+
+    if (n->leaf == false) {
+        for (i = 0; i <= n->count; i++) {
+            bpnode_fputs(t, CHILDREN(t, n)[i], dest, depth + 1);
+        }
+    }
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     any node of a bptree (e.g. an iterator's container)
+ *
+ *  @return     iterator at the smallest key
+ */
+static iterator bpti_begin(void *arg) {
+    bptree *t = ((bpnode *)(arg))->owner;
+    bpnode *leaf = bpnode_leftmost(t);
+    iterator it;
+
+    it.itbl = _bptree_iterator_;
+    it.container = leaf;
+    it.curr = KEYS(leaf);
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     any node of a bptree (e.g. an iterator's container)
+ *
+ *  @return     iterator one past the last key of the last leaf
+ */
+static iterator bpti_end(void *arg) {
+    bptree *t = ((bpnode *)(arg))->owner;
+    bpnode *leaf = bpnode_rightmost(t);
+    iterator it;
+
+    it.itbl = _bptree_iterator_;
+    it.container = leaf;
+    it.curr = KEY(t, leaf, leaf->count);
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator at the next key in order
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *
+ *  @return     a new iterator
+ */
+static iterator bpti_next(iterator it) {
+    iterator iter = it;
+    bpti_incr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator n keys past it
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *  @param[in]  n   number of keys to move
+ *
+ *  @return     a new iterator
+ */
+static iterator bpti_next_n(iterator it, int n) {
+    iterator iter = it;
+    bpti_advance(&iter, n);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator at the previous key in order
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *
+ *  @return     a new iterator
+ */
+static iterator bpti_prev(iterator it) {
+    iterator iter = it;
+    bpti_decr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator n keys behind it
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *  @param[in]  n   number of keys to move
+ *
+ *  @return     a new iterator
+ */
+static iterator bpti_prev_n(iterator it, int n) {
+    iterator iter = it;
+    bpti_advance(&iter, -n);
+    return iter;
+}
+
+/**
+ *  @brief  Determines the distance between first and last numerically
+ *
+ *  @param[in]  first   pointer to iterator that refers to a bptree
+ *  @param[in]  last    pointer to iterator that refers to a bptree
+ *
+ *  @return     numerical distance between first and last
+ *
+ *  Whole leaves are skipped by their key counts -- O(leaves spanned).
+ */
+static int bpti_distance(iterator *first, iterator *last) {
+    bpnode *leaf = NULL;
+    size_t kwidth = 0;
+    size_t from = 0;
+    int delta = 0;
+
+    if (first == NULL && last == NULL) {
+        ERROR(__FILE__, "Both iterator first and last are NULL.");
+        return 0;
+    } else if (first == NULL || last == NULL) {
+        last = last ? last : first;
+        leaf = ((bpnode *)(last->container))->owner->root;
+
+        while (leaf->leaf == false) {
+            leaf = CHILDREN(leaf->owner, leaf)[0];
+        }
+
+        from = 0;
+    } else {
+        leaf = (bpnode *)(first->container);
+        from = ((char *)(first->curr) - KEYS(leaf)) / leaf->owner->key_ttbl->width;
+    }
+
+    kwidth = leaf->owner->key_ttbl->width;
+
+    while (leaf && leaf != last->container) {
+        delta += (int)(leaf->count - from);
+        leaf = leaf->next;
+        from = 0;
+    }
+
+    if (leaf) {
+        delta += (int)((((char *)(last->curr) - KEYS(leaf)) / kwidth) - from);
+    }
+
+    return delta;
+}
+
+/**
+ *  @brief  Advances the position of it n keys (n may be negative)
+ *
+ *  @param[in]  it  pointer to iterator that refers to a bptree
+ *  @param[in]  n   desired amount of keys to move
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *bpti_advance(iterator *it, int n) {
+    massert_iterator(it);
+
+    while (n > 0) {
+        bpti_incr(it);
+        --n;
+    }
+
+    while (n < 0) {
+        bpti_decr(it);
+        ++n;
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Moves it to the next key, crossing into the next leaf if needed
+ *
+ *  @param[in]  it  pointer to iterator that refers to a bptree
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *bpti_incr(iterator *it) {
+    bpnode *leaf = NULL;
+    bptree *t = NULL;
+
+    massert_iterator(it);
+
+    leaf = (bpnode *)(it->container);
+    t = leaf->owner;
+
+    if ((char *)(it->curr) == KEY(t, leaf, leaf->count)) {
+        ERROR(__FILE__, "Cannot increment - already at end.");
+        return it;
+    }
+
+    it->curr = (char *)(it->curr) + t->key_ttbl->width;
+
+    if ((char *)(it->curr) == KEY(t, leaf, leaf->count) && leaf->next) {
+        it->container = leaf->next;
+        it->curr = KEYS(leaf->next);
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Moves it to the previous key, crossing into the previous leaf
+ *          if needed
+ *
+ *  @param[in]  it  pointer to iterator that refers to a bptree
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *bpti_decr(iterator *it) {
+    bpnode *leaf = NULL;
+    bptree *t = NULL;
+
+    massert_iterator(it);
+
+    leaf = (bpnode *)(it->container);
+    t = leaf->owner;
+
+    if ((char *)(it->curr) != KEYS(leaf)) {
+        it->curr = (char *)(it->curr) - t->key_ttbl->width;
+    } else if (leaf->prev) {
+        it->container = leaf->prev;
+        it->curr = KEY(t, leaf->prev, leaf->prev->count - 1);
+    } else {
+        ERROR(__FILE__, "Cannot decrement this iterator, already at begin.");
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Retrieves the address of the key referred to
+ *          by it's current position
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *
+ *  @return     address of a key, NULL at the end
+ */
+static void *bpti_curr(iterator it) {
+    bpnode *leaf = (bpnode *)(it.container);
+    return (char *)(it.curr) == KEY(leaf->owner, leaf, leaf->count) ? NULL : it.curr;
+}
+
+/**
+ *  @brief  Retrieves the address of the smallest key of the bptree
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *
+ *  @return     address of the smallest key, NULL if empty
+ */
+static void *bpti_start(iterator it) {
+    return bptree_min(((bpnode *)(it.container))->owner);
+}
+
+/**
+ *  @brief  Retrieves the current element of the end iterator
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *
+ *  @return     NULL (the end iterator refers to no key)
+ */
+static void *bpti_finish(iterator it) {
+    (void)(it);
+    return NULL;
+}
+
+/**
+ *  @brief  Determines if it has keys to visit in the forward direction
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *
+ *  @return     true if keys remain in the forward direction,
+ *              false otherwise
+ */
+static bool bpti_has_next(iterator it) {
+    return bpti_curr(it) != NULL;
+}
+
+/**
+ *  @brief  Determines if it has keys to visit in the backward direction
+ *
+ *  @param[in]  it  iterator that refers to a bptree
+ *
+ *  @return     true if keys remain in the backward direction,
+ *              false otherwise
+ */
+static bool bpti_has_prev(iterator it) {
+    bpnode *leaf = (bpnode *)(it.container);
+    return leaf->prev != NULL || (char *)(it.curr) != KEYS(leaf);
+}
+
+/**
+ *  @brief  Retrieve a container's (key) typetable
+ *
+ *  @param[in]  arg     leaf of a bptree (an iterator's container)
+ *
+ *  @return     pointer to typetable
+ */
+static struct typetable *bpti_get_ttbl(void *arg) {
+    bpnode *leaf = (bpnode *)(arg);
+    return leaf->owner->key_ttbl;
+}
@@ -0,0 +1,1189 @@
+/**
+ *  @file       columns.c
+ *  @brief      Source file for a structure-of-arrays (columnar) ADT
+ *
+ *  @author     Gemuele Aludino
+ *  @date       02 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "columns.h"
+#include "iterator.h"
+#include "utils.h"
+
+#include <assert.h>
+#include <string.h>
+
+/**< retrieves the struct column for field number FIELD */
+#define COLUMN(COLS, FIELD)     (&((COLS)->cols[(FIELD)]))
+
+/**< address one block past the last element of a column */
+#define COLUMN_FINISH(COL)      ((char *)((COL)->base) + ((COL)->owner->size * (COL)->ttbl->width))
+
+/**
+ *  @struct     column
+ *  @brief      Represents a single field's contiguous, aligned buffer
+ *
+ *  An iterator over a column has its container field set to
+ *  the address of the column (not the address of the columns).
+ */
+struct column {
+    void *base;                 /**< aligned address of the first element */
+    void *raw;                  /**< address returned by malloc (to be freed) */
+
+    struct typetable *ttbl;     /**< width/copy/dtor/swap/compare/print */
+    size_t offset;              /**< offset of the field within a record */
+
+    struct columns *owner;      /**< columns instance this column belongs to */
+};
+
+/**
+ *  @struct     columns
+ *  @brief      Represents a structure-of-arrays ADT --
+ *              one struct column per field of a record schema
+ *
+ *  Note that struct columns and struct column are opaque.
+ */
+struct columns {
+    struct column *cols;        /**< array of nfields columns */
+    size_t nfields;             /**< number of fields per record */
+
+    size_t size;                /**< number of records */
+    size_t capacity;            /**< records each column can hold */
+};
+
+/**
+ *  @enum       column_kind
+ *  @brief      Primitive types recognized by the per-column kernels
+ */
+enum column_kind {
+    COLUMN_KIND_OTHER,
+    COLUMN_KIND_CHAR,
+    COLUMN_KIND_SCHAR,
+    COLUMN_KIND_UCHAR,
+    COLUMN_KIND_SHORT,
+    COLUMN_KIND_USHORT,
+    COLUMN_KIND_INT,
+    COLUMN_KIND_UINT,
+    COLUMN_KIND_LONG,
+    COLUMN_KIND_ULONG,
+    COLUMN_KIND_FLOAT,
+    COLUMN_KIND_DOUBLE
+};
+
+static columns *col_allocate(void);
+static void col_init(columns *c, const struct column_field *schema,
+                     size_t nfields, size_t capacity);
+static void col_deinit(columns *c);
+
+static void *col_buffer_allocate(size_t width, size_t n, void **raw);
+static void col_grow(columns *c, size_t n);
+static enum column_kind col_kind(struct typetable *ttbl);
+
+static iterator coli_begin(void *arg);
+static iterator coli_end(void *arg);
+
+static iterator coli_next(iterator it);
+static iterator coli_next_n(iterator it, int n);
+
+static iterator coli_prev(iterator it);
+static iterator coli_prev_n(iterator it, int n);
+
+static int coli_distance(iterator *first, iterator *last);
+
+static iterator *coli_advance(iterator *it, int n);
+static iterator *coli_incr(iterator *it);
+static iterator *coli_decr(iterator *it);
+
+static void *coli_curr(iterator it);
+static void *coli_start(iterator it);
+static void *coli_finish(iterator it);
+
+static bool coli_has_next(iterator it);
+static bool coli_has_prev(iterator it);
+
+static struct typetable *coli_get_ttbl(void *arg);
+
+struct iterator_table itbl_columns = {
+    coli_begin,
+    coli_end,
+    coli_next,
+    coli_next_n,
+    coli_prev,
+    coli_prev_n,
+    coli_advance,
+    coli_incr,
+    coli_decr,
+    coli_curr,
+    coli_start,
+    coli_finish,
+    coli_distance,
+    coli_has_next,
+    coli_has_prev,
+    coli_get_ttbl
+};
+
+struct iterator_table *_columns_iterator_ = &itbl_columns;
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to columns,
+ *          capacity COLUMNS_DEFAULT_CAPACITY (16) records
+ *
+ *  @param[in]  schema      array of nfields struct column_field
+ *  @param[in]  nfields     number of fields per record
+ *
+ *  @return     pointer to columns, or NULL if nfields is 0
+ */
+columns *col_new(const struct column_field *schema, size_t nfields) {
+    columns *c = NULL;
+
+    if (nfields == 0) {
+        ERROR(__FILE__, "A schema must have at least one field.");
+        return NULL;
+    }
+
+    c = col_allocate();                                      /* allocate */
+    col_init(c, schema, nfields, COLUMNS_DEFAULT_CAPACITY);  /* construct */
+    return c;                                                /* return */
+}
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to columns,
+ *          capacity n records
+ *
+ *  @param[in]  schema      array of nfields struct column_field
+ *  @param[in]  nfields     number of fields per record
+ *  @param[in]  n           number of records to reserve
+ *
+ *  @return     pointer to columns, or NULL if nfields is 0
+ */
+columns *col_newr(const struct column_field *schema, size_t nfields, size_t n) {
+    columns *c = NULL;
+
+    if (nfields == 0) {
+        ERROR(__FILE__, "A schema must have at least one field.");
+        return NULL;
+    }
+
+    c = col_allocate();                                      /* allocate */
+    col_init(c, schema, nfields, n);                         /* construct */
+    return c;                                                /* return */
+}
+
+/**
+ *  @brief  Calls col_deinit (columns' destructor) and deallocates the pointer c
+ *
+ *  @param[out] c   address of a pointer to columns
+ */
+void col_delete(columns **c) {
+    massert_container((*c));
+
+    col_deinit((*c));
+
+    free((*c));
+    (*c) = NULL;
+}
+
+/**
+ *  @brief  Returns an iterator to the first element of column field
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *
+ *  @return     iterator that refers to the column
+ */
+iterator col_begin(columns *c, size_t field) {
+    massert_container(c);
+    assert(field < c->nfields);
+    return coli_begin(COLUMN(c, field));
+}
+
+/**
+ *  @brief  Returns an iterator one block past the last element of column field
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *
+ *  @return     iterator that refers to the column
+ */
+iterator col_end(columns *c, size_t field) {
+    massert_container(c);
+    assert(field < c->nfields);
+    return coli_end(COLUMN(c, field));
+}
+
+/**
+ *  @brief  Returns the number of records in c
+ *
+ *  @param[in]  c   pointer to columns
+ *
+ *  @return     number of records
+ */
+size_t col_size(columns *c) {
+    massert_container(c);
+    return c->size;
+}
+
+/**
+ *  @brief  Returns the number of records c can hold without reallocation
+ *
+ *  @param[in]  c   pointer to columns
+ *
+ *  @return     capacity, in records
+ */
+size_t col_capacity(columns *c) {
+    massert_container(c);
+    return c->capacity;
+}
+
+/**
+ *  @brief  Returns the number of fields (columns) per record
+ *
+ *  @param[in]  c   pointer to columns
+ *
+ *  @return     number of fields
+ */
+size_t col_fields(columns *c) {
+    massert_container(c);
+    return c->nfields;
+}
+
+/**
+ *  @brief  Determines if c has no records
+ *
+ *  @param[in]  c   pointer to columns
+ *
+ *  @return     true if c has no records, false otherwise
+ */
+bool col_empty(columns *c) {
+    massert_container(c);
+    return c->size == 0;
+}
+
+/**
+ *  @brief  Reserves n records worth of storage in every column
+ *
+ *  @param[in]  c   pointer to columns
+ *  @param[in]  n   number of records
+ *
+ *  No-op if n does not exceed c's current capacity.
+ */
+void col_reserve(columns *c, size_t n) {
+    massert_container(c);
+
+    if (n > c->capacity) {
+        col_grow(c, n);
+    }
+}
+
+/**
+ *  @brief  Retrieves the address of field of the record at index
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *  @param[in]  index   record index
+ *
+ *  @return     address of the element, or NULL if out of bounds
+ */
+void *col_at(columns *c, size_t field, size_t index) {
+    struct column *col = NULL;
+
+    massert_container(c);
+
+    if (field >= c->nfields || index >= c->size) {
+        char str[256];
+        sprintf(str, "Field [%lu] / index [%lu] out of bounds. Columns has %lu fields, %lu records.",
+                field, index, c->nfields, c->size);
+        ERROR(__FILE__, str);
+        return NULL;
+    }
+
+    col = COLUMN(c, field);
+    return (char *)(col->base) + (index * col->ttbl->width);
+}
+
+/**
+ *  @brief  Retrieves the base address of column field
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *
+ *  @return     aligned base address of the column's contiguous buffer
+ *
+ *  Cast to the field's pointer type, e.g. (double *)(col_data(c, 1))
+ */
+void *col_data(columns *c, size_t field) {
+    massert_container(c);
+    assert(field < c->nfields);
+    return COLUMN(c, field)->base;
+}
+
+/**
+ *  @brief  Reassembles the record at index into record
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  index   record index
+ *  @param[out] record  address of a record (as per c's schema)
+ *
+ *  Fields are shallow copied -- record does not own any of
+ *  the fields' dynamically allocated memory.
+ */
+void col_get(columns *c, size_t index, void *record) {
+    struct column *col = NULL;
+    size_t i = 0;
+
+    massert_container(c);
+    massert_ptr(record);
+
+    if (index >= c->size) {
+        char str[256];
+        sprintf(str, "Index provided [%lu] is out of bounds. Size of columns is %lu.", index, c->size);
+        ERROR(__FILE__, str);
+        return;
+    }
+
+    for (i = 0; i < c->nfields; i++) {
+        col = COLUMN(c, i);
+        memcpy((char *)(record) + col->offset,
+               (char *)(col->base) + (index * col->ttbl->width),
+               col->ttbl->width);
+    }
+}
+
+/**
+ *  @brief  Appends a record, scattering its fields to their columns
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  record  address of a record (as per c's schema)
+ *
+ *  Each field is deep copied if its typetable has a copy function,
+ *  otherwise it is shallow copied.
+ */
+void col_pushb(columns *c, const void *record) {
+    struct column *col = NULL;
+    void *dst = NULL;
+    const void *src = NULL;
+    size_t i = 0;
+
+    massert_container(c);
+    massert_ptr(record);
+
+    if (c->size == c->capacity) {
+        /* a doubling strategy is employed, as with vector */
+        col_grow(c, c->capacity * 2);
+    }
+
+    for (i = 0; i < c->nfields; i++) {
+        col = COLUMN(c, i);
+
+        dst = (char *)(col->base) + (c->size * col->ttbl->width);
+        src = (const char *)(record) + col->offset;
+
+        if (col->ttbl->copy) {
+            col->ttbl->copy(dst, src);
+        } else {
+            memcpy(dst, src, col->ttbl->width);
+        }
+    }
+
+    ++c->size;
+}
+
+/**
+ *  @brief  Removes the rear record
+ *
+ *  @param[in]  c   pointer to columns
+ */
+void col_popb(columns *c) {
+    struct column *col = NULL;
+    size_t i = 0;
+
+    massert_container(c);
+
+    if (c->size == 0) {
+        return;
+    }
+
+    --c->size;
+
+    for (i = 0; i < c->nfields; i++) {
+        col = COLUMN(c, i);
+
+        if (col->ttbl->dtor) {
+            col->ttbl->dtor((char *)(col->base) + (c->size * col->ttbl->width));
+        }
+    }
+}
+
+/**
+ *  @brief  Destroys all records within c; capacity is retained
+ *
+ *  @param[in]  c   pointer to columns
+ */
+void col_clear(columns *c) {
+    struct column *col = NULL;
+    char *curr = NULL;
+    char *sentinel = NULL;
+    size_t i = 0;
+
+    massert_container(c);
+
+    for (i = 0; i < c->nfields; i++) {
+        col = COLUMN(c, i);
+
+        if (col->ttbl->dtor) {
+            curr = col->base;
+            sentinel = COLUMN_FINISH(col);
+
+            while (curr != sentinel) {
+                col->ttbl->dtor(curr);
+                curr += col->ttbl->width;
+            }
+        }
+
+        memset(col->base, 0, c->size * col->ttbl->width);
+    }
+
+    c->size = 0;
+}
+
+/**< sums an integral column into an accumulator of type ACC */
+#define COL_SUM_INTEGRAL(TYPE, ACC)                                            \
+    do {                                                                       \
+        const TYPE *p = (const TYPE *)(col->base);                             \
+        ACC acc = 0;                                                           \
+        for (i = 0; i < n; i++) {                                              \
+            acc += p[i];                                                       \
+        }                                                                      \
+        sum = (double)(acc);                                                   \
+    } while (0)
+
+/**
+ *  floating point addition is not associative, so the compiler
+ *  will not reorder a single accumulator -- four independent
+ *  accumulators let the adds pipeline (and pair into SIMD lanes).
+ */
+#define COL_SUM_FLOATING(TYPE)                                                 \
+    do {                                                                       \
+        const TYPE *p = (const TYPE *)(col->base);                             \
+        double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0;                 \
+        for (i = 0; i + 4 <= n; i += 4) {                                      \
+            acc0 += p[i];                                                      \
+            acc1 += p[i + 1];                                                  \
+            acc2 += p[i + 2];                                                  \
+            acc3 += p[i + 3];                                                  \
+        }                                                                      \
+        for (; i < n; i++) {                                                   \
+            acc0 += p[i];                                                      \
+        }                                                                      \
+        sum = (acc0 + acc1) + (acc2 + acc3);                                   \
+    } while (0)
+
+/**
+ *  @brief  Sums every element of a primitive-typed column
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *
+ *  @return     sum of the column, as a double;
+ *              0.0 if the column's typetable is not a primitive typetable
+ */
+double col_sum(columns *c, size_t field) {
+    struct column *col = NULL;
+    double sum = 0.0;
+    size_t n = 0;
+    size_t i = 0;
+
+    massert_container(c);
+    assert(field < c->nfields);
+
+    col = COLUMN(c, field);
+    n = c->size;
+
+    switch (col_kind(col->ttbl)) {
+    case COLUMN_KIND_CHAR:
+        COL_SUM_INTEGRAL(char, long);
+        break;
+    case COLUMN_KIND_SCHAR:
+        COL_SUM_INTEGRAL(signed char, long);
+        break;
+    case COLUMN_KIND_UCHAR:
+        COL_SUM_INTEGRAL(unsigned char, unsigned long);
+        break;
+    case COLUMN_KIND_SHORT:
+        COL_SUM_INTEGRAL(short, long);
+        break;
+    case COLUMN_KIND_USHORT:
+        COL_SUM_INTEGRAL(unsigned short, unsigned long);
+        break;
+    case COLUMN_KIND_INT:
+        COL_SUM_INTEGRAL(int, long);
+        break;
+    case COLUMN_KIND_UINT:
+        COL_SUM_INTEGRAL(unsigned int, unsigned long);
+        break;
+    case COLUMN_KIND_LONG:
+        COL_SUM_INTEGRAL(long, long);
+        break;
+    case COLUMN_KIND_ULONG:
+        COL_SUM_INTEGRAL(unsigned long, unsigned long);
+        break;
+    case COLUMN_KIND_FLOAT:
+        COL_SUM_FLOATING(float);
+        break;
+    case COLUMN_KIND_DOUBLE:
+        COL_SUM_FLOATING(double);
+        break;
+    default:
+        WARNING(__FILE__, "col_sum requires a column with a primitive typetable.");
+        break;
+    }
+
+    return sum;
+}
+
+/**
+ *  @brief  Collects the indices of the records whose field satisfies pred
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *  @param[in]  pred    unary predicate, receives the address of an element
+ *  @param[out] out_idx array with room for col_size(c) indices
+ *
+ *  @return     number of indices written to out_idx
+ *
+ *  Works for any column type, but calls pred per element --
+ *  prefer col_filter_range for primitive-typed columns.
+ */
+size_t col_filter(columns *c, size_t field, unary_predicate_fn pred, size_t *out_idx) {
+    struct column *col = NULL;
+    char *curr = NULL;
+    size_t count = 0;
+    size_t i = 0;
+
+    massert_container(c);
+    massert_ptr(pred);
+    massert_ptr(out_idx);
+    assert(field < c->nfields);
+
+    col = COLUMN(c, field);
+    curr = col->base;
+
+    for (i = 0; i < c->size; i++) {
+        if (pred(curr)) {
+            out_idx[count++] = i;
+        }
+
+        curr += col->ttbl->width;
+    }
+
+    return count;
+}
+
+/**
+ *  writes every index, but only advances the output cursor on a match --
+ *  this keeps the loop free of branches on the data.
+ */
+#define COL_FILTER_RANGE(TYPE)                                                 \
+    do {                                                                       \
+        const TYPE *p = (const TYPE *)(col->base);                             \
+        for (i = 0; i < n; i++) {                                              \
+            out_idx[count] = i;                                                \
+            count += (p[i] >= lo) & (p[i] <= hi);                              \
+        }                                                                      \
+    } while (0)
+
+/**
+ *  @brief  Collects the indices of the records whose field lies in [lo, hi]
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *  @param[in]  lo      lower bound (inclusive)
+ *  @param[in]  hi      upper bound (inclusive)
+ *  @param[out] out_idx array with room for col_size(c) indices
+ *
+ *  @return     number of indices written to out_idx;
+ *              0 if the column's typetable is not a primitive typetable
+ */
+size_t col_filter_range(columns *c, size_t field, double lo, double hi, size_t *out_idx) {
+    struct column *col = NULL;
+    size_t count = 0;
+    size_t n = 0;
+    size_t i = 0;
+
+    massert_container(c);
+    massert_ptr(out_idx);
+    assert(field < c->nfields);
+
+    col = COLUMN(c, field);
+    n = c->size;
+
+    switch (col_kind(col->ttbl)) {
+    case COLUMN_KIND_CHAR:
+        COL_FILTER_RANGE(char);
+        break;
+    case COLUMN_KIND_SCHAR:
+        COL_FILTER_RANGE(signed char);
+        break;
+    case COLUMN_KIND_UCHAR:
+        COL_FILTER_RANGE(unsigned char);
+        break;
+    case COLUMN_KIND_SHORT:
+        COL_FILTER_RANGE(short);
+        break;
+    case COLUMN_KIND_USHORT:
+        COL_FILTER_RANGE(unsigned short);
+        break;
+    case COLUMN_KIND_INT:
+        COL_FILTER_RANGE(int);
+        break;
+    case COLUMN_KIND_UINT:
+        COL_FILTER_RANGE(unsigned int);
+        break;
+    case COLUMN_KIND_LONG:
+        COL_FILTER_RANGE(long);
+        break;
+    case COLUMN_KIND_ULONG:
+        COL_FILTER_RANGE(unsigned long);
+        break;
+    case COLUMN_KIND_FLOAT:
+        COL_FILTER_RANGE(float);
+        break;
+    case COLUMN_KIND_DOUBLE:
+        COL_FILTER_RANGE(double);
+        break;
+    default:
+        WARNING(__FILE__, "col_filter_range requires a column with a primitive typetable.");
+        break;
+    }
+
+    return count;
+}
+
+/**< constant-width memcpy compiles to a single load/store */
+#define COL_GATHER(WIDTH)                                                      \
+    do {                                                                       \
+        for (i = 0; i < n; i++) {                                              \
+            memcpy(out + (i * (WIDTH)), base + (idx[i] * (WIDTH)), (WIDTH));   \
+        }                                                                      \
+    } while (0)
+
+/**
+ *  @brief  Copies the field of the records at idx[0..n) into dest, contiguously
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *  @param[in]  idx     array of n record indices (e.g. from col_filter)
+ *  @param[in]  n       number of indices
+ *  @param[out] dest    array with room for n elements of the field's type
+ *
+ *  Elements are shallow copied. Indices are not bounds checked.
+ */
+void col_gather(columns *c, size_t field, const size_t *idx, size_t n, void *dest) {
+    struct column *col = NULL;
+    const char *base = NULL;
+    char *out = NULL;
+    size_t width = 0;
+    size_t i = 0;
+
+    massert_container(c);
+    massert_ptr(idx);
+    massert_ptr(dest);
+    assert(field < c->nfields);
+
+    col = COLUMN(c, field);
+
+    base = col->base;
+    out = dest;
+    width = col->ttbl->width;
+
+    switch (width) {
+    case 1:
+        COL_GATHER(1);
+        break;
+    case 2:
+        COL_GATHER(2);
+        break;
+    case 4:
+        COL_GATHER(4);
+        break;
+    case 8:
+        COL_GATHER(8);
+        break;
+    default:
+        COL_GATHER(width);
+        break;
+    }
+}
+
+/**
+ *  @brief  Retrieves the typetable of column field
+ *
+ *  @param[in]  c       pointer to columns
+ *  @param[in]  field   field (column) number
+ *
+ *  @return     pointer to typetable
+ */
+struct typetable *col_get_ttbl(columns *c, size_t field) {
+    massert_container(c);
+    assert(field < c->nfields);
+    return COLUMN(c, field)->ttbl;
+}
+
+/**
+ *  @brief  Calls malloc to allocate memory for a pointer to columns
+ *
+ *  @return     pointer to columns
+ */
+static columns *col_allocate(void) {
+    columns *c = NULL;
+    c = malloc(sizeof *c);
+    return c;
+}
+
+/**
+ *  @brief  "Constructor" function, initializes columns
+ *
+ *  @param[in]  c           pointer to columns
+ *  @param[in]  schema      array of nfields struct column_field
+ *  @param[in]  nfields     number of fields per record
+ *  @param[in]  capacity    capacity (in records) desired for each column
+ */
+static void col_init(columns *c, const struct column_field *schema,
+                     size_t nfields, size_t capacity) {
+    struct column *col = NULL;
+    size_t i = 0;
+
+    massert_container(c);
+    massert_ptr(schema);
+
+    /* col_new/col_newr reject an empty schema before allocating */
+    assert(nfields > 0);
+
+    if (capacity == 0) {
+        WARNING(__FILE__, "Provided input capacity was 0. Will default to capacity of 1.");
+        capacity = 1;
+    }
+
+    c->cols = malloc(sizeof *c->cols * nfields);
+    massert_malloc(c->cols);
+
+    c->nfields = nfields;
+    c->size = 0;
+    c->capacity = capacity;
+
+    for (i = 0; i < nfields; i++) {
+        col = COLUMN(c, i);
+
+        col->ttbl = schema[i].ttbl ? schema[i].ttbl : _void_ptr_;
+        col->offset = schema[i].offset;
+        col->owner = c;
+
+        col->base = col_buffer_allocate(col->ttbl->width, capacity, &col->raw);
+        memset(col->base, 0, col->ttbl->width * capacity);
+    }
+}
+
+/**
+ *  @brief  "Destructor" function, deinitializes columns
+ *
+ *  @param[in]  c   pointer to columns
+ */
+static void col_deinit(columns *c) {
+    size_t i = 0;
+
+    if (c == NULL) {
+        return;
+    }
+
+    col_clear(c);
+
+    for (i = 0; i < c->nfields; i++) {
+        free(COLUMN(c, i)->raw);
+    }
+
+    free(c->cols);
+    c->cols = NULL;
+
+    c->nfields = 0;
+    c->capacity = 0;
+}
+
+/**
+ *  @brief  Allocates a buffer of n elements of width bytes,
+ *          aligned to COLUMNS_ALIGNMENT
+ *
+ *  @param[in]  width   size of an element
+ *  @param[in]  n       number of elements
+ *  @param[out] raw     receives the address returned by malloc (to be freed)
+ *
+ *  @return     aligned address within raw
+ */
+static void *col_buffer_allocate(size_t width, size_t n, void **raw) {
+    size_t misalignment = 0;
+
+    (*raw) = malloc((width * n) + COLUMNS_ALIGNMENT - 1);
+    massert_malloc((*raw));
+
+    misalignment = (size_t)(*raw) % COLUMNS_ALIGNMENT;
+
+    return misalignment == 0 ? (*raw)
+                             : (char *)(*raw) + (COLUMNS_ALIGNMENT - misalignment);
+}
+
+/**
+ *  @brief  Reallocates every column of c to hold n records
+ *
+ *  @param[in]  c   pointer to columns
+ *  @param[in]  n   new capacity, in records (must be >= col_size(c))
+ */
+static void col_grow(columns *c, size_t n) {
+    struct column *col = NULL;
+    void *base = NULL;
+    void *raw = NULL;
+    size_t i = 0;
+
+    n = n > 0 ? n : 1;
+
+    for (i = 0; i < c->nfields; i++) {
+        col = COLUMN(c, i);
+
+        base = col_buffer_allocate(col->ttbl->width, n, &raw);
+        memcpy(base, col->base, c->size * col->ttbl->width);
+
+        free(col->raw);
+
+        col->base = base;
+        col->raw = raw;
+    }
+
+    c->capacity = n;
+}
+
+/**
+ *  @brief  Maps a typetable to the primitive type it describes
+ *
+ *  @param[in]  ttbl    pointer to typetable
+ *
+ *  @return     column_kind, COLUMN_KIND_OTHER if not a primitive typetable
+ */
+static enum column_kind col_kind(struct typetable *ttbl) {
+    if (ttbl == _char_) {
+        return COLUMN_KIND_CHAR;
+    } else if (ttbl == _signed_char_ || ttbl == _int8_) {
+        return COLUMN_KIND_SCHAR;
+    } else if (ttbl == _unsigned_char_ || ttbl == _uint8_) {
+        return COLUMN_KIND_UCHAR;
+    } else if (ttbl == _short_int_ || ttbl == _signed_short_int_ || ttbl == _int16_) {
+        return COLUMN_KIND_SHORT;
+    } else if (ttbl == _unsigned_short_int_ || ttbl == _uint16_) {
+        return COLUMN_KIND_USHORT;
+    } else if (ttbl == _int_ || ttbl == _signed_int_ || ttbl == _int32_) {
+        return COLUMN_KIND_INT;
+    } else if (ttbl == _unsigned_int_ || ttbl == _uint32_) {
+        return COLUMN_KIND_UINT;
+    } else if (ttbl == _long_int_ || ttbl == _signed_long_int_) {
+        return COLUMN_KIND_LONG;
+    } else if (ttbl == _unsigned_long_int_) {
+        return COLUMN_KIND_ULONG;
+    } else if (ttbl == _float_) {
+        return COLUMN_KIND_FLOAT;
+    } else if (ttbl == _double_) {
+        return COLUMN_KIND_DOUBLE;
+    }
+
+    return COLUMN_KIND_OTHER;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     pointer to struct column
+ *
+ *  @return     iterator at the column's first element
+ */
+static iterator coli_begin(void *arg) {
+    struct column *col = (struct column *)(arg);
+    iterator it;
+
+    it.itbl = _columns_iterator_;
+    it.container = col;
+    it.curr = col->base;
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     pointer to struct column
+ *
+ *  @return     iterator one block past the column's last element
+ */
+static iterator coli_end(void *arg) {
+    struct column *col = (struct column *)(arg);
+    iterator it;
+
+    it.itbl = _columns_iterator_;
+    it.container = col;
+    it.curr = COLUMN_FINISH(col);
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that
+ *          is one block past it's current position
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *
+ *  @return     a new iterator that is one block past it's current position
+ */
+static iterator coli_next(iterator it) {
+    iterator iter = it;
+    coli_incr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that
+ *          is n blocks past it's current position
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *  @param[in]  n   number of blocks to move
+ *
+ *  @return     a new iterator that is n blocks past it's current position
+ */
+static iterator coli_next_n(iterator it, int n) {
+    iterator iter = it;
+    coli_advance(&iter, n);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that
+ *          is one block behind it's current position
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *
+ *  @return     a new iterator that is one block behind it's current position
+ */
+static iterator coli_prev(iterator it) {
+    iterator iter = it;
+    coli_decr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that
+ *          is n blocks behind it's current position
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *  @param[in]  n   number of blocks to move
+ *
+ *  @return     a new iterator that is n blocks behind it's current position
+ */
+static iterator coli_prev_n(iterator it, int n) {
+    iterator iter = it;
+    coli_advance(&iter, -n);
+    return iter;
+}
+
+/**
+ *  @brief  Determines the distance between first and last numerically
+ *
+ *  @param[in]  first   pointer to iterator that refers to a column
+ *  @param[in]  last    pointer to iterator that refers to a column
+ *
+ *  @return     numerical distance between first and last
+ *
+ *  As with vector, leave one of the parameters NULL
+ *  to find the index position of the other.
+ */
+static int coli_distance(iterator *first, iterator *last) {
+    struct column *col = NULL;
+
+    if (first == NULL && last != NULL) {
+        col = (struct column *)(last->container);
+        return (int)(ptr_distance(col->base, last->curr, col->ttbl->width));
+    } else if (last == NULL && first != NULL) {
+        col = (struct column *)(first->container);
+        return (int)(ptr_distance(col->base, first->curr, col->ttbl->width));
+    } else if (first == NULL && last == NULL) {
+        ERROR(__FILE__, "Both iterator first and last are NULL.");
+        return 0;
+    } else {
+        col = (struct column *)(first->container);
+        return (int)(ptr_distance(first->curr, last->curr, col->ttbl->width));
+    }
+}
+
+/**
+ *  @brief  Advances the position of it n blocks (n may be negative)
+ *
+ *  @param[in]  it  pointer to iterator that refers to a column
+ *  @param[in]  n   desired amount of blocks to move
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *coli_advance(iterator *it, int n) {
+    struct column *col = NULL;
+    int pos = 0;
+
+    massert_iterator(it);
+
+    col = (struct column *)(it->container);
+    pos = (int)(ptr_distance(col->base, it->curr, col->ttbl->width));
+
+    if ((pos + n) < 0 || (size_t)(pos + n) > col->owner->size) {
+        char str[256];
+        sprintf(str, "Cannot advance %d times from position %d.", n, pos);
+        ERROR(__FILE__, str);
+    } else {
+        it->curr = (char *)(it->curr) + (n * (int)(col->ttbl->width));
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Increments the position of it 1 block forward
+ *
+ *  @param[in]  it  pointer to iterator that refers to a column
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *coli_incr(iterator *it) {
+    struct column *col = NULL;
+
+    massert_iterator(it);
+
+    col = (struct column *)(it->container);
+
+    if (it->curr == COLUMN_FINISH(col)) {
+        ERROR(__FILE__, "Cannot increment - already at end.");
+    } else {
+        it->curr = (char *)(it->curr) + (col->ttbl->width);
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Decrements the position of it 1 block backward
+ *
+ *  @param[in]  it  pointer to iterator that refers to a column
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *coli_decr(iterator *it) {
+    struct column *col = NULL;
+
+    massert_iterator(it);
+
+    col = (struct column *)(it->container);
+
+    if (it->curr == col->base) {
+        ERROR(__FILE__, "Cannot decrement this iterator, already at begin.");
+    } else {
+        it->curr = (char *)(it->curr) - (col->ttbl->width);
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Retrieves the address of the value referred to
+ *          by it's current position
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *
+ *  @return     address of an element from within a column
+ */
+static void *coli_curr(iterator it) {
+    return it.curr;
+}
+
+/**
+ *  @brief  Retrieves the address of the first element of the column
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *
+ *  @return     address of the first element from within a column
+ */
+static void *coli_start(iterator it) {
+    struct column *col = (struct column *)(it.container);
+    return col->base;
+}
+
+/**
+ *  @brief  Retrieves the address of the block one past
+ *          the last element of the column
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *
+ *  @return     address one block past the column's rear element
+ */
+static void *coli_finish(iterator it) {
+    struct column *col = (struct column *)(it.container);
+    return COLUMN_FINISH(col);
+}
+
+/**
+ *  @brief  Determines if it has elements to visit in the forward direction
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *
+ *  @return     true if elements remain in the forward direction,
+ *              false otherwise
+ */
+static bool coli_has_next(iterator it) {
+    struct column *col = (struct column *)(it.container);
+    return it.curr != COLUMN_FINISH(col);
+}
+
+/**
+ *  @brief  Determines if it has elements to visit in the backward direction
+ *
+ *  @param[in]  it  iterator that refers to a column
+ *
+ *  @return     true if elements remain in the backward direction,
+ *              false otherwise
+ */
+static bool coli_has_prev(iterator it) {
+    struct column *col = (struct column *)(it.container);
+    return it.curr != col->base;
+}
+
+/**
+ *  @brief  Retrieve a column's typetable
+ *
+ *  @param[in]  arg     pointer to struct column
+ *
+ *  @return     pointer to typetable
+ */
+static struct typetable *coli_get_ttbl(void *arg) {
+    struct column *col = (struct column *)(arg);
+    return col->ttbl;
+}
@@ -0,0 +1,1156 @@
+/**
+ *  @file       deque.c
+ *  @brief      Source file for a double-ended queue ADT
+ *
+ *  @author     Gemuele Aludino
+ *  @date       04 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "deque.h"
+#include "iterator.h"
+#include "utils.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define DEQUE_INITIAL_MAP_SIZE 8
+
+/**< size (in bytes) of the elements within a chunk */
+#define CHUNK_BYTES(DEQ)        ((DEQ)->chunk_length * (DEQ)->ttbl->width)
+
+/**< header preceding each chunk's elements, recovers a chunk's owner */
+#define CHUNK_HEADER(CHUNK)     ((union deque_chunk_header *)(CHUNK) - 1)
+#define CHUNK_OWNER(NODE)       (CHUNK_HEADER(*(NODE))->owner)
+
+/**
+ *  @union      deque_chunk_header
+ *  @brief      Stored immediately before the elements of every chunk
+ *
+ *  An iterator refers to a slot of the map (its node) rather than to
+ *  the deque itself, so the chunk's owner is kept here. The remaining
+ *  members only pad the header for the elements' alignment.
+ */
+union deque_chunk_header {
+    struct deque *owner;
+    double align_dbl;
+    long align_lng;
+};
+
+/**
+ *  @struct     deque
+ *  @brief      Represents a double-ended queue ADT
+ *
+ *  Note that struct deque and struct deque_base are opaque.
+ */
+struct deque {
+    /**
+     *  @struct     deque_base
+     *  @brief      Decouples deque-related fields from typetable
+     */
+    struct deque_base {
+        char **map;             /**< array of chunk addresses */
+        size_t map_size;        /**< number of slots in map */
+
+        /**
+         *  @struct     deque_position
+         *  @brief      Address of an element, and the map slot of its chunk
+         */
+        struct deque_position {
+            char **node;        /**< map slot of the chunk */
+            char *curr;         /**< address of an element within *node */
+        } start,                /**< front element */
+          finish;               /**< one block past the rear element */
+    } impl;
+
+    size_t chunk_length;        /**< elements per chunk */
+    size_t size;                /**< number of elements */
+
+    struct typetable *ttbl;     /**< data width, cpy, dtor, swap, compare, print */
+};
+
+static deque *d_allocate(void);
+static void d_init(deque *d, struct typetable *ttbl);
+static void d_deinit(deque *d);
+
+static char *d_chunk_allocate(deque *d);
+static void d_chunk_free(char *chunk);
+static void d_reserve_map(deque *d, size_t nodes_to_add, bool at_front);
+static void d_copy_in(deque *d, void *dst, const void *valaddr);
+
+struct typetable ttbl_deque = {
+    sizeof(deque),
+    deque_copy,
+    deque_dtor,
+    deque_swap,
+    deque_compare,
+    deque_print,
+    NULL /* no hash -- deques cannot be hash keys */
+};
+
+struct typetable *_deque_ = &ttbl_deque;
+
+static iterator dqi_begin(void *arg);
+static iterator dqi_end(void *arg);
+
+static iterator dqi_next(iterator it);
+static iterator dqi_next_n(iterator it, int n);
+
+static iterator dqi_prev(iterator it);
+static iterator dqi_prev_n(iterator it, int n);
+
+static int dqi_distance(iterator *first, iterator *last);
+
+static iterator *dqi_advance(iterator *it, int n);
+static iterator *dqi_incr(iterator *it);
+static iterator *dqi_decr(iterator *it);
+
+static void *dqi_curr(iterator it);
+static void *dqi_start(iterator it);
+static void *dqi_finish(iterator it);
+
+static bool dqi_has_next(iterator it);
+static bool dqi_has_prev(iterator it);
+
+static struct typetable *dqi_get_ttbl(void *arg);
+
+static int dqi_index(iterator *it);
+
+struct iterator_table itbl_deque = {
+    dqi_begin,
+    dqi_end,
+    dqi_next,
+    dqi_next_n,
+    dqi_prev,
+    dqi_prev_n,
+    dqi_advance,
+    dqi_incr,
+    dqi_decr,
+    dqi_curr,
+    dqi_start,
+    dqi_finish,
+    dqi_distance,
+    dqi_has_next,
+    dqi_has_prev,
+    dqi_get_ttbl
+};
+
+struct iterator_table *_deque_iterator_ = &itbl_deque;
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to deque
+ *
+ *  @param[in]  ttbl    pointer to struct typetable for
+ *                      width/copy/dtor/swap/compare/print
+ *
+ *  @return     pointer to deque
+ */
+deque *d_new(struct typetable *ttbl) {
+    deque *d = d_allocate();                    /* allocate */
+    d_init(d, ttbl);                            /* construct */
+    return d;                                   /* return */
+}
+
+/**
+ *  @brief  Allocates a new deque, filled with copies of d's elements
+ *
+ *  @param[in]  d   pointer to deque, containing the desired source elements
+ *
+ *  @return     pointer to deque, with copies of d's elements
+ */
+deque *d_newcopy(deque *d) {
+    deque *copy = NULL;
+    iterator it;
+
+    massert_container(d);
+
+    copy = d_new(d->ttbl);
+
+    for (it = d_begin(d); dqi_has_next(it); dqi_incr(&it)) {
+        d_pushb(copy, dqi_curr(it));
+    }
+
+    return copy;
+}
+
+/**
+ *  @brief  Calls d_deinit (deque's destructor) and deallocates the pointer d
+ *
+ *  @param[out] d   address of a pointer to deque
+ */
+void d_delete(deque **d) {
+    massert_container((*d));
+
+    d_deinit((*d));
+
+    free((*d));
+    (*d) = NULL;
+}
+
+/**
+ *  @brief  Returns an iterator that points to the front element of deque
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  @return     iterator that refers to d
+ */
+iterator d_begin(deque *d) {
+    massert_container(d);
+    return dqi_begin(d->impl.start.node);
+}
+
+/**
+ *  @brief  Returns an iterator one block past the rear element of deque
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  @return     iterator that refers to d
+ */
+iterator d_end(deque *d) {
+    massert_container(d);
+    return dqi_end(d->impl.start.node);
+}
+
+/**
+ *  @brief  Returns the logical length of d
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  @return     number of elements in d
+ */
+size_t d_size(deque *d) {
+    massert_container(d);
+    return d->size;
+}
+
+/**
+ *  @brief  Determines if d is an empty deque, or not
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  @return     true if d has no elements, false otherwise
+ */
+bool d_empty(deque *d) {
+    massert_container(d);
+    return d->size == 0;
+}
+
+/**
+ *  @brief  Retrieves the address of an element from deque at index n
+ *
+ *  @param[in]  d   pointer to deque
+ *  @param[in]  n   index of desired element
+ *
+ *  @return     address of element at n, NULL if n is out of bounds
+ */
+void *d_at(deque *d, size_t n) {
+    size_t offset = 0;
+    char **node = NULL;
+
+    massert_container(d);
+
+    if (n >= d->size) {
+        char str[256];
+        sprintf(str, "Input %lu is greater than deque's logical length, %lu -- index out of bounds.", n, d->size);
+        ERROR(__FILE__, str);
+        return NULL;
+    }
+
+    /* offset of element n from the base of the front chunk */
+    offset = n + ptr_distance(*d->impl.start.node, d->impl.start.curr, d->ttbl->width);
+    node = d->impl.start.node + (offset / d->chunk_length);
+
+    return (*node) + ((offset % d->chunk_length) * d->ttbl->width);
+}
+
+/**
+ *  @brief  Retrieves the address of the front element from deque
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  @return     address of the front element, NULL if d is empty
+ */
+void *d_front(deque *d) {
+    massert_container(d);
+    return d->size > 0 ? d->impl.start.curr : NULL;
+}
+
+/**
+ *  @brief  Retrieves the address of the rear element from deque
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  @return     address of the rear element, NULL if d is empty
+ */
+void *d_back(deque *d) {
+    massert_container(d);
+
+    if (d->size == 0) {
+        return NULL;
+    }
+
+    if (d->impl.finish.curr == *d->impl.finish.node) {
+        /* finish is at the base of its chunk -- the rear is in the chunk before */
+        return *(d->impl.finish.node - 1) + CHUNK_BYTES(d) - d->ttbl->width;
+    }
+
+    return d->impl.finish.curr - d->ttbl->width;
+}
+
+/**
+ *  @brief  Appends an element to the rear of the deque
+ *
+ *  @param[in]  d       pointer to deque
+ *  @param[in]  valaddr address of element to be copied
+ *
+ *  finish.curr never rests at the end of its chunk --
+ *  when the rear chunk fills, the next chunk is allocated immediately.
+ */
+void d_pushb(deque *d, const void *valaddr) {
+    massert_container(d);
+    massert_ptr(valaddr);
+
+    d_copy_in(d, d->impl.finish.curr, valaddr);
+
+    if (d->impl.finish.curr + d->ttbl->width == *d->impl.finish.node + CHUNK_BYTES(d)) {
+        d_reserve_map(d, 1, false);
+
+        *(d->impl.finish.node + 1) = d_chunk_allocate(d);
+
+        ++d->impl.finish.node;
+        d->impl.finish.curr = *d->impl.finish.node;
+    } else {
+        d->impl.finish.curr += d->ttbl->width;
+    }
+
+    ++d->size;
+}
+
+/**
+ *  @brief  Prepends an element to the front of the deque
+ *
+ *  @param[in]  d       pointer to deque
+ *  @param[in]  valaddr address of element to be copied
+ */
+void d_pushf(deque *d, const void *valaddr) {
+    massert_container(d);
+    massert_ptr(valaddr);
+
+    if (d->impl.start.curr == *d->impl.start.node) {
+        d_reserve_map(d, 1, true);
+
+        *(d->impl.start.node - 1) = d_chunk_allocate(d);
+
+        --d->impl.start.node;
+        d->impl.start.curr = *d->impl.start.node + CHUNK_BYTES(d) - d->ttbl->width;
+    } else {
+        d->impl.start.curr -= d->ttbl->width;
+    }
+
+    d_copy_in(d, d->impl.start.curr, valaddr);
+
+    ++d->size;
+}
+
+/**
+ *  @brief  Removes the rear element from the deque
+ *
+ *  @param[in]  d   pointer to deque
+ */
+void d_popb(deque *d) {
+    massert_container(d);
+
+    if (d->size == 0) {
+        return;
+    }
+
+    if (d->impl.finish.curr == *d->impl.finish.node) {
+        /* the (empty) rear chunk is released */
+        d_chunk_free(*d->impl.finish.node);
+        *d->impl.finish.node = NULL;
+
+        --d->impl.finish.node;
+        d->impl.finish.curr = *d->impl.finish.node + CHUNK_BYTES(d) - d->ttbl->width;
+    } else {
+        d->impl.finish.curr -= d->ttbl->width;
+    }
+
+    if (d->ttbl->dtor) {
+        d->ttbl->dtor(d->impl.finish.curr);
+    }
+
+    memset(d->impl.finish.curr, 0, d->ttbl->width);
+    --d->size;
+}
+
+/**
+ *  @brief  Removes the front element from the deque
+ *
+ *  @param[in]  d   pointer to deque
+ */
+void d_popf(deque *d) {
+    massert_container(d);
+
+    if (d->size == 0) {
+        return;
+    }
+
+    if (d->ttbl->dtor) {
+        d->ttbl->dtor(d->impl.start.curr);
+    }
+
+    memset(d->impl.start.curr, 0, d->ttbl->width);
+
+    if (d->impl.start.curr + d->ttbl->width == *d->impl.start.node + CHUNK_BYTES(d)) {
+        /* the (now empty) front chunk is released */
+        d_chunk_free(*d->impl.start.node);
+        *d->impl.start.node = NULL;
+
+        ++d->impl.start.node;
+        d->impl.start.curr = *d->impl.start.node;
+    } else {
+        d->impl.start.curr += d->ttbl->width;
+    }
+
+    --d->size;
+}
+
+/**
+ *  @brief  Swaps fields between d and other
+ *
+ *  @param[out] d       address of pointer to deque
+ *  @param[out] other   address of pointer to deque
+ *
+ *  Chunk owners are rewritten, so that iterators resolve
+ *  to the right deque after the swap.
+ */
+void d_swap(deque **d, deque **other) {
+    deque temp;
+    char **node = NULL;
+
+    massert_container((*d));
+    massert_container((*other));
+
+    temp = *(*d);
+    *(*d) = *(*other);
+    *(*other) = temp;
+
+    for (node = (*d)->impl.start.node; node <= (*d)->impl.finish.node; node++) {
+        CHUNK_OWNER(node) = (*d);
+    }
+
+    for (node = (*other)->impl.start.node; node <= (*other)->impl.finish.node; node++) {
+        CHUNK_OWNER(node) = (*other);
+    }
+}
+
+/**
+ *  @brief  Destroys elements from within d
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  All chunks but one are released, and the map is recentered on it.
+ */
+void d_clear(deque *d) {
+    massert_container(d);
+
+    while (d->size > 0) {
+        d_popb(d);
+    }
+
+    /**
+     *  The single remaining chunk is moved to the middle of the map,
+     *  so that pushes at either end have room to grow.
+     */
+    if (d->impl.start.node != d->impl.map + (d->impl.map_size / 2)) {
+        char *chunk = *d->impl.start.node;
+        *d->impl.start.node = NULL;
+
+        d->impl.start.node = d->impl.map + (d->impl.map_size / 2);
+        *d->impl.start.node = chunk;
+        d->impl.start.curr = chunk + ((d->chunk_length / 2) * d->ttbl->width);
+        d->impl.finish = d->impl.start;
+    }
+}
+
+/**
+ *  @brief  Prints a diagnostic of deque to stdout
+ *
+ *  @param[in]  d   pointer to deque
+ */
+void d_puts(deque *d) {
+    /* redirect to d_fputs with stream stdout */
+    d_fputs(d, stdout);
+}
+
+/**
+ *  @brief  Prints a diagnostic of deque to file stream dest
+ *
+ *  @param[in]  d       pointer to deque
+ *  @param[in]  dest    file stream (e.g stdout, stderr, a file)
+ */
+void d_fputs(deque *d, FILE *dest) {
+    const char *link = "------------------------------";
+    void (*print)(const void *, FILE *dest) = NULL;
+    iterator it;
+
+    massert_container(d);
+    massert_ptr(dest);
+
+    print = d->ttbl->print ? d->ttbl->print : void_ptr_print;
+
+    fprintf(dest, "\n%s\n%s\n%s\n", link, "Elements", link);
+
+    if (d->size == 0) {
+        fprintf(dest, "%s\n", "--- Container is empty ---");
+    }
+
+    for (it = d_begin(d); dqi_has_next(it); dqi_incr(&it)) {
+        print(dqi_curr(it), dest);
+        fprintf(dest, "\t\t(%s%p%s)\n", KCYN, dqi_curr(it), KNRM);
+    }
+
+    fprintf(dest, "%s\n%s\t\t%lu\n%s\t%lu\n%s\t%lu %s\n%s\n", link, "Size",
+            d->size, "Chunk length", d->chunk_length, "Element size",
+            d->ttbl->width, d->ttbl->width == 1 ? "byte" : "bytes", link);
+}
+
+/**
+ *  @brief  Wrapper function for a struct typetable
+ *
+ *  @param[in]  arg     address of a deque pointer
+ *  @param[in]  other   address of a deque pointer
+ *
+ *  @return     a pointer to deque
+ */
+void *deque_copy(void *arg, const void *other) {
+    deque **dest = NULL;
+    deque **source = NULL;
+
+    massert_container(other);
+
+    dest = (deque **)(arg);
+    source = (deque **)(other);
+
+    (*dest) = d_newcopy((*source));
+
+    return (*dest);
+}
+
+/**
+ *  @brief  Wrapper function for a struct typetable
+ *
+ *  @param[in]  arg     address of a deque pointer
+ */
+void deque_dtor(void *arg) {
+    deque **d = NULL;
+
+    massert_ptr(arg);
+
+    d = (deque **)(arg);
+    d_delete(d);
+}
+
+/**
+ *  @brief  Wrapper function for a struct typetable
+ *
+ *  @param[in]  s1  address of a deque pointer
+ *  @param[in]  s2  address of a deque pointer
+ */
+void deque_swap(void *s1, void *s2) {
+    deque **d1 = (deque **)(s1);
+    deque **d2 = (deque **)(s2);
+
+    if ((*d1)) {
+        d_swap(d1, d2);
+    } else {
+        (*d1) = (*d2);
+        (*d2) = NULL;
+    }
+}
+
+/**
+ *  @brief  Wrapper function for a struct typetable
+ *
+ *  @param[in]  c1  address of a deque pointer
+ *  @param[in]  c2  address of a deque pointer
+ *
+ *  @return     -1 if c1 and c2 do not share a comparison function,
+ *              otherwise, the first nonzero comparison between
+ *              c1 and c2's elements in order -- or the difference
+ *              in their lengths, if one is a prefix of the other.
+ */
+int deque_compare(const void *c1, const void *c2) {
+    deque *d1 = NULL;
+    deque *d2 = NULL;
+
+    iterator it1;
+    iterator it2;
+
+    int delta = 0;
+
+    massert_container(c1);
+    massert_container(c2);
+
+    d1 = *(deque **)(c1);
+    d2 = *(deque **)(c2);
+
+    if (d1->ttbl->compare != d2->ttbl->compare || d1->ttbl->compare == NULL) {
+        return -1;
+    }
+
+    it1 = d_begin(d1);
+    it2 = d_begin(d2);
+
+    while (dqi_has_next(it1) && dqi_has_next(it2)) {
+        if ((delta = d1->ttbl->compare(dqi_curr(it1), dqi_curr(it2))) != 0) {
+            return delta;
+        }
+
+        dqi_incr(&it1);
+        dqi_incr(&it2);
+    }
+
+    return (int)(d1->size) - (int)(d2->size);
+}
+
+/**
+ *  @brief  Wrapper function for a struct typetable
+ *
+ *  @param[in]  arg     address of a deque pointer
+ *  @param[in]  dest    file stream (e.g. stdout, stderr, a file)
+ */
+void deque_print(const void *arg, FILE *dest) {
+    deque *d = NULL;
+
+    massert_container(arg);
+    massert_ptr(dest);
+
+    d = *(deque **)(arg);
+    d_fputs(d, dest);
+}
+
+/**
+ *  @brief  Retrieves typetable used by d
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  @return     pointer to typetable
+ */
+struct typetable *d_get_ttbl(deque *d) {
+    massert_container(d);
+    return d->ttbl;
+}
+
+/**
+ *  @brief  Calls malloc to allocate memory for a pointer to deque
+ *
+ *  @return     pointer to deque
+ */
+static deque *d_allocate(void) {
+    deque *d = NULL;
+    d = malloc(sizeof *d);
+    return d;
+}
+
+/**
+ *  @brief  "Constructor" function, initializes deque
+ *
+ *  @param[in]  d       pointer to deque
+ *  @param[in]  ttbl    pointer to typetable; width/copy/dtor/swap/compare/print
+ *
+ *  One chunk is allocated in the middle of the map, and the (empty)
+ *  deque starts in the middle of that chunk -- so the first pushes at
+ *  either end need not allocate.
+ */
+static void d_init(deque *d, struct typetable *ttbl) {
+    massert_container(d);
+
+    d->ttbl = ttbl ? ttbl : _void_ptr_;
+
+    d->chunk_length = DEQUE_CHUNK_SIZE / d->ttbl->width;
+    d->chunk_length = d->chunk_length > 0 ? d->chunk_length : 1;
+    d->size = 0;
+
+    d->impl.map_size = DEQUE_INITIAL_MAP_SIZE;
+    d->impl.map = calloc(d->impl.map_size, sizeof *d->impl.map);
+    massert_calloc(d->impl.map);
+
+    d->impl.start.node = d->impl.map + (d->impl.map_size / 2);
+    *d->impl.start.node = d_chunk_allocate(d);
+    d->impl.start.curr = *d->impl.start.node + ((d->chunk_length / 2) * d->ttbl->width);
+
+    d->impl.finish = d->impl.start;
+}
+
+/**
+ *  @brief  "Destructor" function, deinitializes deque
+ *
+ *  @param[in]  d   pointer to deque
+ */
+static void d_deinit(deque *d) {
+    if (d == NULL) {
+        return;
+    }
+
+    d_clear(d);
+
+    d_chunk_free(*d->impl.start.node);
+
+    free(d->impl.map);
+    d->impl.map = NULL;
+    d->impl.map_size = 0;
+
+    d->ttbl = NULL;
+}
+
+/**
+ *  @brief  Allocates a zeroed chunk (preceded by its header) for d
+ *
+ *  @param[in]  d   pointer to deque
+ *
+ *  @return     address of the chunk's first element
+ */
+static char *d_chunk_allocate(deque *d) {
+    union deque_chunk_header *header = NULL;
+
+    header = calloc(1, sizeof *header + CHUNK_BYTES(d));
+    massert_calloc(header);
+
+    header->owner = d;
+    return (char *)(header + 1);
+}
+
+/**
+ *  @brief  Releases a chunk allocated by d_chunk_allocate
+ *
+ *  @param[in]  chunk   address of the chunk's first element
+ */
+static void d_chunk_free(char *chunk) {
+    if (chunk) {
+        free(CHUNK_HEADER(chunk));
+    }
+}
+
+/**
+ *  @brief  Ensures the map has nodes_to_add free slots
+ *          before start.node (at_front) or after finish.node
+ *
+ *  @param[in]  d               pointer to deque
+ *  @param[in]  nodes_to_add    number of free slots required
+ *  @param[in]  at_front        true for the front, false for the rear
+ *
+ *  If the map is at least twice the size of the nodes in use,
+ *  the nodes are recentered within it; otherwise a larger map
+ *  is allocated. Only chunk addresses move -- never elements.
+ */
+static void d_reserve_map(deque *d, size_t nodes_to_add, bool at_front) {
+    size_t old_nodes = 0;
+    size_t new_nodes = 0;
+    size_t new_map_size = 0;
+
+    char **new_start = NULL;
+    char **new_map = NULL;
+
+    if (at_front) {
+        if (nodes_to_add <= (size_t)(d->impl.start.node - d->impl.map)) {
+            return;
+        }
+    } else {
+        if (nodes_to_add < d->impl.map_size - (size_t)(d->impl.finish.node - d->impl.map)) {
+            return;
+        }
+    }
+
+    old_nodes = (d->impl.finish.node - d->impl.start.node) + 1;
+    new_nodes = old_nodes + nodes_to_add;
+
+    if (d->impl.map_size > 2 * new_nodes) {
+        /* recenter the nodes within the existing map */
+        new_start = d->impl.map + ((d->impl.map_size - new_nodes) / 2)
+                    + (at_front ? nodes_to_add : 0);
+
+        memmove(new_start, d->impl.start.node, old_nodes * sizeof *new_start);
+
+        /* slots vacated by the move are cleared */
+        if (new_start < d->impl.start.node) {
+            memset(new_start + old_nodes, 0,
+                   (d->impl.start.node - new_start) * sizeof *new_start);
+        } else {
+            memset(d->impl.start.node, 0,
+                   (new_start - d->impl.start.node) * sizeof *new_start);
+        }
+    } else {
+        new_map_size = d->impl.map_size + (d->impl.map_size > nodes_to_add ? d->impl.map_size : nodes_to_add) + 2;
+
+        new_map = calloc(new_map_size, sizeof *new_map);
+        massert_calloc(new_map);
+
+        new_start = new_map + ((new_map_size - new_nodes) / 2)
+                    + (at_front ? nodes_to_add : 0);
+
+        memcpy(new_start, d->impl.start.node, old_nodes * sizeof *new_start);
+
+        free(d->impl.map);
+        d->impl.map = new_map;
+        d->impl.map_size = new_map_size;
+    }
+
+    d->impl.start.node = new_start;
+    d->impl.finish.node = new_start + (old_nodes - 1);
+}
+
+/**
+ *  @brief  Copies valaddr into dst, as per d's typetable
+ *
+ *  @param[in]  d       pointer to deque
+ *  @param[out] dst     address of a block within a chunk of d
+ *  @param[in]  valaddr address of element to be copied
+ */
+static void d_copy_in(deque *d, void *dst, const void *valaddr) {
+    if (d->ttbl->copy) {
+        /* if copy fn defined in ttbl, deep copy */
+        d->ttbl->copy(dst, valaddr);
+    } else {
+        /* if no copy defined in ttbl, shallow copy */
+        memcpy(dst, valaddr, d->ttbl->width);
+    }
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     address of a map slot (node) of a deque
+ *
+ *  @return     iterator at the deque's front element
+ */
+static iterator dqi_begin(void *arg) {
+    deque *d = CHUNK_OWNER((char **)(arg));
+    iterator it;
+
+    it.itbl = _deque_iterator_;
+    it.container = d->impl.start.node;
+    it.curr = d->impl.start.curr;
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     address of a map slot (node) of a deque
+ *
+ *  @return     iterator one block past the deque's rear element
+ */
+static iterator dqi_end(void *arg) {
+    deque *d = CHUNK_OWNER((char **)(arg));
+    iterator it;
+
+    it.itbl = _deque_iterator_;
+    it.container = d->impl.finish.node;
+    it.curr = d->impl.finish.curr;
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that
+ *          is one block past it's current position
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *
+ *  @return     a new iterator that is one block past it's current position
+ */
+static iterator dqi_next(iterator it) {
+    iterator iter = it;
+    dqi_incr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that
+ *          is n blocks past it's current position
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *  @param[in]  n   number of blocks to move
+ *
+ *  @return     a new iterator that is n blocks past it's current position
+ */
+static iterator dqi_next_n(iterator it, int n) {
+    iterator iter = it;
+    dqi_advance(&iter, n);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that
+ *          is one block behind it's current position
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *
+ *  @return     a new iterator that is one block behind it's current position
+ */
+static iterator dqi_prev(iterator it) {
+    iterator iter = it;
+    dqi_decr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that
+ *          is n blocks behind it's current position
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *  @param[in]  n   number of blocks to move
+ *
+ *  @return     a new iterator that is n blocks behind it's current position
+ */
+static iterator dqi_prev_n(iterator it, int n) {
+    iterator iter = it;
+    dqi_advance(&iter, -n);
+    return iter;
+}
+
+/**
+ *  @brief  Determines the index of it within its deque
+ *
+ *  @param[in]  it  pointer to iterator that refers to a deque
+ *
+ *  @return     index of the element it refers to
+ */
+static int dqi_index(iterator *it) {
+    char **node = (char **)(it->container);
+    deque *d = CHUNK_OWNER(node);
+
+    return (int)(((node - d->impl.start.node) * d->chunk_length)
+                 + ptr_distance(*node, it->curr, d->ttbl->width)
+                 - ptr_distance(*d->impl.start.node, d->impl.start.curr, d->ttbl->width));
+}
+
+/**
+ *  @brief  Determines the distance between first and last numerically
+ *
+ *  @param[in]  first   pointer to iterator that refers to a deque
+ *  @param[in]  last    pointer to iterator that refers to a deque
+ *
+ *  @return     numerical distance between first and last
+ *
+ *  As with vector, leave one of the parameters NULL
+ *  to find the index position of the other.
+ */
+static int dqi_distance(iterator *first, iterator *last) {
+    if (first == NULL && last != NULL) {
+        return dqi_index(last);
+    } else if (last == NULL && first != NULL) {
+        return dqi_index(first);
+    } else if (first == NULL && last == NULL) {
+        ERROR(__FILE__, "Both iterator first and last are NULL.");
+        return 0;
+    } else {
+        return dqi_index(last) - dqi_index(first);
+    }
+}
+
+/**
+ *  @brief  Advances the position of it n blocks (n may be negative)
+ *
+ *  @param[in]  it  pointer to iterator that refers to a deque
+ *  @param[in]  n   desired amount of blocks to move
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *dqi_advance(iterator *it, int n) {
+    char **node = NULL;
+    deque *d = NULL;
+
+    int pos = 0;
+    int offset = 0;
+    int node_offset = 0;
+    int length = 0;
+
+    massert_iterator(it);
+
+    node = (char **)(it->container);
+    d = CHUNK_OWNER(node);
+    pos = dqi_index(it);
+
+    if ((pos + n) < 0 || (size_t)(pos + n) > d->size) {
+        char str[256];
+        sprintf(str, "Cannot advance %d times from position %d.", n, pos);
+        ERROR(__FILE__, str);
+        return it;
+    }
+
+    length = (int)(d->chunk_length);
+    offset = n + (int)(ptr_distance(*node, it->curr, d->ttbl->width));
+
+    if (offset >= 0 && offset < length) {
+        it->curr = (char *)(it->curr) + (n * (int)(d->ttbl->width));
+    } else {
+        node_offset = offset > 0 ? (offset / length) : -((-offset - 1) / length) - 1;
+
+        node += node_offset;
+        it->container = node;
+        it->curr = (*node) + ((offset - (node_offset * length)) * (int)(d->ttbl->width));
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Increments the position of it 1 block forward
+ *
+ *  @param[in]  it  pointer to iterator that refers to a deque
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *dqi_incr(iterator *it) {
+    char **node = NULL;
+    deque *d = NULL;
+
+    massert_iterator(it);
+
+    node = (char **)(it->container);
+    d = CHUNK_OWNER(node);
+
+    if (it->curr == d->impl.finish.curr) {
+        ERROR(__FILE__, "Cannot increment - already at end.");
+    } else {
+        it->curr = (char *)(it->curr) + (d->ttbl->width);
+
+        if (it->curr == (*node) + CHUNK_BYTES(d)) {
+            ++node;
+            it->container = node;
+            it->curr = *node;
+        }
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Decrements the position of it 1 block backward
+ *
+ *  @param[in]  it  pointer to iterator that refers to a deque
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *dqi_decr(iterator *it) {
+    char **node = NULL;
+    deque *d = NULL;
+
+    massert_iterator(it);
+
+    node = (char **)(it->container);
+    d = CHUNK_OWNER(node);
+
+    if (it->curr == d->impl.start.curr) {
+        ERROR(__FILE__, "Cannot decrement this iterator, already at begin.");
+    } else {
+        if (it->curr == *node) {
+            --node;
+            it->container = node;
+            it->curr = (*node) + CHUNK_BYTES(d);
+        }
+
+        it->curr = (char *)(it->curr) - (d->ttbl->width);
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Retrieves the address of the value referred to
+ *          by it's current position
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *
+ *  @return     address of an element from within a deque
+ */
+static void *dqi_curr(iterator it) {
+    return it.curr;
+}
+
+/**
+ *  @brief  Retrieves the address of the front element of the deque
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *
+ *  @return     address of the front element from within a deque
+ */
+static void *dqi_start(iterator it) {
+    deque *d = CHUNK_OWNER((char **)(it.container));
+    return d->impl.start.curr;
+}
+
+/**
+ *  @brief  Retrieves the address of the block one past
+ *          the rear element of the deque
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *
+ *  @return     address one block past the deque's rear element
+ */
+static void *dqi_finish(iterator it) {
+    deque *d = CHUNK_OWNER((char **)(it.container));
+    return d->impl.finish.curr;
+}
+
+/**
+ *  @brief  Determines if it has elements to visit in the forward direction
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *
+ *  @return     true if elements remain in the forward direction,
+ *              false otherwise
+ */
+static bool dqi_has_next(iterator it) {
+    deque *d = CHUNK_OWNER((char **)(it.container));
+    return it.curr != d->impl.finish.curr;
+}
+
+/**
+ *  @brief  Determines if it has elements to visit in the backward direction
+ *
+ *  @param[in]  it  iterator that refers to a deque
+ *
+ *  @return     true if elements remain in the backward direction,
+ *              false otherwise
+ */
+static bool dqi_has_prev(iterator it) {
+    deque *d = CHUNK_OWNER((char **)(it.container));
+    return it.curr != d->impl.start.curr;
+}
+
+/**
+ *  @brief  Retrieve a container's typetable
+ *
+ *  @param[in]  arg     address of a map slot (node) of a deque
+ *
+ *  @return     pointer to typetable
+ */
+static struct typetable *dqi_get_ttbl(void *arg) {
+    deque *d = CHUNK_OWNER((char **)(arg));
+    return d->ttbl;
+}
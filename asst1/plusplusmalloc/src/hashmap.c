@@ -0,0 +1,1379 @@
+/**
+ *  @file       hashmap.c
+ *  @brief      Source file for an unordered map/set ADT (open addressing)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       08 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "hashmap.h"
+#include "iterator.h"
+#include "utils.h"
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**< rounds N up to a multiple of the strictest alignment for key/value */
+#define HASHMAP_ALIGN(N)    ((((N) + sizeof(double) - 1) / sizeof(double)) * sizeof(double))
+
+/**< control bytes: empty/deleted have the sign bit set, full slots hold H2 */
+#define CTRL_EMPTY          ((signed char)(-128))
+#define CTRL_DELETED        ((signed char)(-2))
+
+/**< H1 selects the first group to probe, H2 is stored in the control byte */
+#define H1(HASH)            ((HASH) >> 7)
+#define H2(HASH)            ((signed char)((HASH) & 0x7f))
+
+#define SLOT_KEY(M, TB, I)  ((TB)->keys + ((I) * (M)->key_ttbl->width))
+#define SLOT_VAL(M, TB, I)  ((TB)->values + ((I) * (M)->val_ttbl->width))
+
+#define NOT_FOUND           ((size_t)(-1))
+
+/**
+ *  @struct     hashmap_table
+ *  @brief      Control bytes, keys, and values of one table
+ *
+ *  All three arrays share a single allocation (raw);
+ *  ctrl is aligned to HASHMAP_GROUP_WIDTH for group loads.
+ */
+struct hashmap_table {
+    signed char *ctrl;          /**< one control byte per slot */
+    char *keys;                 /**< capacity keys */
+    char *values;               /**< capacity values, or NULL (set) */
+
+    size_t capacity;            /**< slots, a power of two (>= group width) */
+    size_t count;               /**< full slots */
+    size_t growth_left;         /**< empty slots that may still be filled */
+
+    void *raw;                  /**< allocation holding ctrl/keys/values */
+};
+
+/**
+ *  @struct     hashmap
+ *  @brief      Represents an unordered map/set ADT
+ *
+ *  Note that struct hashmap is opaque.
+ */
+struct hashmap {
+    struct hashmap_table table; /**< current table -- inserts go here */
+    struct hashmap_table old;   /**< table being migrated (capacity 0 if none) */
+    size_t migrated;            /**< groups of old already moved into table */
+
+    struct typetable *key_ttbl; /**< key width, copy, dtor, compare, hash */
+    struct typetable *val_ttbl; /**< value width, copy, dtor, print -- or NULL */
+
+    bool strkeys;               /**< true if keys are (char *), compared directly */
+};
+
+static hashmap *hashmap_allocate(void);
+static void hashmap_init(hashmap *m, struct typetable *key_ttbl,
+                         struct typetable *val_ttbl, size_t capacity);
+static void hashmap_deinit(hashmap *m);
+
+static size_t hashmap_capacity_for(size_t n);
+static bool hashmap_key_equal(hashmap *m, const void *k1, const void *k2);
+static bool hashmap_str_equal(const void *s1, const void *s2);
+static void hashmap_assign(void *dst, const void *src, struct typetable *ttbl);
+static void hashmap_destroy(hashmap *m, struct hashmap_table *tb, size_t i);
+
+static void hashmap_rehash(hashmap *m, size_t capacity);
+static void hashmap_migrate(hashmap *m, size_t groups);
+
+static void *hashmap_slot(hashmap *m, size_t position);
+static size_t hashmap_position(hashmap *m, void *key);
+
+static unsigned int group_match(const signed char *ctrl, signed char h2);
+static unsigned int group_match_empty(const signed char *ctrl);
+static unsigned int group_match_free(const signed char *ctrl);
+static int group_first(unsigned int mask);
+
+static void table_init(hashmap *m, struct hashmap_table *tb, size_t capacity);
+static void table_free(struct hashmap_table *tb);
+static size_t table_find(hashmap *m, struct hashmap_table *tb, const void *key, size_t hash);
+static size_t table_claim(struct hashmap_table *tb, size_t hash);
+static void table_release(struct hashmap_table *tb, size_t i);
+
+static iterator hmi_begin(void *arg);
+static iterator hmi_end(void *arg);
+
+static iterator hmi_next(iterator it);
+static iterator hmi_next_n(iterator it, int n);
+
+static iterator hmi_prev(iterator it);
+static iterator hmi_prev_n(iterator it, int n);
+
+static int hmi_distance(iterator *first, iterator *last);
+
+static iterator *hmi_advance(iterator *it, int n);
+static iterator *hmi_incr(iterator *it);
+static iterator *hmi_decr(iterator *it);
+
+static void *hmi_curr(iterator it);
+static void *hmi_start(iterator it);
+static void *hmi_finish(iterator it);
+
+static bool hmi_has_next(iterator it);
+static bool hmi_has_prev(iterator it);
+
+static struct typetable *hmi_get_ttbl(void *arg);
+
+struct iterator_table itbl_hashmap = {
+    hmi_begin,
+    hmi_end,
+    hmi_next,
+    hmi_next_n,
+    hmi_prev,
+    hmi_prev_n,
+    hmi_advance,
+    hmi_incr,
+    hmi_decr,
+    hmi_curr,
+    hmi_start,
+    hmi_finish,
+    hmi_distance,
+    hmi_has_next,
+    hmi_has_prev,
+    hmi_get_ttbl
+};
+
+struct iterator_table *_hashmap_iterator_ = &itbl_hashmap;
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to hashmap
+ *
+ *  @param[in]  key_ttbl    typetable for keys (hash and compare are required)
+ *  @param[in]  val_ttbl    typetable for values, or NULL for a set
+ *
+ *  @return     pointer to hashmap
+ */
+hashmap *hashmap_new(struct typetable *key_ttbl, struct typetable *val_ttbl) {
+    return hashmap_newr(key_ttbl, val_ttbl, 0);
+}
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to hashmap,
+ *          with room for n keys
+ *
+ *  @param[in]  key_ttbl    typetable for keys (hash and compare are required)
+ *  @param[in]  val_ttbl    typetable for values, or NULL for a set
+ *  @param[in]  n           number of keys to hold without resizing
+ *
+ *  @return     pointer to hashmap
+ */
+hashmap *hashmap_newr(struct typetable *key_ttbl, struct typetable *val_ttbl, size_t n) {
+    hashmap *m = hashmap_allocate();                                    /* allocate */
+    hashmap_init(m, key_ttbl, val_ttbl, hashmap_capacity_for(n));      /* construct */
+    return m;                                                           /* return */
+}
+
+/**
+ *  @brief  Calls hashmap_deinit (hashmap's destructor)
+ *          and deallocates the pointer m
+ *
+ *  @param[out] m   address of a pointer to hashmap
+ */
+void hashmap_delete(hashmap **m) {
+    massert_container((*m));
+
+    hashmap_deinit((*m));
+
+    free((*m));
+    (*m) = NULL;
+}
+
+/**
+ *  @brief  Returns an iterator at the first full slot of m
+ *
+ *  @param[in]  m   pointer to hashmap
+ *
+ *  @return     iterator that refers to m
+ */
+iterator hashmap_begin(hashmap *m) {
+    massert_container(m);
+    return hmi_begin(m);
+}
+
+/**
+ *  @brief  Returns an iterator past the last full slot of m
+ *
+ *  @param[in]  m   pointer to hashmap
+ *
+ *  @return     iterator that refers to m
+ */
+iterator hashmap_end(hashmap *m) {
+    massert_container(m);
+    return hmi_end(m);
+}
+
+/**
+ *  @brief  Retrieves the address of the value at it's current position
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *
+ *  @return     address of the value, or NULL for a set/the end iterator
+ */
+void *hashmap_itvalue(iterator it) {
+    hashmap *m = (hashmap *)(it.container);
+    size_t position = 0;
+
+    if (it.curr == NULL || m->val_ttbl == NULL) {
+        return NULL;
+    }
+
+    position = hashmap_position(m, it.curr);
+
+    return position < m->old.capacity
+           ? SLOT_VAL(m, &m->old, position)
+           : SLOT_VAL(m, &m->table, position - m->old.capacity);
+}
+
+/**
+ *  @brief  Returns the number of keys in m
+ *
+ *  @param[in]  m   pointer to hashmap
+ *
+ *  @return     number of keys
+ */
+size_t hashmap_size(hashmap *m) {
+    massert_container(m);
+    return m->table.count + m->old.count;
+}
+
+/**
+ *  @brief  Returns the number of slots in m's (current) table
+ *
+ *  @param[in]  m   pointer to hashmap
+ *
+ *  @return     number of slots
+ */
+size_t hashmap_capacity(hashmap *m) {
+    massert_container(m);
+    return m->table.capacity;
+}
+
+/**
+ *  @brief  Determines if m has no keys
+ *
+ *  @param[in]  m   pointer to hashmap
+ *
+ *  @return     true if empty, false otherwise
+ */
+bool hashmap_empty(hashmap *m) {
+    massert_container(m);
+    return hashmap_size(m) == 0;
+}
+
+/**
+ *  @brief  Ensures m can hold n keys without resizing
+ *
+ *  @param[in]  m   pointer to hashmap
+ *  @param[in]  n   number of keys
+ *
+ *  Unlike growth by insertion, this rehashes every key immediately.
+ */
+void hashmap_reserve(hashmap *m, size_t n) {
+    size_t capacity = 0;
+
+    massert_container(m);
+
+    capacity = hashmap_capacity_for(n);
+
+    if (capacity > m->table.capacity) {
+        hashmap_rehash(m, capacity);
+    }
+
+    hashmap_migrate(m, (size_t)(-1));
+}
+
+/**
+ *  @brief  Searches m for key
+ *
+ *  @param[in]  m       pointer to hashmap
+ *  @param[in]  key     address of a key
+ *
+ *  @return     address of key's value (map), or of the stored key (set);
+ *              NULL if key is not found
+ */
+void *hashmap_find(hashmap *m, const void *key) {
+    struct hashmap_table *tb = NULL;
+    size_t hash = 0;
+    size_t i = 0;
+
+    massert_container(m);
+    massert_ptr(key);
+
+    hash = m->key_ttbl->hash(key);
+
+    tb = &m->table;
+    i = table_find(m, tb, key, hash);
+
+    if (i == NOT_FOUND && m->old.capacity > 0) {
+        /* not yet migrated */
+        tb = &m->old;
+        i = table_find(m, tb, key, hash);
+    }
+
+    if (i == NOT_FOUND) {
+        return NULL;
+    }
+
+    return m->val_ttbl ? SLOT_VAL(m, tb, i) : SLOT_KEY(m, tb, i);
+}
+
+/**
+ *  @brief  Determines if m contains key
+ *
+ *  @param[in]  m       pointer to hashmap
+ *  @param[in]  key     address of a key
+ *
+ *  @return     true if found, false otherwise
+ */
+bool hashmap_contains(hashmap *m, const void *key) {
+    return hashmap_find(m, key) != NULL;
+}
+
+/**
+ *  @brief  Inserts key (and value) into m
+ *
+ *  @param[in]  m       pointer to hashmap
+ *  @param[in]  key     address of a key
+ *  @param[in]  value   address of a value, or NULL (for a set)
+ *
+ *  If key is already present, its value is replaced.
+ */
+void hashmap_insert(hashmap *m, const void *key, const void *value) {
+    struct hashmap_table *tb = NULL;
+    size_t capacity = 0;
+    size_t hash = 0;
+    size_t i = 0;
+
+    massert_container(m);
+    massert_ptr(key);
+
+    hash = m->key_ttbl->hash(key);
+
+    hashmap_migrate(m, HASHMAP_MIGRATE_GROUPS);
+
+    tb = &m->table;
+    i = table_find(m, tb, key, hash);
+
+    if (i == NOT_FOUND && m->old.capacity > 0) {
+        tb = &m->old;
+        i = table_find(m, tb, key, hash);
+    }
+
+    if (i != NOT_FOUND) {
+        /* key exists (no duplicates allowed) -- value is replaced */
+        if (m->val_ttbl && value) {
+            if (m->val_ttbl->dtor) {
+                m->val_ttbl->dtor(SLOT_VAL(m, tb, i));
+            }
+
+            hashmap_assign(SLOT_VAL(m, tb, i), value, m->val_ttbl);
+        }
+
+        return;
+    }
+
+    if (m->table.growth_left == 0) {
+        /**
+         *  Double, unless at least half of the full/deleted slots
+         *  are deleted -- then a same-sized table clears the tombstones.
+         */
+        capacity = m->table.capacity;
+        capacity *= hashmap_size(m) > (capacity / 16) * 7 ? 2 : 1;
+
+        hashmap_rehash(m, capacity);
+    }
+
+    tb = &m->table;
+    i = table_claim(tb, hash);
+
+    hashmap_assign(SLOT_KEY(m, tb, i), key, m->key_ttbl);
+
+    if (m->val_ttbl) {
+        if (value) {
+            hashmap_assign(SLOT_VAL(m, tb, i), value, m->val_ttbl);
+        } else {
+            memset(SLOT_VAL(m, tb, i), 0, m->val_ttbl->width);
+        }
+    }
+}
+
+/**
+ *  @brief  Removes key (and its value) from m
+ *
+ *  @param[in]  m       pointer to hashmap
+ *  @param[in]  key     address of a key
+ *
+ *  No-op if key is not found.
+ */
+void hashmap_erase(hashmap *m, const void *key) {
+    struct hashmap_table *tb = NULL;
+    size_t hash = 0;
+    size_t i = 0;
+
+    massert_container(m);
+    massert_ptr(key);
+
+    hash = m->key_ttbl->hash(key);
+
+    hashmap_migrate(m, HASHMAP_MIGRATE_GROUPS);
+
+    tb = &m->table;
+    i = table_find(m, tb, key, hash);
+
+    if (i == NOT_FOUND && m->old.capacity > 0) {
+        tb = &m->old;
+        i = table_find(m, tb, key, hash);
+    }
+
+    if (i == NOT_FOUND) {
+        return;
+    }
+
+    hashmap_destroy(m, tb, i);
+    table_release(tb, i);
+}
+
+/**
+ *  @brief  Removes all keys (and values) from m
+ *
+ *  @param[in]  m   pointer to hashmap
+ *
+ *  The (current) table's capacity is retained.
+ */
+void hashmap_clear(hashmap *m) {
+    size_t capacity = 0;
+
+    massert_container(m);
+
+    capacity = m->table.capacity;
+
+    hashmap_deinit(m);
+    table_init(m, &m->table, capacity);
+}
+
+/**
+ *  @brief  Prints a diagnostic of hashmap to stdout
+ *
+ *  @param[in]  m   pointer to hashmap
+ */
+void hashmap_puts(hashmap *m) {
+    hashmap_fputs(m, stdout);
+}
+
+/**
+ *  @brief  Prints a diagnostic of hashmap to file stream dest
+ *
+ *  @param[in]  m       pointer to hashmap
+ *  @param[in]  dest    file stream (e.g stdout, stderr, a file)
+ */
+void hashmap_fputs(hashmap *m, FILE *dest) {
+    const char *link = "---------------------------";
+    iterator it;
+
+    massert_container(m);
+    massert_ptr(dest);
+
+    fprintf(dest, "\n%s\n%s\n%s\n", link, "Hashmap Elements", link);
+
+    for (it = hmi_begin(m); hmi_has_next(it); hmi_incr(&it)) {
+        fprintf(dest, "[");
+
+        if (m->key_ttbl->print) {
+            m->key_ttbl->print(it.curr, dest);
+        } else {
+            fprintf(dest, "%p", it.curr);
+        }
+
+        fprintf(dest, "]");
+
+        if (m->val_ttbl) {
+            fprintf(dest, " => ");
+
+            if (m->val_ttbl->print) {
+                m->val_ttbl->print(hashmap_itvalue(it), dest);
+            } else {
+                fprintf(dest, "%p", hashmap_itvalue(it));
+            }
+        }
+
+        fprintf(dest, "\n");
+    }
+
+    fprintf(dest, "\n%s\n%s\t\t%lu\n%s\t\t%lu\n%s\t\t%lu\n%s\n", link,
+            "Size         ", hashmap_size(m),
+            "Capacity     ", m->table.capacity,
+            "Migrating    ", m->old.count,
+            link);
+}
+
+/**
+ *  @brief  Retrieves the key typetable used by m
+ *
+ *  @param[in]  m   pointer to hashmap
+ *
+ *  @return     pointer to typetable
+ */
+struct typetable *hashmap_get_key_ttbl(hashmap *m) {
+    massert_container(m);
+    return m->key_ttbl;
+}
+
+/**
+ *  @brief  Retrieves the value typetable used by m
+ *
+ *  @param[in]  m   pointer to hashmap
+ *
+ *  @return     pointer to typetable, NULL if m is a set
+ */
+struct typetable *hashmap_get_val_ttbl(hashmap *m) {
+    massert_container(m);
+    return m->val_ttbl;
+}
+
+/**
+ *  @brief  Calls malloc to allocate memory for a pointer to hashmap
+ *
+ *  @return     pointer to hashmap
+ */
+static hashmap *hashmap_allocate(void) {
+    hashmap *m = NULL;
+    m = malloc(sizeof *m);
+    return m;
+}
+
+/**
+ *  @brief  "Constructor" function, initializes hashmap
+ *
+ *  @param[in]  m           pointer to hashmap
+ *  @param[in]  key_ttbl    typetable for keys
+ *  @param[in]  val_ttbl    typetable for values, or NULL
+ *  @param[in]  capacity    initial number of slots
+ */
+static void hashmap_init(hashmap *m, struct typetable *key_ttbl,
+                         struct typetable *val_ttbl, size_t capacity) {
+    compare_fn compare = NULL;
+
+    massert_container(m);
+    massert_ptr(key_ttbl);
+
+    m->key_ttbl = key_ttbl;
+    m->val_ttbl = val_ttbl;
+
+    if (m->key_ttbl->hash == NULL || m->key_ttbl->compare == NULL) {
+        ERROR(__FILE__, "hashmap requires a key typetable with hash and compare functions.");
+    }
+
+    compare = m->key_ttbl->compare;
+    m->strkeys = compare == str_compare || compare == cstr_compare
+              || compare == char_ptr_compare;
+
+    m->old.capacity = 0;
+    m->old.count = 0;
+    m->old.raw = NULL;
+    m->migrated = 0;
+
+    table_init(m, &m->table, capacity);
+}
+
+/**
+ *  @brief  "Destructor" function, deinitializes hashmap
+ *
+ *  @param[in]  m   pointer to hashmap
+ */
+static void hashmap_deinit(hashmap *m) {
+    size_t i = 0;
+
+    if (m == NULL) {
+        return;
+    }
+
+    for (i = 0; i < m->old.capacity; i++) {
+        if (m->old.ctrl[i] >= 0) {
+            hashmap_destroy(m, &m->old, i);
+        }
+    }
+
+    for (i = 0; i < m->table.capacity; i++) {
+        if (m->table.ctrl[i] >= 0) {
+            hashmap_destroy(m, &m->table, i);
+        }
+    }
+
+    table_free(&m->old);
+    table_free(&m->table);
+
+    m->migrated = 0;
+}
+
+/**
+ *  @brief  Determines the number of slots required to hold n keys
+ *
+ *  @param[in]  n   number of keys
+ *
+ *  @return     a power of two, at least HASHMAP_GROUP_WIDTH,
+ *              at most 7/8 full with n keys
+ */
+static size_t hashmap_capacity_for(size_t n) {
+    size_t capacity = HASHMAP_GROUP_WIDTH;
+
+    while (capacity - (capacity / 8) < n) {
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
+/**
+ *  @brief  Determines if k1 and k2 are equal keys
+ *
+ *  @param[in]  m   pointer to hashmap
+ *  @param[in]  k1  address of a key
+ *  @param[in]  k2  address of a key
+ *
+ *  @return     true if equal, false otherwise
+ */
+static bool hashmap_key_equal(hashmap *m, const void *k1, const void *k2) {
+    if (m->strkeys) {
+        return hashmap_str_equal(k1, k2);
+    }
+
+    return m->key_ttbl->compare(k1, k2) == 0;
+}
+
+/**
+ *  @brief  Fast path for (char *) keys -- equivalent to str_compare == 0
+ *
+ *  @param[in]  s1  address of a (char *)
+ *  @param[in]  s2  address of a (char *)
+ *
+ *  @return     true if equal, false otherwise
+ *
+ *  Like str_compare (and str_hash), leading/trailing ESC_CHARS are ignored,
+ *  but the spans are compared in place rather than trimmed copies.
+ */
+static bool hashmap_str_equal(const void *s1, const void *s2) {
+    const char *first1 = *(char **)(s1);
+    const char *first2 = *(char **)(s2);
+    const char *last1 = NULL;
+    const char *last2 = NULL;
+
+    if (first1 == first2) {
+        return true;
+    }
+
+    last1 = first1 + strlen(first1);
+    last2 = first2 + strlen(first2);
+
+    while (first1 < last1 && strchr(ESC_CHARS, *first1) != NULL) {
+        ++first1;
+    }
+
+    while (last1 > first1 && strchr(ESC_CHARS, *(last1 - 1)) != NULL) {
+        --last1;
+    }
+
+    while (first2 < last2 && strchr(ESC_CHARS, *first2) != NULL) {
+        ++first2;
+    }
+
+    while (last2 > first2 && strchr(ESC_CHARS, *(last2 - 1)) != NULL) {
+        --last2;
+    }
+
+    return (last1 - first1) == (last2 - first2)
+        && memcmp(first1, first2, last1 - first1) == 0;
+}
+
+/**
+ *  @brief  Copies src into dst, as per ttbl
+ *
+ *  @param[out] dst     address of a key/value within a table
+ *  @param[in]  src     address of a key/value
+ *  @param[in]  ttbl    typetable of the key/value
+ */
+static void hashmap_assign(void *dst, const void *src, struct typetable *ttbl) {
+    if (ttbl->copy) {
+        /* if copy fn defined in ttbl, deep copy */
+        ttbl->copy(dst, src);
+    } else {
+        /* if no copy defined in ttbl, shallow copy */
+        memcpy(dst, src, ttbl->width);
+    }
+}
+
+/**
+ *  @brief  Destroys the key (and value) at slot i of tb, as per typetables
+ *
+ *  @param[in]  m   pointer to hashmap
+ *  @param[in]  tb  table holding the slot
+ *  @param[in]  i   index of a full slot
+ */
+static void hashmap_destroy(hashmap *m, struct hashmap_table *tb, size_t i) {
+    if (m->key_ttbl->dtor) {
+        m->key_ttbl->dtor(SLOT_KEY(m, tb, i));
+    }
+
+    if (m->val_ttbl && m->val_ttbl->dtor) {
+        m->val_ttbl->dtor(SLOT_VAL(m, tb, i));
+    }
+}
+
+/**
+ *  @brief  Begins migrating m into a new table with the given capacity
+ *
+ *  @param[in]  m           pointer to hashmap
+ *  @param[in]  capacity    number of slots of the new table
+ *
+ *  A migration already in progress is completed first.
+ */
+static void hashmap_rehash(hashmap *m, size_t capacity) {
+    hashmap_migrate(m, (size_t)(-1));
+
+    m->old = m->table;
+    m->migrated = 0;
+
+    table_init(m, &m->table, capacity);
+
+    if (m->old.count == 0) {
+        table_free(&m->old);
+    }
+}
+
+/**
+ *  @brief  Moves up to groups groups of keys from the old table
+ *
+ *  @param[in]  m       pointer to hashmap
+ *  @param[in]  groups  number of groups to move ((size_t)(-1) for all)
+ *
+ *  Keys/values are moved (memcpy), not copied -- the old slots become
+ *  deleted (not empty), so that keys probed past them are still found.
+ */
+static void hashmap_migrate(hashmap *m, size_t groups) {
+    struct hashmap_table *old = &m->old;
+    size_t first = 0;
+    size_t hash = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    while (groups-- > 0 && old->capacity > 0) {
+        first = m->migrated * HASHMAP_GROUP_WIDTH;
+
+        for (i = first; i < first + HASHMAP_GROUP_WIDTH; i++) {
+            if (old->ctrl[i] < 0) {
+                continue;
+            }
+
+            hash = m->key_ttbl->hash(SLOT_KEY(m, old, i));
+            j = table_claim(&m->table, hash);
+
+            memcpy(SLOT_KEY(m, &m->table, j), SLOT_KEY(m, old, i), m->key_ttbl->width);
+
+            if (m->val_ttbl) {
+                memcpy(SLOT_VAL(m, &m->table, j), SLOT_VAL(m, old, i), m->val_ttbl->width);
+            }
+
+            old->ctrl[i] = CTRL_DELETED;
+            --old->count;
+        }
+
+        ++m->migrated;
+
+        if (old->count == 0 || m->migrated * HASHMAP_GROUP_WIDTH == old->capacity) {
+            table_free(old);
+            m->migrated = 0;
+        }
+    }
+}
+
+/**
+ *  @brief  Retrieves the key at a position (old table first, then table)
+ *
+ *  @param[in]  m           pointer to hashmap
+ *  @param[in]  position    index across both tables
+ *
+ *  @return     address of the key, NULL if the slot is not full
+ */
+static void *hashmap_slot(hashmap *m, size_t position) {
+    struct hashmap_table *tb = &m->old;
+
+    if (position >= m->old.capacity) {
+        position -= m->old.capacity;
+        tb = &m->table;
+    }
+
+    return tb->ctrl[position] >= 0 ? SLOT_KEY(m, tb, position) : NULL;
+}
+
+/**
+ *  @brief  Determines the position of a key's slot (see hashmap_slot)
+ *
+ *  @param[in]  m       pointer to hashmap
+ *  @param[in]  key     address of a key within m, or NULL (the end)
+ *
+ *  @return     index across both tables
+ */
+static size_t hashmap_position(hashmap *m, void *key) {
+    char *k = (char *)(key);
+
+    if (k == NULL) {
+        return m->old.capacity + m->table.capacity;
+    } else if (m->old.capacity > 0 && k >= m->old.keys
+               && k < m->old.keys + (m->old.capacity * m->key_ttbl->width)) {
+        return (k - m->old.keys) / m->key_ttbl->width;
+    }
+
+    return m->old.capacity + ((k - m->table.keys) / m->key_ttbl->width);
+}
+
+/**
+ *  @brief  Determines which slots of a group hold h2
+ *
+ *  @param[in]  ctrl    address of a group's control bytes
+ *  @param[in]  h2      seven bits of a hash
+ *
+ *  @return     bitmask, bit i set if slot i matches
+ */
+static unsigned int group_match(const signed char *ctrl, signed char h2) {
+#if defined(__SSE2__)
+    __m128i group = _mm_load_si128((const __m128i *)(ctrl));
+    return (unsigned int)(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2))));
+#else
+    unsigned int mask = 0;
+    int i = 0;
+
+    for (i = 0; i < HASHMAP_GROUP_WIDTH; i++) {
+        mask |= (unsigned int)(ctrl[i] == h2) << i;
+    }
+
+    return mask;
+#endif
+}
+
+/**
+ *  @brief  Determines which slots of a group are empty
+ *
+ *  @param[in]  ctrl    address of a group's control bytes
+ *
+ *  @return     bitmask, bit i set if slot i is empty
+ */
+static unsigned int group_match_empty(const signed char *ctrl) {
+    return group_match(ctrl, CTRL_EMPTY);
+}
+
+/**
+ *  @brief  Determines which slots of a group are empty or deleted
+ *
+ *  @param[in]  ctrl    address of a group's control bytes
+ *
+ *  @return     bitmask, bit i set if slot i may be claimed
+ */
+static unsigned int group_match_free(const signed char *ctrl) {
+#if defined(__SSE2__)
+    /* empty and deleted are the only control bytes with the sign bit set */
+    __m128i group = _mm_load_si128((const __m128i *)(ctrl));
+    return (unsigned int)(_mm_movemask_epi8(group));
+#else
+    unsigned int mask = 0;
+    int i = 0;
+
+    for (i = 0; i < HASHMAP_GROUP_WIDTH; i++) {
+        mask |= (unsigned int)(ctrl[i] < 0) << i;
+    }
+
+    return mask;
+#endif
+}
+
+/**
+ *  @brief  Index of the lowest set bit of mask (mask must be nonzero)
+ *
+ *  @param[in]  mask    bitmask from a group_match function
+ *
+ *  @return     index of the lowest set bit
+ */
+static int group_first(unsigned int mask) {
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int i = 0;
+
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++i;
+    }
+
+    return i;
+#endif
+}
+
+/**
+ *  @brief  Allocates an empty table
+ *
+ *  @param[in]  m           pointer to hashmap
+ *  @param[out] tb          table to initialize
+ *  @param[in]  capacity    number of slots (a power of two, >= group width)
+ */
+static void table_init(hashmap *m, struct hashmap_table *tb, size_t capacity) {
+    size_t keys_size = HASHMAP_ALIGN(capacity * m->key_ttbl->width);
+    size_t vals_size = m->val_ttbl ? capacity * m->val_ttbl->width : 0;
+    char *base = NULL;
+
+    tb->raw = malloc(HASHMAP_GROUP_WIDTH + capacity + keys_size + vals_size);
+    massert_malloc(tb->raw);
+
+    /* control bytes are aligned for group loads; keys follow them */
+    base = (char *)(tb->raw) + HASHMAP_GROUP_WIDTH
+         - ((size_t)(tb->raw) % HASHMAP_GROUP_WIDTH);
+
+    tb->ctrl = (signed char *)(base);
+    tb->keys = base + capacity;
+    tb->values = m->val_ttbl ? tb->keys + keys_size : NULL;
+
+    memset(tb->ctrl, CTRL_EMPTY, capacity);
+
+    tb->capacity = capacity;
+    tb->count = 0;
+    tb->growth_left = capacity - (capacity / 8);
+}
+
+/**
+ *  @brief  Frees a table's storage (its keys/values must be destroyed
+ *          or moved beforehand)
+ *
+ *  @param[out] tb  table to free
+ */
+static void table_free(struct hashmap_table *tb) {
+    free(tb->raw);
+
+    tb->raw = NULL;
+    tb->ctrl = NULL;
+    tb->keys = NULL;
+    tb->values = NULL;
+
+    tb->capacity = 0;
+    tb->count = 0;
+    tb->growth_left = 0;
+}
+
+/**
+ *  @brief  Searches tb for key
+ *
+ *  @param[in]  m       pointer to hashmap
+ *  @param[in]  tb      table to search
+ *  @param[in]  key     address of a key
+ *  @param[in]  hash    key's hash
+ *
+ *  @return     index of key's slot, NOT_FOUND if absent
+ *
+ *  Groups are probed in triangular order (g, g + 1, g + 3, g + 6, ...),
+ *  which visits every group when the group count is a power of two.
+ *  A group with an empty slot ends the search -- insertion would have
+ *  used that slot, had key been probed past it.
+ */
+static size_t table_find(hashmap *m, struct hashmap_table *tb, const void *key, size_t hash) {
+    size_t groups = tb->capacity / HASHMAP_GROUP_WIDTH;
+    size_t g = H1(hash) & (groups - 1);
+    signed char h2 = H2(hash);
+    unsigned int mask = 0;
+    size_t stride = 0;
+    size_t i = 0;
+
+    for (stride = 0; stride < groups; stride++) {
+        mask = group_match(tb->ctrl + (g * HASHMAP_GROUP_WIDTH), h2);
+
+        while (mask != 0) {
+            i = (g * HASHMAP_GROUP_WIDTH) + group_first(mask);
+
+            if (hashmap_key_equal(m, key, SLOT_KEY(m, tb, i))) {
+                return i;
+            }
+
+            mask &= mask - 1;
+        }
+
+        if (group_match_empty(tb->ctrl + (g * HASHMAP_GROUP_WIDTH)) != 0) {
+            break;
+        }
+
+        g = (g + stride + 1) & (groups - 1);
+    }
+
+    return NOT_FOUND;
+}
+
+/**
+ *  @brief  Claims the first empty/deleted slot along hash's probe sequence
+ *
+ *  @param[in]  tb      table with growth_left > 0
+ *  @param[in]  hash    hash of the key to be stored
+ *
+ *  @return     index of the claimed slot (marked full)
+ */
+static size_t table_claim(struct hashmap_table *tb, size_t hash) {
+    size_t groups = tb->capacity / HASHMAP_GROUP_WIDTH;
+    size_t g = H1(hash) & (groups - 1);
+    unsigned int mask = 0;
+    size_t stride = 0;
+    size_t i = 0;
+
+    for (stride = 0; ; stride++) {
+        mask = group_match_free(tb->ctrl + (g * HASHMAP_GROUP_WIDTH));
+
+        if (mask != 0) {
+            break;
+        }
+
+        g = (g + stride + 1) & (groups - 1);
+    }
+
+    i = (g * HASHMAP_GROUP_WIDTH) + group_first(mask);
+
+    if (tb->ctrl[i] == CTRL_EMPTY) {
+        --tb->growth_left;
+    }
+
+    tb->ctrl[i] = H2(hash);
+    ++tb->count;
+
+    return i;
+}
+
+/**
+ *  @brief  Marks slot i of tb as no longer full
+ *
+ *  @param[in]  tb  table holding the slot
+ *  @param[in]  i   index of a full slot
+ *
+ *  If i's group already has an empty slot, no probe sequence continues
+ *  past this group, so i may become empty (and reusable by growth);
+ *  otherwise, it must become deleted.
+ */
+static void table_release(struct hashmap_table *tb, size_t i) {
+    size_t g = i / HASHMAP_GROUP_WIDTH;
+
+    if (group_match_empty(tb->ctrl + (g * HASHMAP_GROUP_WIDTH)) != 0) {
+        tb->ctrl[i] = CTRL_EMPTY;
+        ++tb->growth_left;
+    } else {
+        tb->ctrl[i] = CTRL_DELETED;
+    }
+
+    --tb->count;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     pointer to hashmap
+ *
+ *  @return     iterator at the first full slot
+ */
+static iterator hmi_begin(void *arg) {
+    hashmap *m = (hashmap *)(arg);
+    size_t total = m->old.capacity + m->table.capacity;
+    size_t position = 0;
+    iterator it;
+
+    it.itbl = _hashmap_iterator_;
+    it.container = m;
+    it.curr = NULL;
+
+    for (position = 0; position < total && it.curr == NULL; position++) {
+        it.curr = hashmap_slot(m, position);
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     pointer to hashmap
+ *
+ *  @return     iterator past the last full slot (its element is NULL)
+ */
+static iterator hmi_end(void *arg) {
+    iterator it;
+
+    it.itbl = _hashmap_iterator_;
+    it.container = arg;
+    it.curr = NULL;
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator at the next full slot
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *
+ *  @return     a new iterator
+ */
+static iterator hmi_next(iterator it) {
+    iterator iter = it;
+    hmi_incr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator n full slots past it
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *  @param[in]  n   number of keys to move
+ *
+ *  @return     a new iterator
+ */
+static iterator hmi_next_n(iterator it, int n) {
+    iterator iter = it;
+    hmi_advance(&iter, n);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator at the previous full slot
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *
+ *  @return     a new iterator
+ */
+static iterator hmi_prev(iterator it) {
+    iterator iter = it;
+    hmi_decr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator n full slots behind it
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *  @param[in]  n   number of keys to move
+ *
+ *  @return     a new iterator
+ */
+static iterator hmi_prev_n(iterator it, int n) {
+    iterator iter = it;
+    hmi_advance(&iter, -n);
+    return iter;
+}
+
+/**
+ *  @brief  Determines the distance between first and last numerically
+ *
+ *  @param[in]  first   pointer to iterator that refers to a hashmap
+ *  @param[in]  last    pointer to iterator that refers to a hashmap
+ *
+ *  @return     number of keys between first and last
+ */
+static int hmi_distance(iterator *first, iterator *last) {
+    hashmap *m = NULL;
+    size_t from = 0;
+    size_t to = 0;
+    int delta = 0;
+
+    if (first == NULL && last == NULL) {
+        ERROR(__FILE__, "Both iterator first and last are NULL.");
+        return 0;
+    } else if (first == NULL || last == NULL) {
+        last = last ? last : first;
+        m = (hashmap *)(last->container);
+        from = 0;
+    } else {
+        m = (hashmap *)(first->container);
+        from = hashmap_position(m, first->curr);
+    }
+
+    to = hashmap_position(m, last->curr);
+
+    for (; from < to; from++) {
+        delta += hashmap_slot(m, from) != NULL ? 1 : 0;
+    }
+
+    return delta;
+}
+
+/**
+ *  @brief  Advances the position of it n keys (n may be negative)
+ *
+ *  @param[in]  it  pointer to iterator that refers to a hashmap
+ *  @param[in]  n   desired amount of keys to move
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *hmi_advance(iterator *it, int n) {
+    massert_iterator(it);
+
+    while (n > 0) {
+        hmi_incr(it);
+        --n;
+    }
+
+    while (n < 0) {
+        hmi_decr(it);
+        ++n;
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Moves it to the next full slot
+ *
+ *  @param[in]  it  pointer to iterator that refers to a hashmap
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *hmi_incr(iterator *it) {
+    hashmap *m = NULL;
+    size_t total = 0;
+    size_t position = 0;
+
+    massert_iterator(it);
+
+    m = (hashmap *)(it->container);
+
+    if (it->curr == NULL) {
+        ERROR(__FILE__, "Cannot increment - already at end.");
+        return it;
+    }
+
+    total = m->old.capacity + m->table.capacity;
+    position = hashmap_position(m, it->curr);
+
+    it->curr = NULL;
+
+    for (++position; position < total && it->curr == NULL; position++) {
+        it->curr = hashmap_slot(m, position);
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Moves it to the previous full slot
+ *
+ *  @param[in]  it  pointer to iterator that refers to a hashmap
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *hmi_decr(iterator *it) {
+    hashmap *m = NULL;
+    size_t position = 0;
+    void *curr = NULL;
+
+    massert_iterator(it);
+
+    m = (hashmap *)(it->container);
+    position = hashmap_position(m, it->curr);
+
+    while (position > 0 && curr == NULL) {
+        curr = hashmap_slot(m, --position);
+    }
+
+    if (curr == NULL) {
+        ERROR(__FILE__, "Cannot decrement this iterator, already at begin.");
+    } else {
+        it->curr = curr;
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Retrieves the address of the key referred to
+ *          by it's current position
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *
+ *  @return     address of a key, NULL at the end
+ */
+static void *hmi_curr(iterator it) {
+    return it.curr;
+}
+
+/**
+ *  @brief  Retrieves the address of the first key of the hashmap
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *
+ *  @return     address of the first key, NULL if empty
+ */
+static void *hmi_start(iterator it) {
+    return hmi_begin(it.container).curr;
+}
+
+/**
+ *  @brief  Retrieves the current element of the end iterator
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *
+ *  @return     NULL (the end iterator refers to no key)
+ */
+static void *hmi_finish(iterator it) {
+    (void)(it);
+    return NULL;
+}
+
+/**
+ *  @brief  Determines if it has keys to visit in the forward direction
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *
+ *  @return     true if keys remain in the forward direction,
+ *              false otherwise
+ */
+static bool hmi_has_next(iterator it) {
+    return it.curr != NULL;
+}
+
+/**
+ *  @brief  Determines if it has keys to visit in the backward direction
+ *
+ *  @param[in]  it  iterator that refers to a hashmap
+ *
+ *  @return     true if keys remain in the backward direction,
+ *              false otherwise
+ */
+static bool hmi_has_prev(iterator it) {
+    return it.curr != hmi_begin(it.container).curr;
+}
+
+/**
+ *  @brief  Retrieve a container's (key) typetable
+ *
+ *  @param[in]  arg     pointer to hashmap
+ *
+ *  @return     pointer to typetable
+ */
+static struct typetable *hmi_get_ttbl(void *arg) {
+    hashmap *m = (hashmap *)(arg);
+    return m->key_ttbl;
+}
@@ -0,0 +1,1671 @@
+/**
+ *  @file       rbtree.c
+ *  @brief      Source file for an ordered map/set ADT (left-leaning red-black tree)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       06 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ *
+ *  [Algorithm credits]
+ *  rotate_left, rotate_right, color_flip, insert,
+ *  move_red_right, move_red_left, erase_min, erase_max, erase, fixup
+ *  http://www.cs.princeton.edu/~rs/talks/LLRB/LLRB.pdf
+ *  http://www.cs.princeton.edu/~rs/talks/LLRB/RedBlack.pdf
+ *  Dr. Robert Sedgewick, Princeton University
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "rbtree.h"
+#include "iterator.h"
+#include "vector.h"
+#include "utils.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+
+#define RBTREE_BUFSZ 4096
+
+/**< black height is floor(log2(n + 1)), at most the bit width of size_t */
+#define RBTREE_MAX_BLACK_HEIGHT ((sizeof(size_t) * CHAR_BIT) + 1)
+
+/**< rounds N up to a multiple of the strictest alignment for key/value */
+#define RBTREE_ALIGN(N)     ((((N) + sizeof(double) - 1) / sizeof(double)) * sizeof(double))
+
+/**< addresses of a node's key and value, stored inline after the node */
+#define KEY(NODE)           ((void *)((NODE) + 1))
+#define VAL(T, NODE)        ((void *)((char *)((NODE) + 1) + (T)->val_offset))
+
+typedef struct rbnode rbnode;
+
+/**
+ *  @struct     rbnode
+ *  @brief      Represents a node of a left-leaning red-black tree
+ *
+ *  The key (and value, if any) immediately follow the node in memory --
+ *  see KEY and VAL.
+ */
+struct rbnode {
+    rbnode *left;               /**< left child (next free node, in a pool) */
+    rbnode *right;              /**< right child */
+    enum node_color color;      /**< color of the link from the parent */
+};
+
+/**
+ *  @struct     rbtree
+ *  @brief      Represents an ordered map/set ADT
+ *
+ *  Note that struct rbtree and struct rbnode are opaque.
+ */
+struct rbtree {
+    rbnode *root;               /**< root of the tree */
+    size_t size;                /**< number of keys */
+
+    struct typetable *key_ttbl; /**< key width, copy, dtor, compare, print */
+    struct typetable *val_ttbl; /**< value width, copy, dtor, print -- or NULL */
+
+    size_t val_offset;          /**< offset of the value from the key */
+    size_t node_size;           /**< node + key + value, aligned */
+
+    /**
+     *  @struct     rbnode_pool
+     *  @brief      Slab allocator for nodes
+     */
+    struct rbnode_pool {
+        void *slabs;            /**< singly linked list of slabs */
+        char *next;             /**< next unused node in the newest slab */
+        char *end;              /**< one past the last node of the newest slab */
+        rbnode *free_list;      /**< recycled nodes, linked by left */
+    } pool;
+};
+
+static rbtree *rbtree_allocate(void);
+static void rbtree_init(rbtree *t, struct typetable *key_ttbl, struct typetable *val_ttbl);
+static void rbtree_deinit(rbtree *t);
+
+static rbnode *rbnode_new(rbtree *t, const void *key, const void *value);
+static void rbnode_delete(rbtree *t, rbnode *n, bool destroy);
+static void rbnode_destroy(rbtree *t, rbnode *n);
+static void rbnode_assign(rbtree *t, void *dst, const void *src, struct typetable *ttbl);
+
+static rbnode *rbnode_build(rbtree *t, const char *keys, const char *values,
+                            size_t lo, size_t hi, int black_height,
+                            const size_t *max_size);
+
+static bool rbnode_is_red(rbnode *n);
+
+static rbnode *rbnode_find(rbtree *t, const void *key);
+static rbnode *rbnode_min(rbnode *n);
+static rbnode *rbnode_max(rbnode *n);
+static rbnode *rbnode_lower_bound(rbtree *t, const void *key, bool inclusive);
+static rbnode *rbnode_predecessor(rbtree *t, rbnode *n);
+
+static int rbnode_height(rbnode *n);
+
+static void rbnode_traverse(rbnode *n, consumer_fn consumer, enum node_traversal ttype);
+static void rbnode_levelorder_helper(rbnode *n, consumer_fn consumer, int level);
+static void rbnode_clear(rbtree *t, rbnode *n);
+
+static rbnode *rbnode_rotate_left(rbnode *n);
+static rbnode *rbnode_rotate_right(rbnode *n);
+static void rbnode_color_flip(rbnode *n);
+
+static rbnode *rbnode_insert(rbtree *t, rbnode *n, const void *key, const void *value);
+static rbnode *rbnode_move_red_right(rbnode *n);
+static rbnode *rbnode_move_red_left(rbnode *n);
+static rbnode *rbnode_erase_min(rbtree *t, rbnode *n, bool destroy);
+static rbnode *rbnode_erase_max(rbtree *t, rbnode *n);
+static rbnode *rbnode_erase(rbtree *t, rbnode *n, const void *key);
+static rbnode *rbnode_fixup(rbnode *n);
+
+static void rbnode_fputs(rbtree *t, rbnode *n, FILE *dest, char *b, bool last);
+
+static iterator rbti_begin(void *arg);
+static iterator rbti_end(void *arg);
+
+static iterator rbti_next(iterator it);
+static iterator rbti_next_n(iterator it, int n);
+
+static iterator rbti_prev(iterator it);
+static iterator rbti_prev_n(iterator it, int n);
+
+static int rbti_distance(iterator *first, iterator *last);
+
+static iterator *rbti_advance(iterator *it, int n);
+static iterator *rbti_incr(iterator *it);
+static iterator *rbti_decr(iterator *it);
+
+static void *rbti_curr(iterator it);
+static void *rbti_start(iterator it);
+static void *rbti_finish(iterator it);
+
+static bool rbti_has_next(iterator it);
+static bool rbti_has_prev(iterator it);
+
+static struct typetable *rbti_get_ttbl(void *arg);
+
+struct iterator_table itbl_rbtree = {
+    rbti_begin,
+    rbti_end,
+    rbti_next,
+    rbti_next_n,
+    rbti_prev,
+    rbti_prev_n,
+    rbti_advance,
+    rbti_incr,
+    rbti_decr,
+    rbti_curr,
+    rbti_start,
+    rbti_finish,
+    rbti_distance,
+    rbti_has_next,
+    rbti_has_prev,
+    rbti_get_ttbl
+};
+
+struct iterator_table *_rbtree_iterator_ = &itbl_rbtree;
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to rbtree
+ *
+ *  @param[in]  key_ttbl    typetable for keys (compare is required)
+ *  @param[in]  val_ttbl    typetable for values, or NULL for a set
+ *
+ *  @return     pointer to rbtree
+ */
+rbtree *rbtree_new(struct typetable *key_ttbl, struct typetable *val_ttbl) {
+    rbtree *t = rbtree_allocate();              /* allocate */
+    rbtree_init(t, key_ttbl, val_ttbl);         /* construct */
+    return t;                                   /* return */
+}
+
+/**
+ *  @brief  Allocates and constructs an rbtree from sorted keys, in O(n)
+ *
+ *  @param[in]  keys    vector of keys, sorted ascending, without duplicates
+ *  @param[in]  values  vector of values (parallel to keys), or NULL for a set
+ *
+ *  @return     pointer to rbtree
+ *
+ *  Rather than n inserts (O(n log n)), the equivalent 2-3 tree is built
+ *  top-down, one node per key -- see rbnode_build.
+ */
+rbtree *rbtree_newsorted(vector *keys, vector *values) {
+    rbtree *t = NULL;
+    size_t max_size[RBTREE_MAX_BLACK_HEIGHT];
+    size_t n = 0;
+    size_t full = 0;
+    int black_height = 0;
+    int i = 0;
+
+    massert_container(keys);
+
+    n = v_size(keys);
+
+    if (values && v_size(values) != n) {
+        ERROR(__FILE__, "keys and values must have the same length.");
+        return NULL;
+    }
+
+    t = rbtree_new(v_get_ttbl(keys), values ? v_get_ttbl(values) : NULL);
+
+    if (n == 0) {
+        return t;
+    }
+
+    /**
+     *  black_height is floor(log2(n + 1)) -- a tree with black height b
+     *  holds at least 2^b - 1 keys (all 2-nodes),
+     *  and at most max_size[b] = 3^b - 1 keys (all 3-nodes).
+     */
+    for (black_height = 0, full = 1; (full * 2) - 1 <= n; black_height++) {
+        full *= 2;
+    }
+
+    max_size[0] = 0;
+    for (i = 1; i <= black_height; i++) {
+        /* saturates once 3^i - 1 no longer fits a size_t */
+        max_size[i] = max_size[i - 1] > (((size_t)(-1)) - 2) / 3
+                    ? ((size_t)(-1)) : (max_size[i - 1] * 3) + 2;
+    }
+
+    t->root = rbnode_build(t, *(char **)(v_data(keys)),
+                           values ? *(char **)(v_data(values)) : NULL,
+                           0, n, black_height, max_size);
+    t->size = n;
+
+    return t;
+}
+
+/**
+ *  @brief  Allocates a new rbtree, filled with copies of t's keys/values
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     pointer to rbtree
+ */
+rbtree *rbtree_newcopy(rbtree *t) {
+    rbtree *copy = NULL;
+    iterator it;
+
+    massert_container(t);
+
+    copy = rbtree_new(t->key_ttbl, t->val_ttbl);
+
+    for (it = rbtree_begin(t); rbti_has_next(it); rbti_incr(&it)) {
+        rbtree_insert(copy, rbti_curr(it), t->val_ttbl ? rbtree_itvalue(it) : NULL);
+    }
+
+    return copy;
+}
+
+/**
+ *  @brief  Calls rbtree_deinit (rbtree's destructor)
+ *          and deallocates the pointer t
+ *
+ *  @param[out] t   address of a pointer to rbtree
+ */
+void rbtree_delete(rbtree **t) {
+    massert_container((*t));
+
+    rbtree_deinit((*t));
+
+    free((*t));
+    (*t) = NULL;
+}
+
+/**
+ *  @brief  Returns an iterator at the smallest key of t
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     iterator that refers to t
+ */
+iterator rbtree_begin(rbtree *t) {
+    massert_container(t);
+    return rbti_begin(t);
+}
+
+/**
+ *  @brief  Returns an iterator one past the largest key of t
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     iterator that refers to t
+ */
+iterator rbtree_end(rbtree *t) {
+    massert_container(t);
+    return rbti_end(t);
+}
+
+/**
+ *  @brief  Returns an iterator at the first key not less than key
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     iterator that refers to t (end iterator if no such key)
+ */
+iterator rbtree_lower_bound(rbtree *t, const void *key) {
+    iterator it;
+
+    massert_container(t);
+    massert_ptr(key);
+
+    it.itbl = _rbtree_iterator_;
+    it.container = t;
+    it.curr = rbnode_lower_bound(t, key, true);
+
+    return it;
+}
+
+/**
+ *  @brief  Returns an iterator at the first key greater than key
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     iterator that refers to t (end iterator if no such key)
+ */
+iterator rbtree_upper_bound(rbtree *t, const void *key) {
+    iterator it;
+
+    massert_container(t);
+    massert_ptr(key);
+
+    it.itbl = _rbtree_iterator_;
+    it.container = t;
+    it.curr = rbnode_lower_bound(t, key, false);
+
+    return it;
+}
+
+/**
+ *  @brief  Retrieves the address of the value at it's current position
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *
+ *  @return     address of the value, or NULL for a set/the end iterator
+ */
+void *rbtree_itvalue(iterator it) {
+    rbtree *t = (rbtree *)(it.container);
+    rbnode *n = (rbnode *)(it.curr);
+
+    return (n && t->val_ttbl) ? VAL(t, n) : NULL;
+}
+
+/**
+ *  @brief  Returns the number of keys in t
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     number of keys
+ */
+size_t rbtree_size(rbtree *t) {
+    massert_container(t);
+    return t->size;
+}
+
+/**
+ *  @brief  Returns the height of t (-1 if empty)
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     height of t
+ */
+int rbtree_height(rbtree *t) {
+    massert_container(t);
+    return rbnode_height(t->root);
+}
+
+/**
+ *  @brief  Determines if t has no keys
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     true if empty, false otherwise
+ */
+bool rbtree_empty(rbtree *t) {
+    massert_container(t);
+    return t->root == NULL;
+}
+
+/**
+ *  @brief  Retrieves the address of t's smallest key
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     address of the smallest key, NULL if empty
+ */
+void *rbtree_min(rbtree *t) {
+    massert_container(t);
+    return t->root ? KEY(rbnode_min(t->root)) : NULL;
+}
+
+/**
+ *  @brief  Retrieves the address of t's largest key
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     address of the largest key, NULL if empty
+ */
+void *rbtree_max(rbtree *t) {
+    massert_container(t);
+    return t->root ? KEY(rbnode_max(t->root)) : NULL;
+}
+
+/**
+ *  @brief  Searches t for key
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     address of key's value (map), or of the stored key (set);
+ *              NULL if key is not found
+ */
+void *rbtree_find(rbtree *t, const void *key) {
+    rbnode *n = NULL;
+
+    massert_container(t);
+    massert_ptr(key);
+
+    n = rbnode_find(t, key);
+
+    if (n == NULL) {
+        return NULL;
+    }
+
+    return t->val_ttbl ? VAL(t, n) : KEY(n);
+}
+
+/**
+ *  @brief  Determines if t contains key
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     true if found, false otherwise
+ */
+bool rbtree_contains(rbtree *t, const void *key) {
+    massert_container(t);
+    massert_ptr(key);
+    return rbnode_find(t, key) != NULL;
+}
+
+/**
+ *  @brief  Inserts key (and value) into t
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  key     address of a key
+ *  @param[in]  value   address of a value, or NULL (for a set)
+ *
+ *  If key is already present, its value is replaced.
+ */
+void rbtree_insert(rbtree *t, const void *key, const void *value) {
+    massert_container(t);
+    massert_ptr(key);
+
+    t->root = rbnode_insert(t, t->root, key, value);
+    t->root->color = BLACK;
+}
+
+/**
+ *  @brief  Removes key (and its value) from t
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  key     address of a key
+ *
+ *  No-op if key is not found.
+ */
+void rbtree_erase(rbtree *t, const void *key) {
+    massert_container(t);
+    massert_ptr(key);
+
+    /* the top-down erase requires that key be present */
+    if (rbnode_find(t, key) == NULL) {
+        return;
+    }
+
+    if (!rbnode_is_red(t->root->left) && !rbnode_is_red(t->root->right)) {
+        t->root->color = RED;
+    }
+
+    t->root = rbnode_erase(t, t->root, key);
+
+    if (t->root) {
+        t->root->color = BLACK;
+    }
+}
+
+/**
+ *  @brief  Removes the smallest key (and its value) from t
+ *
+ *  @param[in]  t   pointer to rbtree
+ */
+void rbtree_erase_min(rbtree *t) {
+    massert_container(t);
+
+    if (t->root == NULL) {
+        return;
+    }
+
+    if (!rbnode_is_red(t->root->left) && !rbnode_is_red(t->root->right)) {
+        t->root->color = RED;
+    }
+
+    t->root = rbnode_erase_min(t, t->root, true);
+
+    if (t->root) {
+        t->root->color = BLACK;
+    }
+}
+
+/**
+ *  @brief  Removes the largest key (and its value) from t
+ *
+ *  @param[in]  t   pointer to rbtree
+ */
+void rbtree_erase_max(rbtree *t) {
+    massert_container(t);
+
+    if (t->root == NULL) {
+        return;
+    }
+
+    if (!rbnode_is_red(t->root->left) && !rbnode_is_red(t->root->right)) {
+        t->root->color = RED;
+    }
+
+    t->root = rbnode_erase_max(t, t->root);
+
+    if (t->root) {
+        t->root->color = BLACK;
+    }
+}
+
+/**
+ *  @brief  Removes all keys (and values) from t
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  Nodes are returned to the pool, not to the heap.
+ */
+void rbtree_clear(rbtree *t) {
+    massert_container(t);
+
+    rbnode_clear(t, t->root);
+
+    t->root = NULL;
+    t->size = 0;
+}
+
+/**
+ *  @brief  Visits every key of t in the given order
+ *
+ *  @param[in]  t           pointer to rbtree
+ *  @param[in]  consumer    receives the address of each key
+ *  @param[in]  ttype       INORDER, PREORDER, POSTORDER, or LEVELORDER
+ */
+void rbtree_foreach(rbtree *t, consumer_fn consumer, enum node_traversal ttype) {
+    int height = 0;
+    int i = 0;
+
+    massert_container(t);
+    massert_ptr(consumer);
+
+    if (ttype == LEVELORDER) {
+        height = rbnode_height(t->root);
+
+        for (i = 1; i <= height + 1; i++) {
+            rbnode_levelorder_helper(t->root, consumer, i);
+        }
+    } else {
+        rbnode_traverse(t->root, consumer, ttype);
+    }
+}
+
+/**
+ *  @brief  Prints a diagnostic of rbtree to stdout
+ *
+ *  @param[in]  t   pointer to rbtree
+ */
+void rbtree_puts(rbtree *t) {
+    rbtree_fputs(t, stdout);
+}
+
+/**
+ *  @brief  Prints a diagnostic of rbtree to file stream dest
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  dest    file stream (e.g stdout, stderr, a file)
+ */
+void rbtree_fputs(rbtree *t, FILE *dest) {
+    const char *link = "---------------------------";
+
+    massert_container(t);
+    massert_ptr(dest);
+
+    if (t->root == NULL) {
+        fprintf(dest, "\n{ empty tree }\n\n");
+        return;
+    }
+
+    fprintf(dest, "\n%s\n%s\n%s\n\n", link, "RED-BLACK Tree Elements", link);
+    rbnode_fputs(t, t->root, dest, "", true);
+
+    fprintf(dest, "\n%s\n%s\t\t%lu\n%s\t\t%d\n%s\n", link,
+            "Size         ", t->size,
+            "Height       ", rbnode_height(t->root),
+            link);
+}
+
+/**
+ *  @brief  Retrieves the key typetable used by t
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     pointer to typetable
+ */
+struct typetable *rbtree_get_key_ttbl(rbtree *t) {
+    massert_container(t);
+    return t->key_ttbl;
+}
+
+/**
+ *  @brief  Retrieves the value typetable used by t
+ *
+ *  @param[in]  t   pointer to rbtree
+ *
+ *  @return     pointer to typetable, NULL if t is a set
+ */
+struct typetable *rbtree_get_val_ttbl(rbtree *t) {
+    massert_container(t);
+    return t->val_ttbl;
+}
+
+/**
+ *  @brief  Calls malloc to allocate memory for a pointer to rbtree
+ *
+ *  @return     pointer to rbtree
+ */
+static rbtree *rbtree_allocate(void) {
+    rbtree *t = NULL;
+    t = malloc(sizeof *t);
+    return t;
+}
+
+/**
+ *  @brief  "Constructor" function, initializes rbtree
+ *
+ *  @param[in]  t           pointer to rbtree
+ *  @param[in]  key_ttbl    typetable for keys
+ *  @param[in]  val_ttbl    typetable for values, or NULL
+ */
+static void rbtree_init(rbtree *t, struct typetable *key_ttbl, struct typetable *val_ttbl) {
+    massert_container(t);
+
+    t->key_ttbl = key_ttbl ? key_ttbl : _void_ptr_;
+    t->val_ttbl = val_ttbl;
+
+    if (t->key_ttbl->compare == NULL) {
+        ERROR(__FILE__, "rbtree requires a key typetable with a compare function.");
+    }
+
+    t->root = NULL;
+    t->size = 0;
+
+    t->val_offset = RBTREE_ALIGN(t->key_ttbl->width);
+    t->node_size = RBTREE_ALIGN(sizeof(rbnode)) + t->val_offset
+                 + (t->val_ttbl ? RBTREE_ALIGN(t->val_ttbl->width) : 0);
+
+    t->pool.slabs = NULL;
+    t->pool.next = NULL;
+    t->pool.end = NULL;
+    t->pool.free_list = NULL;
+}
+
+/**
+ *  @brief  "Destructor" function, deinitializes rbtree
+ *
+ *  @param[in]  t   pointer to rbtree
+ */
+static void rbtree_deinit(rbtree *t) {
+    void *slab = NULL;
+
+    if (t == NULL) {
+        return;
+    }
+
+    rbtree_clear(t);
+
+    /* each slab begins with the address of the previous slab */
+    while (t->pool.slabs) {
+        slab = t->pool.slabs;
+        t->pool.slabs = *(void **)(slab);
+        free(slab);
+    }
+
+    t->pool.next = NULL;
+    t->pool.end = NULL;
+    t->pool.free_list = NULL;
+}
+
+/**
+ *  @brief  Takes a node from t's pool and initializes it with key/value
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  key     address of a key
+ *  @param[in]  value   address of a value, or NULL
+ *
+ *  @return     a red node with no children
+ */
+static rbnode *rbnode_new(rbtree *t, const void *key, const void *value) {
+    rbnode *n = NULL;
+    void *slab = NULL;
+
+    if (t->pool.free_list) {
+        n = t->pool.free_list;
+        t->pool.free_list = n->left;
+    } else {
+        if (t->pool.next == t->pool.end) {
+            /* the newest slab is exhausted -- a new one is linked in */
+            slab = malloc(RBTREE_ALIGN(sizeof(void *))
+                          + (t->node_size * RBTREE_POOL_SLAB_LENGTH));
+            massert_malloc(slab);
+
+            *(void **)(slab) = t->pool.slabs;
+            t->pool.slabs = slab;
+
+            t->pool.next = (char *)(slab) + RBTREE_ALIGN(sizeof(void *));
+            t->pool.end = t->pool.next + (t->node_size * RBTREE_POOL_SLAB_LENGTH);
+        }
+
+        n = (rbnode *)(t->pool.next);
+        t->pool.next += t->node_size;
+    }
+
+    n->left = NULL;
+    n->right = NULL;
+    n->color = RED;     /* all newly inserted red-black tree nodes are red */
+
+    rbnode_assign(t, KEY(n), key, t->key_ttbl);
+
+    if (t->val_ttbl) {
+        if (value) {
+            rbnode_assign(t, VAL(t, n), value, t->val_ttbl);
+        } else {
+            memset(VAL(t, n), 0, t->val_ttbl->width);
+        }
+    }
+
+    return n;
+}
+
+/**
+ *  @brief  Returns a node to t's pool
+ *
+ *  @param[in]  t           pointer to rbtree
+ *  @param[in]  n           node to release
+ *  @param[in]  destroy     true to destroy n's key/value first, false if
+ *                          they were moved elsewhere
+ */
+static void rbnode_delete(rbtree *t, rbnode *n, bool destroy) {
+    if (destroy) {
+        rbnode_destroy(t, n);
+    }
+
+    n->right = NULL;
+    n->left = t->pool.free_list;
+    t->pool.free_list = n;
+
+    --t->size;
+}
+
+/**
+ *  @brief  Destroys n's key and value, as per their typetables
+ *
+ *  @param[in]  t   pointer to rbtree
+ *  @param[in]  n   node whose key/value are to be destroyed
+ */
+static void rbnode_destroy(rbtree *t, rbnode *n) {
+    if (t->key_ttbl->dtor) {
+        t->key_ttbl->dtor(KEY(n));
+    }
+
+    if (t->val_ttbl && t->val_ttbl->dtor) {
+        t->val_ttbl->dtor(VAL(t, n));
+    }
+}
+
+/**
+ *  @brief  Copies src into dst, as per ttbl
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[out] dst     address of a key/value within a node
+ *  @param[in]  src     address of a key/value
+ *  @param[in]  ttbl    typetable of the key/value
+ */
+static void rbnode_assign(rbtree *t, void *dst, const void *src, struct typetable *ttbl) {
+    (void)(t);
+
+    if (ttbl->copy) {
+        /* if copy fn defined in ttbl, deep copy */
+        ttbl->copy(dst, src);
+    } else {
+        /* if no copy defined in ttbl, shallow copy */
+        memcpy(dst, src, ttbl->width);
+    }
+}
+
+/**
+ *  @brief  Builds a subtree with the given black height from keys[lo, hi)
+ *
+ *  @param[in]  t               pointer to rbtree
+ *  @param[in]  keys            base address of the sorted keys
+ *  @param[in]  values          base address of the values, or NULL
+ *  @param[in]  lo              first index (inclusive)
+ *  @param[in]  hi              last index (exclusive)
+ *  @param[in]  black_height    black height of the subtree
+ *  @param[in]  max_size        max_size[b] is the most keys that fit
+ *                              in a subtree of black height b
+ *
+ *  @return     root of the subtree (black)
+ *
+ *  The root becomes a 2-node (one black node) if both halves fit under
+ *  black_height - 1, otherwise a 3-node (a black node and its red left
+ *  child) whose three subtrees split the remaining keys evenly.
+ */
+static rbnode *rbnode_build(rbtree *t, const char *keys, const char *values,
+                            size_t lo, size_t hi, int black_height,
+                            const size_t *max_size) {
+    rbnode *n = NULL;
+    rbnode *red = NULL;
+    size_t count = hi - lo;
+    size_t third = 0;
+    size_t a = 0;
+    size_t b = 0;
+
+    if (count == 0) {
+        return NULL;
+    }
+
+    if (count / 2 <= max_size[black_height - 1]) {
+        /* 2-node: the left half receives the extra key, if any */
+        a = lo + (count / 2);
+
+        n = rbnode_new(t, keys + (a * t->key_ttbl->width),
+                       values ? values + (a * t->val_ttbl->width) : NULL);
+
+        n->left = rbnode_build(t, keys, values, lo, a, black_height - 1, max_size);
+        n->right = rbnode_build(t, keys, values, a + 1, hi, black_height - 1, max_size);
+    } else {
+        /* 3-node: keys[a] is the red left child of keys[b] */
+        third = (count - 2) / 3;
+        a = lo + third + ((count - 2) % 3 > 0 ? 1 : 0);
+        b = a + 1 + third + ((count - 2) % 3 > 1 ? 1 : 0);
+
+        red = rbnode_new(t, keys + (a * t->key_ttbl->width),
+                         values ? values + (a * t->val_ttbl->width) : NULL);
+        n = rbnode_new(t, keys + (b * t->key_ttbl->width),
+                       values ? values + (b * t->val_ttbl->width) : NULL);
+
+        red->left = rbnode_build(t, keys, values, lo, a, black_height - 1, max_size);
+        red->right = rbnode_build(t, keys, values, a + 1, b, black_height - 1, max_size);
+        n->right = rbnode_build(t, keys, values, b + 1, hi, black_height - 1, max_size);
+
+        n->left = red;
+    }
+
+    n->color = BLACK;
+    return n;
+}
+
+/**
+ *  @brief  Determines if n is red (NULL links are black)
+ *
+ *  @param[in]  n   node, or NULL
+ *
+ *  @return     true if n is red, false otherwise
+ */
+static bool rbnode_is_red(rbnode *n) {
+    return n ? n->color == RED : false;
+}
+
+/**
+ *  @brief  Finds the node with key
+ *
+ *  @param[in]  t       pointer to rbtree
+ *  @param[in]  key     address of a key
+ *
+ *  @return     node with key, NULL if not found
+ */
+static rbnode *rbnode_find(rbtree *t, const void *key) {
+    compare_fn compare = t->key_ttbl->compare;
+    rbnode *n = t->root;
+    int delta = 0;
+
+    while (n != NULL) {
+        delta = compare(key, KEY(n));
+
+        if (delta == 0) {
+            /* the desired node was found. */
+            break;
+        }
+
+        /* proceed to left subtree if key is smaller, otherwise right subtree */
+        n = delta < 0 ? n->left : n->right;
+    }
+
+    return n;
+}
+
+/**
+ *  @brief  Finds the leftmost node of the subtree rooted at n
+ *
+ *  @param[in]  n   root of a subtree
+ *
+ *  @return     node with the smallest key
+ */
+static rbnode *rbnode_min(rbnode *n) {
+    assert(n);
+
+    while (n->left != NULL) {
+        n = n->left;
+    }
+
+    return n;
+}
+
+/**
+ *  @brief  Finds the rightmost node of the subtree rooted at n
+ *
+ *  @param[in]  n   root of a subtree
+ *
+ *  @return     node with the largest key
+ */
+static rbnode *rbnode_max(rbnode *n) {
+    assert(n);
+
+    while (n->right != NULL) {
+        n = n->right;
+    }
+
+    return n;
+}
+
+/**
+ *  @brief  Finds the first node whose key is >= key (inclusive)
+ *          or > key (not inclusive)
+ *
+ *  @param[in]  t           pointer to rbtree
+ *  @param[in]  key         address of a key
+ *  @param[in]  inclusive   true for lower bound, false for upper bound
+ *
+ *  @return     node, or NULL if every key is smaller
+ *
+ *  Also serves as the in-order successor: rbnode_lower_bound(t, KEY(n), false)
+ */
+static rbnode *rbnode_lower_bound(rbtree *t, const void *key, bool inclusive) {
+    compare_fn compare = t->key_ttbl->compare;
+    rbnode *candidate = NULL;
+    rbnode *n = t->root;
+    int delta = 0;
+
+    while (n != NULL) {
+        delta = compare(KEY(n), key);
+
+        if (delta > 0 || (inclusive && delta == 0)) {
+            candidate = n;
+            n = n->left;
+        } else {
+            n = n->right;
+        }
+    }
+
+    return candidate;
+}
+
+/**
+ *  @brief  Finds the in-order predecessor of n
+ *
+ *  @param[in]  t   pointer to rbtree
+ *  @param[in]  n   node, or NULL (the predecessor of the end is the max)
+ *
+ *  @return     predecessor node, or NULL if n is the minimum
+ */
+static rbnode *rbnode_predecessor(rbtree *t, rbnode *n) {
+    compare_fn compare = t->key_ttbl->compare;
+    rbnode *candidate = NULL;
+    rbnode *x = t->root;
+
+    if (n == NULL) {
+        return t->root ? rbnode_max(t->root) : NULL;
+    } else if (n->left) {
+        return rbnode_max(n->left);
+    }
+
+    while (x != NULL) {
+        if (compare(KEY(x), KEY(n)) < 0) {
+            candidate = x;
+            x = x->right;
+        } else {
+            x = x->left;
+        }
+    }
+
+    return candidate;
+}
+
+/**
+ *  @brief  Determines the height of the subtree rooted at n
+ *
+ *  @param[in]  n   root of a subtree, or NULL
+ *
+ *  @return     height (-1 if n is NULL)
+ */
+static int rbnode_height(rbnode *n) {
+    int left = 0;
+    int right = 0;
+
+    if (n == NULL) {
+        return -1;
+    }
+
+    left = rbnode_height(n->left);
+    right = rbnode_height(n->right);
+
+    return 1 + (left >= right ? left : right);
+}
+
+/**
+ *  @brief  Visits the subtree rooted at n in pre/in/post order
+ *
+ *  @param[in]  n           root of a subtree, or NULL
+ *  @param[in]  consumer    receives the address of each key
+ *  @param[in]  ttype       INORDER, PREORDER, or POSTORDER
+ */
+static void rbnode_traverse(rbnode *n, consumer_fn consumer, enum node_traversal ttype) {
+    if (n == NULL) {
+        return;
+    }
+
+    if (ttype == PREORDER) {
+        consumer(KEY(n));
+    }
+
+    rbnode_traverse(n->left, consumer, ttype);
+
+    if (ttype == INORDER) {
+        consumer(KEY(n));
+    }
+
+    rbnode_traverse(n->right, consumer, ttype);
+
+    if (ttype == POSTORDER) {
+        consumer(KEY(n));
+    }
+}
+
+/**
+ *  @brief  Visits the nodes at a given level of the subtree rooted at n
+ *
+ *  @param[in]  n           root of a subtree, or NULL
+ *  @param[in]  consumer    receives the address of each key
+ *  @param[in]  level       level to visit (1 is n itself)
+ */
+static void rbnode_levelorder_helper(rbnode *n, consumer_fn consumer, int level) {
+    if (n == NULL) {
+        return;
+    } else if (level == 1) {
+        consumer(KEY(n));
+    } else if (level > 1) {
+        rbnode_levelorder_helper(n->left, consumer, level - 1);
+        rbnode_levelorder_helper(n->right, consumer, level - 1);
+    }
+}
+
+/**
+ *  @brief  Destroys and releases every node of the subtree rooted at n
+ *
+ *  @param[in]  t   pointer to rbtree
+ *  @param[in]  n   root of a subtree, or NULL
+ */
+static void rbnode_clear(rbtree *t, rbnode *n) {
+    if (n == NULL) {
+        return;
+    }
+
+    rbnode_clear(t, n->left);
+    rbnode_clear(t, n->right);
+
+    rbnode_delete(t, n, true);
+}
+
+static rbnode *rbnode_rotate_left(rbnode *n) {
+    rbnode *x = NULL;
+
+    assert(n);
+
+    x = n->right;
+    n->right = x->left;
+    x->left = n;
+
+    x->color = n->color;
+    n->color = RED;
+
+    return x;
+}
+
+static rbnode *rbnode_rotate_right(rbnode *n) {
+    rbnode *x = NULL;
+
+    assert(n);
+
+    x = n->left;
+    n->left = x->right;
+    x->right = n;
+
+    x->color = n->color;
+    n->color = RED;
+
+    return x;
+}
+
+static void rbnode_color_flip(rbnode *n) {
+    if (n != NULL) {
+        /* if n != NULL, toggle n's colors/n's children's colors */
+        n->color = !n->color;
+
+        if (n->left != NULL) {
+            n->left->color = !(n->left->color);
+        }
+
+        if (n->right != NULL) {
+            n->right->color = !(n->right->color);
+        }
+    }
+}
+
+static rbnode *rbnode_insert(rbtree *t, rbnode *n, const void *key, const void *value) {
+    int delta = 0;
+
+    if (n == NULL) {
+        /* BASE CASE: n is a leaf, return new node */
+        ++t->size;
+        return rbnode_new(t, key, value);
+    }
+
+    delta = t->key_ttbl->compare(key, KEY(n));
+
+    if (delta == 0) {
+        /* BASE CASE: key exists (no duplicates allowed) -- value is replaced */
+        if (t->val_ttbl && value) {
+            if (t->val_ttbl->dtor) {
+                t->val_ttbl->dtor(VAL(t, n));
+            }
+
+            rbnode_assign(t, VAL(t, n), value, t->val_ttbl);
+        }
+    } else if (delta < 0) {
+        /* RECURSIVE CASE 1: key < n's key */
+        n->left = rbnode_insert(t, n->left, key, value);
+    } else {
+        /* RECURSIVE CASE 2: key > n's key */
+        n->right = rbnode_insert(t, n->right, key, value);
+    }
+
+    if (rbnode_is_red(n->right)) {
+        /* rotate left to fix right-leaning red nodes */
+        n = rbnode_rotate_left(n);
+    }
+
+    if (rbnode_is_red(n->left) && rbnode_is_red((n->left)->left)) {
+        /* rotate right to fix left-leaning double-red nodes */
+        n = rbnode_rotate_right(n);
+    }
+
+    if (rbnode_is_red(n->left) && rbnode_is_red(n->right)) {
+        /**
+         *  if n has red children, split the temporary 4-node on the way up.
+         *  Flipping on the way down instead (2-3-4 variant) leaves 4-nodes
+         *  in the tree, which rbnode_erase's moves do not account for.
+         */
+        rbnode_color_flip(n);
+    }
+
+    return n;
+}
+
+static rbnode *rbnode_move_red_right(rbnode *n) {
+    /* start by toggling colors */
+    rbnode_color_flip(n);
+
+    if (rbnode_is_red(n->left->left)) {
+        /* if n's left grandchild is red */
+        n = rbnode_rotate_right(n);
+        rbnode_color_flip(n);
+    }
+
+    return n;
+}
+
+static rbnode *rbnode_move_red_left(rbnode *n) {
+    /* start by toggling colors */
+    rbnode_color_flip(n);
+
+    if (rbnode_is_red(n->right->left)) {
+        /* if n's right grandchild is red */
+        n->right = rbnode_rotate_right(n->right);
+        n = rbnode_rotate_left(n);
+
+        rbnode_color_flip(n);
+    }
+
+    return n;
+}
+
+static rbnode *rbnode_erase_min(rbtree *t, rbnode *n, bool destroy) {
+    if (n->left == NULL) {
+        /* BASE CASE: n->left is a leaf, min node found. */
+        rbnode_delete(t, n, destroy);
+        return NULL;
+    }
+
+    if (!rbnode_is_red(n->left) && !rbnode_is_red((n->left)->left)) {
+        /* n's left child is black, n's left grandchild is black */
+        n = rbnode_move_red_left(n);
+    }
+
+    /* RECURSIVE CASE: left leaf node not found yet */
+    n->left = rbnode_erase_min(t, n->left, destroy);
+
+    return rbnode_fixup(n);
+}
+
+static rbnode *rbnode_erase_max(rbtree *t, rbnode *n) {
+    if (rbnode_is_red(n->left)) {
+        /* if n's left child is red, rotate right at n */
+        n = rbnode_rotate_right(n);
+    }
+
+    if (n->right == NULL) {
+        /* BASE CASE: n->right is a leaf, max node found */
+        rbnode_delete(t, n, true);
+        return NULL;
+    }
+
+    if (!rbnode_is_red(n->right) && !(rbnode_is_red((n->right)->left))) {
+        /* n's right child is black, n's right grandchild is black */
+        n = rbnode_move_red_right(n);
+    }
+
+    /* RECURSIVE CASE: right leaf node not found yet */
+    n->right = rbnode_erase_max(t, n->right);
+
+    return rbnode_fixup(n);
+}
+
+static rbnode *rbnode_erase(rbtree *t, rbnode *n, const void *key) {
+    compare_fn compare = t->key_ttbl->compare;
+    rbnode *successor = NULL;
+
+    if (compare(key, KEY(n)) < 0) {
+        /* key is less than n's key */
+        if (!rbnode_is_red(n->left) && !rbnode_is_red((n->left)->left)) {
+            /* if n's left child is black, and n's left grandchild is black */
+            n = rbnode_move_red_left(n);
+        }
+
+        /* RECURSIVE CASE */
+        n->left = rbnode_erase(t, n->left, key);
+    } else {
+        /* key is greater than or equal to n's key */
+        if (rbnode_is_red(n->left)) {
+            /* if n's left child is red */
+            n = rbnode_rotate_right(n);
+        }
+
+        /* n may have changed -- comparisons must be made against the new n */
+        if (compare(key, KEY(n)) == 0 && n->right == NULL) {
+            /* BASE CASE: n is the node to erase, and has no right child */
+            rbnode_delete(t, n, true);
+            return NULL;
+        }
+
+        if (!rbnode_is_red(n->right) && !rbnode_is_red((n->right)->left)) {
+            /* if n's right child is black, and its left child is black */
+            n = rbnode_move_red_right(n);
+        }
+
+        if (compare(key, KEY(n)) == 0) {
+            /**
+             *  BASE CASE: n is the node to erase, but has a right child --
+             *  n's key/value are destroyed and replaced by (moved from)
+             *  those of its in-order successor, whose node is then
+             *  released without destroying what was moved.
+             */
+            successor = rbnode_min(n->right);
+
+            rbnode_destroy(t, n);
+            memcpy(KEY(n), KEY(successor),
+                   t->node_size - RBTREE_ALIGN(sizeof(rbnode)));
+
+            n->right = rbnode_erase_min(t, n->right, false);
+        } else {
+            /* RECURSIVE CASE: proceed to right child */
+            n->right = rbnode_erase(t, n->right, key);
+        }
+    }
+
+    return rbnode_fixup(n);
+}
+
+static rbnode *rbnode_fixup(rbnode *n) {
+    if (rbnode_is_red(n->right)) {
+        /* if n's right child is red */
+        n = rbnode_rotate_left(n);
+    }
+
+    if (rbnode_is_red(n->left) && rbnode_is_red((n->left)->left)) {
+        /* if n's left child is red, and n's left grandchild is red */
+        n = rbnode_rotate_right(n);
+    }
+
+    if (rbnode_is_red(n->left) && rbnode_is_red(n->right)) {
+        /* if n has red children */
+        rbnode_color_flip(n);
+    }
+
+    return n;
+}
+
+static void rbnode_fputs(rbtree *t, rbnode *n, FILE *dest, char *b, bool last) {
+    /**
+     *  Not a good long-term solution,
+     *  as this can overflow with large data sets.
+     *  Looks "pretty" though.
+     */
+    char newbuf[RBTREE_BUFSZ];
+    const char *color = NULL;
+
+    strcpy(newbuf, b);
+
+    fprintf(dest, "%s", b);
+
+    if (last) {
+        fprintf(dest, "R----");
+        strcat(newbuf, "      ");
+    } else {
+        fprintf(dest, "L----");
+        strcat(newbuf, "|     ");
+    }
+
+    color = rbnode_is_red(n) ? "RED" : "BLACK";
+
+    if (n != NULL) {
+        fprintf(dest, "[");
+
+        if (t->key_ttbl->print) {
+            t->key_ttbl->print(KEY(n), dest);
+        } else {
+            fprintf(dest, "%p", KEY(n));
+        }
+
+        fprintf(dest, "] (%s)\n", color);
+
+        rbnode_fputs(t, n->left, dest, newbuf, false);
+        rbnode_fputs(t, n->right, dest, newbuf, true);
+    } else {
+        fprintf(dest, "[#] (nil)\n");
+    }
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     pointer to rbtree
+ *
+ *  @return     iterator at the smallest key
+ */
+static iterator rbti_begin(void *arg) {
+    rbtree *t = (rbtree *)(arg);
+    iterator it;
+
+    it.itbl = _rbtree_iterator_;
+    it.container = t;
+    it.curr = t->root ? rbnode_min(t->root) : NULL;
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator that refers to arg
+ *
+ *  @param[in]  arg     pointer to rbtree
+ *
+ *  @return     iterator one past the largest key (its node is NULL)
+ */
+static iterator rbti_end(void *arg) {
+    iterator it;
+
+    it.itbl = _rbtree_iterator_;
+    it.container = arg;
+    it.curr = NULL;
+
+    return it;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator at the next key in order
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *
+ *  @return     a new iterator, at it's in-order successor
+ */
+static iterator rbti_next(iterator it) {
+    iterator iter = it;
+    rbti_incr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator n keys past it
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *  @param[in]  n   number of keys to move
+ *
+ *  @return     a new iterator
+ */
+static iterator rbti_next_n(iterator it, int n) {
+    iterator iter = it;
+    rbti_advance(&iter, n);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator at the previous key in order
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *
+ *  @return     a new iterator, at it's in-order predecessor
+ */
+static iterator rbti_prev(iterator it) {
+    iterator iter = it;
+    rbti_decr(&iter);
+    return iter;
+}
+
+/**
+ *  @brief  Initializes and returns an iterator n keys behind it
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *  @param[in]  n   number of keys to move
+ *
+ *  @return     a new iterator
+ */
+static iterator rbti_prev_n(iterator it, int n) {
+    iterator iter = it;
+    rbti_advance(&iter, -n);
+    return iter;
+}
+
+/**
+ *  @brief  Determines the distance between first and last numerically
+ *
+ *  @param[in]  first   pointer to iterator that refers to an rbtree
+ *  @param[in]  last    pointer to iterator that refers to an rbtree
+ *
+ *  @return     numerical distance between first and last
+ *
+ *  Nodes do not store subtree sizes, so this walks from first to last
+ *  (or from the smallest key, if first is NULL) -- O(distance * log n).
+ */
+static int rbti_distance(iterator *first, iterator *last) {
+    iterator it;
+    int delta = 0;
+
+    if (first == NULL && last == NULL) {
+        ERROR(__FILE__, "Both iterator first and last are NULL.");
+        return 0;
+    } else if (first == NULL || last == NULL) {
+        last = last ? last : first;
+        it = rbti_begin(last->container);
+    } else {
+        it = (*first);
+    }
+
+    while (it.curr != last->curr && it.curr != NULL) {
+        rbti_incr(&it);
+        ++delta;
+    }
+
+    return delta;
+}
+
+/**
+ *  @brief  Advances the position of it n keys (n may be negative)
+ *
+ *  @param[in]  it  pointer to iterator that refers to an rbtree
+ *  @param[in]  n   desired amount of keys to move
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *rbti_advance(iterator *it, int n) {
+    massert_iterator(it);
+
+    while (n > 0) {
+        rbti_incr(it);
+        --n;
+    }
+
+    while (n < 0) {
+        rbti_decr(it);
+        ++n;
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Moves it to the in-order successor of it's current key
+ *
+ *  @param[in]  it  pointer to iterator that refers to an rbtree
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *rbti_incr(iterator *it) {
+    rbtree *t = NULL;
+    rbnode *n = NULL;
+
+    massert_iterator(it);
+
+    t = (rbtree *)(it->container);
+    n = (rbnode *)(it->curr);
+
+    if (n == NULL) {
+        ERROR(__FILE__, "Cannot increment - already at end.");
+    } else if (n->right) {
+        it->curr = rbnode_min(n->right);
+    } else {
+        it->curr = rbnode_lower_bound(t, KEY(n), false);
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Moves it to the in-order predecessor of it's current key
+ *
+ *  @param[in]  it  pointer to iterator that refers to an rbtree
+ *
+ *  @return     pointer to iterator
+ */
+static iterator *rbti_decr(iterator *it) {
+    rbtree *t = NULL;
+    rbnode *n = NULL;
+
+    massert_iterator(it);
+
+    t = (rbtree *)(it->container);
+    n = rbnode_predecessor(t, (rbnode *)(it->curr));
+
+    if (n == NULL) {
+        ERROR(__FILE__, "Cannot decrement this iterator, already at begin.");
+    } else {
+        it->curr = n;
+    }
+
+    return it;
+}
+
+/**
+ *  @brief  Retrieves the address of the key referred to
+ *          by it's current position
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *
+ *  @return     address of a key, NULL at the end
+ */
+static void *rbti_curr(iterator it) {
+    return it.curr ? KEY((rbnode *)(it.curr)) : NULL;
+}
+
+/**
+ *  @brief  Retrieves the address of the smallest key of the rbtree
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *
+ *  @return     address of the smallest key, NULL if empty
+ */
+static void *rbti_start(iterator it) {
+    return rbtree_min((rbtree *)(it.container));
+}
+
+/**
+ *  @brief  Retrieves the current element of the end iterator
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *
+ *  @return     NULL (the end iterator refers to no key)
+ */
+static void *rbti_finish(iterator it) {
+    (void)(it);
+    return NULL;
+}
+
+/**
+ *  @brief  Determines if it has keys to visit in the forward direction
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *
+ *  @return     true if keys remain in the forward direction,
+ *              false otherwise
+ */
+static bool rbti_has_next(iterator it) {
+    return it.curr != NULL;
+}
+
+/**
+ *  @brief  Determines if it has keys to visit in the backward direction
+ *
+ *  @param[in]  it  iterator that refers to an rbtree
+ *
+ *  @return     true if keys remain in the backward direction,
+ *              false otherwise
+ */
+static bool rbti_has_prev(iterator it) {
+    rbtree *t = (rbtree *)(it.container);
+    return t->root != NULL && it.curr != rbnode_min(t->root);
+}
+
+/**
+ *  @brief  Retrieve a container's (key) typetable
+ *
+ *  @param[in]  arg     pointer to rbtree
+ *
+ *  @return     pointer to typetable
+ */
+static struct typetable *rbti_get_ttbl(void *arg) {
+    rbtree *t = (rbtree *)(arg);
+    return t->key_ttbl;
+}
@@ -0,0 +1,996 @@
+/**
+ *  @file       ulogb.c
+ *  @brief      Source file for a binary ulog encoder/decoder
+ *              (interned call sites, arguments serialized as is)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       19 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ *  snprintf is not declared under -std=c89 alone;
+ *  <string.h> then declares strdup, so it must precede the macro in utils.h.
+ */
+#define _XOPEN_SOURCE 500
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ulogb.h"
+
+#define ULOGB_MAGIC "ULOGB1\n"
+#define ULOGB_MAGIC_SIZE 8
+#define ULOGB_ENDIAN 0x01020304U
+
+#define ULOGB_TAG_SITE 'D'
+#define ULOGB_TAG_EVENT 'E'
+
+#define ULOGB_EVENT_HEADER (1 + sizeof(unsigned int) + 1 + sizeof(unsigned short))
+
+/**< sites held back for ulogb_fallback, one per level */
+#define ULOGB_FALLBACK_SITES 8
+#define ULOGB_SPEC_SIZE 32
+
+/**
+ *  @enum       ulogb_type
+ *  @brief      How a conversion's argument is stored
+ */
+enum ulogb_type {
+    ULOGB_NONE,         /**< no argument (%%) */
+    ULOGB_INT,          /**< int (also char, short, and '*' widths) */
+    ULOGB_LONG,         /**< long */
+    ULOGB_SIZE,         /**< size_t (z) */
+    ULOGB_DOUBLE,       /**< double (also float) */
+    ULOGB_LDOUBLE,      /**< long double (L) */
+    ULOGB_PTR,          /**< void * (p) */
+    ULOGB_STR,          /**< char * (s), stored by value */
+    ULOGB_SKIP          /**< pointer consumed, not stored (n) */
+};
+
+/**
+ *  @struct     ulogb_spec
+ *  @brief      One conversion specification within a format string
+ */
+struct ulogb_spec {
+    const char *begin;  /**< address of '%' */
+    const char *end;    /**< one past the conversion character */
+    int stars;          /**< number of '*' (int) arguments preceding it */
+    int type;           /**< enum ulogb_type */
+};
+
+/**
+ *  @struct     ulogb_site
+ *  @brief      An interned call site
+ *
+ *  level/file/func/fmt are the caller's pointers (the lookup key);
+ *  their contents are kept in text, to detect a reused buffer.
+ */
+struct ulogb_site {
+    unsigned int id;
+
+    const char *level;
+    const char *file;
+    const char *func;
+    const char *fmt;
+    long double line;
+
+    size_t nargs;
+    unsigned char types[ULOGB_ARGS];
+
+    char *text[4];      /**< copies of level, file, func, fmt */
+};
+
+static struct ulogb_site *volatile ulogb_table[ULOGB_SITES];
+static unsigned int ulogb_count = 0;
+static volatile unsigned long ulogb_drops = 0;
+
+static FILE *ulogb_stream = NULL;
+static pthread_mutex_t ulogb_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ *  Fallback site fields -- a message whose own site cannot be interned
+ *  is formatted by ulogb_encode, and written through the fallback site
+ *  of its level, with its location as part of the text.
+ */
+static const char ulogb_fallback_file[] = "ulogb";
+static const char ulogb_fallback_func[] = "ulogb_fallback";
+static const char ulogb_fallback_fmt[] = "%s";
+
+static const char *ulogb_parse(const char *fmt, struct ulogb_spec *spec);
+static struct ulogb_site *ulogb_fallback(const char *level);
+
+static struct ulogb_site *ulogb_site_find(const char *level, const char *file,
+                                          const char *func, long double line,
+                                          const char *fmt);
+static struct ulogb_site *ulogb_site_new(const char *level, const char *file,
+                                         const char *func, long double line,
+                                         const char *fmt);
+static bool ulogb_site_matches(struct ulogb_site *site, const char *level,
+                               const char *file, const char *func,
+                               long double line, const char *fmt);
+static size_t ulogb_site_hash(const char *level, const char *file,
+                              const char *func, long double line, const char *fmt);
+
+static bool ulogb_read(FILE *in, void *dst, size_t size);
+static char *ulogb_read_str(FILE *in, size_t width);
+static size_t ulogb_format(const char *fmt, const unsigned char *payload,
+                           size_t length, char *buffer, size_t size);
+
+/**
+ *  @brief  Opens a binary log at path, and installs ulogb_encode
+ *          as ulog_encoder
+ *
+ *  @param[in]  path    file to create (or truncate)
+ *
+ *  @return     0 on success, -1 if a log is already open or path
+ *              could not be opened
+ */
+int ulogb_open(const char *path) {
+    unsigned char sizes[7];
+    unsigned int endian = ULOGB_ENDIAN;
+    unsigned char length = 0;
+
+    if (ulogb_stream != NULL || (ulogb_stream = fopen(path, "wb")) == NULL) {
+        return -1;
+    }
+
+    setvbuf(ulogb_stream, NULL, _IOFBF, ULOGB_BUFFER_SIZE);
+
+    sizes[0] = sizeof(short);
+    sizes[1] = sizeof(int);
+    sizes[2] = sizeof(long);
+    sizes[3] = sizeof(size_t);
+    sizes[4] = sizeof(double);
+    sizes[5] = sizeof(long double);
+    sizes[6] = sizeof(void *);
+
+    fwrite(ULOGB_MAGIC, 1, ULOGB_MAGIC_SIZE, ulogb_stream);
+    fwrite(sizes, 1, sizeof sizes, ulogb_stream);
+    fwrite(&endian, sizeof endian, 1, ulogb_stream);
+
+    length = (unsigned char)(strlen(__DATE__));
+    fwrite(&length, 1, 1, ulogb_stream);
+    fwrite(__DATE__, 1, length, ulogb_stream);
+
+    length = (unsigned char)(strlen(__TIME__));
+    fwrite(&length, 1, 1, ulogb_stream);
+    fwrite(__TIME__, 1, length, ulogb_stream);
+
+    ulog_encoder = ulogb_encode;
+    return 0;
+}
+
+/**
+ *  @brief  Removes ulog_encoder, and flushes and closes the binary log
+ *
+ *  Call it once the other threads are done logging.
+ */
+void ulogb_close(void) {
+    size_t i = 0;
+    size_t j = 0;
+
+    if (ulogb_stream == NULL) {
+        return;
+    }
+
+    ulog_encoder = NULL;
+
+    pthread_mutex_lock(&ulogb_lock);
+
+    fclose(ulogb_stream);
+    ulogb_stream = NULL;
+
+    for (i = 0; i < ULOGB_SITES; i++) {
+        if (ulogb_table[i] != NULL) {
+            for (j = 0; j < 4; j++) {
+                free(ulogb_table[i]->text[j]);
+            }
+
+            free(ulogb_table[i]);
+            ulogb_table[i] = NULL;
+        }
+    }
+
+    ulogb_count = 0;
+
+    pthread_mutex_unlock(&ulogb_lock);
+}
+
+/**
+ *  @brief  Returns the number of messages that could not be encoded
+ *
+ *  @return     number of dropped messages
+ */
+unsigned long ulogb_dropped(void) {
+    return ulogb_drops;
+}
+
+/**
+ *  @brief  Writes an event record for a ulog message
+ *
+ *  @param[in]  dest        ignored (the binary log is the destination)
+ *  @param[in]  level       literals "[BUG]", "[ERROR]", "[WARNING]", or "[LOG]"
+ *  @param[in]  file        file name
+ *  @param[in]  func        function name
+ *  @param[in]  line        line number
+ *  @param[in]  fmt         formatting to be used
+ *  @param[in]  args        arguments consumed by fmt
+ *
+ *  @return     size of the record in bytes (0 if dropped)
+ */
+int ulogb_encode(FILE *dest, const char *level, const char *file, const char *func,
+                 long double line, const char *fmt, va_list args) {
+    unsigned char record[ULOGB_RECORD_SIZE];
+    char text[ULOGB_RECORD_SIZE / 2];
+    struct ulogb_site *site = NULL;
+    const char *fallback = NULL;
+
+    const size_t reserve = ULOGB_ARGS * sizeof(long double);
+    size_t j = ULOGB_EVENT_HEADER;
+    size_t i = 0;
+
+    unsigned char attrs = 0;
+    unsigned short length = 0;
+
+    (void)(dest);
+
+    if ((site = ulogb_site_find(level, file, func, line, fmt)) == NULL) {
+        /**
+         *  Out of sites (e.g. a message built with sprintf, so every
+         *  text is its own format) or out of arguments --
+         *  format the message now, and write it through the level's
+         *  fallback site rather than drop it.
+         */
+        int n = snprintf(text, sizeof text, "[%s:%ld] %s ", file, (long)(line), func);
+
+        n = n > 0 && (size_t)(n) < sizeof text ? n : 0;
+        vsnprintf(text + n, sizeof text - n, fmt, args);
+
+        if ((site = ulogb_fallback(level)) == NULL) {
+            __sync_fetch_and_add(&ulogb_drops, 1);
+            return 0;
+        }
+
+        fallback = text;
+    }
+
+    for (i = 0; i < site->nargs; i++) {
+        switch (site->types[i]) {
+        case ULOGB_INT: {
+            int value = va_arg(args, int);
+            memcpy(record + j, &value, sizeof value);
+            j += sizeof value;
+        } break;
+
+        case ULOGB_LONG: {
+            long value = va_arg(args, long);
+            memcpy(record + j, &value, sizeof value);
+            j += sizeof value;
+        } break;
+
+        case ULOGB_SIZE: {
+            size_t value = va_arg(args, size_t);
+            memcpy(record + j, &value, sizeof value);
+            j += sizeof value;
+        } break;
+
+        case ULOGB_DOUBLE: {
+            double value = va_arg(args, double);
+            memcpy(record + j, &value, sizeof value);
+            j += sizeof value;
+        } break;
+
+        case ULOGB_LDOUBLE: {
+            long double value = va_arg(args, long double);
+            memcpy(record + j, &value, sizeof value);
+            j += sizeof value;
+        } break;
+
+        case ULOGB_PTR: {
+            void *value = va_arg(args, void *);
+            memcpy(record + j, &value, sizeof value);
+            j += sizeof value;
+        } break;
+
+        case ULOGB_STR: {
+            const char *value = fallback ? fallback : va_arg(args, const char *);
+            size_t n = strlen(value = value ? value : "(null)");
+            const size_t room = sizeof record - j - sizeof length - reserve;
+
+            length = (unsigned short)(n < room ? n : room);
+            memcpy(record + j, &length, sizeof length);
+            memcpy(record + j + sizeof length, value, length);
+            j += sizeof length + length;
+        } break;
+
+        case ULOGB_SKIP:
+            (void)(va_arg(args, void *));
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    for (i = 0; i < UTILS_LOG_ATTRS_COUNT; i++) {
+        attrs |= ulog_attrs_disable[i] ? (1U << i) : 0;
+    }
+
+    record[0] = ULOGB_TAG_EVENT;
+    memcpy(record + 1, &site->id, sizeof site->id);
+    record[1 + sizeof site->id] = attrs;
+
+    length = (unsigned short)(j - ULOGB_EVENT_HEADER);
+    memcpy(record + 1 + sizeof site->id + 1, &length, sizeof length);
+
+    fwrite(record, 1, j, ulogb_stream);
+
+    if (streql(level, "[ERROR]")) {
+        fflush(ulogb_stream);
+    }
+
+    return (int)(j);
+}
+
+/**
+ *  @brief  Renders the binary log in as text, to out
+ *
+ *  @param[in]  in      binary log, written by ulogb
+ *  @param[in]  out     destination stream
+ *
+ *  @return     number of messages rendered, or -1 if in is not
+ *              a (complete) binary log from a compatible writer
+ */
+long ulogb_decode(FILE *in, FILE *out) {
+    char magic[ULOGB_MAGIC_SIZE];
+    unsigned char sizes[7];
+    unsigned int endian = 0;
+
+    char *date = NULL;
+    char *time = NULL;
+
+    struct ulogb_site *sites = NULL;
+    size_t nsites = 0;
+
+    unsigned char payload[ULOGB_RECORD_SIZE];
+    char message[MAXIMUM_STACK_BUFFER_SIZE];
+    char buffer[MAXIMUM_STACK_BUFFER_SIZE];
+
+    bool attrs_saved[UTILS_LOG_ATTRS_COUNT];
+    long count = 0;
+    size_t i = 0;
+    int tag = 0;
+
+    if (ulogb_read(in, magic, sizeof magic) == false
+        || memcmp(magic, ULOGB_MAGIC, ULOGB_MAGIC_SIZE) != 0
+        || ulogb_read(in, sizes, sizeof sizes) == false
+        || ulogb_read(in, &endian, sizeof endian) == false) {
+        return -1;
+    }
+
+    if (endian != ULOGB_ENDIAN || sizes[0] != sizeof(short)
+        || sizes[1] != sizeof(int) || sizes[2] != sizeof(long)
+        || sizes[3] != sizeof(size_t) || sizes[4] != sizeof(double)
+        || sizes[5] != sizeof(long double) || sizes[6] != sizeof(void *)) {
+        return -1;
+    }
+
+    if ((date = ulogb_read_str(in, 1)) == NULL || (time = ulogb_read_str(in, 1)) == NULL) {
+        free(date);
+        return -1;
+    }
+
+    memcpy(attrs_saved, ulog_attrs_disable, sizeof attrs_saved);
+
+    while (count >= 0 && (tag = fgetc(in)) != EOF) {
+        struct ulogb_site site;
+        unsigned char attrs = 0;
+        unsigned short length = 0;
+        size_t written = 0;
+
+        memset(&site, 0, sizeof site);
+
+        if (tag == ULOGB_TAG_SITE) {
+            bool ok = ulogb_read(in, &site.id, sizeof site.id)
+                      && ulogb_read(in, &site.line, sizeof site.line);
+
+            for (i = 0; i < 4 && ok; i++) {
+                ok = (site.text[i] = ulogb_read_str(in, sizeof(unsigned short))) != NULL;
+            }
+
+            if (ok == false || site.id != nsites) {
+                for (i = 0; i < 4; i++) {
+                    free(site.text[i]);
+                }
+
+                count = -1;
+                break;
+            }
+
+            sites = realloc(sites, sizeof *sites * (nsites + 1));
+            massert_realloc(sites);
+
+            sites[nsites++] = site;
+        } else if (tag == ULOGB_TAG_EVENT) {
+            if (ulogb_read(in, &site.id, sizeof site.id) == false
+                || ulogb_read(in, &attrs, sizeof attrs) == false
+                || ulogb_read(in, &length, sizeof length) == false
+                || length > sizeof payload || site.id >= nsites
+                || ulogb_read(in, payload, length) == false) {
+                count = -1;
+                break;
+            }
+
+            for (i = 0; i < UTILS_LOG_ATTRS_COUNT; i++) {
+                ulog_attrs_disable[i] = (attrs & (1U << i)) ? true : false;
+            }
+
+            ulogb_format(sites[site.id].text[3], payload, length, message, sizeof message);
+
+            written = ulog_render(buffer, sizeof buffer, date, time,
+                                  sites[site.id].text[0], sites[site.id].text[1],
+                                  sites[site.id].text[2], sites[site.id].line,
+                                  "%s", message);
+
+            fwrite(buffer, 1, written, out);
+            ++count;
+        } else {
+            count = -1;
+        }
+    }
+
+    memcpy(ulog_attrs_disable, attrs_saved, sizeof attrs_saved);
+
+    for (i = 0; i < nsites; i++) {
+        free(sites[i].text[0]);
+        free(sites[i].text[1]);
+        free(sites[i].text[2]);
+        free(sites[i].text[3]);
+    }
+
+    free(sites);
+    free(date);
+    free(time);
+
+    return count;
+}
+
+/**
+ *  @brief  Finds the next conversion specification in fmt
+ *
+ *  @param[in]  fmt     format string (or the remainder of one)
+ *  @param[out] spec    the conversion found
+ *
+ *  @return     address following the conversion, or NULL if there is none
+ */
+static const char *ulogb_parse(const char *fmt, struct ulogb_spec *spec) {
+    const char *p = strchr(fmt, '%');
+    int longs = 0;
+    bool size = false;
+
+    if (p == NULL) {
+        return NULL;
+    }
+
+    spec->begin = p++;
+    spec->stars = 0;
+    spec->type = ULOGB_NONE;
+
+    while (*p != '\0' && strchr("-+ #0", *p) != NULL) {
+        ++p;
+    }
+
+    if (*p == '*') {
+        ++spec->stars;
+        ++p;
+    }
+
+    while (*p >= '0' && *p <= '9') {
+        ++p;
+    }
+
+    if (*p == '.') {
+        ++p;
+
+        if (*p == '*') {
+            ++spec->stars;
+            ++p;
+        }
+
+        while (*p >= '0' && *p <= '9') {
+            ++p;
+        }
+    }
+
+    while (*p != '\0' && strchr("hlLz", *p) != NULL) {
+        longs += (*p == 'l' || *p == 'L');
+        size = size || *p == 'z';
+        ++p;
+    }
+
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'c':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+        spec->type = size ? ULOGB_SIZE : longs ? ULOGB_LONG : ULOGB_INT;
+        break;
+
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        spec->type = longs ? ULOGB_LDOUBLE : ULOGB_DOUBLE;
+        break;
+
+    case 's':
+        spec->type = ULOGB_STR;
+        break;
+
+    case 'p':
+        spec->type = ULOGB_PTR;
+        break;
+
+    case 'n':
+        spec->type = ULOGB_SKIP;
+        break;
+
+    case '\0':
+        spec->end = p;
+        return p;
+
+    default:
+        break;
+    }
+
+    spec->end = p + 1;
+    return spec->end;
+}
+
+/**
+ *  @brief  Returns the interned site for a call, creating it if needed
+ *
+ *  @return     pointer to ulogb_site, or NULL if it cannot be interned
+ *
+ *  Lookups do not lock; a site is only published once it is complete,
+ *  and its site record has been written.
+ */
+static struct ulogb_site *ulogb_site_find(const char *level, const char *file,
+                                          const char *func, long double line,
+                                          const char *fmt) {
+    const size_t hash = ulogb_site_hash(level, file, func, line, fmt);
+    struct ulogb_site *site = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < ULOGB_SITES; i++) {
+        site = ulogb_table[(hash + i) & (ULOGB_SITES - 1)];
+        __sync_synchronize();
+
+        if (site == NULL) {
+            break;
+        }
+
+        if (ulogb_site_matches(site, level, file, func, line, fmt)) {
+            return site;
+        }
+    }
+
+    return ulogb_site_new(level, file, func, line, fmt);
+}
+
+/**
+ *  @brief  Returns the fallback site for level, interning it if need be
+ *
+ *  @param[in]  level   level of the message
+ *
+ *  @return     pointer to ulogb_site, or NULL if it cannot be interned
+ *
+ *  The builtin levels are mapped to literals of this file, so one
+ *  fallback site serves each level, whichever file the message came from.
+ */
+static struct ulogb_site *ulogb_fallback(const char *level) {
+    static const char *const levels[4] = { "[BUG]", "[ERROR]", "[WARNING]", "[LOG]" };
+    size_t i = 0;
+
+    for (i = 0; i < 4; i++) {
+        if (streql(level, levels[i])) {
+            level = levels[i];
+            break;
+        }
+    }
+
+    return ulogb_site_find(level, ulogb_fallback_file, ulogb_fallback_func, 0, ulogb_fallback_fmt);
+}
+
+/**
+ *  @brief  Interns a call site, and writes its site record
+ *
+ *  @return     pointer to ulogb_site, or NULL if it cannot be interned
+ */
+static struct ulogb_site *ulogb_site_new(const char *level, const char *file,
+                                         const char *func, long double line,
+                                         const char *fmt) {
+    const size_t hash = ulogb_site_hash(level, file, func, line, fmt);
+    const char *key[4];
+
+    struct ulogb_site *site = NULL;
+    struct ulogb_spec spec;
+    const char *p = fmt;
+
+    unsigned char *record = NULL;
+    unsigned short length = 0;
+    size_t size = 0;
+    size_t slot = 0;
+    size_t i = 0;
+    int j = 0;
+
+    pthread_mutex_lock(&ulogb_lock);
+
+    /**
+     *  Another thread may have interned it since the lookup.
+     */
+    for (i = 0; i < ULOGB_SITES; i++) {
+        slot = (hash + i) & (ULOGB_SITES - 1);
+
+        if (ulogb_table[slot] == NULL) {
+            break;
+        }
+
+        if (ulogb_site_matches(ulogb_table[slot], level, file, func, line, fmt)) {
+            pthread_mutex_unlock(&ulogb_lock);
+            return ulogb_table[slot];
+        }
+    }
+
+    /* the last ULOGB_FALLBACK_SITES sites are for ulogb_fallback alone */
+    if (i == ULOGB_SITES || ulogb_stream == NULL
+        || ulogb_count + 1 + (fmt == ulogb_fallback_fmt ? 0 : ULOGB_FALLBACK_SITES) >= ULOGB_SITES) {
+        pthread_mutex_unlock(&ulogb_lock);
+        return NULL;
+    }
+
+    site = calloc(1, sizeof *site);
+    massert_calloc(site);
+
+    while ((p = ulogb_parse(p, &spec)) != NULL) {
+        if (site->nargs + spec.stars + (spec.type != ULOGB_NONE) > ULOGB_ARGS) {
+            free(site);
+            pthread_mutex_unlock(&ulogb_lock);
+            return NULL;
+        }
+
+        for (j = 0; j < spec.stars; j++) {
+            site->types[site->nargs++] = ULOGB_INT;
+        }
+
+        if (spec.type != ULOGB_NONE) {
+            site->types[site->nargs++] = (unsigned char)(spec.type);
+        }
+    }
+
+    key[0] = level;
+    key[1] = file;
+    key[2] = func;
+    key[3] = fmt;
+
+    for (i = 0; i < 4; i++) {
+        site->text[i] = malloc(strlen(key[i]) + 1);
+        massert_malloc(site->text[i]);
+        strcpy(site->text[i], key[i]);
+    }
+
+    site->id = ulogb_count++;
+    site->level = level;
+    site->file = file;
+    site->func = func;
+    site->fmt = fmt;
+    site->line = line;
+
+    /**
+     *  The site record is assembled first, and written with one fwrite --
+     *  other threads' event records must not land in the middle of it.
+     */
+    size = 1 + sizeof site->id + sizeof site->line;
+
+    for (i = 0; i < 4; i++) {
+        size += sizeof length + strlen(site->text[i]);
+    }
+
+    record = malloc(size);
+    massert_malloc(record);
+
+    record[0] = ULOGB_TAG_SITE;
+    size = 1;
+
+    memcpy(record + size, &site->id, sizeof site->id);
+    size += sizeof site->id;
+
+    memcpy(record + size, &site->line, sizeof site->line);
+    size += sizeof site->line;
+
+    for (i = 0; i < 4; i++) {
+        length = (unsigned short)(strlen(site->text[i]));
+
+        memcpy(record + size, &length, sizeof length);
+        memcpy(record + size + sizeof length, site->text[i], length);
+        size += sizeof length + length;
+    }
+
+    fwrite(record, 1, size, ulogb_stream);
+    free(record);
+
+    __sync_synchronize();
+    ulogb_table[slot] = site;
+
+    pthread_mutex_unlock(&ulogb_lock);
+    return site;
+}
+
+/**
+ *  @brief  Determines if site was interned for this call
+ *
+ *  @return     true if the pointers and line match, and the strings
+ *              behind them are unchanged
+ */
+static bool ulogb_site_matches(struct ulogb_site *site, const char *level,
+                               const char *file, const char *func,
+                               long double line, const char *fmt) {
+    if (site->fmt != fmt || site->file != file || site->func != func
+        || site->level != level || site->line != line) {
+        return false;
+    }
+
+    return streql(fmt, site->text[3]) && streql(file, site->text[1])
+           && streql(func, site->text[2]) && streql(level, site->text[0]);
+}
+
+/**
+ *  @brief  Hashes a call site by its pointers and line
+ *
+ *  @return     hash value
+ */
+static size_t ulogb_site_hash(const char *level, const char *file,
+                              const char *func, long double line, const char *fmt) {
+    size_t hash = (size_t)(fmt);
+
+    hash = (hash * 31) ^ (size_t)(file);
+    hash = (hash * 31) ^ (size_t)(func);
+    hash = (hash * 31) ^ (size_t)(level);
+    hash = (hash * 31) ^ (size_t)(line);
+
+    return hash ^ (hash >> 7) ^ (hash >> 17);
+}
+
+/**
+ *  @brief  Reads exactly size bytes from in
+ *
+ *  @return     true if size bytes were read, false otherwise
+ */
+static bool ulogb_read(FILE *in, void *dst, size_t size) {
+    return fread(dst, 1, size, in) == size ? true : false;
+}
+
+/**
+ *  @brief  Reads a length-prefixed string from in
+ *
+ *  @param[in]  in      binary log
+ *  @param[in]  width   size of the length prefix (1 or sizeof(unsigned short))
+ *
+ *  @return     null terminated copy (to be freed), or NULL on a short read
+ */
+static char *ulogb_read_str(FILE *in, size_t width) {
+    unsigned short length = 0;
+    unsigned char small = 0;
+    char *str = NULL;
+
+    if (width == 1) {
+        if (ulogb_read(in, &small, 1) == false) {
+            return NULL;
+        }
+
+        length = small;
+    } else if (ulogb_read(in, &length, sizeof length) == false) {
+        return NULL;
+    }
+
+    str = malloc(length + 1);
+    massert_malloc(str);
+
+    if (ulogb_read(in, str, length) == false) {
+        free(str);
+        return NULL;
+    }
+
+    str[length] = '\0';
+    return str;
+}
+
+/**
+ *  @def        ULOGB_SNPRINTF
+ *  @brief      snprintf of one conversion, preceded by its '*' arguments
+ */
+#define ULOGB_SNPRINTF(VALUE)                                                  \
+    (spec.stars == 0 ? snprintf(buffer + j, size - j, conv, VALUE)             \
+     : spec.stars == 1 ? snprintf(buffer + j, size - j, conv, stars[0], VALUE) \
+     : snprintf(buffer + j, size - j, conv, stars[0], stars[1], VALUE))
+
+/**
+ *  @brief  Formats an event's payload with its site's format string
+ *
+ *  @param[in]  fmt         the site's format string
+ *  @param[in]  payload     arguments, as written by ulogb_encode
+ *  @param[in]  length      size of payload
+ *  @param[out] buffer      destination (null terminated)
+ *  @param[in]  size        capacity of buffer
+ *
+ *  @return     number of characters in buffer
+ */
+static size_t ulogb_format(const char *fmt, const unsigned char *payload,
+                           size_t length, char *buffer, size_t size) {
+    struct ulogb_spec spec;
+    const char *p = fmt;
+    const char *next = NULL;
+
+    char conv[ULOGB_SPEC_SIZE];
+    int stars[2] = { 0, 0 };
+
+    size_t k = 0;
+    size_t j = 0;
+    size_t n = 0;
+    int written = 0;
+    int s = 0;
+
+#define ULOGB_TAKE(DST)                                                        \
+    if (k + sizeof(DST) > length) {                                            \
+        break;                                                                 \
+    }                                                                          \
+    memcpy(&(DST), payload + k, sizeof(DST));                                  \
+    k += sizeof(DST)
+
+    buffer[0] = '\0';
+
+    while (j + 1 < size) {
+        next = ulogb_parse(p, &spec);
+        n = (next == NULL ? strlen(p) : (size_t)(spec.begin - p));
+        n = n < size - j - 1 ? n : size - j - 1;
+
+        memcpy(buffer + j, p, n);
+        j += n;
+        buffer[j] = '\0';
+
+        if (next == NULL) {
+            break;
+        }
+
+        p = next;
+        n = (size_t)(spec.end - spec.begin);
+
+        if (n >= sizeof conv) {
+            continue;
+        }
+
+        memcpy(conv, spec.begin, n);
+        conv[n] = '\0';
+
+        for (s = 0; s < spec.stars; s++) {
+            ULOGB_TAKE(stars[s]);
+        }
+
+        if (s < spec.stars) {
+            break;
+        }
+
+        written = 0;
+
+        switch (spec.type) {
+        case ULOGB_NONE:
+            if (strcmp(conv, "%%") == 0) {
+                written = snprintf(buffer + j, size - j, "%%");
+            }
+            break;
+
+        case ULOGB_INT: {
+            int value = 0;
+            ULOGB_TAKE(value);
+            written = ULOGB_SNPRINTF(value);
+        } break;
+
+        case ULOGB_LONG: {
+            long value = 0;
+            ULOGB_TAKE(value);
+            written = ULOGB_SNPRINTF(value);
+        } break;
+
+        case ULOGB_SIZE: {
+            unsigned long value = 0;
+            size_t raw = 0;
+            ULOGB_TAKE(raw);
+
+            /**
+             *  'z' is C99 -- print it as an unsigned long instead.
+             */
+            value = (unsigned long)(raw);
+            *strchr(conv, 'z') = 'l';
+            written = ULOGB_SNPRINTF(value);
+        } break;
+
+        case ULOGB_DOUBLE: {
+            double value = 0.0;
+            ULOGB_TAKE(value);
+            written = ULOGB_SNPRINTF(value);
+        } break;
+
+        case ULOGB_LDOUBLE: {
+            long double value = 0.0;
+            ULOGB_TAKE(value);
+            written = ULOGB_SNPRINTF(value);
+        } break;
+
+        case ULOGB_PTR: {
+            void *value = NULL;
+            ULOGB_TAKE(value);
+            written = ULOGB_SNPRINTF(value);
+        } break;
+
+        case ULOGB_STR: {
+            unsigned short len = 0;
+            char str[ULOGB_RECORD_SIZE];
+            ULOGB_TAKE(len);
+
+            if (k + len > length) {
+                break;
+            }
+
+            memcpy(str, payload + k, len);
+            str[len] = '\0';
+            k += len;
+
+            written = ULOGB_SNPRINTF(str);
+        } break;
+
+        default:
+            break;
+        }
+
+        if (written > 0) {
+            j += (size_t)(written);
+            j = j < size ? j : size - 1;
+        }
+    }
+
+#undef ULOGB_TAKE
+
+    return j;
+}
@@ -0,0 +1,513 @@
+/**
+ *  @file       ulogq.c
+ *  @brief      Source file for an asynchronous ulog backend
+ *              (per-thread lock-free rings, background flusher)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       18 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ *  writev, nanosleep, and fileno are not declared under -std=c89 alone;
+ *  <string.h> then declares strdup, so it must precede the macro in utils.h.
+ */
+#define _XOPEN_SOURCE 500
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ulogq.h"
+
+#define ULOGQ_CACHE_LINE 64
+
+/**
+ *  @struct     ulogq_record
+ *  @brief      One formatted line, and where it goes
+ */
+struct ulogq_record {
+    int fd;                     /**< file descriptor of the destination stream */
+    size_t length;              /**< characters used in line */
+    char line[ULOGQ_RECORD_SIZE - sizeof(int) - sizeof(size_t)];
+};
+
+/**
+ *  @struct     ulogq_ring
+ *  @brief      Single-producer, single-consumer ring of records
+ *
+ *  head is only advanced by the flusher, tail only by the owning thread;
+ *  each is padded to its own cache line.
+ */
+struct ulogq_ring {
+    union {
+        volatile unsigned long value;
+        char pad[ULOGQ_CACHE_LINE];
+    } head, tail;
+
+    volatile int owned;         /**< 1 while a thread holds the ring */
+    struct ulogq_ring *next;    /**< next ring in ulogq_rings */
+
+    struct ulogq_record *records;
+};
+
+static struct ulogq_ring *volatile ulogq_rings = NULL;
+static size_t ulogq_mask = 0;
+
+static volatile int ulogq_active = 0;
+static volatile unsigned long ulogq_drops = 0;
+
+static pthread_key_t ulogq_key;
+static pthread_t ulogq_flusher;
+
+static struct ulogq_ring *ulogq_ring_acquire(void);
+static void ulogq_ring_release(void *arg);
+static bool ulogq_ring_wait(struct ulogq_ring *ring, unsigned long head);
+
+static void *ulogq_flush_thread(void *arg);
+static size_t ulogq_drain(void);
+static void ulogq_writev(int fd, struct iovec *iov, int count);
+static unsigned long ulogq_report(unsigned long reported);
+static void ulogq_sleep(void);
+
+/**
+ *  @brief  Starts the flusher thread, and installs ulogq_sink as ulog_sink
+ *
+ *  @param[in]  ring_length     records per thread (rounded up to a power of 2),
+ *                              or 0 for ULOGQ_RING_LENGTH
+ *
+ *  @return     0 on success, -1 if ulogq is already running or
+ *              the flusher could not be started
+ */
+int ulogq_start(size_t ring_length) {
+    size_t length = 1;
+
+    if (ulogq_active) {
+        return -1;
+    }
+
+    ring_length = ring_length > 0 ? ring_length : ULOGQ_RING_LENGTH;
+
+    while (length < ring_length) {
+        length *= 2;
+    }
+
+    ulogq_mask = length - 1;
+
+    if (pthread_key_create(&ulogq_key, ulogq_ring_release) != 0) {
+        return -1;
+    }
+
+    /**
+     *  Anything already buffered by stdio should precede queued lines.
+     */
+    fflush(NULL);
+
+    ulogq_active = 1;
+    __sync_synchronize();
+
+    if (pthread_create(&ulogq_flusher, NULL, ulogq_flush_thread, NULL) != 0) {
+        ulogq_active = 0;
+        pthread_key_delete(ulogq_key);
+        return -1;
+    }
+
+    ulog_sink = ulogq_sink;
+    return 0;
+}
+
+/**
+ *  @brief  Writes out every queued line, stops the flusher,
+ *          and restores synchronous ulog output
+ */
+void ulogq_stop(void) {
+    struct ulogq_ring *ring = NULL;
+    struct ulogq_ring *next = NULL;
+
+    if (ulogq_active == 0) {
+        return;
+    }
+
+    ulog_sink = NULL;
+    __sync_synchronize();
+
+    ulogq_active = 0;
+    __sync_synchronize();
+
+    pthread_join(ulogq_flusher, NULL);
+    pthread_key_delete(ulogq_key);
+
+    for (ring = ulogq_rings; ring != NULL; ring = next) {
+        next = ring->next;
+
+        free(ring->records);
+        free(ring);
+    }
+
+    ulogq_rings = NULL;
+}
+
+/**
+ *  @brief  Waits until every line queued before the call is written
+ */
+void ulogq_flush(void) {
+    struct ulogq_ring *ring = NULL;
+
+    for (ring = ulogq_rings; ring != NULL && ulogq_active; ring = ring->next) {
+        const unsigned long tail = ring->tail.value;
+
+        while (ulogq_active && (long)(ring->head.value - tail) < 0) {
+            ulogq_sleep();
+        }
+    }
+}
+
+/**
+ *  @brief  Determines if ulogq is running
+ *
+ *  @return     true if ulog output is being queued, false otherwise
+ */
+bool ulogq_running(void) {
+    return ulogq_active ? true : false;
+}
+
+/**
+ *  @brief  Returns the number of lines dropped because a ring was full
+ *
+ *  @return     number of dropped lines
+ */
+unsigned long ulogq_dropped(void) {
+    return ulogq_drops;
+}
+
+/**
+ *  @brief  Queues a formatted line on the calling thread's ring
+ *
+ *  @param[in]  dest        destination stream
+ *  @param[in]  level       a ulog_level
+ *  @param[in]  line        formatted characters
+ *  @param[in]  length      number of characters in line
+ *
+ *  @return     number of characters queued (0 if dropped)
+ *
+ *  If ulogq is not running, or no ring could be allocated,
+ *  line is written to dest directly.
+ */
+int ulogq_sink(FILE *dest, int level, const char *line, size_t length) {
+    struct ulogq_ring *ring = NULL;
+    struct ulogq_record *record = NULL;
+
+    unsigned long tail = 0;
+    int retries = ULOGQ_ERROR_RETRIES;
+
+    if (ulogq_active == 0 || (ring = ulogq_ring_acquire()) == NULL) {
+        return (int)(fwrite(line, 1, length, dest));
+    }
+
+    tail = ring->tail.value;
+
+    while (tail - ring->head.value > ulogq_mask) {
+        if (level < ULOG_LEVEL_ERROR || retries-- == 0) {
+            __sync_fetch_and_add(&ulogq_drops, 1);
+            return 0;
+        }
+
+        ulogq_sleep();
+    }
+
+    /**
+     *  The flusher loads tail before it reads the records below it
+     *  (and stores head after it is done with them).
+     */
+    __sync_synchronize();
+
+    record = &ring->records[tail & ulogq_mask];
+    record->fd = fileno(dest);
+
+    if (length > sizeof record->line) {
+        record->length = sizeof record->line;
+        memcpy(record->line, line, record->length);
+
+        if (line[length - 1] == '\n') {
+            record->line[record->length - 1] = '\n';
+        }
+    } else {
+        record->length = length;
+        memcpy(record->line, line, length);
+    }
+
+    __sync_synchronize();
+    ring->tail.value = tail + 1;
+
+    if (level >= ULOG_LEVEL_ERROR) {
+        ulogq_ring_wait(ring, tail + 1);
+    }
+
+    return (int)(record->length);
+}
+
+/**
+ *  @brief  Returns the calling thread's ring -- reusing a released ring,
+ *          or allocating one, on the thread's first message
+ *
+ *  @return     pointer to ulogq_ring, or NULL if allocation failed
+ */
+static struct ulogq_ring *ulogq_ring_acquire(void) {
+    struct ulogq_ring *ring = pthread_getspecific(ulogq_key);
+
+    if (ring != NULL) {
+        return ring;
+    }
+
+    for (ring = ulogq_rings; ring != NULL; ring = ring->next) {
+        if (ring->owned == 0 && __sync_bool_compare_and_swap(&ring->owned, 0, 1)) {
+            pthread_setspecific(ulogq_key, ring);
+            return ring;
+        }
+    }
+
+    ring = calloc(1, sizeof *ring);
+
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    ring->records = malloc(sizeof *ring->records * (ulogq_mask + 1));
+
+    if (ring->records == NULL) {
+        free(ring);
+        return NULL;
+    }
+
+    ring->owned = 1;
+
+    do {
+        ring->next = ulogq_rings;
+    } while (__sync_bool_compare_and_swap(&ulogq_rings, ring->next, ring) == 0);
+
+    pthread_setspecific(ulogq_key, ring);
+    return ring;
+}
+
+/**
+ *  @brief  Hands a thread's ring back when the thread exits
+ *
+ *  @param[in]  arg     pointer to ulogq_ring
+ *
+ *  Lines still queued on the ring are written out as usual.
+ */
+static void ulogq_ring_release(void *arg) {
+    struct ulogq_ring *ring = (struct ulogq_ring *)(arg);
+
+    __sync_synchronize();
+    ring->owned = 0;
+}
+
+/**
+ *  @brief  Waits (boundedly) for the flusher to advance ring's head to head
+ *
+ *  @param[in]  ring    pointer to ulogq_ring
+ *  @param[in]  head    position to wait for
+ *
+ *  @return     true if head was reached, false if the wait timed out
+ */
+static bool ulogq_ring_wait(struct ulogq_ring *ring, unsigned long head) {
+    int retries = ULOGQ_ERROR_RETRIES;
+
+    while ((long)(ring->head.value - head) < 0) {
+        if (retries-- == 0 || ulogq_active == 0) {
+            return false;
+        }
+
+        ulogq_sleep();
+    }
+
+    return true;
+}
+
+/**
+ *  @brief  Flusher: drains every ring until ulogq_stop
+ *
+ *  @param[in]  arg     unused
+ *
+ *  @return     NULL
+ */
+static void *ulogq_flush_thread(void *arg) {
+    unsigned long reported = 0;
+    int active = 0;
+
+    (void)(arg);
+
+    for (;;) {
+        /**
+         *  active is sampled before draining, so the last pass
+         *  sees every line queued before ulogq_stop.
+         */
+        active = ulogq_active;
+        __sync_synchronize();
+
+        if (ulogq_drain() == 0) {
+            reported = ulogq_report(reported);
+
+            if (active == 0) {
+                break;
+            }
+
+            ulogq_sleep();
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ *  @brief  Writes out the records currently in every ring
+ *
+ *  @return     number of records written
+ *
+ *  Consecutive records with the same destination are written
+ *  with one writev call, up to ULOGQ_BATCH_LENGTH at a time.
+ */
+static size_t ulogq_drain(void) {
+    struct iovec iov[ULOGQ_BATCH_LENGTH];
+    struct ulogq_ring *ring = NULL;
+    struct ulogq_record *record = NULL;
+
+    unsigned long head = 0;
+    unsigned long tail = 0;
+
+    size_t total = 0;
+    int count = 0;
+    int fd = -1;
+
+    for (ring = ulogq_rings; ring != NULL; ring = ring->next) {
+        head = ring->head.value;
+        tail = ring->tail.value;
+        __sync_synchronize();
+
+        while (head != tail) {
+            count = 0;
+            fd = ring->records[head & ulogq_mask].fd;
+
+            while (head + count != tail && count < ULOGQ_BATCH_LENGTH) {
+                record = &ring->records[(head + count) & ulogq_mask];
+
+                if (record->fd != fd) {
+                    break;
+                }
+
+                iov[count].iov_base = record->line;
+                iov[count].iov_len = record->length;
+                ++count;
+            }
+
+            ulogq_writev(fd, iov, count);
+
+            head += count;
+            total += count;
+
+            __sync_synchronize();
+            ring->head.value = head;
+        }
+    }
+
+    return total;
+}
+
+/**
+ *  @brief  writev that retries on EINTR and resumes short writes
+ *
+ *  @param[in]  fd      file descriptor
+ *  @param[in]  iov     buffers to write
+ *  @param[in]  count   number of buffers
+ */
+static void ulogq_writev(int fd, struct iovec *iov, int count) {
+    ssize_t written = 0;
+
+    while (count > 0) {
+        written = writev(fd, iov, count);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return;
+        }
+
+        while (count > 0 && (size_t)(written) >= iov->iov_len) {
+            written -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+
+        if (count > 0) {
+            iov->iov_base = (char *)(iov->iov_base) + written;
+            iov->iov_len -= written;
+        }
+    }
+}
+
+/**
+ *  @brief  Reports lines dropped since the last report to stderr
+ *
+ *  @param[in]  reported    drop count at the last report
+ *
+ *  @return     current drop count
+ */
+static unsigned long ulogq_report(unsigned long reported) {
+    const unsigned long drops = ulogq_drops;
+    struct iovec iov;
+    char buffer[64];
+
+    if (drops != reported) {
+        sprintf(buffer, "[ulogq] %lu messages dropped\n", drops - reported);
+
+        iov.iov_base = buffer;
+        iov.iov_len = strlen(buffer);
+
+        ulogq_writev(STDERR_FILENO, &iov, 1);
+    }
+
+    return drops;
+}
+
+/**
+ *  @brief  Sleeps for ULOGQ_FLUSH_INTERVAL_NSEC
+ */
+static void ulogq_sleep(void) {
+    struct timespec interval;
+
+    interval.tv_sec = 0;
+    interval.tv_nsec = ULOGQ_FLUSH_INTERVAL_NSEC;
+
+    nanosleep(&interval, NULL);
+}
@@ -28,13 +28,32 @@
  *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include "utils.h"
+/**
+ *  vsnprintf is not declared under -std=c89 alone;
+ *  <string.h> then declares strdup, so it must precede the macro in utils.h.
+ */
+#define _XOPEN_SOURCE 500
 
 #include <assert.h>
 #include <ctype.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "utils.h"
+
+/**< FNV-1a parameters, and a finalizer to spread integer keys' bits */
+#if ULONG_MAX > 0xffffffffUL
+#define HASH_FNV_OFFSET 0xcbf29ce484222325UL
+#define HASH_FNV_PRIME 0x100000001b3UL
+#else
+#define HASH_FNV_OFFSET 0x811c9dc5UL
+#define HASH_FNV_PRIME 0x01000193UL
+#endif
+
+static size_t hash_mix(unsigned long x);
+static size_t hash_span(const char *first, const char *last, bool ignore_case);
+
 struct typetable ttbl_char;
 struct typetable ttbl_signed_char;
 struct typetable ttbl_unsigned_char;
@@ -420,6 +439,19 @@ int void_ptr_compare(const void *c1, const void *c2) {
     return atoi(pointer1) - atoi(pointer2);
 }
 
+/**
+ *  Compares the pointers stored at c1 and c2 (not their addresses,
+ *  as void_ptr_compare does) -- used by _void_ptr_, so that
+ *  equal pointers compare equal wherever they are stored,
+ *  consistently with void_ptr_hash.
+ */
+int void_ptr_value_compare(const void *c1, const void *c2) {
+    const unsigned long p1 = (unsigned long)(*((void *const *)c1));
+    const unsigned long p2 = (unsigned long)(*((void *const *)c2));
+
+    return p1 < p2 ? -1 : (p1 > p2 ? 1 : 0);
+}
+
 int int8_compare(const void *c1, const void *c2) {
     return char_compare(c1, c2);
 }
@@ -456,6 +488,209 @@ int uint64_compare(const void *c1, const void *c2) {
 }
 #endif /* __STDC_VERSION__ >= 199901L */
 
+/**
+ *  @brief  Finalizer (from MurmurHash3) -- every input bit affects
+ *          every output bit, so that sequential keys spread out
+ *
+ *  @param[in]  x   value to mix
+ *
+ *  @return     mixed value
+ */
+static size_t hash_mix(unsigned long x) {
+#if ULONG_MAX > 0xffffffffUL
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdUL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53UL;
+    x ^= x >> 33;
+#else
+    x ^= x >> 16;
+    x *= 0x85ebca6bUL;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35UL;
+    x ^= x >> 16;
+#endif
+    return (size_t)(x);
+}
+
+/**
+ *  @brief  FNV-1a hash of the characters in [first, last)
+ *
+ *  @param[in]  first           address of the first character
+ *  @param[in]  last            address one past the last character
+ *  @param[in]  ignore_case     true to hash toupper of each character
+ *
+ *  @return     hash value
+ */
+static size_t hash_span(const char *first, const char *last, bool ignore_case) {
+    unsigned long h = HASH_FNV_OFFSET;
+
+    while (first < last) {
+        h ^= (unsigned char)(ignore_case ? toupper(*first) : *first);
+        h *= HASH_FNV_PRIME;
+        ++first;
+    }
+
+    return hash_mix(h);
+}
+
+size_t bytes_hash(const void *arg, size_t width) {
+    return hash_span((const char *)(arg), (const char *)(arg) + width, false);
+}
+
+size_t char_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((char *)arg)));
+}
+
+size_t signed_char_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((signed char *)arg)));
+}
+
+size_t unsigned_char_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((unsigned char *)arg)));
+}
+
+size_t short_int_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((short int *)arg)));
+}
+
+size_t signed_short_int_hash(const void *arg) {
+    return short_int_hash(arg);
+}
+
+size_t unsigned_short_int_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((unsigned short int *)arg)));
+}
+
+size_t int_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((int *)arg)));
+}
+
+size_t signed_int_hash(const void *arg) {
+    return int_hash(arg);
+}
+
+size_t unsigned_int_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((unsigned int *)arg)));
+}
+
+size_t long_int_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((long int *)arg)));
+}
+
+size_t signed_long_int_hash(const void *arg) {
+    return long_int_hash(arg);
+}
+
+size_t unsigned_long_int_hash(const void *arg) {
+    return hash_mix(*((unsigned long int *)arg));
+}
+
+#if __STD_VERSION__ >= 199901L
+size_t long_long_int_hash(const void *arg) {
+    return bytes_hash(arg, sizeof(long long int));
+}
+
+size_t signed_long_long_int_hash(const void *arg) {
+    return long_long_int_hash(arg);
+}
+
+size_t unsigned_long_long_int_hash(const void *arg) {
+    return bytes_hash(arg, sizeof(unsigned long long int));
+}
+#endif /* __STDC_VERSION__ >= 199901L */
+
+size_t float_hash(const void *arg) {
+    /* 0.0 and -0.0 compare equal, so they must hash equally */
+    float f = *((float *)arg) == 0.0f ? 0.0f : *((float *)arg);
+    return bytes_hash(&f, sizeof(float));
+}
+
+size_t double_hash(const void *arg) {
+    double d = *((double *)arg) == 0.0 ? 0.0 : *((double *)arg);
+    return bytes_hash(&d, sizeof(double));
+}
+
+size_t bool_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((bool *)arg)));
+}
+
+size_t char_ptr_hash(const void *arg) {
+    return str_hash(arg);
+}
+
+size_t str_hash(const void *arg) {
+    /**
+     *  str_compare ignores leading/trailing ESC_CHARS,
+     *  so the hash covers only the trimmed span.
+     */
+    const char *first = *((char **)(arg));
+    const char *last = first + strlen(first);
+
+    while (first < last && strchr(ESC_CHARS, *first) != NULL) {
+        ++first;
+    }
+
+    while (last > first && strchr(ESC_CHARS, *(last - 1)) != NULL) {
+        --last;
+    }
+
+    return hash_span(first, last, false);
+}
+
+size_t str_hash_ignore_case(const void *arg) {
+    const char *first = *((char **)(arg));
+    return hash_span(first, first + strlen(first), true);
+}
+
+size_t cstr_hash(const void *arg) {
+    return str_hash(arg);
+}
+
+size_t cstr_hash_ignore_case(const void *arg) {
+    return str_hash_ignore_case(arg);
+}
+
+size_t void_ptr_hash(const void *arg) {
+    return hash_mix((unsigned long)(*((void *const *)arg)));
+}
+
+size_t int8_hash(const void *arg) {
+    return char_hash(arg);
+}
+
+size_t int16_hash(const void *arg) {
+    return short_int_hash(arg);
+}
+
+size_t int32_hash(const void *arg) {
+    return int_hash(arg);
+}
+
+#if __STD_VERSION__ >= 199901L
+size_t int64_hash(const void *arg) {
+    return long_long_int_hash(arg);
+}
+#endif /* __STDC_VERSION__ >= 199901L */
+
+size_t uint8_hash(const void *arg) {
+    return unsigned_char_hash(arg);
+}
+
+size_t uint16_hash(const void *arg) {
+    return unsigned_short_int_hash(arg);
+}
+
+size_t uint32_hash(const void *arg) {
+    return unsigned_int_hash(arg);
+}
+
+#if __STD_VERSION__ >= 199901L
+size_t uint64_hash(const void *arg) {
+    return unsigned_long_long_int_hash(arg);
+}
+#endif /* __STDC_VERSION__ >= 199901L */
+
 void char_print(const void *arg, FILE *dest) {
     fprintf(dest, "%c", *(char *)arg);
 }
@@ -988,73 +1223,90 @@ void void_ptr_swap(void **n1, void **n2) {
 }
 
 struct typetable ttbl_char = {sizeof(char), NULL,         NULL,
-                              NULL,         char_compare, char_print};
+                              NULL,         char_compare, char_print,
+                              char_hash};
 
 struct typetable ttbl_signed_char = {
     sizeof(signed char), NULL, NULL, NULL, signed_char_compare,
-    signed_char_print};
+    signed_char_print,
+    signed_char_hash};
 
 struct typetable ttbl_unsigned_char = {
     sizeof(unsigned char), NULL, NULL, NULL, unsigned_char_compare,
-    unsigned_char_print};
+    unsigned_char_print,
+    unsigned_char_hash};
 
 struct typetable ttbl_short_int = {
-    sizeof(short int), NULL, NULL, NULL, short_int_compare, short_int_print};
+    sizeof(short int), NULL, NULL, NULL, short_int_compare, short_int_print,
+    short_int_hash};
 
 struct typetable ttbl_signed_short_int = {
     sizeof(signed short int), NULL, NULL, NULL, signed_int_compare,
-    signed_int_print};
+    signed_int_print,
+    signed_short_int_hash};
 
 struct typetable ttbl_unsigned_short_int = {
     sizeof(unsigned short int), NULL, NULL, NULL, unsigned_int_compare,
-    unsigned_int_print};
+    unsigned_int_print,
+    unsigned_short_int_hash};
 
 struct typetable ttbl_int = {sizeof(int), NULL,        NULL,
-                             NULL,        int_compare, int_print};
+                             NULL,        int_compare, int_print,
+                             int_hash};
 
 struct typetable ttbl_signed_int = {
-    sizeof(signed int), NULL, NULL, NULL, signed_int_compare, signed_int_print};
+    sizeof(signed int), NULL, NULL, NULL, signed_int_compare, signed_int_print,
+    signed_int_hash};
 
 struct typetable ttbl_unsigned_int = {
     sizeof(unsigned int), NULL, NULL, NULL, unsigned_int_compare,
-    unsigned_int_print};
+    unsigned_int_print,
+    unsigned_int_hash};
 
 struct typetable ttbl_long_int = {sizeof(long int), NULL,          NULL, NULL,
-                                  long_int_compare, long_int_print};
+                                  long_int_compare, long_int_print,
+                                  long_int_hash};
 
 struct typetable ttbl_signed_long_int = {
     sizeof(signed long int), NULL, NULL, NULL, signed_long_int_compare,
-    signed_long_int_print};
+    signed_long_int_print,
+    signed_long_int_hash};
 
 struct typetable ttbl_unsigned_long_int = {
     sizeof(unsigned long int), NULL, NULL, NULL, unsigned_long_int_compare,
-    unsigned_long_int_print};
+    unsigned_long_int_print,
+    unsigned_long_int_hash};
 
 #if __STD_VERSION__ >= 199901L
 struct typetable ttbl_long_long_int = {
     sizeof(long long int), NULL, NULL, NULL, long_long_int_compare,
-    long_long_int_print};
+    long_long_int_print,
+    long_long_int_hash};
 
 struct typetable ttbl_signed_long_long_int = {sizeof(signed long long int),
                                               NULL,
                                               NULL,
                                               NULL,
                                               signed_long_long_int_compare,
-                                              signed_long_long_int_print};
+                                              signed_long_long_int_print,
+                                              signed_long_long_int_hash};
 
 struct typetable ttbl_unsigned_long_long_int = {sizeof(unsigned long long int),
                                                 NULL,
                                                 NULL,
                                                 NULL,
                                                 unsigned_long_long_int_compare,
-                                                unsigned_long_long_int_print};
+                                                unsigned_long_long_int_print,
+                                                unsigned_long_long_int_hash};
 #endif /* __STDC_VERSION__ >= 199901L */
 
 struct typetable ttbl_float = {sizeof(float), NULL,          NULL,
-                               NULL,          float_compare, float_print};
+                               NULL,          float_compare, float_print,
+                               float_hash};
 
 struct typetable ttbl_double = {sizeof(double), NULL,           NULL,
-                                NULL,           double_compare, double_print};
+                                NULL,           double_compare, double_print,
+                                double_hash};
 
 #if __STDC_VERSION__ >= 199901L
 struct typetable ttbl_long_double = {
@@ -1063,62 +1315,78 @@ struct typetable ttbl_long_double = {
 #endif
 
 struct typetable ttbl_bool = {sizeof(bool), NULL,         NULL,
-                              NULL,         bool_compare, bool_print};
+                              NULL,         bool_compare, bool_print,
+                              bool_hash};
 
 struct typetable ttbl_char_ptr = {sizeof(char *),   NULL,          NULL, NULL,
-                                  char_ptr_compare, char_ptr_print};
+                                  char_ptr_compare, char_ptr_print,
+                                  char_ptr_hash};
 
 struct typetable ttbl_str = {sizeof(char *), str_copy,    str_dtor,
-                             str_swap,       str_compare, str_print};
+                             str_swap,       str_compare, str_print,
+                             str_hash};
 
 struct typetable ttbl_str_ignore_case = {
     sizeof(char *),          str_copy, str_dtor, str_swap,
-    str_compare_ignore_case, str_print};
+    str_compare_ignore_case, str_print,
+    str_hash_ignore_case};
 
 struct typetable ttbl_cstr = {sizeof(char *), NULL,         NULL,
-                              cstr_swap,      cstr_compare, cstr_print};
+                              cstr_swap,      cstr_compare, cstr_print,
+                              cstr_hash};
 
 struct typetable ttbl_cstr_ignore_case = {
     sizeof(char *),           NULL,      NULL, cstr_swap,
-    cstr_compare_ignore_case, cstr_print};
+    cstr_compare_ignore_case, cstr_print,
+    cstr_hash_ignore_case};
 
 struct typetable ttbl_cstr_strdup = {sizeof(char *), cstr_copy,    cstr_dtor,
-                                     cstr_swap,      cstr_compare, cstr_print};
+                                     cstr_swap,      cstr_compare, cstr_print,
+                                     cstr_hash};
 
 struct typetable ttbl_cstr_ignore_case_strdup = {
     sizeof(char *),           cstr_copy, cstr_dtor, cstr_swap,
-    cstr_compare_ignore_case, cstr_print};
+    cstr_compare_ignore_case, cstr_print,
+    cstr_hash_ignore_case};
 
-struct typetable ttbl_void_ptr = {sizeof(void *),   NULL,
-                                  void_ptr_dtor,    NULL,
-                                  void_ptr_compare, void_ptr_print};
+struct typetable ttbl_void_ptr = {sizeof(void *),         NULL,
+                                  void_ptr_dtor,          NULL,
+                                  void_ptr_value_compare, void_ptr_print,
+                                  void_ptr_hash};
 
 struct typetable ttbl_int8 = {sizeof(char), NULL,         NULL,
-                              NULL,         char_compare, char_print};
+                              NULL,         char_compare, char_print,
+                              int8_hash};
 
 struct typetable ttbl_int16 = {sizeof(short int), NULL,           NULL, NULL,
-                               short_int_compare, short_int_print};
+                               short_int_compare, short_int_print,
+                               int16_hash};
 
 struct typetable ttbl_int32 = {sizeof(int), NULL,        NULL,
-                               NULL,        int_compare, int_print};
+                               NULL,        int_compare, int_print,
+                               int32_hash};
 
 #if __STD_VERSION__ >= 199901L
 struct typetable ttbl_int64 = {
     sizeof(long long int), NULL, NULL, NULL, long_long_int_compare,
-    long_long_int_print};
+    long_long_int_print,
+    int64_hash};
 #endif /* __STDC_VERSION__ >= 199901L */
 
 struct typetable ttbl_uint8 = {
     sizeof(unsigned char), NULL, NULL, NULL, unsigned_char_compare,
-    unsigned_char_print};
+    unsigned_char_print,
+    uint8_hash};
 
 struct typetable ttbl_uint16 = {
     sizeof(unsigned short int), NULL, NULL, NULL, unsigned_int_compare,
-    unsigned_int_print};
+    unsigned_int_print,
+    uint16_hash};
 
 struct typetable ttbl_uint32 = {
     sizeof(unsigned int), NULL, NULL, NULL, unsigned_int_compare,
-    unsigned_int_print};
+    unsigned_int_print,
+    uint32_hash};
 
 #if __STD_VERSION__ >= 199901L
 struct typetable ttbl_uint64 = {sizeof(unsigned long long int),
@@ -1126,7 +1394,8 @@ struct typetable ttbl_uint64 = {sizeof(unsigned long long int),
                                 NULL,
                                 NULL,
                                 unsigned_long_long_int_compare,
-                                unsigned_long_long_int_print};
+                                unsigned_long_long_int_print,
+                              uint64_hash};
 #endif /* __STDC_VERSION__ >= 199901L */
 
 struct typetable *_char_ = &ttbl_char;
@@ -1209,6 +1478,20 @@ struct typetable *_pthread_t_ = NULL;
 
 bool ulog_attrs_disable[] = {false, false, false, false, false, false, false};
 
+int ulog_threshold = ULOG_LEVEL_BUG;
+ulog_sink_fn ulog_sink = NULL;
+ulog_encoder_fn ulog_encoder = NULL;
+
+static int ulog_level_of(const char *level);
+static size_t ulog_vrender(char *buffer, size_t size, const char *date,
+                           const char *time, const char *level, const char *file,
+                           const char *func, long double line, const char *fmt,
+                           va_list args);
+static void ulog_puts(char *buffer, size_t size, size_t *length, const char *str);
+static void ulog_append(char *buffer, size_t size, size_t *length, const char *fmt, ...);
+static void ulog_vappend(char *buffer, size_t size, size_t *length, const char *fmt, va_list args);
+static int ulog_write(FILE *dest, int level, const char *line, size_t length);
+
 /**
  *  Utility function for debugging/error messages
  *
@@ -1219,152 +1502,94 @@ bool ulog_attrs_disable[] = {false, false, false, false, false, false, false};
  *  @param[in]      line        macro __LINE__ is to be used here
  *  @param[in]      fmt         formatting to be used
  *
- *  @return         character count of buffer (from fprintf)
+ *  @return         character count of buffer (0 if level is filtered out)
+ *
+ *  The message is formatted once, directly into a single buffer,
+ *  and handed to ulog_sink (or written to dest, if there is no sink).
+ *  If ulog_encoder is set, it receives the unformatted arguments instead.
  */
 int ulog(FILE *dest, const char *level, const char *file, const char *func,
          long double line, const char *fmt, ...) {
-
     char buffer[MAXIMUM_STACK_BUFFER_SIZE];
-    char temp[256];
-
-    const char *color = KNRM;
-    const char *blink = "";
+    size_t length = 0;
 
-    bool found = false;
-    bool is_integer = false;
-    bool is_currency = *file == '$';
-
-    int j = 0;
+    const int severity = ulog_level_of(level);
+    va_list args;
 
-    if (streql(level, "[BUG]")) {
-        color = KYEL_b;
-        found = true;
+    if (!ULOG_ENABLED(severity)) {
+        return 0;
     }
 
-    if (found == false) {
-        if (streql(level, "[LOG]")) {
-            color = KCYN_b;
-            found = true;
-        }
-    }
-
-    if (found == false) {
-        if (streql(level, "[ERROR]")) {
-            color = KRED_b;
-            blink = KBNK;
-            found = true;
-        }
-    }
+    va_start(args, fmt);
 
-    if (found == false) {
-        if (streql(level, "[WARNING]")) {
-            color = KMAG_b;
-            blink = KBNK;
-        }
-    }
-
-    sprintf(temp, "%Lf", line);
-
-    /* char digit = strchr(temp, '.'); */
-
-#if __STD_VERSION__ >= 199901L
-    is_integer = line / (long long int)(line) == 1.000000 || line == 0.00000;
-#else
-    is_integer = line / (long int)(line) == 1.000000 || line == 0.00000;
-#endif /* __STDC_VERSION__ >= 199901L */
-
-    is_integer = is_currency ? false : is_integer;
-
-    if (ulog_attrs_disable[DATE] == false) {
-        char date[1024];
-        sprintf(date, "%s%s%s ", KGRY, __DATE__, KNRM);
-
-        j += sprintf(buffer + j, "%s", date);
-    }
-
-    if (ulog_attrs_disable[TIME] == false) {
-        char time[1024];
-        sprintf(time, "%s%s%s ", KGRY, __TIME__, KNRM);
-
-        j += sprintf(buffer + j, "%s", time);
-    }
-
-    if (ulog_attrs_disable[LEVEL] == false) {
-        char leveltype[1024];
-        sprintf(leveltype, "%s%s%s%s ", blink, color, level, KNRM);
+    if (ulog_encoder != NULL) {
+        length = (size_t)(ulog_encoder(dest, level, file, func, line, fmt, args));
+        va_end(args);
 
-        j += sprintf(buffer + j, "%s", leveltype);
+        return (int)(length);
     }
 
-    if (ulog_attrs_disable[FILENAME] == false && ulog_attrs_disable[LINE]) {
-        char filename[1024];
-        sprintf(filename, "[%s] ", file);
-
-        j += sprintf(buffer + j, "%s", filename);
-    } else if (ulog_attrs_disable[FILENAME] &&
-               ulog_attrs_disable[LINE] == false) {
-        char linenumber[1024];
-
-        if (is_integer) {
-            #if __STD_VERSION__ >= 199901L
-            sprintf(linenumber, "[%lli] ", (long long int)(line));
-            #else
-            sprintf(linenumber, "[%li] ", (long int)(line));
-            #endif
-        } else {
-            if (is_currency) {
-                sprintf(linenumber, "[%0.2Lf] ", line);
-            } else {
-                sprintf(linenumber, "[%Lf] ", line);
-            }
-        }
+    length = ulog_vrender(buffer, sizeof buffer, __DATE__, __TIME__,
+                          level, file, func, line, fmt, args);
+    va_end(args);
 
-        j += sprintf(buffer + j, "%s", linenumber);
-    } else if (ulog_attrs_disable[FILENAME] == false &&
-               ulog_attrs_disable[LINE] == false) {
-        char fileline[1024];
+    return ulog_write(dest, severity, buffer, length);
+}
 
-        if (is_integer) {
-            #if __STD_VERSION__ >= 199901L
-            sprintf(fileline, "[%s:%lli] ", file, (long long int)(line));
-            #else
-            sprintf(fileline, "[%s:%li] ", file, (long int)(line));
-            #endif
-        } else {
-            if (is_currency) {
-                sprintf(fileline, "[%s%0.2Lf] ", file, line);
-            } else {
-                sprintf(fileline, "[%s:%Lf] ", file, line);
-            }
-        }
+/**
+ *  Formats a ulog line into buffer, as ulog would --
+ *  with the given date and time strings in place of ulog's own
+ *
+ *  @param[out]     buffer      destination
+ *  @param[in]      size        capacity of buffer (at least 2)
+ *  @param[in]      date        date string (ulog uses __DATE__)
+ *  @param[in]      time        time string (ulog uses __TIME__)
+ *  @param[in]      level       literals "BUG", "ERROR", "WARNING", or "LOG"
+ *  @param[in]      file        file name
+ *  @param[in]      func        function name
+ *  @param[in]      line        line number
+ *  @param[in]      fmt         formatting to be used
+ *
+ *  @return         character count of buffer, newline included
+ *                  (buffer is not null terminated)
+ */
+size_t ulog_render(char *buffer, size_t size, const char *date, const char *time,
+                   const char *level, const char *file, const char *func,
+                   long double line, const char *fmt, ...) {
+    size_t length = 0;
+    va_list args;
 
-        j += sprintf(buffer + j, "%s", fileline);
-    }
+    va_start(args, fmt);
+    length = ulog_vrender(buffer, size, date, time, level, file, func, line, fmt, args);
+    va_end(args);
 
-    if (ulog_attrs_disable[FUNCTION] == false) {
-        char function[1024];
-        sprintf(function, "%s%s", KCYN, func);
+    return length;
+}
 
-        j += sprintf(buffer + j, "%s", function);
-    }
+/**
+ *  Writes a message to dest, as is, through the same level filter
+ *  and backend (ulog_sink) as ulog
+ *
+ *  @param[in]      dest        stream destination
+ *  @param[in]      level       a ulog_level (e.g. ULOG_LEVEL_LOG)
+ *  @param[in]      fmt         formatting to be used
+ *
+ *  @return         character count of message (0 if level is filtered out)
+ */
+int ulog_raw(FILE *dest, int level, const char *fmt, ...) {
+    char buffer[MAXIMUM_STACK_BUFFER_SIZE];
+    size_t j = 0;
+    va_list args;
 
-    if (ulog_attrs_disable[FUNCTION] == false &&
-        ulog_attrs_disable[MESSAGE] == false) {
-        j += sprintf(buffer + j, "%s", " ");
+    if (!ULOG_ENABLED(level)) {
+        return 0;
     }
 
-    if (ulog_attrs_disable[MESSAGE] == false) {
-        char message[4096];
-        va_list args;
-
-        va_start(args, fmt);
-        vsprintf(message, fmt, args);
-        va_end(args);
-
-        j += sprintf(buffer + j, "%s%s%s", KNRM_b, message, KNRM);
-    }
+    va_start(args, fmt);
+    ulog_vappend(buffer, sizeof buffer, &j, fmt, args);
+    va_end(args);
 
-    return fprintf(dest, "%s\n", buffer);
+    return ulog_write(dest, level, buffer, j);
 }
 
 /**
@@ -1606,3 +1831,203 @@ void slnb_reverse_after(slist_node_base *n) {
         n->next->next = keep;
     }
 }
+
+/**
+ *  Maps a ulog level string ("[BUG]", "[LOG]", ...) to its ulog_level
+ *
+ *  @param[in]      level       level string, as passed to ulog
+ *
+ *  @return         corresponding ulog_level (custom strings are ULOG_LEVEL_LOG)
+ */
+static int ulog_level_of(const char *level) {
+    if (streql(level, "[ERROR]")) {
+        return ULOG_LEVEL_ERROR;
+    } else if (streql(level, "[WARNING]")) {
+        return ULOG_LEVEL_WARNING;
+    } else if (streql(level, "[BUG]")) {
+        return ULOG_LEVEL_BUG;
+    }
+
+    return ULOG_LEVEL_LOG;
+}
+
+/**
+ *  va_list counterpart of ulog_render
+ */
+static size_t ulog_vrender(char *buffer, size_t size, const char *date,
+                           const char *time, const char *level, const char *file,
+                           const char *func, long double line, const char *fmt,
+                           va_list args) {
+    const int severity = ulog_level_of(level);
+    size_t j = 0;
+
+    const char *color = KNRM;
+    const char *blink = "";
+
+    bool is_integer = false;
+    bool is_currency = *file == '$';
+
+    --size; /**< reserved for the newline */
+
+    switch (severity) {
+    case ULOG_LEVEL_BUG:
+        color = KYEL_b;
+        break;
+
+    case ULOG_LEVEL_LOG:
+        color = KCYN_b;
+        break;
+
+    case ULOG_LEVEL_ERROR:
+        color = KRED_b;
+        blink = KBNK;
+        break;
+
+    case ULOG_LEVEL_WARNING:
+        color = KMAG_b;
+        blink = KBNK;
+        break;
+
+    default:
+        break;
+    }
+
+    is_integer = line / (long int)(line) == 1.000000 || line == 0.00000;
+    is_integer = is_currency ? false : is_integer;
+
+    if (ulog_attrs_disable[DATE] == false) {
+        ulog_puts(buffer, size, &j, KGRY);
+        ulog_puts(buffer, size, &j, date);
+        ulog_puts(buffer, size, &j, KNRM " ");
+    }
+
+    if (ulog_attrs_disable[TIME] == false) {
+        ulog_puts(buffer, size, &j, KGRY);
+        ulog_puts(buffer, size, &j, time);
+        ulog_puts(buffer, size, &j, KNRM " ");
+    }
+
+    if (ulog_attrs_disable[LEVEL] == false) {
+        ulog_puts(buffer, size, &j, blink);
+        ulog_puts(buffer, size, &j, color);
+        ulog_puts(buffer, size, &j, level);
+        ulog_puts(buffer, size, &j, KNRM " ");
+    }
+
+    if (ulog_attrs_disable[FILENAME] == false && ulog_attrs_disable[LINE]) {
+        ulog_puts(buffer, size, &j, "[");
+        ulog_puts(buffer, size, &j, file);
+        ulog_puts(buffer, size, &j, "] ");
+    } else if (ulog_attrs_disable[FILENAME] &&
+               ulog_attrs_disable[LINE] == false) {
+        if (is_integer) {
+            ulog_append(buffer, size, &j, "[%li] ", (long int)(line));
+        } else if (is_currency) {
+            ulog_append(buffer, size, &j, "[%0.2Lf] ", line);
+        } else {
+            ulog_append(buffer, size, &j, "[%Lf] ", line);
+        }
+    } else if (ulog_attrs_disable[FILENAME] == false &&
+               ulog_attrs_disable[LINE] == false) {
+        if (is_integer) {
+            ulog_append(buffer, size, &j, "[%s:%li] ", file, (long int)(line));
+        } else if (is_currency) {
+            ulog_append(buffer, size, &j, "[%s%0.2Lf] ", file, line);
+        } else {
+            ulog_append(buffer, size, &j, "[%s:%Lf] ", file, line);
+        }
+    }
+
+    if (ulog_attrs_disable[FUNCTION] == false) {
+        ulog_puts(buffer, size, &j, KCYN);
+        ulog_puts(buffer, size, &j, func);
+    }
+
+    if (ulog_attrs_disable[FUNCTION] == false &&
+        ulog_attrs_disable[MESSAGE] == false) {
+        ulog_puts(buffer, size, &j, " ");
+    }
+
+    if (ulog_attrs_disable[MESSAGE] == false) {
+        ulog_puts(buffer, size, &j, KNRM_b);
+        ulog_vappend(buffer, size, &j, fmt, args);
+
+        ulog_puts(buffer, size, &j, KNRM);
+    }
+
+    buffer[j++] = '\n';
+    return j;
+}
+
+/**
+ *  Copies str into buffer at offset (*length), never past size bytes,
+ *  and advances (*length) -- for the parts of a line that need no formatting
+ *
+ *  @param[out]     buffer      destination
+ *  @param[in]      size        capacity of buffer
+ *  @param[in,out]  length      characters used so far
+ *  @param[in]      str         null terminated string
+ */
+static void ulog_puts(char *buffer, size_t size, size_t *length, const char *str) {
+    size_t n = strlen(str);
+
+    if ((*length) + n >= size) {
+        n = (*length) + 1 < size ? size - (*length) - 1 : 0;
+    }
+
+    memcpy(buffer + (*length), str, n);
+    (*length) += n;
+}
+
+/**
+ *  Formats into buffer at offset (*length), never past size bytes,
+ *  and advances (*length)
+ *
+ *  @param[out]     buffer      destination
+ *  @param[in]      size        capacity of buffer
+ *  @param[in,out]  length      characters used so far
+ *  @param[in]      fmt         formatting to be used
+ */
+static void ulog_append(char *buffer, size_t size, size_t *length, const char *fmt, ...) {
+    va_list args;
+
+    va_start(args, fmt);
+    ulog_vappend(buffer, size, length, fmt, args);
+    va_end(args);
+}
+
+/**
+ *  va_list counterpart of ulog_append -- output is truncated, not overrun
+ */
+static void ulog_vappend(char *buffer, size_t size, size_t *length, const char *fmt, va_list args) {
+    int written = 0;
+
+    if ((*length) + 1 >= size) {
+        return;
+    }
+
+    written = vsnprintf(buffer + (*length), size - (*length), fmt, args);
+
+    if (written > 0) {
+        (*length) += (size_t)(written);
+        (*length) = (*length) < size ? (*length) : size - 1;
+    }
+}
+
+/**
+ *  Delivers a formatted line to ulog_sink, or to dest if there is none
+ *
+ *  @param[in]      dest        stream destination
+ *  @param[in]      level       a ulog_level
+ *  @param[in]      line        formatted characters (not null terminated)
+ *  @param[in]      length      number of characters in line
+ *
+ *  @return         character count written (or queued)
+ */
+static int ulog_write(FILE *dest, int level, const char *line, size_t length) {
+    if (ulog_sink != NULL) {
+        return ulog_sink(dest, level, line, length);
+    }
+
+    return (int)(fwrite(line, 1, length, dest));
+}
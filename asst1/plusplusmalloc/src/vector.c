@@ -28,19 +28,39 @@
  *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+/**
+ *  mmap/open/fstat are not declared under -std=c89 alone;
+ *  <string.h> then declares strdup, so it must precede the macro in utils.h.
+ */
+#define _XOPEN_SOURCE 500
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "mymalloc.h"
 
 #include "vector.h"
 #include "mergesort.h"
 #include "iterator.h"
+#include "workpool.h"
 #include "utils.h"
 
-#include <assert.h>
-#include <math.h>
-#include <string.h>
-
 #define VECTOR_MAXIMUM_STACK_BUFFER_SIZE 16384
 #define VECTOR_DEFAULT_CAPACITY          16
+#define VECTOR_INLINE_BUFFER_SIZE        64
+#define VECTOR_PAGE_SIZE                 4096
+#define VECTOR_HEADER_SIZE               64
+#define VECTOR_HEADER_MAGIC              "gcsvec1"
+#define VECTOR_PARALLEL_MINIMUM          (256 * 1024)
+#define VECTOR_PARALLEL_PARTITION        (64 * 1024)
+#define VECTOR_PARALLEL_POLL             4096
 
 /**< optional macros for accessing the innards of vector_base */
 #define AT(VEC, INDEX)      ((char *)(VEC->impl.start) + ((INDEX) * (VEC->ttbl->width)))
@@ -48,6 +68,17 @@
 #define BACK(VEC)           ((char *)(VEC->impl.finish) - (VEC->ttbl->width))
 #define END(VEC)            VEC->impl.end_of_storage
 
+/**< macros for the small-buffer (inline) storage region of vector */
+#define INLINE(VEC)             ((void *)((VEC)->buffer.bytes))
+#define IS_INLINE(VEC)          ((VEC)->impl.start == INLINE(VEC))
+#define FITS_INLINE(VEC, N)     (((N) * (VEC)->ttbl->width) <= VECTOR_INLINE_BUFFER_SIZE)
+
+/**< macros for read-only vectors backed by a file mapping (v_mmap_open/v_load) */
+#define IS_MAPPED(VEC)          ((VEC)->mapping.addr != NULL)
+
+#define massert_writable(VEC);\
+massert(!IS_MAPPED(VEC), "['"#VEC"' is a read-only view of a mapped file -- use v_newcopy for a modifiable copy.]");
+
 /**
  *  @struct     vector
  *  @brief      Represents a dynamic array ADT
@@ -69,6 +100,55 @@ struct vector {
     } impl;
 
     struct typetable *ttbl; /**< data width, cpy, dtor, swap, compare, print */
+
+    enum vector_growth growth; /**< policy used when the buffer must grow */
+
+    /**
+     *  @union      vector_inline
+     *  @brief      Inline storage for small element counts
+     *
+     *  If (width * capacity) fits within VECTOR_INLINE_BUFFER_SIZE,
+     *  impl.start addresses this buffer and no heap allocation is made.
+     *  Once the vector grows past it, the elements spill to the heap.
+     *  The pointer/double/long members exist only for alignment.
+     */
+    union vector_inline {
+        char bytes[VECTOR_INLINE_BUFFER_SIZE];
+        void *align_ptr;
+        double align_dbl;
+        long align_lng;
+    } buffer;
+
+    /**
+     *  @struct     vector_mapping
+     *  @brief      File mapping that impl.start points into, if any
+     *
+     *  addr is NULL unless the vector came from v_mmap_open/v_load --
+     *  such a vector is read-only, and v_delete unmaps [addr, addr + length).
+     */
+    struct vector_mapping {
+        void *addr;    /**< base address of the mapping (file offset 0) */
+        size_t length; /**< length of the mapping, in bytes */
+    } mapping;
+};
+
+/**
+ *  @union      vector_header
+ *  @brief      Header preceding the elements of a file written by v_save
+ *
+ *  Padded to VECTOR_HEADER_SIZE bytes, so the first element of a
+ *  mapped file is aligned suitably for any builtin type.
+ *  Fields (and elements) are stored in host byte order --
+ *  files are not portable between machines of differing ABIs.
+ */
+union vector_header {
+    struct vector_header_fields {
+        char magic[8];       /**< VECTOR_HEADER_MAGIC */
+        unsigned long width; /**< size of each element, in bytes */
+        unsigned long count; /**< number of elements that follow */
+    } fields;
+
+    char bytes[VECTOR_HEADER_SIZE];
 };
 
 static vector *v_allocate(void);
@@ -76,13 +156,60 @@ static void v_init(vector *v, struct typetable *ttbl, size_t capacity);
 static void v_deinit(vector *v);
 static void v_swap_addr(vector *v, void *first, void *second);
 
+static void *v_storage_acquire(vector *v, size_t n);
+static void v_storage_release(vector *v);
+static void v_transfer(vector *dest, vector *src);
+
+static size_t v_growth_capacity(vector *v, size_t n);
+static void v_grow(vector *v, size_t n);
+static void *v_open_slot(vector *v, size_t index);
+
+static vector *v_map(const char *path, struct typetable *ttbl, bool header);
+
+static bool v_range_contiguous(iterator first, iterator last);
+static void *v_copy_contiguous(vector *v, void *dst, const void *first, const void *last);
+
+/**
+ *  @struct     vector_search
+ *  @brief      Shared state of one v_search_parallel call
+ *
+ *  found only ever decreases -- a task stops once every index
+ *  it has yet to scan is past a match another task has already made.
+ */
+struct vector_search {
+    const char *base;   /**< address of the first element */
+    size_t count;       /**< element count */
+    size_t width;       /**< ttbl->width */
+    size_t partition;   /**< element count per task */
+
+    const void *valaddr;
+    int (*comparator)(const void *, const void *);
+    bool bitwise;       /**< compare by value rather than calling comparator */
+
+    volatile long found; /**< lowest matching index so far, count if none */
+};
+
+static bool v_search_bitwise(int (*comparator)(const void *, const void *));
+static long v_search_range(struct vector_search *search, size_t first, size_t last);
+static void v_search_task(void *arg, size_t task);
+static void v_search_pool_atexit(void);
+
+/**
+ *  Pool shared by every call to v_search_parallel --
+ *  created on first use, recreated if a call asks for
+ *  a different thread count, and joined at exit.
+ */
+static workpool_t *v_search_pool = NULL;
+static pthread_mutex_t v_search_lock = PTHREAD_MUTEX_INITIALIZER;
+
 struct typetable ttbl_vector = {
     sizeof(vector),
     vector_copy,
     vector_dtor,
     vector_swap,
     vector_compare,
-    vector_print
+    vector_print,
+    NULL /* no hash -- vectors cannot be hash keys */
 };
 
 struct typetable *_vector_ = &ttbl_vector;
@@ -134,7 +261,9 @@ struct iterator_table *_vector_iterator_ = &itbl_vector;
 
 /**
  *  @brief  Allocates, constructs, and returns a pointer to vector,
- *          size VECTOR_DEFAULT_CAPACITY (16)
+ *          with as many elements as fit in its inline buffer
+ *          (VECTOR_INLINE_BUFFER_SIZE bytes), or VECTOR_DEFAULT_CAPACITY (16)
+ *          if not even one element fits
  *
  *  @param[in]  ttbl    pointer to struct typetable for
  *                      width/copy/dtor/swap/compare/print
@@ -142,8 +271,14 @@ struct iterator_table *_vector_iterator_ = &itbl_vector;
  *  @return     pointer to vector
  */
 vector *v_new(struct typetable *ttbl) {
-    vector *v = v_allocate();                   /* allocate */
-    v_init(v, ttbl, VECTOR_DEFAULT_CAPACITY);   /* construct */
+    vector *v = NULL;
+    size_t capacity = 0;
+
+    capacity = VECTOR_INLINE_BUFFER_SIZE / (ttbl ? ttbl : _void_ptr_)->width;
+    capacity = capacity > 0 ? capacity : VECTOR_DEFAULT_CAPACITY;
+
+    v = v_allocate();                           /* allocate */
+    v_init(v, ttbl, capacity);                  /* construct */
     return v;                                   /* return */
 }
 
@@ -262,6 +397,12 @@ vector *v_newrnge(iterator first, iterator last) {
 
     v = v_newr(ttbl_first, delta);
 
+    if (v_range_contiguous(first, last)) {
+        /* [first, last) is a slice of a vector's buffer -- no per-element dispatch */
+        v->impl.finish = v_copy_contiguous(v, v->impl.finish, first.curr, last.curr);
+        return v;
+    }
+
     sentinel = it_curr(last);         /* iteration range is [first, last) */
 
     if (ttbl_first->copy) {
@@ -352,12 +493,10 @@ vector *v_newmove(vector **v) {
      *  The previous vector, v, is initialized to have a size of 1 --
      *  v may be deleted clientside if preferred.
      */
-    move->impl.start = (*v)->impl.start;
-    move->impl.finish = (*v)->impl.finish;
-    move->impl.end_of_storage = (*v)->impl.end_of_storage;
-    move->ttbl = (*v)->ttbl;
+    v_transfer(move, (*v));
 
     v_init((*v), (*v)->ttbl, 1);
+    (*v)->growth = move->growth;
 
     return move;
 }
@@ -477,6 +616,7 @@ void v_resize(vector *v, size_t n) {
     size_t end = 0;
     
     massert_container(v);
+    massert_writable(v);
 
     old_size = v_size(v);
     old_capacity = v_capacity(v);
@@ -511,14 +651,23 @@ void v_resize(vector *v, size_t n) {
         return;
     }
 
-    newstart = malloc(n * v->ttbl->width);
-    memcpy(newstart, v->impl.start, v->ttbl->width * old_size);
-    free(v->impl.start);
-    v->impl.start = NULL;
-
     fin = n > old_size ? old_size : n;
     end = n > old_size ? n : fin;
 
+    if (IS_INLINE(v) && FITS_INLINE(v, n)) {
+        /* still fits in the inline buffer -- nothing to move */
+        newstart = v->impl.start;
+    } else {
+        /**
+         *  Either spilling from the inline buffer to the heap,
+         *  moving heap memory back into the inline buffer,
+         *  or growing/shrinking a heap buffer.
+         */
+        newstart = v_storage_acquire(v, n);
+        memcpy(newstart, v->impl.start, v->ttbl->width * fin);
+        v_storage_release(v);
+    }
+
     v->impl.start = newstart;
     v->impl.finish = (char *)(v->impl.start) + (fin * v->ttbl->width);
     v->impl.end_of_storage = (char *)(v->impl.start) + (end * v->ttbl->width);
@@ -545,6 +694,7 @@ void v_resizefill(vector *v, size_t n, const void *valaddr) {
     void *newstart = NULL;
 
     massert_container(v);
+    massert_writable(v);
 
     old_capacity = v_capacity(v);
 
@@ -590,8 +740,7 @@ void v_resizefill(vector *v, size_t n, const void *valaddr) {
         }
 
         /* memory at the base address of the vector will be released... */
-        free(v->impl.start);
-        v->impl.start = NULL;
+        v_storage_release(v);
 
         /**
          *  ...and new memory will be allocated of size n to represent
@@ -605,7 +754,7 @@ void v_resizefill(vector *v, size_t n, const void *valaddr) {
         newstart = calloc(n, v->ttbl->width);
         massert_calloc(newstart);
         */
-        newstart = malloc(v->ttbl->width * n);
+        newstart = v_storage_acquire(v, n);
         memset(newstart, 0, v->ttbl->width * n);
 
         /* pointers at impl are re-established */
@@ -669,6 +818,7 @@ bool v_empty(vector *v) {
  */
 void v_reserve(vector *v, size_t n) {
     massert_container(v);
+    massert_writable(v);
 
     /**
      *  Reserve is effectively a resize,
@@ -683,6 +833,25 @@ void v_reserve(vector *v, size_t n) {
     }
 }
 
+/**
+ *  @brief  Reserves exactly n blocks of elements for v
+ *
+ *  @param[out] v   pointer to vector
+ *  @param[in]  n   desired amount of blocks to reserve
+ *
+ *  Unlike v_reserve, n within v's current capacity is not an error (no-op).
+ *  The growth policy is bypassed -- capacity becomes exactly n,
+ *  so a bulk load of a known size costs one allocation and no slack.
+ */
+void v_reserve_exact(vector *v, size_t n) {
+    massert_container(v);
+    massert_writable(v);
+
+    if (n > v_capacity(v)) {
+        v_resize(v, n);
+    }
+}
+
 /**
  *  @brief  Shrinks vector's buffer to that of its logical length
  *
@@ -695,12 +864,37 @@ void v_reserve(vector *v, size_t n) {
  */
 void v_shrink_to_fit(vector *v) {
     massert_container(v);
+    massert_writable(v);
 
     if ((v->impl.start != v->impl.finish) && (v->impl.finish != v->impl.end_of_storage)) {
         v_resize(v, v_size(v));
     }
 }
 
+/**
+ *  @brief  Sets the growth policy used when v's buffer must grow
+ *
+ *  @param[in]  v       pointer to vector
+ *  @param[in]  policy  VECTOR_GROWTH_DOUBLE, VECTOR_GROWTH_1_5X,
+ *                      or VECTOR_GROWTH_PAGE
+ */
+void v_set_growth(vector *v, enum vector_growth policy) {
+    massert_container(v);
+    v->growth = policy;
+}
+
+/**
+ *  @brief  Retrieves the growth policy used by v
+ *
+ *  @param[in]  v   pointer to vector
+ *
+ *  @return     growth policy of v
+ */
+enum vector_growth v_get_growth(vector *v) {
+    massert_container(v);
+    return v->growth;
+}
+
 /**
  *  @brief  Retrieves the address of an element from vector at index n
  *
@@ -969,7 +1163,10 @@ void v_assignrnge(vector *v, iterator first, iterator last) {
         v_resize(v, delta);
     }
 
-    if (ttbl_first->copy) {
+    if (v_range_contiguous(first, last)) {
+        /* [first, last) is a slice of a vector's buffer -- no per-element dispatch */
+        v->impl.finish = v_copy_contiguous(v, v->impl.finish, first.curr, last.curr);
+    } else if (ttbl_first->copy) {
         while ((curr = it_curr(first)) != sentinel)  {
             ttbl_first->copy(v->impl.finish, curr);
 
@@ -1038,14 +1235,15 @@ void v_assignfill(vector *v, size_t n, const void *valaddr) {
  */
 void v_pushb(vector *v, const void *valaddr) {
     massert_container(v);
+    massert_writable(v);
     massert_ptr(valaddr);
 
     /**
-     *  A doubling strategy is employed when the finish pointer
+     *  The buffer grows (as per v's growth policy) when the finish pointer
      *  meets the end_of_storage pointer.
      */
     if (v->impl.finish == v->impl.end_of_storage) {
-        v_resize(v, v_capacity(v) * 2);
+        v_grow(v, v_size(v) + 1);
     }
 
     if (v->ttbl->copy) {
@@ -1078,6 +1276,7 @@ void v_pushb(vector *v, const void *valaddr) {
  */
 void v_popb(vector *v) {
     massert_container(v);
+    massert_writable(v);
 
     if (v->impl.finish == v->impl.start) {
         /* v_popb is a no-op if vector is empty */
@@ -1101,6 +1300,169 @@ void v_popb(vector *v) {
      */
 }
 
+/**
+ *  @brief  Appends n contiguous elements from src to the rear of the vector
+ *
+ *  @param[in]  v       pointer to vector
+ *  @param[in]  src     base address of an array of n elements
+ *  @param[in]  n       number of elements to append
+ *
+ *  v grows at most once (as per its growth policy -- or not at all,
+ *  if v_reserve_exact was used beforehand).
+ *
+ *  If ttbl has a copy function defined, each element is deep copied.
+ *  Otherwise, all n elements are shallow copied with a single memcpy.
+ */
+void v_append_bulk(vector *v, const void *src, size_t n) {
+    const char *curr = NULL;
+    void *sentinel = NULL;
+
+    massert_container(v);
+    massert_writable(v);
+    massert_ptr(src);
+
+    if (n == 0) {
+        return;
+    }
+
+    v_grow(v, v_size(v) + n);
+
+    if (v->ttbl->copy) {
+        curr = (const char *)(src);
+        sentinel = (char *)(v->impl.finish) + (n * v->ttbl->width);
+
+        while (v->impl.finish != sentinel) {
+            v->ttbl->copy(v->impl.finish, curr);
+
+            v->impl.finish = (char *)(v->impl.finish) + (v->ttbl->width);
+            curr += v->ttbl->width;
+        }
+    } else {
+        memcpy(v->impl.finish, src, n * v->ttbl->width);
+        v->impl.finish = (char *)(v->impl.finish) + (n * v->ttbl->width);
+    }
+}
+
+/**
+ *  @brief  Moves valaddr to the rear of the vector
+ *
+ *  @param[in]  v       pointer to vector
+ *  @param[out] valaddr address of element to move into v
+ *
+ *  The element is relocated (not copied) into v, and valaddr is zeroed --
+ *  e.g. for a vector of str, the char * is adopted by v as-is,
+ *  instead of being duplicated and then freed by the caller.
+ */
+void v_pushbmove(vector *v, void *valaddr) {
+    void *slot = NULL;
+
+    massert_container(v);
+    massert_writable(v);
+    massert_ptr(valaddr);
+
+    slot = v_open_slot(v, v_size(v));
+
+    memcpy(slot, valaddr, v->ttbl->width);
+    memset(valaddr, 0, v->ttbl->width);
+}
+
+/**
+ *  @brief  Moves valaddr into v at index
+ *
+ *  @param[in]  v       pointer to vector
+ *  @param[in]  index   index in [0, v_size(v)] where valaddr is to reside
+ *  @param[out] valaddr address of element to move into v
+ */
+void v_insert_atmove(vector *v, size_t index, void *valaddr) {
+    void *slot = NULL;
+
+    massert_container(v);
+    massert_writable(v);
+    massert_ptr(valaddr);
+
+    if (index > v_size(v)) {
+        char str[256];
+        sprintf(str, "Index provided [%lu] is out of bounds. Size of vector is %lu.", index, v_size(v));
+        ERROR(__FILE__, str);
+        return;
+    }
+
+    slot = v_open_slot(v, index);
+
+    memcpy(slot, valaddr, v->ttbl->width);
+    memset(valaddr, 0, v->ttbl->width);
+}
+
+/**
+ *  @brief  Replaces the contents of v by moving n elements from base
+ *
+ *  @param[in]  v       pointer to vector
+ *  @param[out] base    base address of an array of n elements
+ *  @param[in]  n       number of elements to move
+ *
+ *  Elements in this vector will be destroyed, and v takes ownership of
+ *  base's n elements with a single memcpy. base is zeroed afterward,
+ *  but not freed -- the array itself still belongs to the caller.
+ */
+void v_assignmove(vector *v, void *base, size_t n) {
+    massert_container(v);
+    massert_writable(v);
+    massert_ptr(base);
+
+    v_clear(v);
+
+    if (n > v_capacity(v)) {
+        v_resize(v, n);
+    }
+
+    memcpy(v->impl.start, base, n * v->ttbl->width);
+    memset(base, 0, n * v->ttbl->width);
+
+    v->impl.finish = (char *)(v->impl.start) + (n * v->ttbl->width);
+}
+
+/**
+ *  @brief  Appends a zeroed block to the rear of the vector,
+ *          for an element to be constructed in place
+ *
+ *  @param[in]  v   pointer to vector
+ *
+ *  @return     address of the new rear block
+ *
+ *  The returned address is only valid until v's next reallocation.
+ *  e.g. for a vector of str, *(char **)(v_emplaceb(v)) = buffer;
+ */
+void *v_emplaceb(vector *v) {
+    massert_container(v);
+    massert_writable(v);
+    return v_open_slot(v, v_size(v));
+}
+
+/**
+ *  @brief  Opens a zeroed block at index,
+ *          for an element to be constructed in place
+ *
+ *  @param[in]  v       pointer to vector
+ *  @param[in]  index   index in [0, v_size(v)] of the new block
+ *
+ *  @return     address of the new block, or NULL if index is out of bounds
+ *
+ *  Elements from [index, v_size(v)) are shifted one block to the right.
+ */
+void *v_emplace_at(vector *v, size_t index) {
+    massert_container(v);
+    massert_writable(v);
+
+    if (index > v_size(v)) {
+        char str[256];
+        sprintf(str, "Index provided [%lu] is out of bounds. Size of vector is %lu.", index, v_size(v));
+        ERROR(__FILE__, str);
+        return NULL;
+    }
+
+    return v_open_slot(v, index);
+}
+
 /**
  *  @brief  Inserts a value into vector at position specified by pos
  *
@@ -1122,14 +1484,15 @@ iterator v_insert(vector *v, iterator pos, const void *valaddr) {
     size_t ipos = 0;
 
     massert_container(v);
+    massert_writable(v);
     massert_ptr(valaddr);
 
     /**
-     *  A doubling strategy is employed when the finish pointer
+     *  The buffer grows (as per v's growth policy) when the finish pointer
      *  meets the end_of_storage pointer.
      */
     if (v->impl.finish == v->impl.end_of_storage) {
-        v_resize(v, v_capacity(v) * 2);
+        v_grow(v, v_size(v) + 1);
     }
 
     /**
@@ -1195,6 +1558,7 @@ iterator v_insertfill(vector *v, iterator pos, size_t n, const void *valaddr) {
     void *finish = NULL;
 
     massert_container(v);
+    massert_writable(v);
     massert_ptr(valaddr);
 
     ipos = it_distance(NULL, &pos);      /**< pos's index position */
@@ -1204,9 +1568,10 @@ iterator v_insertfill(vector *v, iterator pos, size_t n, const void *valaddr) {
     if ((old_size + n) >= old_capacity) {
         /**
          *  If inserting n elements will equal or exceed that of old_capacity,
-         *  vector will be resized to accomodate ((old_capacity + n) * 2) elements.
+         *  vector will grow (as per its growth policy) to accomodate
+         *  at least (old_size + n + 1) elements.
          */
-        v_resize(v, (old_capacity + n) * 2);
+        v_grow(v, old_size + n + 1);
         pos = it_next_n(v_begin(v), ipos);
     }
 
@@ -1347,6 +1712,7 @@ iterator v_insertrnge(vector *v, iterator pos, iterator first, iterator last) {
     void *finish = NULL;
 
     massert_container(v);
+    massert_writable(v);
 
     ipos = it_distance(NULL, &pos);      /**< pos's index position */
     old_size = v_size(v);                /**< v's former size */
@@ -1356,10 +1722,10 @@ iterator v_insertrnge(vector *v, iterator pos, iterator first, iterator last) {
     if ((old_size + delta) >= old_capacity) {
         /**
          *  If inserting delta elements will equal or exceed that of
-         *  old_capacity, vector will be resized to
-         *  accommodate ((old_capacity + delta) * 2) elements.
+         *  old_capacity, vector will grow (as per its growth policy)
+         *  to accommodate at least (old_size + delta + 1) elements.
          */
-        v_resize(v, (old_capacity + delta) * 2);
+        v_grow(v, old_size + delta + 1);
         pos = it_next_n(v_begin(v), ipos);
     }
 
@@ -1376,7 +1742,9 @@ iterator v_insertrnge(vector *v, iterator pos, iterator first, iterator last) {
         /* inlined instructions resembling pushb */
         sentinel = (char *)(v->impl.finish) + (delta * v->ttbl->width);
 
-        if (v->ttbl->copy) {
+        if (v_range_contiguous(first, last)) {
+            v->impl.finish = v_copy_contiguous(v, v->impl.finish, first.curr, last.curr);
+        } else if (v->ttbl->copy) {
             while (v->impl.finish != sentinel) {
                 v->ttbl->copy(v->impl.finish, it_curr(first));
                 v->impl.finish = (char *)(v->impl.finish) + (v->ttbl->width);
@@ -1437,7 +1805,10 @@ iterator v_insertrnge(vector *v, iterator pos, iterator first, iterator last) {
          */
         v->impl.finish = (char *)(v->impl.finish) + (v->ttbl->width);
 
-        if (v->ttbl->copy) {
+        if (v_range_contiguous(first, last)) {
+            /* [first, last) is a slice of a vector's buffer -- no per-element dispatch */
+            v_copy_contiguous(v, v->impl.finish, first.curr, last.curr);
+        } else if (v->ttbl->copy) {
             /* deep copy */
             while (v->impl.finish != sentinel) {
                 v->ttbl->copy(v->impl.finish, it_curr(first));
@@ -1474,40 +1845,21 @@ iterator v_insertrnge(vector *v, iterator pos, iterator first, iterator last) {
  *  dynamically allocated fields, and/or the type itself
  *  is a pointer to dynamically allocated memory.
  *
- *  A swap function must be defined in v's typetable in order
- *  to run this function, otherwise a regular insert is performed.
+ *  v takes full ownership of the memory valaddr referred to --
+ *  the element is neither deep copied nor shallow copied into two owners;
+ *  its bytes are relocated into v and valaddr is zeroed.
  */
 iterator v_insertmove(vector *v, iterator pos, void *valaddr) {
-    void *dst = NULL;
+    size_t ipos = 0;
 
     massert_container(v);
+    massert_writable(v);
     massert_ptr(valaddr);
 
-    if (v->ttbl->swap) {
-        /**
-         *  If a swap function is defined,
-         *  the address of dst will be sent to swap,
-         *  along with valaddr (which is already the address of some var
-         *  sent in by the client)
-         * 
-         *  The contents of valaddr will be used to initialize dst,
-         *  and the standard insert function will be called after.
-         * 
-         *  If no swap function is defined,
-         *  a regular insert occurs.
-         *  
-         *  This function can prove useful if a client has a dynamically
-         *  allocated type, like a pointer (or a type with dynamically allocated fields)
-         *  and wants vector to have full ownership of the memory that param inserted
-         *  referred to.
-         * 
-         *  This can help prevent unwanted deep copying of elements, or shallow copies
-         *  of elements where there are two pointers referring to the same memory.
-         */
-        v->ttbl->swap(&dst, valaddr);
-    }
+    ipos = it_distance(NULL, &pos);      /**< pos's index position */
 
-    return v_insert(v, pos, &dst);
+    v_insert_atmove(v, ipos, valaddr);
+    return it_next_n(v_begin(v), ipos);
 }
 
 /**
@@ -1535,6 +1887,7 @@ iterator v_erase(vector *v, iterator pos) {
     void *sentinel = NULL;
 
     massert_container(v);
+    massert_writable(v);
 
     ipos = it_distance(NULL, &pos);
     back_index = v_size(v) - 1;
@@ -1625,6 +1978,7 @@ iterator v_erasernge(vector *v, iterator pos, iterator last) {
     void *sentinel = NULL;
 
     massert_container(v);
+    massert_writable(v);
 
     ipos = it_distance(NULL, &pos);     /**< index of pos */
     delta = it_distance(&pos, &last);   /**< diff between pos/last */
@@ -1704,26 +2058,19 @@ iterator v_erasernge(vector *v, iterator pos, iterator last) {
  *  @param[out] other   address of pointer to vector
  */
 void v_swap(vector **v, vector **other) {
-    vector *temp = NULL;
+    vector temp;
 
     massert_container((*v));
     massert_container((*other));
 
-    temp = (*v);
-
-    /* change of ownership between v and other */
-    (*v)->impl.start = (*other)->impl.start;
-    (*v)->impl.finish = (*other)->impl.finish;
-    (*v)->impl.end_of_storage = (*other)->impl.end_of_storage;
-
-    /* vectors holding two different types can be swapped */
-    (*v)->ttbl = (*other)->ttbl;
-
-    (*other)->impl.start = temp->impl.start;
-    (*other)->impl.finish = temp->impl.finish;
-    (*other)->impl.end_of_storage = temp->impl.end_of_storage;
-
-    (*other)->ttbl = temp->ttbl;
+    /**
+     *  change of ownership between v and other --
+     *  vectors holding two different types can be swapped.
+     *  v_transfer copies inline buffers where necessary.
+     */
+    v_transfer(&temp, (*v));
+    v_transfer((*v), (*other));
+    v_transfer((*other), &temp);
 }
 
 /**
@@ -1738,6 +2085,7 @@ void v_swap(vector **v, vector **other) {
  */
 void v_clear(vector *v) {
     massert_container(v);
+    massert_writable(v);
 
     if (v->impl.finish == v->impl.start) {
         /**
@@ -1795,6 +2143,7 @@ void v_insert_at(vector *v, size_t index, const void *valaddr) {
     void *curr = NULL;
 
     massert_container(v);
+    massert_writable(v);
     massert_ptr(valaddr);
 
     size = v_size(v);
@@ -1807,11 +2156,11 @@ void v_insert_at(vector *v, size_t index, const void *valaddr) {
     }
 
     /**
-     *  A doubling strategy is employed when the finish pointer
+     *  The buffer grows (as per v's growth policy) when the finish pointer
      *  meets the end_of_storage pointer.
      */
     if (v->impl.finish == v->impl.end_of_storage) {
-        v_resize(v, v_capacity(v) * 2);
+        v_grow(v, v_size(v) + 1);
     }
 
     /**
@@ -1868,6 +2217,7 @@ void v_erase_at(vector *v, size_t index) {
     void *sentinel = NULL;
 
     massert_container(v);
+    massert_writable(v);
 
     size = v_size(v);
 
@@ -1944,6 +2294,7 @@ void v_replace_at(vector *v, size_t index, const void *valaddr) {
     void *curr = NULL;
 
     massert_container(v);
+    massert_writable(v);
 
     size = v_size(v);
 
@@ -1990,6 +2341,7 @@ void v_swap_elem(vector *v, size_t n1, size_t n2) {
     void *data_2 = NULL;
 
     massert_container(v);
+    massert_writable(v);
 
     size = v_size(v);
     capacity = v_capacity(v);
@@ -2048,6 +2400,7 @@ void v_remove(vector *v, const void *valaddr) {
     void *curr = NULL;
 
     massert_container(v);
+    massert_writable(v);
     massert_ptr(valaddr);
 
     if (v->impl.start == v->impl.finish) {
@@ -2091,6 +2444,7 @@ void v_remove_if(vector *v, bool (*unary_predicate)(const void *)) {
     void *curr = NULL;
 
     massert_container(v);
+    massert_writable(v);
     massert_pfunc(unary_predicate);
 
     if (v->impl.start == v->impl.finish) {
@@ -2135,22 +2489,23 @@ vector *v_merge(vector *v, vector *other) {
     void *sentinel = NULL;
 
     massert_container(v);
+    massert_writable(v);
     massert_ptr(other);
 
     if (v->ttbl != other->ttbl) {
         WARNING(__FILE__, "Merging vectors with different data types may result in undefined behavior.");
     }
 
-    size_other = v_size(v);
+    size_other = v_size(other);
     capacity_v = v_capacity(v);
 
-    if (size_other >= capacity_v) {
+    if ((v_size(v) + size_other) > capacity_v) {
         /**
          *  If (other's size + v's current size) 
          *  will exceed that of v's capacity,
-         *  have v resized.
+         *  have v grow.
          */
-        v_resize(v, capacity_v * 2);
+        v_grow(v, v_size(v) + size_other);
     }
 
     sentinel = other->impl.finish;
@@ -2207,6 +2562,7 @@ void v_reverse(vector *v) {
     void *restore = NULL;
 
     massert_container(v);
+    massert_writable(v);
 
     back = (char *)(v->impl.finish) - (v->ttbl->width);
 
@@ -2332,9 +2688,110 @@ vector *v_ptrtov(struct typetable *ttbl, void *base, size_t length, size_t capac
     v->impl.finish = (char *)(v->impl.start) + (length * v->ttbl->width);
     v->impl.end_of_storage = (char *)(v->impl.start) + (capacity * v->ttbl->width);
 
+    v->growth = VECTOR_GROWTH_DOUBLE;
+
+    v->mapping.addr = NULL;
+    v->mapping.length = 0;
+
     return v;
 }
 
+/**
+ *  @brief  Returns a read-only vector that views a file of fixed-width records
+ *
+ *  @param[in]  path    path of a file of (file size / width) records
+ *  @param[in]  ttbl    typetable matching that of the records' type
+ *
+ *  @return     pointer to vector viewing the records, or NULL on failure
+ *
+ *  The file is mapped, not read -- pages are loaded as elements are
+ *  first accessed, so opening a multi-GB file is O(1).
+ *  The file may not be empty (a trailing partial record is ignored),
+ *  and ttbl may not have a copy or dtor function
+ *  (records holding pointers are meaningless once written to a file).
+ *
+ *  The returned vector may be read, searched, printed, iterated, and copied
+ *  (v_newcopy), but any function that modifies it will fail an massert;
+ *  writing through v_at/v_front/v_back/v_data is undefined behavior.
+ *  v_delete unmaps the file.
+ */
+vector *v_mmap_open(const char *path, struct typetable *ttbl) {
+    massert_ptr(path);
+    return v_map(path, ttbl, false);
+}
+
+/**
+ *  @brief  Writes v's elements to a file, preceded by a header
+ *          recording their width and count
+ *
+ *  @param[in]  v       pointer to vector
+ *  @param[in]  path    path of the file to create (or truncate)
+ *
+ *  @return     0 on success, -1 on failure
+ *
+ *  The file may be viewed with v_load. As with v_mmap_open,
+ *  v's ttbl may not have a copy or dtor function.
+ */
+int v_save(vector *v, const char *path) {
+    union vector_header header;
+    FILE *file = NULL;
+    size_t count = 0;
+    int status = 0;
+
+    massert_container(v);
+    massert_ptr(path);
+
+    if (v->ttbl->copy || v->ttbl->dtor) {
+        ERROR(__FILE__, "Elements with a copy or dtor function cannot be saved as flat records.");
+        return -1;
+    }
+
+    file = fopen(path, "wb");
+
+    if (file == NULL) {
+        ERROR(__FILE__, strerror(errno));
+        return -1;
+    }
+
+    count = v_size(v);
+
+    memset(&header, 0, sizeof header);
+    memcpy(header.fields.magic, VECTOR_HEADER_MAGIC, sizeof header.fields.magic);
+    header.fields.width = v->ttbl->width;
+    header.fields.count = count;
+
+    if (fwrite(&header, sizeof header, 1, file) != 1
+        || fwrite(v->impl.start, v->ttbl->width, count, file) != count) {
+        ERROR(__FILE__, strerror(errno));
+        status = -1;
+    }
+
+    if (fclose(file) != 0 && status == 0) {
+        ERROR(__FILE__, strerror(errno));
+        status = -1;
+    }
+
+    return status;
+}
+
+/**
+ *  @brief  Returns a read-only vector that views a file written by v_save
+ *
+ *  @param[in]  path    path of a file written by v_save
+ *  @param[in]  ttbl    typetable matching that of the saved vector
+ *
+ *  @return     pointer to vector viewing the file's elements, or NULL on failure
+ *
+ *  The header's width must match ttbl's width, and the file must hold
+ *  at least as many elements as the header records.
+ *  The returned vector has the same restrictions as one from v_mmap_open --
+ *  use v_newcopy if a modifiable vector is required.
+ */
+vector *v_load(const char *path, struct typetable *ttbl) {
+    massert_ptr(path);
+    return v_map(path, ttbl, true);
+}
+
 /**
  *  @brief  Performs a linear search to find valaddr using the ttbl->compare function
  *
@@ -2369,6 +2826,73 @@ int v_search(vector *v, const void *valaddr) {
     return found ? result : -1;
 }
 
+/**
+ *  @brief  Performs a linear search to find valaddr using the ttbl->compare function,
+ *          split across nthreads threads
+ *
+ *  @param[in]  v           pointer to vector
+ *  @param[in]  valaddr     address of a copy of an element to find
+ *  @param[in]  nthreads    thread count (including the caller), 0 for one per core
+ *
+ *  @return     index of the first element equal to valaddr, or -1 if not found
+ */
+int v_search_parallel(vector *v, const void *valaddr, size_t nthreads) {
+    static bool registered = false;
+
+    struct vector_search search;
+    size_t tasks = 0;
+
+    massert_container(v);
+    massert_ptr(valaddr);
+
+    search.base = (const char *)(v->impl.start);
+    search.width = v->ttbl->width;
+    search.count = v_size(v);
+
+    search.valaddr = valaddr;
+    search.comparator = v->ttbl->compare ? v->ttbl->compare : void_ptr_compare;
+
+    /* the typed fast paths read whole elements, so they need aligned storage */
+    search.bitwise = v_search_bitwise(search.comparator)
+                     && ((size_t)(search.base) % search.width) == 0;
+
+    search.found = (long)(search.count);
+
+    nthreads = nthreads > 0 ? nthreads : workpool_cores();
+
+    if (nthreads == 1 || search.count * search.width < VECTOR_PARALLEL_MINIMUM) {
+        long result = v_search_range(&search, 0, search.count);
+        return result < (long)(search.count) ? (int)(result) : -1;
+    }
+
+    search.partition = VECTOR_PARALLEL_PARTITION / search.width;
+    search.partition = search.partition > 0 ? search.partition : 1;
+
+    tasks = (search.count + search.partition - 1) / search.partition;
+
+    pthread_mutex_lock(&v_search_lock);
+
+    /* the caller scans too -- the pool supplies the other (nthreads - 1) threads */
+    if (v_search_pool != NULL && workpool_size(v_search_pool) != nthreads - 1) {
+        workpool_delete(&v_search_pool);
+    }
+
+    if (v_search_pool == NULL) {
+        v_search_pool = workpool_new(nthreads - 1);
+    }
+
+    if (registered == false) {
+        atexit(v_search_pool_atexit);
+        registered = true;
+    }
+
+    workpool_run(v_search_pool, tasks, v_search_task, &search);
+
+    pthread_mutex_unlock(&v_search_lock);
+
+    return search.found < (long)(search.count) ? (int)(search.found) : -1;
+}
+
 /**
  *  @brief  Sorts the contents of v using ttbl->compare
  *
@@ -2379,6 +2903,7 @@ void v_sort(vector *v) {
     int (*comparator)(const void *, const void *) = NULL; 
 
     massert_container(v);
+    massert_writable(v);
 
     size = v_size(v);
 
@@ -2794,7 +3319,7 @@ static void v_init(vector *v, struct typetable *ttbl, size_t capacity) {
     start = calloc(capacity, v->ttbl->width);
     massert_calloc(start);
     */
-    start = malloc(v->ttbl->width * capacity);
+    start = v_storage_acquire(v, capacity);
     memset(start, 0, v->ttbl->width * capacity);
 
     v->impl.start = start;
@@ -2802,6 +3327,11 @@ static void v_init(vector *v, struct typetable *ttbl, size_t capacity) {
 
     v->impl.end_of_storage
     = (char *)(v->impl.start) + (capacity * v->ttbl->width);
+
+    v->growth = VECTOR_GROWTH_DOUBLE;
+
+    v->mapping.addr = NULL;
+    v->mapping.length = 0;
 }
 
 /**
@@ -2814,10 +3344,12 @@ static void v_deinit(vector *v) {
         return;
     }
 
-    v_clear(v);
+    if (IS_MAPPED(v) == false) {
+        /* a mapping is read-only, and its elements own no memory */
+        v_clear(v);
+    }
 
-    free(v->impl.start);
-    v->impl.start = NULL;
+    v_storage_release(v);
     v->impl.finish = NULL;
     v->impl.end_of_storage = NULL;
 
@@ -2849,6 +3381,463 @@ static void v_swap_addr(vector *v, void *first, void *second) {
     temp = NULL;
 }
 
+/**
+ *  @brief  Returns storage for n elements of v -- v's inline buffer
+ *          if n elements fit within it, otherwise, heap memory
+ *
+ *  @param[in]  v   pointer to vector
+ *  @param[in]  n   number of elements to allocate storage for
+ *
+ *  @return     base address of the storage
+ *
+ *  If the inline buffer is returned while v->impl.start is
+ *  still using it, the caller is responsible for not clobbering its contents.
+ */
+static void *v_storage_acquire(vector *v, size_t n) {
+    void *start = NULL;
+
+    if (FITS_INLINE(v, n)) {
+        return INLINE(v);
+    }
+
+    start = malloc(v->ttbl->width * n);
+    massert_malloc(start);
+    return start;
+}
+
+/**
+ *  @brief  Releases v's storage, if it was allocated on the heap
+ *          or mapped from a file
+ *
+ *  @param[in]  v   pointer to vector
+ */
+static void v_storage_release(vector *v) {
+    if (IS_MAPPED(v)) {
+        munmap(v->mapping.addr, v->mapping.length);
+
+        v->mapping.addr = NULL;
+        v->mapping.length = 0;
+    } else if (!IS_INLINE(v)) {
+        free(v->impl.start);
+    }
+
+    v->impl.start = NULL;
+}
+
+/**
+ *  @brief  Transfers ownership of src's buffer and typetable to dest
+ *
+ *  @param[out] dest    pointer to vector, receives src's fields
+ *  @param[in]  src     pointer to vector, its fields are to be reassigned
+ *
+ *  Heap buffers change ownership by pointer; inline buffers cannot,
+ *  so their contents are copied to dest's inline buffer and the impl
+ *  pointers are rebased. src's fields are left as-is --
+ *  the caller must reinitialize or overwrite them.
+ */
+static void v_transfer(vector *dest, vector *src) {
+    size_t fin = 0;
+    size_t end = 0;
+
+    if (IS_INLINE(src)) {
+        fin = (char *)(src->impl.finish) - (char *)(src->impl.start);
+        end = (char *)(src->impl.end_of_storage) - (char *)(src->impl.start);
+
+        memcpy(dest->buffer.bytes, src->buffer.bytes, end);
+
+        dest->impl.start = INLINE(dest);
+        dest->impl.finish = (char *)(dest->impl.start) + fin;
+        dest->impl.end_of_storage = (char *)(dest->impl.start) + end;
+    } else {
+        dest->impl.start = src->impl.start;
+        dest->impl.finish = src->impl.finish;
+        dest->impl.end_of_storage = src->impl.end_of_storage;
+    }
+
+    dest->ttbl = src->ttbl;
+    dest->growth = src->growth;
+
+    dest->mapping = src->mapping;
+}
+
+/**
+ *  @brief  Computes the capacity v should grow to, to hold at least n elements
+ *
+ *  @param[in]  v   pointer to vector
+ *  @param[in]  n   minimum number of elements required
+ *
+ *  @return     new capacity, as per v's growth policy
+ *
+ *  VECTOR_GROWTH_PAGE only rounds buffers of one page or larger --
+ *  rounding a small buffer up to a whole page would mostly waste it.
+ */
+static size_t v_growth_capacity(vector *v, size_t n) {
+    size_t capacity = 0;
+    size_t bytes = 0;
+
+    capacity = v_capacity(v);
+    capacity = capacity > 0 ? capacity : 1;
+
+    while (capacity < n) {
+        if (v->growth == VECTOR_GROWTH_1_5X) {
+            capacity += capacity > 1 ? (capacity / 2) : 1;
+        } else {
+            capacity *= 2;
+        }
+    }
+
+    if (v->growth == VECTOR_GROWTH_PAGE) {
+        bytes = capacity * v->ttbl->width;
+
+        if (bytes >= VECTOR_PAGE_SIZE) {
+            bytes = ((bytes + VECTOR_PAGE_SIZE - 1) / VECTOR_PAGE_SIZE) * VECTOR_PAGE_SIZE;
+            capacity = bytes / v->ttbl->width;
+        }
+    }
+
+    return capacity;
+}
+
+/**
+ *  @brief  Grows v's buffer, as per its growth policy,
+ *          if it cannot already hold n elements
+ *
+ *  @param[in]  v   pointer to vector
+ *  @param[in]  n   minimum number of elements required
+ */
+static void v_grow(vector *v, size_t n) {
+    if (n > v_capacity(v)) {
+        v_resize(v, v_growth_capacity(v, n));
+    }
+}
+
+/**
+ *  @brief  Opens a zeroed block at index, shifting [index, v_size(v))
+ *          one block to the right
+ *
+ *  @param[in]  v       pointer to vector
+ *  @param[in]  index   index in [0, v_size(v)], bounds checked by caller
+ *
+ *  @return     address of the new block
+ */
+static void *v_open_slot(vector *v, size_t index) {
+    char *slot = NULL;
+
+    if (v->impl.finish == v->impl.end_of_storage) {
+        v_grow(v, v_size(v) + 1);
+    }
+
+    slot = (char *)(v->impl.start) + (index * v->ttbl->width);
+
+    memmove(slot + v->ttbl->width, slot, (char *)(v->impl.finish) - slot);
+    memset(slot, 0, v->ttbl->width);
+
+    v->impl.finish = (char *)(v->impl.finish) + (v->ttbl->width);
+    return slot;
+}
+
+/**
+ *  @brief  Maps the file at path read-only, and returns a vector
+ *          that views its elements
+ *
+ *  @param[in]  path    path of the file to map
+ *  @param[in]  ttbl    typetable matching that of the file's elements
+ *  @param[in]  header  true if the file begins with a (union vector_header)
+ *
+ *  @return     pointer to vector, or NULL on failure
+ */
+static vector *v_map(const char *path, struct typetable *ttbl, bool header) {
+    struct typetable *table = NULL;
+    vector *v = NULL;
+
+    union vector_header *head = NULL;
+    struct stat st;
+
+    void *addr = NULL;
+    size_t length = 0;
+    size_t offset = 0;
+    size_t count = 0;
+    int fd = -1;
+
+    table = ttbl ? ttbl : _void_ptr_;
+
+    if (table->copy || table->dtor) {
+        ERROR(__FILE__, "Elements with a copy or dtor function cannot be mapped from flat records.");
+        return NULL;
+    }
+
+    fd = open(path, O_RDONLY);
+
+    if (fd == -1) {
+        ERROR(__FILE__, strerror(errno));
+        return NULL;
+    }
+
+    if (fstat(fd, &st) == -1) {
+        ERROR(__FILE__, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    length = (size_t)(st.st_size);
+    offset = header ? VECTOR_HEADER_SIZE : 0;
+
+    if (length == 0 || length < offset) {
+        ERROR(__FILE__, "File is too short to hold a vector.");
+        close(fd);
+        return NULL;
+    }
+
+    /* the descriptor is not needed once the mapping exists */
+    addr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        ERROR(__FILE__, strerror(errno));
+        return NULL;
+    }
+
+    if (header) {
+        head = (union vector_header *)(addr);
+
+        if (memcmp(head->fields.magic, VECTOR_HEADER_MAGIC, sizeof head->fields.magic) != 0) {
+            ERROR(__FILE__, "File was not written by v_save.");
+            munmap(addr, length);
+            return NULL;
+        }
+
+        if (head->fields.width != table->width) {
+            char str[256];
+            sprintf(str, "Element width in file [%lu] does not match the typetable's width [%lu].", head->fields.width, (unsigned long)(table->width));
+            ERROR(__FILE__, str);
+            munmap(addr, length);
+            return NULL;
+        }
+
+        count = head->fields.count;
+
+        if (count > (length - offset) / table->width) {
+            ERROR(__FILE__, "File is shorter than its header records -- it may be truncated.");
+            munmap(addr, length);
+            return NULL;
+        }
+    } else {
+        count = length / table->width;
+
+        if (length % table->width != 0) {
+            WARNING(__FILE__, "File size is not a multiple of the typetable's width -- the trailing partial record is ignored.");
+        }
+    }
+
+    v = v_allocate();
+    massert_malloc(v);
+
+    v->ttbl = table;
+
+    v->impl.start = (char *)(addr) + offset;
+    v->impl.finish = (char *)(v->impl.start) + (count * table->width);
+    v->impl.end_of_storage = v->impl.finish;
+
+    v->growth = VECTOR_GROWTH_DOUBLE;
+
+    v->mapping.addr = addr;
+    v->mapping.length = length;
+
+    return v;
+}
+
+/**
+ *  @brief  Determines if comparator is a builtin comparator under which
+ *          two elements compare equal exactly when their values are equal
+ *
+ *  @param[in]  comparator  ttbl->compare of a vector
+ *
+ *  @return     true if v_search_range may compare elements by value
+ *
+ *  Floating point comparators are excluded (0.0 == -0.0, NaN != NaN),
+ *  as are those that compare pointees rather than pointers.
+ */
+static bool v_search_bitwise(int (*comparator)(const void *, const void *)) {
+    int (*const bitwise[])(const void *, const void *) = {
+        char_compare, signed_char_compare, unsigned_char_compare,
+        short_int_compare, signed_short_int_compare, unsigned_short_int_compare,
+        int_compare, signed_int_compare, unsigned_int_compare,
+        long_int_compare, signed_long_int_compare, unsigned_long_int_compare,
+        bool_compare,
+        int8_compare, int16_compare, int32_compare,
+        uint8_compare, uint16_compare, uint32_compare
+    };
+
+    size_t i = 0;
+
+    for (i = 0; i < sizeof bitwise / sizeof *bitwise; i++) {
+        if (comparator == bitwise[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ *  @brief  Scans elements [first, last) of search for search->valaddr
+ *
+ *  @param[in]  search  pointer to the state of a v_search_parallel call
+ *  @param[in]  first   index of the first element to scan (inclusive)
+ *  @param[in]  last    index of the last element to scan (exclusive)
+ *
+ *  @return     index of the first match within [first, last), or last if none
+ */
+static long v_search_range(struct vector_search *search, size_t first, size_t last) {
+    const size_t width = search->width;
+    size_t i = first;
+
+    if (search->bitwise == false) {
+        const char *curr = search->base + (first * width);
+
+        for (i = first; i < last; i++) {
+            if (search->comparator(curr, search->valaddr) == 0) {
+                break;
+            }
+
+            curr += width;
+        }
+    } else if (width == 1) {
+        const char *match = memchr(search->base + first, *(const unsigned char *)(search->valaddr), last - first);
+        i = match ? (size_t)(match - search->base) : last;
+    } else if (width == sizeof(unsigned short)) {
+        const unsigned short *base = (const unsigned short *)(search->base);
+        unsigned short key = 0;
+
+        memcpy(&key, search->valaddr, width);
+
+        for (i = first; i < last && base[i] != key; i++) {
+            /* scan */
+        }
+    } else if (width == sizeof(unsigned int)) {
+        const unsigned int *base = (const unsigned int *)(search->base);
+        unsigned int key = 0;
+
+        memcpy(&key, search->valaddr, width);
+
+        for (i = first; i < last && base[i] != key; i++) {
+            /* scan */
+        }
+    } else if (width == sizeof(unsigned long)) {
+        const unsigned long *base = (const unsigned long *)(search->base);
+        unsigned long key = 0;
+
+        memcpy(&key, search->valaddr, width);
+
+        for (i = first; i < last && base[i] != key; i++) {
+            /* scan */
+        }
+    } else {
+        const char *curr = search->base + (first * width);
+
+        for (i = first; i < last; i++) {
+            if (memcmp(curr, search->valaddr, width) == 0) {
+                break;
+            }
+
+            curr += width;
+        }
+    }
+
+    return (long)(i);
+}
+
+/**
+ *  @brief  v_search_parallel task: scans partition task of the vector,
+ *          recording a match if it precedes any found so far
+ *
+ *  @param[in]  arg     pointer to (struct vector_search)
+ *  @param[in]  task    partition index
+ */
+static void v_search_task(void *arg, size_t task) {
+    struct vector_search *search = (struct vector_search *)(arg);
+
+    size_t first = task * search->partition;
+    size_t last = first + search->partition;
+
+    last = last < search->count ? last : search->count;
+
+    /* in steps, so a match in an earlier partition ends this scan early */
+    while (first < last && (long)(first) < search->found) {
+        size_t step = first + VECTOR_PARALLEL_POLL < last ? first + VECTOR_PARALLEL_POLL : last;
+        long result = v_search_range(search, first, step);
+
+        if (result < (long)(step)) {
+            long found = search->found;
+
+            while (result < found && !__sync_bool_compare_and_swap(&search->found, found, result)) {
+                found = search->found;
+            }
+
+            break;
+        }
+
+        first = step;
+    }
+}
+
+/**
+ *  @brief  Joins the v_search_parallel pool at exit
+ */
+static void v_search_pool_atexit(void) {
+    workpool_delete(&v_search_pool);
+}
+
+/**
+ *  @brief  Determines if [first, last) is a contiguous block of memory
+ *
+ *  @param[in]  first   represents the beginning of the range (inclusive)
+ *  @param[in]  last    represents the end of the range (exclusive)
+ *
+ *  @return     true if first and last are vector iterators
+ *              that refer to the same vector, false otherwise
+ *
+ *  Range functions use this to walk [first, last) with a pointer,
+ *  rather than by it_curr/it_incr (two indirect calls per element).
+ */
+static bool v_range_contiguous(iterator first, iterator last) {
+    return first.itbl == _vector_iterator_ && last.itbl == _vector_iterator_
+        && first.container == last.container;
+}
+
+/**
+ *  @brief  Copies the elements of a contiguous range [first, last) to dst
+ *
+ *  @param[in]  v       pointer to vector (dst is within its buffer)
+ *  @param[in]  dst     address of the first block to copy to
+ *  @param[in]  first   address of the first element to copy
+ *  @param[in]  last    address one block past the last element to copy
+ *
+ *  @return     address one block past the last block copied to
+ *
+ *  If v's ttbl has a copy function, each element is deep copied;
+ *  otherwise, the whole range is moved with a single memmove.
+ */
+static void *v_copy_contiguous(vector *v, void *dst, const void *first, const void *last) {
+    const size_t size = (const char *)(last) - (const char *)(first);
+    char *target = (char *)(dst);
+    const char *curr = (const char *)(first);
+
+    if (v->ttbl->copy) {
+        while (curr != last) {
+            v->ttbl->copy(target, curr);
+
+            target += v->ttbl->width;
+            curr += v->ttbl->width;
+        }
+
+        return target;
+    }
+
+    memmove(target, curr, size);
+    return target + size;
+}
+
 /**
  *  @brief  Initializes and returns an iterator that refers to arg
  *
@@ -0,0 +1,45 @@
+/**
+ *  @file       vector_typed.c
+ *  @brief      Source file for type-specialized vectors (int, double, char *)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       16 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "vector_typed.h"
+#include "utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+DEFINE_VECTOR(int, vector_int, VECTOR_COPY_ASSIGN, VECTOR_DTOR_NONE,
+              VECTOR_COMPARE_VALUE, VECTOR_PRINT_INT);
+
+DEFINE_VECTOR(double, vector_double, VECTOR_COPY_ASSIGN, VECTOR_DTOR_NONE,
+              VECTOR_COMPARE_VALUE, VECTOR_PRINT_DOUBLE);
+
+DEFINE_VECTOR(char_ptr, vector_str, VECTOR_COPY_STR, VECTOR_DTOR_STR,
+              VECTOR_COMPARE_STR, VECTOR_PRINT_STR);
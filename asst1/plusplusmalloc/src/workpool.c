@@ -0,0 +1,467 @@
+/**
+ *  @file       workpool.c
+ *  @brief      Source file for a reusable work-stealing thread pool
+ *
+ *  @author     Gemuele Aludino
+ *  @date       17 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ *  sysconf(_SC_NPROCESSORS_ONLN) is not declared under -std=c89 alone;
+ *  <string.h> then declares strdup, so it must precede the macro in utils.h.
+ */
+#define _XOPEN_SOURCE 500
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "workpool.h"
+#include "utils.h"
+
+/**< deques are padded and aligned to this -- a typical cache line */
+#define WORKPOOL_DEFAULT_LINE 64
+
+/**
+ *  A worker's share of a run: tasks [top, bottom) remain.
+ *  The owner takes from bottom, thieves take from top --
+ *  both ends are only ever moved toward each other,
+ *  so the deque needs no storage beyond its two ends.
+ *  Each deque gets its own cache line, so workers taking
+ *  from their own ends do not contend.
+ */
+struct workpool_deque {
+    volatile long top;
+    volatile long bottom;
+    char pad[WORKPOOL_DEFAULT_LINE - (2 * sizeof(long))];
+};
+
+struct workpool {
+    pthread_t *threads;
+    struct workpool_deque *deques; /**< aligned to WORKPOOL_DEFAULT_LINE, within deques_raw */
+    void *deques_raw;              /**< address returned by malloc (to be freed) */
+    size_t nthreads;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake; /**< signalled when a run begins, or on shutdown */
+    pthread_cond_t done; /**< signalled when a run's last task/worker finishes */
+
+    workpool_task_fn task;
+    void *arg;
+
+    unsigned long epoch;     /**< incremented at the start of every run */
+    volatile long remaining; /**< tasks of the current run yet to finish */
+    volatile long cancelled; /**< nonzero once the current run is cancelled */
+    size_t active;           /**< workers still taking tasks from this run */
+    bool shutdown;
+};
+
+/**
+ *  Per-worker startup argument -- the pool, and the worker's deque index
+ */
+struct workpool_worker {
+    workpool_t *pool;
+    size_t id;
+};
+
+static void *workpool_worker(void *arg);
+static void workpool_drain(workpool_t *pool, size_t id);
+
+static bool workpool_pop(struct workpool_deque *deque, long *task);
+static bool workpool_steal(struct workpool_deque *deque, long *task);
+
+static void *workpool_aligned_alloc(size_t size, void **raw);
+
+/**
+ *  @brief  Allocates, constructs, and returns a pool of nthreads worker threads
+ *
+ *  @param[in]  nthreads    worker count, 0 for the number of online cores
+ *
+ *  @return     pointer to workpool
+ */
+workpool_t *workpool_new(size_t nthreads) {
+    workpool_t *pool = NULL;
+    size_t i = 0;
+
+    pool = malloc(sizeof *pool);
+    assert(pool);
+
+    pool->nthreads = nthreads > 0 ? nthreads : workpool_cores();
+
+    pool->threads = calloc(pool->nthreads, sizeof *pool->threads);
+    assert(pool->threads);
+
+    /* calloc only guarantees 16-byte alignment -- a deque could straddle two lines */
+    pool->deques = workpool_aligned_alloc(pool->nthreads * sizeof *pool->deques, &pool->deques_raw);
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pool->task = NULL;
+    pool->arg = NULL;
+
+    pool->epoch = 0;
+    pool->remaining = 0;
+    pool->cancelled = 0;
+    pool->active = 0;
+    pool->shutdown = false;
+
+    for (i = 0; i < pool->nthreads; i++) {
+        struct workpool_worker *worker = NULL;
+
+        worker = malloc(sizeof *worker);
+        assert(worker);
+
+        worker->pool = pool;
+        worker->id = i;
+
+        pthread_create(pool->threads + i, NULL, workpool_worker, worker);
+    }
+
+    return pool;
+}
+
+/**
+ *  @brief  Joins the workers of (*pool), releases it, and sets (*pool) to NULL
+ *
+ *  @param[out] pool    address of a pointer to workpool
+ */
+void workpool_delete(workpool_t **pool) {
+    size_t i = 0;
+
+    if ((*pool) == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&(*pool)->lock);
+    (*pool)->shutdown = true;
+    pthread_cond_broadcast(&(*pool)->wake);
+    pthread_mutex_unlock(&(*pool)->lock);
+
+    for (i = 0; i < (*pool)->nthreads; i++) {
+        pthread_join((*pool)->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&(*pool)->done);
+    pthread_cond_destroy(&(*pool)->wake);
+    pthread_mutex_destroy(&(*pool)->lock);
+
+    free((*pool)->deques_raw);
+    free((*pool)->threads);
+
+    free((*pool));
+    (*pool) = NULL;
+}
+
+/**
+ *  @brief  Runs task(arg, i) for every i in [0, count), across pool's workers
+ *
+ *  @param[in]  pool    pointer to workpool
+ *  @param[in]  count   number of tasks
+ *  @param[in]  task    task function
+ *  @param[in]  arg     argument passed to every call of task
+ */
+void workpool_run(workpool_t *pool, size_t count, workpool_task_fn task, void *arg) {
+    size_t i = 0;
+    size_t block = 0;
+    size_t first = 0;
+
+    if (count == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+
+    /**
+     *  A worker that woke late for the previous run may have joined it
+     *  after the caller stopped waiting -- it still counts as active,
+     *  and may be scanning the deques. Wait for it to leave.
+     */
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+
+    pool->task = task;
+    pool->arg = arg;
+
+    pool->remaining = (long)(count);
+    pool->cancelled = 0;
+
+    /**
+     *  Deal [0, count) out in contiguous blocks --
+     *  no worker is taking tasks (active == 0, and the lock is held),
+     *  so the deques may be written directly.
+     */
+    block = count / pool->nthreads;
+
+    for (i = 0; i < pool->nthreads; i++) {
+        size_t length = block + (i < count % pool->nthreads ? 1 : 0);
+
+        pool->deques[i].top = (long)(first);
+        pool->deques[i].bottom = (long)(first + length);
+
+        first += length;
+    }
+
+    ++pool->epoch;
+
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    /* the caller steals too, rather than sleeping through the run */
+    workpool_drain(pool, pool->nthreads);
+
+    pthread_mutex_lock(&pool->lock);
+
+    /**
+     *  A worker that finds no task left may still be scanning
+     *  the deques -- the next run may not refill them until it stops.
+     *  Once cancelled, the dropped tasks never decrement remaining.
+     */
+    while ((pool->remaining > 0 && pool->cancelled == 0) || pool->active > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ *  @brief  Drops the tasks of the current run that have not yet started
+ *
+ *  @param[in]  pool    pointer to workpool
+ *
+ *  Meant to be called from within a task; a no-op between runs.
+ */
+void workpool_cancel(workpool_t *pool) {
+    if (__sync_bool_compare_and_swap(&pool->cancelled, 0, 1)) {
+        /* the caller may be waiting on remaining, which will not reach 0 */
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+/**
+ *  @brief  Returns the number of worker threads in pool
+ *
+ *  @param[in]  pool    pointer to workpool
+ *
+ *  @return     worker count
+ */
+size_t workpool_size(workpool_t *pool) {
+    return pool->nthreads;
+}
+
+/**
+ *  @brief  Returns the number of online cores (at least 1)
+ */
+size_t workpool_cores(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (size_t)(cores) : 1;
+}
+
+/**
+ *  @brief  Worker thread routine -- sleeps until a run begins,
+ *          drains it, and sleeps again, until shutdown
+ *
+ *  @param[in]  arg     pointer to (struct workpool_worker), freed here
+ */
+static void *workpool_worker(void *arg) {
+    struct workpool_worker *worker = (struct workpool_worker *)(arg);
+
+    workpool_t *pool = worker->pool;
+    size_t id = worker->id;
+
+    unsigned long epoch = 0;
+
+    free(worker);
+    worker = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+
+    for (;;) {
+        while (pool->epoch == epoch && pool->shutdown == false) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        if (pool->shutdown) {
+            break;
+        }
+
+        epoch = pool->epoch;
+        ++pool->active;
+
+        pthread_mutex_unlock(&pool->lock);
+        workpool_drain(pool, id);
+        pthread_mutex_lock(&pool->lock);
+
+        if (--pool->active == 0 && (pool->remaining == 0 || pool->cancelled)) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/**
+ *  @brief  Runs tasks from deque id until it is empty,
+ *          then steals from the other deques until all are empty
+ *          (or until the run is cancelled)
+ *
+ *  @param[in]  pool    pointer to workpool
+ *  @param[in]  id      index of the caller's deque, or nthreads for none
+ */
+static void workpool_drain(workpool_t *pool, size_t id) {
+    size_t i = 0;
+    long task = -1;
+    bool found = false;
+
+    do {
+        found = false;
+
+        if (pool->cancelled) {
+            break;
+        }
+
+        if (id < pool->nthreads && workpool_pop(pool->deques + id, &task)) {
+            found = true;
+        } else {
+            for (i = 1; i <= pool->nthreads && found == false; i++) {
+                size_t victim = (id + i) % pool->nthreads;
+
+                /**
+                 *  A failed steal may have lost a race, not found an empty
+                 *  deque -- retry while the victim still holds tasks.
+                 */
+                while (pool->deques[victim].top < pool->deques[victim].bottom) {
+                    if (workpool_steal(pool->deques + victim, &task)) {
+                        found = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (found) {
+            pool->task(pool->arg, (size_t)(task));
+
+            if (__sync_sub_and_fetch(&pool->remaining, 1) == 0) {
+                /* lock, so the signal cannot fall between the caller's test and wait */
+                pthread_mutex_lock(&pool->lock);
+                pthread_cond_signal(&pool->done);
+                pthread_mutex_unlock(&pool->lock);
+            }
+        }
+    } while (found);
+}
+
+/**
+ *  @brief  Takes the task at the owner's end (bottom) of deque
+ *
+ *  @param[in]  deque   pointer to the caller's own deque
+ *  @param[out] task    receives the task taken
+ *
+ *  @return     true if a task was taken, false if deque was empty
+ */
+static bool workpool_pop(struct workpool_deque *deque, long *task) {
+    long bottom = deque->bottom - 1;
+    long top = 0;
+
+    deque->bottom = bottom;
+    __sync_synchronize();
+    top = deque->top;
+
+    if (top < bottom) {
+        /* more than one task left -- no thief can reach this one */
+        (*task) = bottom;
+        return true;
+    }
+
+    if (top == bottom && __sync_bool_compare_and_swap(&deque->top, top, top + 1)) {
+        /* won the race for the last task against the thieves */
+        (*task) = bottom;
+        deque->bottom = top + 1;
+        return true;
+    }
+
+    /* empty (or the last task was stolen) -- leave bottom == top */
+    deque->bottom = deque->top;
+    return false;
+}
+
+/**
+ *  @brief  Takes the task at the thieves' end (top) of deque
+ *
+ *  @param[in]  deque   pointer to another worker's deque
+ *  @param[out] task    receives the task taken
+ *
+ *  @return     true if a task was taken, false if deque was empty
+ *              or another thread took the task first
+ */
+static bool workpool_steal(struct workpool_deque *deque, long *task) {
+    long top = deque->top;
+    long bottom = 0;
+
+    __sync_synchronize();
+    bottom = deque->bottom;
+
+    if (top >= bottom) {
+        return false;
+    }
+
+    if (__sync_bool_compare_and_swap(&deque->top, top, top + 1)) {
+        (*task) = top;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ *  @brief  Allocates size zeroed bytes, aligned to WORKPOOL_DEFAULT_LINE
+ *
+ *  @param[in]  size    number of bytes
+ *  @param[out] raw     receives the address returned by malloc (to be freed)
+ *
+ *  @return     aligned address within raw
+ */
+static void *workpool_aligned_alloc(size_t size, void **raw) {
+    size_t misalignment = 0;
+    char *aligned = NULL;
+
+    (*raw) = malloc(size + WORKPOOL_DEFAULT_LINE - 1);
+    assert((*raw));
+
+    misalignment = (size_t)(*raw) % WORKPOOL_DEFAULT_LINE;
+    aligned = misalignment == 0 ? (char *)(*raw)
+                                : (char *)(*raw) + (WORKPOOL_DEFAULT_LINE - misalignment);
+
+    memset(aligned, 0, size);
+    return aligned;
+}
@@ -55,8 +55,65 @@ typedef unsigned char bool;
 #include <fcntl.h>
 */
 
+#include <stddef.h>
+#include <unistd.h>
+
 #include "mymalloc.h"
 
+#include "vector.h"
+#include "vector_typed.h"
+#include "deque.h"
+#include "rbtree.h"
+#include "bptree.h"
+#include "hashmap.h"
+#include "columns.h"
+#include "bloom.h"
+#include "utils.h"
+
+/**
+ *  Every test below drives a container through a pseudo-random sequence
+ *  of operations and checks it against a reference model
+ *  (a plain array indexed by key, or a ring of ints),
+ *  so a failure names the operation that diverged.
+ */
+
+/**< number of distinct keys drawn by the map tests */
+#define TEST_KEYS 512
+
+/**< number of operations applied by the map/deque tests */
+#define TEST_STEPS 20000
+
+/**< failed CHECKs so far -- main returns EXIT_FAILURE if nonzero */
+static int test_failures = 0;
+
+#define CHECK(COND)                                                            \
+    do {                                                                       \
+        if (!(COND)) {                                                         \
+            fprintf(stderr, "%s:%d: check failed: %s\n",                       \
+                    __FILE__, __LINE__, #COND);                                \
+            ++test_failures;                                                   \
+        }                                                                      \
+    } while (0)
+
+/**< test: pseudo-random numbers, reproducible across runs */
+static unsigned long test_seed = 1;
+static int test_rand(int n);
+
+/**< test: one function per container/API */
+static void test_hashmap(void);
+static void test_deque(void);
+static void test_rbtree(void);
+static void test_bptree(void);
+static void test_columns(void);
+static void test_bloom(void);
+static void test_cmsketch(void);
+static void test_vector(void);
+static void test_vector_move(void);
+static void test_vector_search(void);
+static void test_vector_typed(void);
+static void test_vector_file(void);
+static void test_mymalloc(void);
+
 /**
  *  @brief  Program execution begins here
  *
@@ -66,7 +123,878 @@ typedef unsigned char bool;
  *  @return     exit status
  */
 int main(int argc, const char *argv[]) {
-    /* Enter source code here... */
+    test_hashmap();
+    test_deque();
+    test_rbtree();
+    test_bptree();
+    test_columns();
+    test_bloom();
+    test_cmsketch();
+    test_vector();
+    test_vector_move();
+    test_vector_search();
+    test_vector_typed();
+    test_vector_file();
+
+    /* last -- test_mymalloc leaves the 4 KB heap full */
+    test_mymalloc();
+
+    if (test_failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", test_failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("all checks passed\n");
+    return EXIT_SUCCESS;
+}
+
+/**
+ *  @brief  Returns a pseudo-random int in [0, n)
+ *
+ *  @param[in]  n   upper bound (exclusive)
+ *
+ *  @return     pseudo-random int in [0, n)
+ *
+ *  A fixed LCG, rather than rand(), so every run (and platform)
+ *  applies the same sequence of operations.
+ */
+static int test_rand(int n) {
+    test_seed = (test_seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return (int)((test_seed >> 8) % (unsigned long)(n));
+}
+
+/**
+ *  @brief  Inserts/erases random keys in a hashmap, checking every key
+ *          against a reference model after the map has grown
+ *          and rehashed several times
+ */
+static void test_hashmap(void) {
+    int present[TEST_KEYS];
+    int value[TEST_KEYS];
+    hashmap *m = NULL;
+    hashmap *set = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    int grown = 0;
+    int step = 0;
+    int key = 0;
+    int val = 0;
+
+    memset(present, 0, sizeof present);
+    memset(value, 0, sizeof value);
+
+    /* start small, so the map rehashes (incrementally) while under test */
+    m = hashmap_newr(_int_, _int_, 1);
+    capacity = hashmap_capacity(m);
+
+    for (step = 0; step < TEST_STEPS; step++) {
+        key = test_rand(TEST_KEYS);
+
+        if (test_rand(3) == 0) {
+            hashmap_erase(m, &key);
+            count -= present[key];
+            present[key] = 0;
+        } else {
+            val = test_rand(1 << 20);
+            hashmap_insert(m, &key, &val);
+            count += !present[key];
+            present[key] = 1;
+            value[key] = val;
+        }
+
+        if (hashmap_capacity(m) != capacity) {
+            capacity = hashmap_capacity(m);
+            ++grown;
+        }
+
+        CHECK(hashmap_size(m) == count);
+    }
+
+    CHECK(grown > 0);
+
+    for (key = 0; key < TEST_KEYS; key++) {
+        int *found = hashmap_find(m, &key);
+
+        CHECK(!hashmap_contains(m, &key) == !present[key]);
+        CHECK((found != NULL) == (present[key] != 0));
+        CHECK(found == NULL || *found == value[key]);
+    }
+
+    /* absent keys outside the drawn range */
+    key = -1;
+    CHECK(hashmap_find(m, &key) == NULL);
+    key = TEST_KEYS;
+    CHECK(!hashmap_contains(m, &key));
+
+    /* reserve must not lose anything */
+    hashmap_reserve(m, TEST_KEYS * 4);
+    CHECK(hashmap_capacity(m) >= TEST_KEYS * 4);
+
+    for (key = 0; key < TEST_KEYS; key++) {
+        int *found = hashmap_find(m, &key);
+        CHECK((found != NULL) == (present[key] != 0));
+        CHECK(found == NULL || *found == value[key]);
+    }
+
+    hashmap_clear(m);
+    CHECK(hashmap_size(m) == 0);
+    CHECK(hashmap_empty(m));
+
+    for (key = 0; key < TEST_KEYS; key++) {
+        CHECK(!hashmap_contains(m, &key));
+    }
+
+    hashmap_delete(&m);
+    CHECK(m == NULL);
+
+    /* a set: find yields the stored key */
+    set = hashmap_new(_int_, NULL);
+
+    for (key = 0; key < TEST_KEYS; key += 3) {
+        hashmap_insert(set, &key, NULL);
+        hashmap_insert(set, &key, NULL);
+    }
+
+    CHECK(hashmap_size(set) == (TEST_KEYS + 2) / 3);
+
+    for (key = 0; key < TEST_KEYS; key++) {
+        int *found = hashmap_find(set, &key);
+        CHECK((found != NULL) == (key % 3 == 0));
+        CHECK(found == NULL || *found == key);
+    }
+
+    hashmap_delete(&set);
+}
+
+/**
+ *  @brief  Pushes/pops at both ends of a deque, checking it against
+ *          a ring buffer of ints, across many chunk boundaries
+ */
+static void test_deque(void) {
+    static int model[TEST_STEPS * 2];
+    size_t head = TEST_STEPS;
+    size_t tail = TEST_STEPS;
+    deque *d = NULL;
+    deque *copy = NULL;
+    size_t i = 0;
+    int step = 0;
+    int val = 0;
+
+    d = d_new(_int_);
+
+    for (step = 0; step < TEST_STEPS; step++) {
+        /* push 3:1 over pop, so the deque grows across many chunks */
+        switch (test_rand(8)) {
+        case 0:
+            if (tail > head) {
+                d_popb(d);
+                --tail;
+            }
+            break;
+        case 1:
+            if (tail > head) {
+                d_popf(d);
+                ++head;
+            }
+            break;
+        case 2:
+        case 3:
+        case 4:
+            val = step;
+            d_pushf(d, &val);
+            model[--head] = val;
+            break;
+        default:
+            val = step;
+            d_pushb(d, &val);
+            model[tail++] = val;
+            break;
+        }
+
+        CHECK(d_size(d) == tail - head);
+
+        if (tail > head) {
+            CHECK(*(int *)(d_front(d)) == model[head]);
+            CHECK(*(int *)(d_back(d)) == model[tail - 1]);
+        }
+    }
+
+    for (i = 0; i < tail - head; i++) {
+        CHECK(*(int *)(d_at(d, i)) == model[head + i]);
+    }
+
+    copy = d_newcopy(d);
+    CHECK(d_size(copy) == d_size(d));
+
+    for (i = 0; i < d_size(copy); i++) {
+        CHECK(*(int *)(d_at(copy, i)) == model[head + i]);
+    }
+
+    /* drain from the front, then reuse the emptied deque */
+    while (!d_empty(d)) {
+        CHECK(*(int *)(d_front(d)) == model[head]);
+        d_popf(d);
+        ++head;
+    }
+
+    CHECK(head == tail);
+
+    val = 42;
+    d_pushb(d, &val);
+    CHECK(d_size(d) == 1 && *(int *)(d_front(d)) == 42);
+
+    d_clear(copy);
+    CHECK(d_empty(copy));
+
+    d_delete(&copy);
+    d_delete(&d);
+    CHECK(d == NULL);
+}
+
+/**
+ *  @brief  Inserts/erases random keys in an rbtree, checking
+ *          membership, order (min/max/lower_bound), and balance
+ */
+static void test_rbtree(void) {
+    int present[TEST_KEYS];
+    int value[TEST_KEYS];
+    rbtree *t = NULL;
+    size_t count = 0;
+    int step = 0;
+    int key = 0;
+    int val = 0;
+    int lo = 0;
+    int hi = 0;
+    int height = 0;
+
+    memset(present, 0, sizeof present);
+    memset(value, 0, sizeof value);
+
+    t = rbtree_new(_int_, _int_);
+
+    for (step = 0; step < TEST_STEPS; step++) {
+        key = test_rand(TEST_KEYS);
+
+        if (test_rand(3) == 0) {
+            rbtree_erase(t, &key);
+            count -= present[key];
+            present[key] = 0;
+        } else {
+            val = test_rand(1 << 20);
+            rbtree_insert(t, &key, &val);
+            count += !present[key];
+            present[key] = 1;
+            value[key] = val;
+        }
+
+        CHECK(rbtree_size(t) == count);
+    }
+
+    for (key = 0; key < TEST_KEYS; key++) {
+        int *found = rbtree_find(t, &key);
+        CHECK(!rbtree_contains(t, &key) == !present[key]);
+        CHECK((found != NULL) == (present[key] != 0));
+        CHECK(found == NULL || *found == value[key]);
+    }
+
+    /* red-black: height is at most 2 * log2(n + 1) */
+    height = rbtree_height(t);
+    for (step = 1, lo = 0; (size_t)(step) <= count + 1; step <<= 1, lo++)
+        ;
+    CHECK(height <= 2 * lo);
+
+    /* order: min/max, and lower_bound of every key (present or not) */
+    for (lo = 0; lo < TEST_KEYS && !present[lo]; lo++)
+        ;
+    for (hi = TEST_KEYS - 1; hi >= 0 && !present[hi]; hi--)
+        ;
+
+    CHECK(count == 0 || *(int *)(rbtree_min(t)) == lo);
+    CHECK(count == 0 || *(int *)(rbtree_max(t)) == hi);
+
+    for (key = 0; key <= hi; key++) {
+        iterator it = rbtree_lower_bound(t, &key);
+        int next = key;
+
+        while (!present[next]) {
+            ++next;
+        }
+
+        CHECK(*(int *)(it_curr(it)) == next);
+        CHECK(*(int *)(rbtree_itvalue(it)) == value[next]);
+    }
+
+    /* erase_min/erase_max walk the model inward */
+    while (count > 2) {
+        rbtree_erase_min(t);
+        present[lo] = 0;
+        rbtree_erase_max(t);
+        present[hi] = 0;
+        count -= 2;
+
+        for (; lo < TEST_KEYS && !present[lo]; lo++)
+            ;
+        for (; hi >= 0 && !present[hi]; hi--)
+            ;
+
+        CHECK(rbtree_size(t) == count);
+        CHECK(*(int *)(rbtree_min(t)) == lo);
+        CHECK(*(int *)(rbtree_max(t)) == hi);
+    }
+
+    rbtree_clear(t);
+    CHECK(rbtree_empty(t));
+
+    rbtree_delete(&t);
+    CHECK(t == NULL);
+}
+
+/**
+ *  @brief  Inserts/erases random keys in bptrees of a few node sizes,
+ *          checking membership and order (min/max/lower_bound)
+ *
+ *  The smallest node size forces many splits/merges with few keys.
+ */
+static void test_bptree(void) {
+    size_t node_sizes[] = { 128, 256, 4096 };
+    int present[TEST_KEYS];
+    int value[TEST_KEYS];
+    bptree *t = NULL;
+    size_t count = 0;
+    size_t n = 0;
+    int step = 0;
+    int key = 0;
+    int val = 0;
+    int lo = 0;
+    int hi = 0;
+
+    for (n = 0; n < sizeof node_sizes / sizeof *node_sizes; n++) {
+        memset(present, 0, sizeof present);
+        memset(value, 0, sizeof value);
+        count = 0;
+
+        t = bptree_newsz(_int_, _int_, node_sizes[n]);
+
+        for (step = 0; step < TEST_STEPS; step++) {
+            key = test_rand(TEST_KEYS);
+
+            if (test_rand(3) == 0) {
+                bptree_erase(t, &key);
+                count -= present[key];
+                present[key] = 0;
+            } else {
+                val = test_rand(1 << 20);
+                bptree_insert(t, &key, &val);
+                count += !present[key];
+                present[key] = 1;
+                value[key] = val;
+            }
+
+            CHECK(bptree_size(t) == count);
+        }
+
+        for (key = 0; key < TEST_KEYS; key++) {
+            int *found = bptree_find(t, &key);
+            CHECK(!bptree_contains(t, &key) == !present[key]);
+            CHECK((found != NULL) == (present[key] != 0));
+            CHECK(found == NULL || *found == value[key]);
+        }
+
+        for (lo = 0; lo < TEST_KEYS && !present[lo]; lo++)
+            ;
+        for (hi = TEST_KEYS - 1; hi >= 0 && !present[hi]; hi--)
+            ;
+
+        CHECK(count == 0 || *(int *)(bptree_min(t)) == lo);
+        CHECK(count == 0 || *(int *)(bptree_max(t)) == hi);
+
+        for (key = 0; key <= hi; key++) {
+            iterator it = bptree_lower_bound(t, &key);
+            int next = key;
+
+            while (!present[next]) {
+                ++next;
+            }
+
+            CHECK(*(int *)(it_curr(it)) == next);
+            CHECK(*(int *)(bptree_itvalue(it)) == value[next]);
+        }
+
+        /* erase everything, in an order unrelated to insertion */
+        for (key = 0; key < TEST_KEYS; key++) {
+            int k = (key * 7) % TEST_KEYS;
+            bptree_erase(t, &k);
+            count -= present[k];
+            present[k] = 0;
+            CHECK(bptree_size(t) == count);
+        }
+
+        CHECK(bptree_empty(t));
+        bptree_delete(&t);
+    }
+}
+
+/**
+ *  @brief  Record type for test_columns
+ */
+struct test_point {
+    int id;
+    double x;
+    double y;
+};
+
+/**
+ *  @brief  Pushes records into columns, and checks get/at/sum/
+ *          filter_range/gather against the same records in an array
+ */
+static void test_columns(void) {
+    struct column_field schema[3];
+    static struct test_point records[1000];
+    struct test_point record;
+    size_t idx[1000];
+    double gathered[1000];
+    columns *c = NULL;
+    size_t n = sizeof records / sizeof *records;
+    size_t expected = 0;
+    size_t found = 0;
+    double sum = 0.0;
+    size_t i = 0;
+
+    schema[0].ttbl = _int_;
+    schema[0].offset = offsetof(struct test_point, id);
+    schema[1].ttbl = _double_;
+    schema[1].offset = offsetof(struct test_point, x);
+    schema[2].ttbl = _double_;
+    schema[2].offset = offsetof(struct test_point, y);
+
+    /* an empty schema is rejected */
+    CHECK(col_new(schema, 0) == NULL);
+
+    /* start at 1, so the columns grow while under test */
+    c = col_newr(schema, 3, 1);
+    CHECK(col_fields(c) == 3);
+
+    for (i = 0; i < n; i++) {
+        records[i].id = test_rand(100);
+        records[i].x = (double)(i);
+        records[i].y = (double)(test_rand(1000)) / 10.0;
+        col_pushb(c, &records[i]);
+    }
+
+    CHECK(col_size(c) == n);
+
+    for (i = 0; i < n; i++) {
+        col_get(c, i, &record);
+        CHECK(record.id == records[i].id);
+        CHECK(record.x == records[i].x && record.y == records[i].y);
+        CHECK(*(int *)(col_at(c, 0, i)) == records[i].id);
+        CHECK(*(double *)(col_at(c, 2, i)) == records[i].y);
+    }
+
+    /* sum of the int column is exact; of x = 0..n-1, also exact */
+    for (i = 0, sum = 0.0; i < n; i++) {
+        sum += records[i].id;
+    }
+    CHECK(col_sum(c, 0) == sum);
+    CHECK(col_sum(c, 1) == (double)(n) * (double)(n - 1) / 2.0);
+
+    /* filter_range [25, 50] on id, compared with a scalar scan */
+    found = col_filter_range(c, 0, 25.0, 50.0, idx);
+
+    for (i = 0, expected = 0; i < n; i++) {
+        if (records[i].id >= 25 && records[i].id <= 50) {
+            CHECK(expected < found && idx[expected] == i);
+            ++expected;
+        }
+    }
+    CHECK(found == expected);
+
+    /* gather y at the filtered indices */
+    col_gather(c, 2, idx, found, gathered);
+
+    for (i = 0; i < found; i++) {
+        CHECK(gathered[i] == records[idx[i]].y);
+    }
+
+    /* an empty range matches nothing */
+    CHECK(col_filter_range(c, 1, 2000.0, 3000.0, idx) == 0);
+
+    col_popb(c);
+    CHECK(col_size(c) == n - 1);
+
+    col_clear(c);
+    CHECK(col_empty(c));
+
+    col_delete(&c);
+    CHECK(c == NULL);
+}
+
+/**
+ *  @brief  Checks that bloom has no false negatives (alone or merged),
+ *          and that its false positive rate is near the one requested
+ */
+static void test_bloom(void) {
+    bloom *b = NULL;
+    bloom *other = NULL;
+    size_t positives = 0;
+    int key = 0;
+
+    b = bloom_new(_int_, 1000, 0.01);
+    other = bloom_new(_int_, 1000, 0.01);
+
+    for (key = 0; key < 1000; key++) {
+        bloom_insert(key % 2 ? b : other, &key);
+    }
+
+    for (key = 0; key < 1000; key++) {
+        CHECK(bloom_contains(key % 2 ? b : other, &key));
+    }
+
+    bloom_merge(b, other);
+
+    for (key = 0; key < 1000; key++) {
+        CHECK(bloom_contains(b, &key));
+    }
+
+    /* 0.01 requested -- allow 3x, over 10000 absent keys */
+    for (key = 1000; key < 11000; key++) {
+        positives += bloom_contains(b, &key) ? 1 : 0;
+    }
+    CHECK(positives < 300);
+
+    bloom_clear(b);
+
+    for (key = 0, positives = 0; key < 1000; key++) {
+        positives += bloom_contains(b, &key) ? 1 : 0;
+    }
+    CHECK(positives == 0);
+
+    bloom_delete(&other);
+    bloom_delete(&b);
+    CHECK(b == NULL);
+}
+
+/**
+ *  @brief  Checks that cmsketch never underestimates,
+ *          and stays within epsilon * total for most keys
+ */
+static void test_cmsketch(void) {
+    unsigned long counts[TEST_KEYS];
+    unsigned long total = 0;
+    unsigned long estimate = 0;
+    size_t over = 0;
+    cmsketch *s = NULL;
+    int step = 0;
+    int key = 0;
+
+    memset(counts, 0, sizeof counts);
+
+    s = cmsketch_new(_int_, 0.01, 0.01);
+
+    for (step = 0; step < TEST_STEPS; step++) {
+        key = test_rand(TEST_KEYS / 2);
+        cmsketch_add(s, &key, 1 + (unsigned long)(key % 4));
+        counts[key] += 1 + (unsigned long)(key % 4);
+        total += 1 + (unsigned long)(key % 4);
+    }
+
+    /* remove some of what was added */
+    for (key = 0; key < TEST_KEYS / 2; key += 5) {
+        cmsketch_remove(s, &key, counts[key] / 2);
+        total -= counts[key] / 2;
+        counts[key] -= counts[key] / 2;
+    }
+
+    CHECK(cmsketch_total(s) == total);
+
+    for (key = 0; key < TEST_KEYS; key++) {
+        estimate = cmsketch_estimate(s, &key);
+        CHECK(estimate >= counts[key]);
+        CHECK(!cmsketch_contains(s, &key) == !estimate);
+        over += estimate - counts[key] > total / 100;
+    }
+
+    /* the bound holds with probability 1 - delta, per key */
+    CHECK(over <= TEST_KEYS / 20);
+
+    cmsketch_clear(s);
+    CHECK(cmsketch_total(s) == 0);
+
+    key = 1;
+    CHECK(cmsketch_estimate(s, &key) == 0);
+
+    cmsketch_delete(&s);
+    CHECK(s == NULL);
+}
+
+/**
+ *  @brief  Checks vector across the inline buffer boundary
+ *          (small-buffer optimization)
+ *
+ *  vector.c allocates from mymalloc's 4 KB heap, so sizes stay small.
+ */
+static void test_vector(void) {
+    vector *v = NULL;
+    size_t capacity = 0;
+    int i = 0;
+
+    v = v_new(_int_);
+    capacity = v_capacity(v);
+    CHECK(capacity > 0);
+
+    /* fill the inline buffer, then spill past it */
+    for (i = 0; i < 40; i++) {
+        v_pushb(v, &i);
+        CHECK(v_size(v) == (size_t)(i) + 1);
+    }
+
+    CHECK(v_capacity(v) > capacity);
+
+    for (i = 0; i < 40; i++) {
+        CHECK(*(int *)(v_at(v, i)) == i);
+    }
+
+    /* shrink back into the inline buffer */
+    v_resize(v, 4);
+    v_shrink_to_fit(v);
+    CHECK(v_size(v) == 4);
+
+    for (i = 0; i < 4; i++) {
+        CHECK(*(int *)(v_at(v, i)) == i);
+    }
+
+    v_delete(&v);
+    CHECK(v == NULL);
+}
+
+/**
+ *  @brief  Checks vector's move/emplace functions
+ */
+static void test_vector_move(void) {
+    int array[40];
+    vector *v = NULL;
+    vector *moved = NULL;
+    int i = 0;
+
+    v = v_new(_int_);
+
+    for (i = 0; i < 4; i++) {
+        v_pushb(v, &i);
+    }
+
+    /* v_newmove: moved takes v's elements, v is left empty and usable */
+    moved = v_newmove(&v);
+    CHECK(v_size(moved) == 4 && v_size(v) == 0);
+
+    for (i = 0; i < 4; i++) {
+        CHECK(*(int *)(v_at(moved, i)) == i);
+    }
+
+    i = 7;
+    v_pushbmove(v, &i);
+    CHECK(i == 0 && v_size(v) == 1 && *(int *)(v_front(v)) == 7);
+
+    *(int *)(v_emplaceb(v)) = 8;
+    CHECK(v_size(v) == 2 && *(int *)(v_back(v)) == 8);
+
+    /* v_assignmove: replace v's contents with array's, zeroing array */
+    for (i = 0; i < 40; i++) {
+        array[i] = 100 + i;
+    }
+
+    v_assignmove(v, array, 40);
+    CHECK(v_size(v) == 40 && array[0] == 0 && array[39] == 0);
+
+    for (i = 0; i < 40; i++) {
+        CHECK(*(int *)(v_at(v, i)) == 100 + i);
+    }
+
+    v_delete(&moved);
+    v_delete(&v);
+    CHECK(v == NULL);
+}
+
+/**
+ *  @brief  Checks that v_search_parallel agrees with v_search,
+ *          including for an absent key
+ */
+static void test_vector_search(void) {
+    vector *v = NULL;
+    int i = 0;
+
+    v = v_new(_int_);
+
+    for (i = 100; i < 140; i++) {
+        v_pushb(v, &i);
+    }
+
+    for (i = 98; i < 142; i++) {
+        CHECK(v_search(v, &i) == v_search_parallel(v, &i, 2));
+        CHECK(v_search(v, &i) == (i >= 100 && i < 140 ? i - 100 : -1));
+    }
+
+    v_delete(&v);
+    CHECK(v == NULL);
+}
+
+/**
+ *  @brief  Checks a type-specialized vector: NAME_back on an empty
+ *          vector, and NAME_sort against a histogram of its input
+ */
+static void test_vector_typed(void) {
+    char *words[] = { "pear", "apple", "kiwi", "fig" };
+    int counts[64];
+    vector_int *v = NULL;
+    vector_str *s = NULL;
+    size_t i = 0;
+    int val = 0;
+
+    memset(counts, 0, sizeof counts);
+
+    v = vector_int_new();
+    CHECK(vector_int_back(v) == NULL);
+
+    /* an empty vector sorts, as does a single element */
+    vector_int_sort(v);
+    CHECK(vector_int_size(v) == 0);
+
+    val = 3;
+    vector_int_pushb(v, &val);
+    vector_int_sort(v);
+    CHECK(*vector_int_back(v) == 3);
+    vector_int_popb(v);
+
+    /* enough elements for several insertion sorted runs and merges */
+    for (i = 0; i < TEST_KEYS + 7; i++) {
+        val = test_rand(64);
+        vector_int_pushb(v, &val);
+        ++counts[val];
+    }
+
+    vector_int_sort(v);
+    CHECK(vector_int_size(v) == TEST_KEYS + 7);
+
+    for (i = 0; i < vector_int_size(v); i++) {
+        CHECK(i == 0 || *vector_int_at(v, i - 1) <= *vector_int_at(v, i));
+        --counts[*vector_int_at(v, i)];
+    }
+
+    for (val = 0; val < 64; val++) {
+        CHECK(counts[val] == 0);
+    }
+
+    vector_int_delete(&v);
+    CHECK(v == NULL);
+
+    /* vector_str compares with strcmp */
+    s = vector_str_new();
+
+    for (i = 0; i < sizeof words / sizeof *words; i++) {
+        vector_str_pushb(s, &words[i]);
+    }
+
+    vector_str_sort(s);
+    CHECK(strcmp(*vector_str_at(s, 0), "apple") == 0);
+    CHECK(strcmp(*vector_str_at(s, 1), "fig") == 0);
+    CHECK(strcmp(*vector_str_at(s, 2), "kiwi") == 0);
+    CHECK(strcmp(*vector_str_back(s), "pear") == 0);
+
+    vector_str_delete(&s);
+}
+
+/**
+ *  @brief  Round-trips a vector through v_save/v_load, and views
+ *          a headerless file with v_mmap_open
+ */
+static void test_vector_file(void) {
+    char path[] = "/tmp/gcslib_test_XXXXXX";
+    int records[64];
+    vector *v = NULL;
+    vector *loaded = NULL;
+    FILE *file = NULL;
+    int fd = -1;
+    int i = 0;
+
+    fd = mkstemp(path);
+    CHECK(fd != -1);
+
+    if (fd == -1) {
+        return;
+    }
+
+    close(fd);
+
+    v = v_new(_int_);
+
+    for (i = 0; i < 64; i++) {
+        int val = i * i;
+        v_pushb(v, &val);
+    }
+
+    CHECK(v_save(v, path) == 0);
+
+    loaded = v_load(path, _int_);
+    CHECK(loaded != NULL);
+
+    if (loaded) {
+        CHECK(v_size(loaded) == v_size(v));
+
+        for (i = 0; i < 64; i++) {
+            CHECK(*(int *)(v_at(loaded, i)) == i * i);
+        }
+
+        v_delete(&loaded);
+    }
+
+    /* a file saved with ints cannot be loaded as doubles */
+    loaded = v_load(path, _double_);
+    CHECK(loaded == NULL);
+
+    /* an empty vector round-trips too */
+    v_clear(v);
+    CHECK(v_save(v, path) == 0);
+
+    loaded = v_load(path, _int_);
+    CHECK(loaded != NULL && v_size(loaded) == 0);
+
+    if (loaded) {
+        v_delete(&loaded);
+    }
+
+    /* v_mmap_open: a headerless file of records */
+    for (i = 0; i < 64; i++) {
+        records[i] = 64 - i;
+    }
+
+    file = fopen(path, "wb");
+    CHECK(file != NULL);
+
+    if (file) {
+        CHECK(fwrite(records, sizeof *records, 64, file) == 64);
+        fclose(file);
+
+        loaded = v_mmap_open(path, _int_);
+        CHECK(loaded != NULL && v_size(loaded) == 64);
+
+        for (i = 0; loaded && i < 64; i++) {
+            CHECK(*(int *)(v_at(loaded, i)) == 64 - i);
+        }
+
+        if (loaded) {
+            v_delete(&loaded);
+        }
+    }
+
+    v_delete(&v);
+    unlink(path);
+}
+
+/**
+ *  @brief  Exercises mymalloc with a growing array of small blocks
+ *
+ *  The blocks are never freed -- afterward, the heap is full.
+ */
+static void test_mymalloc(void) {
     char **temp = malloc(sizeof *temp * 16);
     int size = 0;
     int cap = 16;
@@ -87,7 +1015,4 @@ int main(int argc, const char *argv[]) {
     }
 
     listlog();
-
-    
-    return EXIT_SUCCESS;
 }
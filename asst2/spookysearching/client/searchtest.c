@@ -36,6 +36,40 @@
 
 #include "header.h"
 #include "multitest.h"
+#include "workpool.h"
+
+/**
+ *  Where the key is placed before each search in a -bench sample
+ */
+enum test_keys {
+    TEST_KEYS_FIRST,    /**< index 0 */
+    TEST_KEYS_MIDDLE,   /**< index capacity / 2 */
+    TEST_KEYS_LAST,     /**< index capacity - 1 */
+    TEST_KEYS_UNIFORM,  /**< a uniformly random index, per search */
+    TEST_KEYS_ABSENT,   /**< nowhere -- every element is scanned */
+    TEST_KEYS_COUNT
+};
+
+/**
+ *  Parameters of a -bench sweep -- every combination of
+ *  backend, key placement, array size and partition size is one record
+ */
+struct test_bench {
+    bool backends[2];           /**< [0]: control, [1]: the linked backend */
+    bool keys[TEST_KEYS_COUNT];
+
+    int32_t *sizes;
+    size_t sizes_length;
+
+    int32_t *partitions;        /**< 0 is "auto" -- lsearch_int32_partition */
+    size_t partitions_length;
+
+    int32_t repetitions;
+    int32_t warmup;
+
+    bool json;
+    const char *path;
+};
 
 /**
  *  @brief Creates an array of size capacity, with search partitions of size subcapacity, and conducts a search for a integer, key -- and runs the search iterations times using test_case
@@ -68,6 +102,87 @@ void test_case(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
                int32_t key,
                int32_t iterations);
 
+/**
+ *  @brief Returns the line test_case prints before each run of searchfunc -- the search functions print nothing, so that they can be timed without their output
+ *
+ *  @param[in]  searchfunc  linear search function
+ *
+ *  @return     "Single process linear search" for lsearch_int32_control, else the name of the backend's search
+ */
+const char *test_label(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t));
+
+/**
+ *  @brief Creates an array of size capacity, then compares a linear search of it against lookups in each kind of lsindex_t -- and reports after how many searches building the index pays off
+ *
+ *  @param[in]  capacity    desired array capacity
+ *  @param[in]  iterations  quantity of searches/lookups timed per method
+ */
+void test_index(size_t capacity, int32_t iterations);
+
+/**
+ *  @brief Returns a shuffled permutation of [0, capacity), allocated with lsearch_int32_alloc (release with lsearch_int32_free)
+ *
+ *  @param[in]  capacity    desired array capacity
+ *
+ *  @return     base address of the array
+ */
+int32_t *test_array(size_t capacity);
+
+/**
+ *  @brief Runs a benchmark sweep configured by argv, writing one record per combination of parameters (with mean, stddev, median, p95 and a 95% confidence interval of its samples) as CSV or JSON
+ *
+ *  @param[in]  argc    argument count, not including "-bench"
+ *  @param[in]  argv    arguments following "-bench"
+ *
+ *  @return     exit status
+ */
+int test_bench(int argc, const char *argv[]);
+
+/**
+ *  @brief Runs searchfunc repetitions times after warmup untimed runs, moving the key before each run, and records the time of each timed run
+ *
+ *  @param[in]  searchfunc  linear search function
+ *  @param[in]  base        array generated by test_array
+ *  @param[in]  capacity    element count of base
+ *  @param[in]  subcapacity partition size for search
+ *  @param[in]  keys        where to place the key
+ *  @param[in]  repetitions quantity of timed runs
+ *  @param[in]  warmup      quantity of untimed runs
+ *  @param[out] samples     repetitions elapsed times, in nanoseconds
+ *
+ *  @return     quantity of runs that returned the wrong index
+ */
+int32_t test_bench_case(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
+                        int32_t *base,
+                        size_t capacity,
+                        int32_t subcapacity,
+                        enum test_keys keys,
+                        int32_t repetitions,
+                        int32_t warmup,
+                        double *samples);
+
+/**
+ *  @brief Parses a comma-separated list of positive integers (or "auto", parsed as 0) into a list allocated with malloc
+ *
+ *  @param[in]  arg     the list, e.g. "500,5000,auto"
+ *  @param[out] list    address of the parsed list
+ *
+ *  @return     element count of list, 0 if arg is invalid
+ */
+size_t test_list(const char *arg, int32_t **list);
+
+/**
+ *  @brief Parses a comma-separated list of names, setting selected[i] for each that is names[i]
+ *
+ *  @param[in]  arg         the list, e.g. "first,last"
+ *  @param[in]  names       valid names
+ *  @param[in]  count       element count of names and selected
+ *  @param[out] selected    flags, one per name
+ *
+ *  @return     0 on success, -1 if arg names something else
+ */
+int test_names(const char *arg, const char **names, size_t count, bool *selected);
+
 /**
  *  @brief  Program execution begins here
  *
@@ -79,6 +194,15 @@ void test_case(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
 int main(int argc, const char *argv[]) {
     srand(time(NULL));
 
+    if (argc > 1) {
+        if (strcmp(argv[1], "-bench") == 0) {
+            return test_bench(argc - 2, argv + 2);
+        }
+
+        fprintf(stderr, "USAGE: %s [-bench [options]]\n(run '%s -bench -help' for options)\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+
     printf("\n(array size / partition size / proc-thread count)\n\n");
 
     /* control - single process */
@@ -157,6 +281,39 @@ int main(int argc, const char *argv[]) {
     printf("Test P3_4\n");
     test_set(lsearch_int32, 25000, 250, 99, 100);
 
+    /* partition size chosen from the machine's cores and caches */
+    printf("Test A0_0\n");
+    test_set(lsearch_int32, 500, lsearch_int32_partition(500), 99, 100);
+
+    printf("Test A0_1\n");
+    test_set(lsearch_int32, 5000, lsearch_int32_partition(5000), 99, 100);
+
+    printf("Test A0_2\n");
+    test_set(lsearch_int32, 10000, lsearch_int32_partition(10000), 99, 100);
+
+    printf("Test A0_3\n");
+    test_set(lsearch_int32, 20000, lsearch_int32_partition(20000), 99, 100);
+
+    printf("Test A0_4\n");
+    test_set(lsearch_int32, 25000, lsearch_int32_partition(25000), 99, 100);
+
+    printf("Test I0_0\n");
+    test_index(500, 100);
+
+    printf("Test I0_1\n");
+    test_index(5000, 100);
+
+    printf("Test I0_2\n");
+    test_index(10000, 100);
+
+    printf("Test I0_3\n");
+    test_index(20000, 100);
+
+    printf("Test I0_4\n");
+    test_index(25000, 100);
+
+    lsearch_int32_shutdown();
+
     return EXIT_SUCCESS;
 }
 
@@ -167,6 +324,30 @@ void test_set(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
               int32_t iterations) {
     int32_t *base = NULL;
 
+    base = test_array(capacity);
+
+    printf("- test parameters -\narray capacity: %lu\narray partition size: %d\narray search key: %d\niteration count: %d\n\n", capacity, subcapacity, key, iterations);
+    test_case(searchfunc, base, capacity, subcapacity, key, iterations);
+    printf("- end of test -\n\n");
+
+    lsearch_int32_free(base);
+    base = NULL;
+    
+}
+
+const char *test_label(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t)) {
+    if (searchfunc == lsearch_int32_control) {
+        return "Single process linear search";
+    }
+
+    return strcmp(lsearch_int32_backend(), "proc") == 0 ?
+            "Multiprocess linear search (-proc)" :
+            "Multithreaded linear search (-thread)";
+}
+
+int32_t *test_array(size_t capacity) {
+    int32_t *base = NULL;
+
     int32_t r0 = 0;
     int32_t r1 = 0;
     int32_t temp = 0;
@@ -176,8 +357,8 @@ void test_set(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
     srand(time(NULL));
 
     {
-        base = calloc(capacity, sizeof *base);
-        assert(base);
+        /* first touched where it will be searched -- release with lsearch_int32_free */
+        base = lsearch_int32_alloc(capacity);
     }
 
     {
@@ -202,13 +383,90 @@ void test_set(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
         }
     }    
 
-    printf("- test parameters -\narray capacity: %lu\narray partition size: %d\narray search key: %d\niteration count: %d\n\n", capacity, subcapacity, key, iterations);
-    test_case(searchfunc, base, capacity, subcapacity, key, iterations);
+    return base;
+}
+
+void test_index(size_t capacity, int32_t iterations) {
+    const enum lsindex_kind kinds[2] = { LSINDEX_SORTED, LSINDEX_HASH };
+    const char *names[2] = { "sorted", "hash" };
+
+    int32_t *base = NULL;
+    int32_t *keys = NULL;
+
+    struct timespec x = { 0, 0 };
+    struct timespec y = { 0, 0 };
+
+    double scan_ns = 0.0;
+    volatile int32_t sink = 0;
+
+    int32_t i = 0;
+    int32_t k = 0;
+
+    base = test_array(capacity);
+
+    keys = calloc(iterations, sizeof *keys);
+    assert(keys);
+
+    for (i = 0; i < iterations; i++) {
+        keys[i] = randrnge(0, capacity);
+    }
+
+    printf("- test parameters -\narray capacity: %lu\niteration count: %d\n\n", capacity, iterations);
+
+    /* the fastest scan available, so the crossover is not flattered */
+    clock_gettime(CLOCK_MONOTONIC, &x);
+
+    for (i = 0; i < iterations; i++) {
+        sink = lsearch_int32_kernel(base, 0, capacity, keys[i]);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &y);
+    scan_ns = elapsed_time_ns(x, y) / iterations;
+
+    printf("linear scan (%s): %f %s per search\n", lsearch_int32_kernel_name(), convert_ns_to_mcs(scan_ns), MCS);
+
+    for (k = 0; k < 2; k++) {
+        lsindex_t *index = NULL;
+
+        double build_ns = 0.0;
+        double lookup_ns = 0.0;
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        index = lsindex_new(base, capacity, kinds[k]);
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        build_ns = elapsed_time_ns(x, y);
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+
+        for (i = 0; i < iterations; i++) {
+            sink = lsindex_find(index, keys[i]);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &y);
+        lookup_ns = elapsed_time_ns(x, y) / iterations;
+
+        printf("%s index: build %f %s, lookup %f %s -- ", names[k],
+               convert_ns_to_mcs(build_ns), MCS, convert_ns_to_mcs(lookup_ns), MCS);
+
+        /* building pays off once (searches * time saved per search) exceeds the build time */
+        if (lookup_ns < scan_ns) {
+            printf("pays off after %.0f searches\n", ceil(build_ns / (scan_ns - lookup_ns)));
+        } else {
+            printf("never pays off\n");
+        }
+
+        lsindex_delete(&index);
+    }
+
     printf("- end of test -\n\n");
 
-    free(base);
+    (void)(sink);
+
+    free(keys);
+    keys = NULL;
+
+    lsearch_int32_free(base);
     base = NULL;
-    
 }
 
 void test_case(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
@@ -259,6 +517,8 @@ void test_case(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
             } while (result == r0);
         }
 
+        printf("%s\n", test_label(searchfunc));
+
         clock_gettime(CLOCK_REALTIME, &x);
         result = searchfunc(base, capacity, subcapacity, key);
         clock_gettime(CLOCK_REALTIME, &y);
@@ -300,3 +560,364 @@ void test_case(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
     free(results);
     results = NULL;
 }
+
+int test_bench(int argc, const char *argv[]) {
+    const char *backend_names[2] = { "control", "parallel" };
+    const char *key_names[TEST_KEYS_COUNT] = { "first", "middle", "last", "uniform", "absent" };
+
+    int32_t (*searchfuncs[2])(int32_t *, size_t, int32_t, int32_t) = { lsearch_int32_control, lsearch_int32 };
+
+    struct test_bench bench;
+
+    char path[256];
+    FILE *dest = NULL;
+
+    double *samples = NULL;
+    size_t records = 0;
+
+    int status = EXIT_SUCCESS;
+    int32_t i = 0;
+    size_t b = 0;
+    size_t k = 0;
+    size_t c = 0;
+    size_t p = 0;
+
+    {
+        memset(&bench, 0, sizeof bench);
+
+        bench.backends[1] = true;
+        bench.keys[TEST_KEYS_UNIFORM] = true;
+
+        bench.sizes_length = test_list("500,5000,10000,20000,25000", &bench.sizes);
+        bench.partitions_length = test_list("25,50,125,250,auto", &bench.partitions);
+
+        bench.repetitions = 100;
+        bench.warmup = 10;
+    }
+
+    for (i = 0; i < argc && status == EXIT_SUCCESS; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        int32_t *list = NULL;
+
+        if (strcmp(argv[i], "-help") == 0) {
+            status = EXIT_FAILURE;
+        } else if (value == NULL) {
+            fprintf(stderr, "%s requires a value\n", argv[i]);
+            status = EXIT_FAILURE;
+        } else if (strcmp(argv[i], "-backend") == 0) {
+            memset(bench.backends, 0, sizeof bench.backends);
+            status = test_names(value, backend_names, 2, bench.backends) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else if (strcmp(argv[i], "-keys") == 0) {
+            memset(bench.keys, 0, sizeof bench.keys);
+            status = test_names(value, key_names, TEST_KEYS_COUNT, bench.keys) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else if (strcmp(argv[i], "-sizes") == 0) {
+            free(bench.sizes);
+            bench.sizes_length = test_list(value, &bench.sizes);
+
+            for (c = 0; c < bench.sizes_length; c++) {
+                status = bench.sizes[c] > 1 ? status : EXIT_FAILURE;
+            }
+
+            status = bench.sizes_length > 0 ? status : EXIT_FAILURE;
+        } else if (strcmp(argv[i], "-partitions") == 0) {
+            free(bench.partitions);
+            bench.partitions_length = test_list(value, &bench.partitions);
+            status = bench.partitions_length > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else if (strcmp(argv[i], "-reps") == 0) {
+            status = test_list(value, &list) == 1 && list[0] > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+            bench.repetitions = list ? list[0] : 0;
+        } else if (strcmp(argv[i], "-warmup") == 0) {
+            status = strcmp(value, "0") == 0 || (test_list(value, &list) == 1 && list[0] > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+            bench.warmup = list ? list[0] : 0;
+        } else if (strcmp(argv[i], "-format") == 0) {
+            bench.json = strcmp(value, "json") == 0;
+            status = bench.json || strcmp(value, "csv") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else if (strcmp(argv[i], "-o") == 0) {
+            bench.path = value;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            status = EXIT_FAILURE;
+        }
+
+        if (status != EXIT_SUCCESS && value != NULL && strcmp(argv[i], "-help") != 0) {
+            fprintf(stderr, "invalid value for %s: %s\n", argv[i], value);
+        }
+
+        free(list);
+        list = NULL;
+
+        i++;
+    }
+
+    if (status != EXIT_SUCCESS) {
+        const char *usage[] = {
+            "USAGE: searchtest -bench [options]",
+            "  -backend    control,parallel                    (default: parallel)",
+            "  -keys       first,middle,last,uniform,absent    (default: uniform)",
+            "  -sizes      n[,n...]                            (default: 500,5000,10000,20000,25000)",
+            "  -partitions n|auto[,n|auto...]                  (default: 25,50,125,250,auto)",
+            "  -reps       n   timed searches per record       (default: 100)",
+            "  -warmup     n   untimed searches per record     (default: 10)",
+            "  -format     csv|json                            (default: csv)",
+            "  -o          path                                (default: dat/bench_<backend>.<format>)",
+            "parallel is the backend linked in (make proc or make thread);",
+            "control ignores -partitions. json records include every sample."
+        };
+
+        for (i = 0; i < (int32_t)(sizeof usage / sizeof *usage); i++) {
+            fprintf(stderr, "%s\n", usage[i]);
+        }
+
+        free(bench.sizes);
+        free(bench.partitions);
+
+        return EXIT_FAILURE;
+    }
+
+    if (bench.path == NULL) {
+        sprintf(path, "dat/bench_%s.%s", lsearch_int32_backend(), bench.json ? "json" : "csv");
+        bench.path = path;
+    }
+
+    dest = fopen(bench.path, "w");
+
+    if (dest == NULL) {
+        perror(bench.path);
+
+        free(bench.sizes);
+        free(bench.partitions);
+
+        return EXIT_FAILURE;
+    }
+
+    samples = calloc(bench.repetitions, sizeof *samples);
+    assert(samples);
+
+    if (bench.json) {
+        fprintf(dest, "[");
+    } else {
+        fprintf(dest, "backend,kernel,cores,capacity,subcapacity,keys,repetitions,warmup,failures,"
+                      "mean_ns,stddev_ns,min_ns,median_ns,p95_ns,max_ns,ci95_low_ns,ci95_high_ns\n");
+    }
+
+    for (b = 0; b < 2; b++) {
+        for (k = 0; k < TEST_KEYS_COUNT; k++) {
+            if (bench.backends[b] == false || bench.keys[k] == false) {
+                continue;
+            }
+
+            for (c = 0; c < bench.sizes_length; c++) {
+                const int32_t capacity = bench.sizes[c];
+                int32_t *base = test_array(capacity);
+
+                /* the control search has no partitions -- one record per size */
+                for (p = 0; p < (b == 0 ? 1 : bench.partitions_length); p++) {
+                    const char *backend = b == 0 ? "control" : lsearch_int32_backend();
+
+                    int32_t subcapacity = b == 0 ? capacity : bench.partitions[p];
+                    int32_t failures = 0;
+
+                    double avg = 0.0;
+                    double stddev = 0.0;
+                    double ci = 0.0;
+
+                    subcapacity = subcapacity > 0 ? subcapacity : lsearch_int32_partition(capacity);
+                    subcapacity = subcapacity < capacity ? subcapacity : capacity;
+
+                    failures = test_bench_case(searchfuncs[b], base, capacity, subcapacity, k,
+                                               bench.repetitions, bench.warmup, samples);
+
+                    avg = mean(samples, bench.repetitions);
+                    stddev = bench.repetitions > 1 ? standard_deviation(samples, bench.repetitions) : 0.0;
+                    ci = confidence_interval(samples, bench.repetitions);
+
+                    if (bench.json) {
+                        fprintf(dest, "%s\n  {\"backend\": \"%s\", \"kernel\": \"%s\", \"cores\": %lu, "
+                                      "\"capacity\": %d, \"subcapacity\": %d, \"keys\": \"%s\", "
+                                      "\"repetitions\": %d, \"warmup\": %d, \"failures\": %d,\n"
+                                      "   \"mean_ns\": %.1f, \"stddev_ns\": %.1f, \"min_ns\": %.1f, "
+                                      "\"median_ns\": %.1f, \"p95_ns\": %.1f, \"max_ns\": %.1f, "
+                                      "\"ci95_ns\": [%.1f, %.1f],\n   \"samples_ns\": [",
+                                records > 0 ? "," : "", backend, lsearch_int32_kernel_name(),
+                                (unsigned long)(workpool_cores()), capacity, subcapacity, key_names[k],
+                                bench.repetitions, bench.warmup, failures,
+                                avg, stddev, percentile(samples, bench.repetitions, 0.0),
+                                median(samples, bench.repetitions), percentile(samples, bench.repetitions, 95.0),
+                                percentile(samples, bench.repetitions, 100.0), avg - ci, avg + ci);
+
+                        for (i = 0; i < bench.repetitions; i++) {
+                            fprintf(dest, "%s%.0f", i > 0 ? ", " : "", samples[i]);
+                        }
+
+                        fprintf(dest, "]}");
+                    } else {
+                        fprintf(dest, "%s,%s,%lu,%d,%d,%s,%d,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                                backend, lsearch_int32_kernel_name(),
+                                (unsigned long)(workpool_cores()), capacity, subcapacity, key_names[k],
+                                bench.repetitions, bench.warmup, failures,
+                                avg, stddev, percentile(samples, bench.repetitions, 0.0),
+                                median(samples, bench.repetitions), percentile(samples, bench.repetitions, 95.0),
+                                percentile(samples, bench.repetitions, 100.0), avg - ci, avg + ci);
+                    }
+
+                    fflush(dest);
+                    records++;
+
+                    printf("%s %s: %d / %d: %f %s (+/- %f %s)%s\n", backend, key_names[k], capacity, subcapacity,
+                           convert_ns_to_mcs(avg), MCS, convert_ns_to_mcs(ci), MCS,
+                           failures > 0 ? " -- wrong index returned" : "");
+
+                    status = failures > 0 ? EXIT_FAILURE : status;
+                }
+
+                lsearch_int32_free(base);
+                base = NULL;
+            }
+        }
+    }
+
+    if (bench.json) {
+        fprintf(dest, "\n]\n");
+    }
+
+    fclose(dest);
+    dest = NULL;
+
+    printf("%lu records written to %s\n", (unsigned long)(records), bench.path);
+
+    free(samples);
+    samples = NULL;
+
+    free(bench.sizes);
+    free(bench.partitions);
+
+    lsearch_int32_shutdown();
+
+    return status;
+}
+
+int32_t test_bench_case(int32_t (*searchfunc)(int32_t *, size_t, int32_t, int32_t),
+                        int32_t *base,
+                        size_t capacity,
+                        int32_t subcapacity,
+                        enum test_keys keys,
+                        int32_t repetitions,
+                        int32_t warmup,
+                        double *samples) {
+    struct timespec x = { 0, 0 };
+    struct timespec y = { 0, 0 };
+
+    /* base is a permutation of [0, capacity) -- 0 is the key, capacity is absent */
+    int32_t key = keys == TEST_KEYS_ABSENT ? capacity : 0;
+    int32_t position = lsearch_int32_kernel(base, 0, capacity, 0);
+    int32_t expected = -1;
+    int32_t result = -1;
+    int32_t failures = 0;
+
+    int32_t i = 0;
+
+    for (i = -warmup; i < repetitions; i++) {
+        int32_t target = position;
+        int32_t temp = 0;
+
+        switch (keys) {
+        case TEST_KEYS_FIRST:
+            target = 0;
+            break;
+        case TEST_KEYS_MIDDLE:
+            target = capacity / 2;
+            break;
+        case TEST_KEYS_LAST:
+            target = capacity - 1;
+            break;
+        case TEST_KEYS_UNIFORM:
+            target = randrnge(0, capacity);
+            break;
+        default:
+            break;
+        }
+
+        temp = base[target];
+        base[target] = base[position];
+        base[position] = temp;
+
+        position = target;
+        expected = keys == TEST_KEYS_ABSENT ? -1 : position;
+
+        clock_gettime(CLOCK_MONOTONIC, &x);
+        result = searchfunc(base, capacity, subcapacity, key);
+        clock_gettime(CLOCK_MONOTONIC, &y);
+
+        if (i >= 0) {
+            samples[i] = elapsed_time_ns(x, y);
+        }
+
+        failures += result != expected;
+    }
+
+    return failures;
+}
+
+size_t test_list(const char *arg, int32_t **list) {
+    size_t length = 1;
+    size_t i = 0;
+
+    const char *token = arg;
+
+    for (i = 0; arg[i] != '\0'; i++) {
+        length += arg[i] == ',';
+    }
+
+    *list = calloc(length, sizeof **list);
+    assert(*list);
+
+    for (i = 0; i < length; i++) {
+        char *end = NULL;
+        long value = 0;
+
+        if (strncmp(token, "auto", 4) == 0 && (token[4] == ',' || token[4] == '\0')) {
+            end = (char *)(token) + 4;
+        } else {
+            value = strtol(token, &end, 10);
+        }
+
+        if (end == token || (*end != ',' && *end != '\0') || value < 0 || value > 0x7FFFFFFFL
+            || (value == 0 && end != token + 4)) {
+            free(*list);
+            *list = NULL;
+
+            return 0;
+        }
+
+        (*list)[i] = (int32_t)(value);
+        token = end + 1;
+    }
+
+    return length;
+}
+
+int test_names(const char *arg, const char **names, size_t count, bool *selected) {
+    const char *token = arg;
+
+    while (true) {
+        size_t length = strcspn(token, ",");
+        size_t i = 0;
+
+        for (i = 0; i < count; i++) {
+            if (strlen(names[i]) == length && strncmp(token, names[i], length) == 0) {
+                selected[i] = true;
+                break;
+            }
+        }
+
+        if (i == count) {
+            return -1;
+        }
+
+        if (token[length] == '\0') {
+            return 0;
+        }
+
+        token += length + 1;
+    }
+}
@@ -110,5 +110,8 @@ ptrdiff_t ptr_distance(const void *beg, const void *end, size_t width);
 
 double mean(double *results, size_t count);
 double standard_deviation(double *results, size_t count);
+double percentile(double *results, size_t count, double p);
+double median(double *results, size_t count);
+double confidence_interval(double *results, size_t count);
 
 #endif /* HEADER_H */
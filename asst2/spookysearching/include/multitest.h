@@ -41,6 +41,14 @@
 
 #define lsearch_int32 __linear_search_int32__
 #define lsearch_int32_control __linear_search_int32__CONTROL__
+#define lsearch_int32_shutdown __linear_search_int32__SHUTDOWN__
+#define lsearch_int32_backend __linear_search_int32__BACKEND__
+#define lsearch_int32_kernel __linear_search_int32__KERNEL__
+#define lsearch_int32_kernel_name __linear_search_int32__KERNEL_NAME__
+#define lsearch_int32_many __linear_search_int32__MANY__
+#define lsearch_int32_partition __linear_search_int32__PARTITION__
+#define lsearch_int32_alloc __linear_search_int32__ALLOC__
+#define lsearch_int32_free __linear_search_int32__FREE__
 
 #define ARR_SEARCH_VALUE 99
 #define ARR_RANGE_START (256)
@@ -51,6 +59,8 @@
 typedef struct linear_search_object lsobject_t;
 typedef struct linear_search_vector lsvector_t;
 typedef struct linear_search_params lsparams_t;
+typedef struct linear_search_keyset lskeyset_t;
+typedef struct linear_search_index lsindex_t;
 
 struct linear_search_object {
     struct linear_search_vector {
@@ -70,8 +80,109 @@ struct linear_search_object {
     int32_t key;
 };
 
+/**
+ *  Open-addressed hash set of search keys, for searching many keys in one
+ *  pass -- each element is hashed once, rather than compared once per key.
+ *  found[slot] holds the lowest index at which keys[slot] was seen (or -1),
+ *  and is lowered with compare-and-swap, so partitions may be scanned
+ *  concurrently (by threads, or by processes if storage is MAP_SHARED).
+ */
+struct linear_search_keyset {
+    int32_t *keys;
+    int32_t *found;
+    uint8_t *used;
+    uint32_t bits;  /**< table length is (1 << bits) */
+};
+
+/**
+ *  Index over an int32_t array, for an array that is searched many times --
+ *  built once in O(n log n) (LSINDEX_SORTED) or O(n) (LSINDEX_HASH),
+ *  after which lookups are O(log n) or O(1) rather than a scan.
+ *  Either kind finds the first occurrence of a key, as a scan would.
+ *  The index is a copy -- it does not see later changes to the array.
+ */
+enum lsindex_kind {
+    LSINDEX_SORTED, /**< (key, index) pairs sorted by key, then index; binary search */
+    LSINDEX_HASH    /**< open-addressed (key, index) table, first occurrence only */
+};
+
+struct linear_search_index {
+    struct linear_search_entry {
+        int32_t key;
+        int32_t index;
+    } *entries;
+
+    uint8_t *used;          /**< LSINDEX_HASH only: occupied slots */
+    size_t length;          /**< entry count, or table length for LSINDEX_HASH */
+    uint32_t bits;          /**< LSINDEX_HASH only: length is (1 << bits) */
+    enum lsindex_kind kind;
+};
+
 int __linear_search_int32__(int32_t *base, size_t capacity, int32_t subcapacity, int32_t key);
 
 int __linear_search_int32__CONTROL__(int32_t *base, size_t capacity, int32_t subcapacity, int32_t key);
 
+/**
+ *  Both backends keep their workers (threads or processes) between calls --
+ *  the first search starts them, and __linear_search_int32__SHUTDOWN__
+ *  stops them (a later search starts them again). Called at exit if need be.
+ */
+void __linear_search_int32__SHUTDOWN__(void);
+
+/**< name of the backend linked in: "proc" or "thread" */
+const char *__linear_search_int32__BACKEND__(void);
+
+/**
+ *  Scans base[first, last) for key, returning the index of its first
+ *  occurrence or -1 -- every backend scans its partitions with it.
+ *  The widest kernel the CPU supports (AVX2, SSE2, or scalar)
+ *  is chosen at runtime, on first use.
+ */
+int32_t __linear_search_int32__KERNEL__(const int32_t *base, int32_t first, int32_t last, int32_t key);
+const char *__linear_search_int32__KERNEL_NAME__(void);
+
+/**
+ *  Searches base[0, capacity) for each of keys[0, nkeys) in a single pass --
+ *  out_idx[k] receives the index of the first occurrence of keys[k], or -1.
+ *  Partitions of the pass are spread across the backend's workers.
+ */
+void __linear_search_int32__MANY__(int32_t *base, size_t capacity, const int32_t *keys, size_t nkeys, int32_t *out_idx);
+
+/**
+ *  Returns a partition size (subcapacity) for an array of capacity elements,
+ *  from the core count and cache sizes in sysfs -- about four partitions
+ *  per core (so idle workers have something to steal), each at least
+ *  the L1 data cache and at most half the L2, in whole cache lines.
+ *  Small arrays get a single partition, searched by the caller alone.
+ */
+int32_t __linear_search_int32__PARTITION__(size_t capacity);
+
+/**
+ *  Allocates a zeroed array of capacity elements for searching --
+ *  with the -thread backend, each page is first touched by the pinned
+ *  worker that will search it, so it is placed on that worker's NUMA node.
+ *  With the -proc backend, the array is a shared mapping the pool's
+ *  processes search in place (and first touch themselves); any other
+ *  array is copied into the pool's own mapping on every search, at O(capacity).
+ *  Only one -proc array is shared at a time -- until it is released,
+ *  further calls fall back to calloc. Release with __linear_search_int32__FREE__.
+ */
+int32_t *__linear_search_int32__ALLOC__(size_t capacity);
+void __linear_search_int32__FREE__(int32_t *base);
+
+/**< lskeyset: table length for nkeys, and bytes of storage that length needs */
+uint32_t lskeyset_bits(size_t nkeys);
+size_t lskeyset_bytes(uint32_t bits);
+
+/**< lskeyset: construct within storage, insert/find keys, scan a partition */
+void lskeyset_init(lskeyset_t *set, void *storage, uint32_t bits);
+void lskeyset_insert(lskeyset_t *set, int32_t key);
+int32_t lskeyset_find(const lskeyset_t *set, int32_t key);
+void lskeyset_scan(const lskeyset_t *set, const int32_t *base, int32_t first, int32_t last);
+
+/**< lsindex: build/release an index over base[0, capacity), and look up a key */
+lsindex_t *lsindex_new(const int32_t *base, size_t capacity, enum lsindex_kind kind);
+void lsindex_delete(lsindex_t **index);
+int32_t lsindex_find(const lsindex_t *index, int32_t key);
+
 #endif /* MULTITEST_H */
@@ -0,0 +1,159 @@
+/**
+ *  @file       workpool.h
+ *  @brief      Header file for a persistent worker pool (Asst2: Spooky Search)
+ *
+ *  @author     Gemuele Aludino
+ *  @date       22 Nov 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <pthread.h>
+
+#include "header.h"
+
+/**
+ *  A workpool is a fixed set of worker threads, created once and reused --
+ *  workpool_run hands the pool count tasks, numbered [0, count),
+ *  and returns once every task has run (task(arg, i) for each i).
+ *
+ *  Tasks are dealt out in contiguous blocks, one block per worker.
+ *  Each worker runs its own block from the back (owner end),
+ *  and once it runs dry, steals tasks from the front of the other
+ *  workers' blocks (work-stealing deque), so an uneven block
+ *  does not leave the remaining workers idle.
+ *  The calling thread steals as well, rather than sleeping.
+ *
+ *  A task may end its run early with workpool_cancel (e.g. once a search
+ *  has its answer) -- tasks not yet started are dropped, tasks already
+ *  running finish, and workpool_run returns as soon as they have.
+ *
+ *  One run at a time -- workpool_run is not reentrant,
+ *  and may not be called from within a task.
+ *
+ *  With WORKPOOL_PIN, worker i runs only on CPU workpool_cpu(i) --
+ *  the i-th CPU (modulo their count) that the process may run on.
+ *  Since blocks are dealt in order, worker i starts on the same block
+ *  of a same-sized run every time -- memory first touched by
+ *  workpool_first_touch then tends to be local to the worker
+ *  (and NUMA node) that will search it.
+ */
+
+typedef struct workpool workpool_t;
+
+enum workpool_flags {
+    WORKPOOL_DEFAULT = 0,
+    WORKPOOL_PIN = 1        /**< pin each worker to one CPU */
+};
+
+typedef void (*workpool_task_fn)(void *arg, size_t task);
+
+/**
+ *  @brief  Creates a pool of nthreads worker threads
+ *
+ *  @param[in]  nthreads    worker count, 0 for the number of online cores
+ *  @param[in]  flags       WORKPOOL_DEFAULT, or WORKPOOL_PIN
+ *
+ *  @return     pointer to workpool
+ */
+workpool_t *workpool_new(size_t nthreads, int flags);
+
+/**
+ *  @brief  Joins pool's workers and releases pool
+ *
+ *  @param[out] pool    address of a pointer to workpool
+ */
+void workpool_delete(workpool_t **pool);
+
+/**
+ *  @brief  Runs task(arg, i) for every i in [0, count), across pool's workers
+ *
+ *  @param[in]  pool    pointer to workpool
+ *  @param[in]  count   number of tasks
+ *  @param[in]  task    task function
+ *  @param[in]  arg     argument passed to every call of task
+ */
+void workpool_run(workpool_t *pool, size_t count, workpool_task_fn task, void *arg);
+
+/**
+ *  @brief  Drops the tasks of the current run that have not yet started
+ *
+ *  @param[in]  pool    pointer to workpool
+ *
+ *  Meant to be called from within a task; a no-op between runs.
+ */
+void workpool_cancel(workpool_t *pool);
+
+/**
+ *  @brief  Returns the number of worker threads in pool
+ *
+ *  @param[in]  pool    pointer to workpool
+ *
+ *  @return     worker count
+ */
+size_t workpool_size(workpool_t *pool);
+
+/**
+ *  @brief  Zeroes [base, base + length), one contiguous slice per worker,
+ *          so that each page is first touched by the worker that owns it
+ *
+ *  @param[in]  pool    pointer to workpool
+ *  @param[out] base    base address of memory not yet touched
+ *  @param[in]  length  length of the memory, in bytes
+ */
+void workpool_first_touch(workpool_t *pool, void *base, size_t length);
+
+/**
+ *  @brief  Returns the number of online cores (at least 1)
+ */
+size_t workpool_cores(void);
+
+/**
+ *  @brief  Returns the i-th CPU (modulo their count) in the calling
+ *          thread's affinity mask, for pinning worker i
+ *
+ *  @param[in]  i   worker index
+ *
+ *  @return     CPU index (i % workpool_cores() where the mask is unavailable)
+ */
+long workpool_cpu(size_t i);
+
+/**
+ *  @brief  Returns the size in bytes of CPU 0's level-level data
+ *          (or unified) cache, read from sysfs
+ *
+ *  @param[in]  level   1, 2, or 3
+ *
+ *  @return     cache size, or a typical size if sysfs is unavailable
+ */
+size_t workpool_cache_size(int level);
+
+/**
+ *  @brief  Returns the cache line size in bytes, read from sysfs (64 if unavailable)
+ */
+size_t workpool_cache_line(void);
+
+#endif /* WORKPOOL_H */
@@ -28,36 +28,122 @@
  *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+/**
+ *  MAP_ANONYMOUS is not declared under -std=c89 alone,
+ *  and sched_setaffinity/cpu_set_t are GNU extensions
+ */
+#define _GNU_SOURCE
+
 #include "multitest.h"
+#include "workpool.h"
 
 #include <signal.h>
+#include <sys/mman.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/**
+ *  Smallest array (in elements) the process pool's shared copy is sized for
+ */
+#define LSEARCH_POOL_MIN_CAPACITY 4096
+
+/**
+ *  Fewest keys the process pool's shared key set is sized for
+ */
+#define LSEARCH_POOL_MIN_KEYS 256
+
+/**
+ *  Elements a pool process scans between polls of the shared found word
+ */
+#define LSEARCH_POLL_LENGTH 256
+
+/**
+ *  Sent to a pool process over the task pipe --
+ *  search partitions [partition_first, partition_last) of the shared array,
+ *  for key (LSEARCH_TASK_ONE, outcome to results[slot])
+ *  or for every key in the shared key set (LSEARCH_TASK_MANY)
+ */
+enum lsearch_task_mode {
+    LSEARCH_TASK_ONE,
+    LSEARCH_TASK_MANY
+};
+
+struct lsearch_task {
+    int32_t mode;
+    int32_t shared;         /**< nonzero: search lsearch_array, not the pool's copy */
+    int32_t slot;
+    int32_t partition_first;
+    int32_t partition_last;
+    int32_t capacity;
+    int32_t subcapacity;
+    int32_t key;
+};
+
+/**
+ *  Pre-forked process pool, shared by every call to __linear_search_int32__.
+ *  Processes only share what existed when they were forked, so an array
+ *  not allocated by __linear_search_int32__ALLOC__ is copied into
+ *  a MAP_SHARED mapping (base) made beforehand -- an O(capacity) copy
+ *  on every search. If such an array does not fit, the pool is restarted
+ *  with a larger mapping.
+ */
+static struct lsearch_pool {
+    pid_t *pids;
+    size_t length;          /**< process count */
+
+    int tasks;              /**< write end of the task pipe */
+    int done;               /**< read end of the done pipe, one byte per task */
+
+    void *mapping;
+    size_t mapping_length;
+
+    volatile int32_t *found; /**< index claimed by the first hit, or -1 -- within mapping */
+    lsparams_t *results;    /**< one per process, within mapping */
+    int32_t *base;          /**< shared copy of the array, within mapping */
+    size_t capacity;        /**< element capacity of base */
+
+    lskeyset_t keyset;      /**< storage within mapping, emptied per call */
+} lsearch_pool = { NULL, 0, -1, -1, NULL, 0, NULL, NULL, NULL, 0, { NULL, NULL, NULL, 0 } };
+
+/**
+ *  Array handed out by __linear_search_int32__ALLOC__ -- a MAP_SHARED
+ *  mapping of its own, made before the pool's processes are (re)forked,
+ *  so they search it in place. One at a time -- while it is in use,
+ *  further arrays come from calloc, and are copied per search.
+ */
+static struct lsearch_array {
+    int32_t *base;
+    size_t capacity;        /**< element count of base */
+    size_t length;          /**< length of the mapping, in bytes */
+    bool touched;           /**< first touched by the pool's processes */
+} lsearch_array = { NULL, 0, 0, false };
 
 static void *handler_lsearch(void *arg);
 
+static void lsearch_pool_start(size_t capacity, size_t nkeys);
+static bool lsearch_pool_reserve(int32_t *base, size_t capacity, size_t nkeys);
+static void lsearch_pool_send(struct lsearch_task *task);
+static void lsearch_pool_wait(size_t task_count);
+static void lsearch_pool_worker(size_t id, int tasks, int done);
+static void lsearch_pool_atexit(void);
+
 int __linear_search_int32__(int32_t *base, size_t capacity, int32_t subcapacity, int32_t key) {
     lsobject_t *lso = NULL;
 
     int32_t i = 0;
-    int32_t j = 0;
-
-    int32_t status = -1;
-
-    pid_t c_pid = -1;
 
     int32_t index = -1;
     int32_t range_start = 0;
     int32_t range_end = 0;
     int32_t partition = -1;
-    int32_t position = -1;
 
-    struct {
-        pid_t (*base)[2];
-        size_t length;
-    } v_pid = { NULL, 0 };
+    size_t partition_count = 0;
+    size_t partitions_per_task = 0;
+    size_t task_count = 0;
 
-    size_t process_count = 0;
-
-    printf("Multiprocess linear search (-proc)\n");
+    bool shared = false;
 
     {
         lso = malloc(sizeof *lso);
@@ -76,166 +162,204 @@ int __linear_search_int32__(int32_t *base, size_t capacity, int32_t subcapacity,
         lso->search.value = index;
     }
 
-    process_count = lso->vec.capacity % lso->vec.subcapacity == 0 ?
-                        (lso->vec.capacity / lso->vec.subcapacity) + 1 :
-                        (lso->vec.capacity / lso->vec.subcapacity) + 2;
+    shared = lsearch_pool_reserve(base, capacity, 0);
+
+    partition_count = lso->vec.capacity % lso->vec.subcapacity == 0 ?
+                        lso->vec.capacity / lso->vec.subcapacity :
+                        (lso->vec.capacity / lso->vec.subcapacity) + 1;
+
+    /**
+     *  One task per pool process -- each searches a contiguous run
+     *  of partitions, rather than one task per partition.
+     */
+    task_count = lsearch_pool.length < partition_count ? lsearch_pool.length : partition_count;
+    task_count = task_count > 0 ? task_count : 1; /* an empty array still gets its -1 */
+
+    partitions_per_task = partition_count % task_count == 0 ?
+                            partition_count / task_count :
+                            (partition_count / task_count) + 1;
+
+    for (i = 0; i < task_count; i++) {
+        struct lsearch_task task;
+
+        task.mode = LSEARCH_TASK_ONE;
+        task.shared = shared;
+        task.slot = i;
+        task.partition_first = i * partitions_per_task;
+        task.partition_last = (i + 1) * partitions_per_task;
+        task.partition_last = task.partition_last < partition_count ? task.partition_last : partition_count;
+        task.capacity = lso->vec.capacity;
+        task.subcapacity = lso->vec.subcapacity;
+        task.key = lso->key;
+
+        lsearch_pool.results[i].value = -1;
+
+        if (i == 0) {
+            /* before any task is sent -- a process that sees -1 keeps scanning */
+            (*lsearch_pool.found) = -1;
+        }
 
-    {
-        pid_t(*base)[2] = NULL;
+        lsearch_pool_send(&task);
+    }
 
-        base = calloc(process_count, sizeof *base);
-        assert(base);
+    /**
+     *  Every task reports, even one that stopped early on another's hit --
+     *  a byte left in the done pipe would be taken for the next search's.
+     */
+    lsearch_pool_wait(task_count);
 
-        v_pid.base = base;
+    for (i = 0; i < task_count; i++) {
+        if (lsearch_pool.results[i].value > -1) {
+            lso->search = lsearch_pool.results[i];
+            index = lso->search.value;
+        }
     }
 
-    v_pid.base[v_pid.length][j++] = getpid();
-    v_pid.base[v_pid.length++][j] = partition;
+    /*
+    printf("position: %d\nindex: %d\npartition number: %d\n\n",
+           lso->search.position,
+           lso->search.value,
+           lso->search.partition);
+    */
 
-    j = 0;
+    free(lso);
+    lso = NULL;
 
-    for (i = 0; i < lso->vec.capacity; i += lso->vec.subcapacity) {
-        range_start = i;
-        range_end = i + lso->vec.subcapacity;
+    return index;
+}
 
-        ++partition;
+void __linear_search_int32__MANY__(int32_t *base, size_t capacity, const int32_t *keys, size_t nkeys, int32_t *out_idx) {
+    size_t i = 0;
+    size_t task_count = 0;
+    size_t task_length = 0;
 
-        c_pid = fork();
+    bool shared = false;
 
-        if (c_pid == 0) {
-            lsobject_t *lso_process = NULL;
+    if (nkeys == 0) {
+        return;
+    }
 
-            {
-                lso_process = malloc(sizeof *lso_process);
-                assert(lso_process);
+    shared = lsearch_pool_reserve(base, capacity, nkeys);
 
-                lso_process->vec.base = lso->vec.base;
-                lso_process->vec.capacity = lso->vec.capacity;
-                lso_process->vec.subcapacity = lso->vec.subcapacity;
+    lskeyset_init(&lsearch_pool.keyset, lsearch_pool.keyset.keys, lsearch_pool.keyset.bits);
 
-                lso_process->search.value = -1;
-                lso_process->search.range_start = range_start;
-                lso_process->search.range_end = range_end;
-                lso_process->search.partition = partition;
-                lso_process->search.position = -1;
+    for (i = 0; i < nkeys; i++) {
+        lskeyset_insert(&lsearch_pool.keyset, keys[i]);
+    }
 
-                lso_process->key =  lso->key;
-            }
+    /* one task (of one partition) per pool process */
+    task_count = lsearch_pool.length < capacity ? lsearch_pool.length : capacity;
+    task_count = task_count > 0 ? task_count : 1;
 
-            handler_lsearch(&lso_process);
+    task_length = capacity % task_count == 0 ?
+                    capacity / task_count :
+                    (capacity / task_count) + 1;
 
-            position = lso_process->search.position;
+    for (i = 0; i < task_count; i++) {
+        struct lsearch_task task;
 
-            {
-                v_pid.length = 0;
+        task.mode = LSEARCH_TASK_MANY;
+        task.shared = shared;
+        task.slot = i;
+        task.partition_first = i;
+        task.partition_last = i + 1;
+        task.capacity = capacity;
+        task.subcapacity = task_length;
+        task.key = 0;
 
-                free(v_pid.base);
-                v_pid.base = NULL;
-            }
+        lsearch_pool_send(&task);
+    }
 
-            {
-                {
-                    lso_process->search.partition = 0;
-                    lso_process->search.position = -1;
-                    lso_process->search.range_end = 0;
-                    lso_process->search.range_start = 0;
-                    lso_process->search.value = -1;
-                }
+    lsearch_pool_wait(task_count);
 
-                lso_process->key = 0;
+    for (i = 0; i < nkeys; i++) {
+        out_idx[i] = lskeyset_find(&lsearch_pool.keyset, keys[i]);
+    }
+}
 
-                free(lso_process);
-                lso_process = NULL;
-            }
+int32_t *__linear_search_int32__ALLOC__(size_t capacity) {
+    int32_t *base = NULL;
+    size_t length = 0;
 
-            {
-                {
-                    lso->search.partition = 0;
-                    lso->search.position = -1;
-                    lso->search.range_end = 0;
-                    lso->search.range_start = 0;
-                    lso->search.value = -1;
-                }
+    if (lsearch_array.base != NULL) {
+        base = calloc(capacity > 0 ? capacity : 1, sizeof *base);
+        assert(base);
 
-                lso->key = 0;
+        return base;
+    }
 
-                {
-                    lso->vec.subcapacity = 0;
-                    lso->vec.capacity = 0;
-                }
+    length = (capacity > 0 ? capacity : 1) * sizeof *base;
 
-                free(lso);
-                lso = NULL;
-            }
+    base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert(base != MAP_FAILED);
 
-            exit(position);
-        } else if (c_pid > 0) {
-            v_pid.base[v_pid.length][j++] = c_pid;
-            v_pid.base[v_pid.length++][j] = partition;
+    lsearch_array.base = base;
+    lsearch_array.capacity = capacity;
+    lsearch_array.length = length;
+    lsearch_array.touched = false;
 
-            j = 0;
+    /* processes only share mappings made before they were forked -- refork them now */
+    __linear_search_int32__SHUTDOWN__();
+    lsearch_pool_start(0, 0);
 
-            if (lso->search.value > -1) {
-                break;
-            }
-        } else {
-            perror("fork\n");
-            _exit(EXIT_FAILURE);
-        }
+    return base;
+}
+
+void __linear_search_int32__FREE__(int32_t *base) {
+    if (base == NULL || base != lsearch_array.base) {
+        free(base);
+        return;
     }
 
-    i = 0;
+    /* processes forked since keep their view of it until they exit */
+    munmap(lsearch_array.base, lsearch_array.length);
 
-    for (i = 1; i < v_pid.length; i++) {
-        waitpid(v_pid.base[i][0], &status, 0);
+    lsearch_array.base = NULL;
+    lsearch_array.capacity = 0;
+    lsearch_array.length = 0;
+    lsearch_array.touched = false;
+}
 
-        position = WEXITSTATUS(status);
+const char *__linear_search_int32__BACKEND__(void) {
+    return "proc";
+}
 
-        if (position == lso->vec.subcapacity) {
+void __linear_search_int32__SHUTDOWN__(void) {
+    size_t i = 0;
 
-        } else {
-            int32_t offset = -1;
+    if (lsearch_pool.pids == NULL) {
+        return;
+    }
 
-            partition = v_pid.base[i][1];
-            offset = partition * lso->vec.subcapacity;
-            index = offset + position;
+    /* end-of-file on the task pipe tells each process to exit */
+    close(lsearch_pool.tasks);
+    close(lsearch_pool.done);
 
-            lso->search.position = position;
-            lso->search.partition = partition;
-            lso->search.value = index;
-        }
+    for (i = 0; i < lsearch_pool.length; i++) {
+        waitpid(lsearch_pool.pids[i], NULL, 0);
     }
 
-    /*
-    printf("position: %d\nindex: %d\npartition number: %d\n\n",
-           lso->search.position,
-           lso->search.value,
-           lso->search.partition);
-    */
-
-    /*
-    {
-        for (i = 0; i < v_pid.length; i++) {
-            for (j = 0; j < 2; j++) {
-                printf("v_pid.base[%d][%d]: %d\n", i, j, v_pid.base[i][j]);
-            }
+    free(lsearch_pool.pids);
+    munmap(lsearch_pool.mapping, lsearch_pool.mapping_length);
 
-            printf("\n");
-        }
-    }
-    */
+    lsearch_pool.pids = NULL;
+    lsearch_pool.length = 0;
 
-    {
-        free(v_pid.base);
-        v_pid.base = NULL;
+    lsearch_pool.tasks = -1;
+    lsearch_pool.done = -1;
 
-        v_pid.length = 0;
-    }
+    lsearch_pool.mapping = NULL;
+    lsearch_pool.mapping_length = 0;
 
-    free(lso);
-    lso = NULL;
+    lsearch_pool.found = NULL;
+    lsearch_pool.results = NULL;
+    lsearch_pool.base = NULL;
+    lsearch_pool.capacity = 0;
 
-    return index;
+    lsearch_pool.keyset.keys = NULL;
+    lsearch_pool.keyset.found = NULL;
+    lsearch_pool.keyset.used = NULL;
+    lsearch_pool.keyset.bits = 0;
 }
 
 /* vanilla lsobject_search, for one process only */
@@ -300,8 +424,6 @@ int __linear_search_int32__CONTROL__(int32_t *base, size_t capacity, int32_t sub
         lso->search.value = index;
     }
 
-    printf("Single process linear search\n");
-
     handler_lsearch(&lso);
     index = lso->search.value;
 
@@ -321,47 +443,328 @@ int __linear_search_int32__CONTROL__(int32_t *base, size_t capacity, int32_t sub
 static void *handler_lsearch(void *arg) {
     lsobject_t *lso = *(lsobject_t **)(arg);
 
-    int32_t j = 0;
-    int32_t position = 0;
+    int32_t j = -1;
 
     /*
     printf("\n\nBeginning search for partition %d...\n",
     lso->search.partition);
     */
 
-    for (j = lso->search.range_start; j < lso->search.range_end; j++) {
+    j = lsearch_int32_kernel(lso->vec.base, lso->search.range_start, lso->search.range_end, lso->key);
+
+    if (j > -1) {
+        lso->search.value = j;
+
         /*
-        printf("vec[%d]: %d\n", j, lso->vec.base[j]);
+        printf("handler: found key %d at index "
+               "%d, partition %d\n\n",
+               lso->key,
+               lso->search.value,
+               lso->search.partition);
         */
+    }
 
-        if (lso->vec.base[j] == lso->key) {
-            lso->search.value = j;
+    lso->search.position = lso->search.value != -1 ? j - lso->search.range_start : lso->vec.subcapacity;
 
-            /*
-            printf("handler: found key %d at index "
-                   "%d, partition %d\n\n",
-                   lso->key,
-                   lso->search.value,
-                   lso->search.partition);
-            */
+    /*
+    printf("\nSearch ended for partition %d.\nwas %s\n\n",
+    lso->search.partition, lso->search.value != -1 ? "SUCCESSFUL" :
+    "unsuccessful");
+    */
 
-            /*
-            raise(SIGUSR1);
-            */
+    return arg;
+}
 
+/**
+ *  @brief  Maps shared memory for an array of at least capacity elements
+ *          (and a key set for at least nkeys keys),
+ *          and forks one pool process per core
+ *
+ *  @param[in]  capacity    element count of the array to be searched
+ *  @param[in]  nkeys       key count for __linear_search_int32__MANY__
+ */
+static void lsearch_pool_start(size_t capacity, size_t nkeys) {
+    static bool registered = false;
+
+    int tasks[2] = { -1, -1 };
+    int done[2] = { -1, -1 };
+
+    size_t results_length = 0;
+    size_t base_length = 0;
+    uint32_t bits = 0;
+    size_t i = 0;
+
+    pid_t c_pid = -1;
+
+    lsearch_pool.capacity = LSEARCH_POOL_MIN_CAPACITY;
+
+    while (lsearch_pool.capacity < capacity) {
+        lsearch_pool.capacity *= 2;
+    }
+
+    lsearch_pool.length = workpool_cores();
+
+    bits = lskeyset_bits(nkeys > LSEARCH_POOL_MIN_KEYS ? nkeys : LSEARCH_POOL_MIN_KEYS);
+
+    /* found (a line of its own), results, base, then the key set -- each aligned to a cache line */
+    results_length = 64 + (lsearch_pool.length * sizeof *lsearch_pool.results);
+    results_length = (results_length + 63) & ~((size_t)(63));
+
+    base_length = lsearch_pool.capacity * sizeof *lsearch_pool.base;
+
+    lsearch_pool.mapping_length = results_length + base_length + lskeyset_bytes(bits);
+    lsearch_pool.mapping = mmap(NULL, lsearch_pool.mapping_length,
+                                PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert(lsearch_pool.mapping != MAP_FAILED);
+
+    lsearch_pool.found = (volatile int32_t *)(lsearch_pool.mapping);
+    lsearch_pool.results = (lsparams_t *)((char *)(lsearch_pool.mapping) + 64);
+    lsearch_pool.base = (int32_t *)((char *)(lsearch_pool.mapping) + results_length);
+
+    lskeyset_init(&lsearch_pool.keyset, (char *)(lsearch_pool.base) + base_length, bits);
+
+    lsearch_pool.pids = calloc(lsearch_pool.length, sizeof *lsearch_pool.pids);
+    assert(lsearch_pool.pids);
+
+    if (pipe(tasks) == -1 || pipe(done) == -1) {
+        perror("pipe\n");
+        _exit(EXIT_FAILURE);
+    }
+
+    /* output buffered before a fork would otherwise be written once per process */
+    fflush(stdout);
+
+    for (i = 0; i < lsearch_pool.length; i++) {
+        c_pid = fork();
+
+        if (c_pid == 0) {
+            close(tasks[1]);
+            close(done[0]);
+
+            lsearch_pool_worker(i, tasks[0], done[1]);
+        } else if (c_pid > 0) {
+            lsearch_pool.pids[i] = c_pid;
+        } else {
+            perror("fork\n");
+            _exit(EXIT_FAILURE);
+        }
+    }
+
+    close(tasks[0]);
+    close(done[1]);
+
+    lsearch_pool.tasks = tasks[1];
+    lsearch_pool.done = done[0];
+
+    /* one done byte per process, once its slice is touched -- before base is copied */
+    lsearch_pool_wait(lsearch_pool.length);
+
+    /* from now on, lsearch_array holds the caller's data -- never touch it again */
+    lsearch_array.touched = lsearch_array.base != NULL;
+
+    if (registered == false) {
+        atexit(lsearch_pool_atexit);
+        registered = true;
+    }
+}
+
+/**
+ *  @brief  Pool process routine -- runs tasks from the task pipe
+ *          until it is closed, then exits
+ *
+ *  @param[in]  id      index of this process within the pool
+ *  @param[in]  tasks   read end of the task pipe
+ *  @param[in]  done    write end of the done pipe
+ *
+ *  Process id is pinned to CPU workpool_cpu(id), and first touches slice id
+ *  of the shared array (and of lsearch_array, if newly allocated)
+ *  -- the slice a search of a full-capacity array deals it --
+ *  so those pages are placed on its NUMA node.
+ */
+static void lsearch_pool_worker(size_t id, int tasks, int done) {
+    lsobject_t lso;
+
+    struct lsearch_task task;
+    int32_t p = 0;
+
+    size_t slice = 0;
+    size_t first = 0;
+
+#if defined(__linux__)
+    {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(workpool_cpu(id), &set);
+
+        /* best effort -- a failure leaves the process unpinned */
+        sched_setaffinity(0, sizeof set, &set);
+    }
+#endif
+
+    slice = (lsearch_pool.capacity / lsearch_pool.length) + 1;
+    first = id * slice;
+
+    if (first < lsearch_pool.capacity) {
+        slice = first + slice < lsearch_pool.capacity ? slice : lsearch_pool.capacity - first;
+        memset(lsearch_pool.base + first, 0, slice * sizeof *lsearch_pool.base);
+    }
+
+    if (lsearch_array.base != NULL && lsearch_array.touched == false) {
+        slice = (lsearch_array.capacity / lsearch_pool.length) + 1;
+        first = id * slice;
+
+        if (first < lsearch_array.capacity) {
+            slice = first + slice < lsearch_array.capacity ? slice : lsearch_array.capacity - first;
+            memset(lsearch_array.base + first, 0, slice * sizeof *lsearch_array.base);
+        }
+    }
+
+    if (write(done, "", 1) != 1) {
+        _exit(EXIT_FAILURE);
+    }
+
+    /**
+     *  Every task is written whole, and read whole --
+     *  a short read only happens once the pipe is closed.
+     */
+    while (read(tasks, &task, sizeof task) == sizeof task) {
+        int32_t *base = task.shared ? lsearch_array.base : lsearch_pool.base;
+
+        if (task.mode == LSEARCH_TASK_MANY) {
+            for (p = task.partition_first; p < task.partition_last; p++) {
+                int32_t range_start = p * task.subcapacity;
+                int32_t range_end = range_start + task.subcapacity;
+
+                range_end = range_end < task.capacity ? range_end : task.capacity;
+                lskeyset_scan(&lsearch_pool.keyset, base, range_start, range_end);
+            }
+
+            if (write(done, "", 1) != 1) {
+                break;
+            }
+
+            continue;
+        }
+
+        lso.vec.base = base;
+        lso.vec.capacity = task.capacity;
+        lso.vec.subcapacity = task.subcapacity;
+
+        lso.key = task.key;
+        lso.search.value = -1;
+
+        /**
+         *  As with the -thread backend, the shared found word is polled
+         *  every LSEARCH_POLL_LENGTH elements -- once any process
+         *  claims a hit, the others stop and report their tasks done.
+         */
+        for (p = task.partition_first; p < task.partition_last && (*lsearch_pool.found) == -1; p++) {
+            int32_t j = 0;
+            int32_t poll = 0;
+
+            lso.search.range_start = p * task.subcapacity;
+            lso.search.range_end = lso.search.range_start + task.subcapacity;
+            lso.search.range_end = lso.search.range_end < task.capacity ? lso.search.range_end : task.capacity;
+            lso.search.partition = p;
+            lso.search.position = -1;
+
+            for (j = lso.search.range_start; j < lso.search.range_end && (*lsearch_pool.found) == -1; j = poll) {
+                int32_t index = -1;
+
+                poll = j + LSEARCH_POLL_LENGTH < lso.search.range_end ? j + LSEARCH_POLL_LENGTH : lso.search.range_end;
+                index = lsearch_int32_kernel(base, j, poll, task.key);
+
+                if (index > -1) {
+                    if (__sync_bool_compare_and_swap(lsearch_pool.found, -1, index)) {
+                        lso.search.value = index;
+                        lso.search.position = index - lso.search.range_start;
+                        lsearch_pool.results[task.slot] = lso.search;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        if (write(done, "", 1) != 1) {
             break;
         }
+    }
+
+    /**
+     *  _exit, not exit -- the parent's stdio buffers and
+     *  atexit handlers belong to the parent alone.
+     */
+    _exit(EXIT_SUCCESS);
+}
+
+/**
+ *  @brief  Starts (or restarts) the pool if it cannot yet hold capacity
+ *          elements and nkeys keys, then copies base into its shared memory
+ *          (unless base is lsearch_array, which the processes already share)
+ *
+ *  @param[in]  base        base address of the array to be searched
+ *  @param[in]  capacity    element count of base
+ *  @param[in]  nkeys       key count, 0 if not a __linear_search_int32__MANY__ call
+ *
+ *  @return     true if the processes are to search lsearch_array in place
+ */
+static bool lsearch_pool_reserve(int32_t *base, size_t capacity, size_t nkeys) {
+    const bool shared = base == lsearch_array.base && capacity <= lsearch_array.capacity;
+
+    if (lsearch_pool.pids == NULL
+        || (shared == false && capacity > lsearch_pool.capacity)
+        || lskeyset_bits(nkeys) > lsearch_pool.keyset.bits) {
+        __linear_search_int32__SHUTDOWN__();
+        lsearch_pool_start(shared ? 0 : capacity, nkeys);
+    }
 
-        ++position;
+    if (shared == false && base != lsearch_pool.base) {
+        memcpy(lsearch_pool.base, base, capacity * sizeof *base);
     }
 
-    lso->search.position = lso->search.value != -1 ? position : lso->vec.subcapacity;
+    return shared;
+}
 
-    /*
-    printf("\nSearch ended for partition %d.\nwas %s\n\n",
-    lso->search.partition, lso->search.value != -1 ? "SUCCESSFUL" :
-    "unsuccessful");
-    */
+/**
+ *  @brief  Writes task to the task pipe, for the next idle pool process
+ *
+ *  @param[in]  task    pointer to the task to send
+ */
+static void lsearch_pool_send(struct lsearch_task *task) {
+    /* writes of at most PIPE_BUF bytes are atomic -- tasks never interleave */
+    if (write(lsearch_pool.tasks, task, sizeof *task) != sizeof *task) {
+        perror("write\n");
+        _exit(EXIT_FAILURE);
+    }
+}
 
-    return arg;
+/**
+ *  @brief  Blocks until task_count tasks have reported done
+ *
+ *  @param[in]  task_count  number of tasks sent
+ */
+static void lsearch_pool_wait(size_t task_count) {
+    size_t received = 0;
+
+    while (received < task_count) {
+        char buffer[64];
+        ssize_t length = read(lsearch_pool.done, buffer,
+                              task_count - received < sizeof buffer ? task_count - received : sizeof buffer);
+
+        if (length <= 0) {
+            perror("read\n");
+            _exit(EXIT_FAILURE);
+        }
+
+        received += length;
+    }
+}
+
+/**
+ *  @brief  Shuts the pool down at exit, if the client has not
+ */
+static void lsearch_pool_atexit(void) {
+    __linear_search_int32__SHUTDOWN__();
 }
@@ -29,31 +29,52 @@
  */
 
 #include "multitest.h"
+#include "workpool.h"
 
 #include <unistd.h>
 
-static void *handler_lsearch(void *arg);
+/**
+ *  Elements scanned (by lsearch_int32_kernel) between polls of the
+ *  shared found index -- 16 64-byte cache lines of int32_t
+ */
+#define LSEARCH_POLL_LENGTH 256
+
+/**
+ *  Elements per task for __linear_search_int32__MANY__ (64 KiB of int32_t)
+ */
+#define LSEARCH_MANY_PARTITION_LENGTH 16384
+
+/**
+ *  Argument shared by the tasks of one __linear_search_int32__MANY__ call
+ */
+struct lsearch_many {
+    const int32_t *base;
+    int32_t capacity;
+    lskeyset_t set;
+};
+
+static void task_lsearch(void *arg, size_t partition);
+static void task_lsearch_many(void *arg, size_t partition);
+
+static workpool_t *lsearch_pool_get(void);
+static void lsearch_pool_atexit(void);
+
+/**
+ *  Worker pool shared by every call to __linear_search_int32__ --
+ *  created on first use, sized to the core count, and joined
+ *  by __linear_search_int32__SHUTDOWN__ (or at exit).
+ */
+static workpool_t *lsearch_pool = NULL;
 
 int __linear_search_int32__(int32_t *base, size_t capacity, int32_t subcapacity, int32_t key) {
     lsobject_t *lso = NULL;
-    lsobject_t **retval = NULL;
-    lsobject_t **v_lso = NULL;
-
-    int32_t i = 0;
 
     int32_t index = -1;
     int32_t range_start = 0;
-    int32_t range_end = 0;
+    int32_t range_end = capacity;
     int32_t partition = -1;
 
-    struct {
-        pthread_t *base;
-        size_t length;
-    } v_tid = { NULL, 0 };
-
-    size_t thread_count = 0;
-
-    printf("Multithreaded linear search (-thread)\n");
+    size_t partition_count = 0;
 
     {
         lso = malloc(sizeof *lso);
@@ -72,107 +93,93 @@ int __linear_search_int32__(int32_t *base, size_t capacity, int32_t subcapacity,
         lso->search.value = index;
     }
 
-    thread_count = lso->vec.capacity % lso->vec.subcapacity == 0 ?
+    partition_count = lso->vec.capacity % lso->vec.subcapacity == 0 ?
                        lso->vec.capacity / lso->vec.subcapacity :
                        (lso->vec.capacity / lso->vec.subcapacity) + 1;
 
-    {
-        pthread_t *base = NULL;
-
-        base = calloc(thread_count, sizeof *base);
-        assert(base);
-
-        v_tid.base = base;
-    }
+    /**
+     *  Each partition is one task for the pool -- all tasks share lso,
+     *  and the one that finds key records it in lso->search,
+     *  then cancels the tasks that have yet to start.
+     */
+    workpool_run(lsearch_pool_get(), partition_count, task_lsearch, lso);
 
-    {
-        v_lso = calloc(thread_count, sizeof *v_lso);
-        assert(v_lso);
-    }
+    index = lso->search.value;
 
-    for (i = 0; i < lso->vec.capacity; i += lso->vec.subcapacity) {
-        pthread_attr_t attr;
+    /*
+    printf("position: %d\nindex: %d\npartition number: %d\n\n",
+           lso->search.position,
+           lso->search.value,
+           lso->search.partition);
+    */
 
-        range_start = i;
-        range_end = i + lso->vec.subcapacity;
+    free(lso);
+    lso = NULL;
+ 
+    return index;
+}
 
-        ++partition;
+void __linear_search_int32__MANY__(int32_t *base, size_t capacity, const int32_t *keys, size_t nkeys, int32_t *out_idx) {
+    struct lsearch_many many;
+    void *storage = NULL;
 
-        {
-            lsobject_t *lso_thread = NULL;
+    uint32_t bits = 0;
+    size_t partition_count = 0;
+    size_t i = 0;
 
-            lso_thread = malloc(sizeof *lso_thread);
-            assert(lso_thread);
+    if (nkeys == 0) {
+        return;
+    }
 
-            lso_thread->vec = lso->vec;
+    bits = lskeyset_bits(nkeys);
 
-            lso_thread->search.value = -1;
-            lso_thread->search.range_start = range_start;
-            lso_thread->search.range_end = range_end;
-            lso_thread->search.partition = partition;
-            lso_thread->search.position = -1;
+    storage = malloc(lskeyset_bytes(bits));
+    assert(storage);
 
-            lso_thread->key = lso->key;
+    many.base = base;
+    many.capacity = capacity;
+    lskeyset_init(&many.set, storage, bits);
 
-            v_lso[v_tid.length] = lso_thread;
-        }
+    for (i = 0; i < nkeys; i++) {
+        lskeyset_insert(&many.set, keys[i]);
+    }
 
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-        pthread_create(v_tid.base + v_tid.length, NULL, handler_lsearch, v_lso + v_tid.length);
+    partition_count = capacity % LSEARCH_MANY_PARTITION_LENGTH == 0 ?
+                        capacity / LSEARCH_MANY_PARTITION_LENGTH :
+                        (capacity / LSEARCH_MANY_PARTITION_LENGTH) + 1;
 
-        pthread_attr_destroy(&attr);
+    workpool_run(lsearch_pool_get(), partition_count, task_lsearch_many, &many);
 
-        ++v_tid.length;
+    for (i = 0; i < nkeys; i++) {
+        out_idx[i] = lskeyset_find(&many.set, keys[i]);
     }
 
-    for (i = 0; i < v_tid.length; i++) {
-        lsobject_t *ret = NULL;
-
-        pthread_join(v_tid.base[i], (void **)(&retval));
-        ret = (*retval);
+    free(storage);
+    storage = NULL;
+}
 
-        if (ret->search.value > -1) {
-            lso->search.value = ret->search.value;
-            lso->search.range_start = ret->search.range_start;
-            lso->search.range_end = ret->search.range_end;
-            lso->search.partition = ret->search.partition;
-            lso->search.position = ret->search.position;
+int32_t *__linear_search_int32__ALLOC__(size_t capacity) {
+    int32_t *base = NULL;
 
-            index = lso->search.value;
-        }
-    }
+    base = malloc((capacity > 0 ? capacity : 1) * sizeof *base);
+    assert(base);
 
-    {
-        {
-            for (i = 0; i < thread_count; i++) {
-                free(v_lso[i]);
-                v_lso[i] = NULL;
-            }
-        }
-
-        free(v_lso);
-        v_lso = NULL;
-    }
+    /* zeroed by the workers themselves, in the blocks a search deals them */
+    workpool_first_touch(lsearch_pool_get(), base, capacity * sizeof *base);
 
-    {
-        free(v_tid.base);
-        v_tid.base = NULL;
+    return base;
+}
 
-        v_tid.length = 0;
-    }
+void __linear_search_int32__FREE__(int32_t *base) {
+    free(base);
+}
 
-    /*
-    printf("position: %d\nindex: %d\npartition number: %d\n\n",
-           lso->search.position,
-           lso->search.value,
-           lso->search.partition);
-    */
+const char *__linear_search_int32__BACKEND__(void) {
+    return "thread";
+}
 
-    free(lso);
-    lso = NULL;
- 
-    return index;
+void __linear_search_int32__SHUTDOWN__(void) {
+    workpool_delete(&lsearch_pool);
 }
 
 int __linear_search_int32__CONTROL__(int32_t *base, size_t capacity, int32_t subcapacity, int32_t key) {
@@ -182,7 +189,6 @@ int __linear_search_int32__CONTROL__(int32_t *base, size_t capacity, int32_t sub
     int32_t range_start = 0;
     int32_t range_end = capacity;
     int32_t partition = subcapacity;
-    int32_t i = 0;
 
     {
         lso = malloc(sizeof *lso);
@@ -201,13 +207,7 @@ int __linear_search_int32__CONTROL__(int32_t *base, size_t capacity, int32_t sub
         lso->search.value = index;
     }
 
-    printf("Single process linear search\n");
-
-    for (i = 0; i < lso->vec.capacity; i++) {
-        if (lso->vec.base[i] == lso->key) {
-            lso->search.value = i;
-        }
-    }
+    lso->search.value = lsearch_int32_kernel(lso->vec.base, 0, lso->vec.capacity, lso->key);
 
     index = lso->search.value;
 
@@ -224,50 +224,92 @@ int __linear_search_int32__CONTROL__(int32_t *base, size_t capacity, int32_t sub
     return index;
 }
 
-static void *handler_lsearch(void *arg) {
-    lsobject_t *lso = *(lsobject_t **)(arg);
+/**
+ *  @brief  Pool task: searches one partition of the array described by arg
+ *
+ *  @param[in]  arg         pointer to the caller's lsobject_t
+ *  @param[in]  partition   partition number, in [0, partition count)
+ *
+ *  lso->search.value doubles as the shared "found" index --
+ *  it is polled every LSEARCH_POLL_LENGTH elements, and claimed
+ *  with a compare-and-swap, so every task stops shortly after the first hit.
+ */
+static void task_lsearch(void *arg, size_t partition) {
+    lsobject_t *lso = (lsobject_t *)(arg);
+    volatile int32_t *found = &lso->search.value;
 
     int32_t j = 0;
-    int32_t position = 0;
+    int32_t poll = 0;
+    int32_t range_start = partition * lso->vec.subcapacity;
+    int32_t range_end = range_start + lso->vec.subcapacity;
 
-    /*
-    printf("\n\nBeginning search for partition %d...\n",
-    lso->search.partition);
-    */
+    range_end = range_end < lso->vec.capacity ? range_end : lso->vec.capacity;
 
-    for (j = lso->search.range_start; j < lso->search.range_end; j++) {
-        /*
-        printf("vec[%d]: %d\n", j, lso->vec.base[j]);
-        */
+    for (j = range_start; j < range_end; j = poll) {
+        int32_t index = -1;
 
-        if (lso->vec.base[j] == lso->key) {
-            lso->search.value = j;
+        poll = j + LSEARCH_POLL_LENGTH < range_end ? j + LSEARCH_POLL_LENGTH : range_end;
 
-            /*
-            printf("handler: found key %d at index "
-                   "%d, partition %d\n\n",
-                   lso->key,
-                   lso->search.value,
-                   lso->search.partition);
-            */
+        if ((*found) != -1) {
+            return;
+        }
+
+        index = lsearch_int32_kernel(lso->vec.base, j, poll, lso->key);
+
+        if (index > -1) {
+            if (__sync_bool_compare_and_swap(found, -1, index)) {
+                lso->search.partition = partition;
+                lso->search.position = index - range_start;
+                lso->search.range_start = range_start;
+                lso->search.range_end = range_end;
 
-            /*
-            raise(SIGUSR1);
-            */
+                workpool_cancel(lsearch_pool);
+            }
 
-            break;
+            return;
         }
+    }
+}
+
+/**
+ *  @brief  Pool task: looks up one partition's elements in a key set
+ *
+ *  @param[in]  arg         pointer to the caller's (struct lsearch_many)
+ *  @param[in]  partition   partition number, of LSEARCH_MANY_PARTITION_LENGTH elements
+ */
+static void task_lsearch_many(void *arg, size_t partition) {
+    struct lsearch_many *many = (struct lsearch_many *)(arg);
+
+    int32_t range_start = partition * LSEARCH_MANY_PARTITION_LENGTH;
+    int32_t range_end = range_start + LSEARCH_MANY_PARTITION_LENGTH;
+
+    range_end = range_end < many->capacity ? range_end : many->capacity;
 
-        ++position;
+    lskeyset_scan(&many->set, many->base, range_start, range_end);
+}
+
+/**
+ *  @brief  Returns the shared worker pool, creating it on first use
+ *          (searches are made from one thread, like workpool_run)
+ */
+static workpool_t *lsearch_pool_get(void) {
+    static bool registered = false;
+
+    if (lsearch_pool == NULL) {
+        lsearch_pool = workpool_new(0, WORKPOOL_PIN);
     }
 
-    lso->search.position = lso->search.value != -1 ? position : lso->vec.subcapacity;
+    if (registered == false) {
+        atexit(lsearch_pool_atexit);
+        registered = true;
+    }
 
-    /*
-    printf("\nSearch ended for partition %d.\nwas %s\n\n",
-    lso->search.partition, lso->search.value != -1 ? "SUCCESSFUL" :
-    "unsuccessful");
-    */
+    return lsearch_pool;
+}
 
-    pthread_exit(arg);
+/**
+ *  @brief  Joins the pool at exit, if the client has not
+ */
+static void lsearch_pool_atexit(void) {
+    __linear_search_int32__SHUTDOWN__();
 }
@@ -29,3 +29,475 @@
  */
 
 #include "multitest.h"
+#include "workpool.h"
+
+/**< lskeyset: multiplicative (Fibonacci) hash to the table's bits */
+#define LSKEYSET_HASH(KEY, BITS) \
+    ((uint32_t)((uint32_t)(KEY) * 0x9E3779B1U) >> (32 - (BITS)))
+
+/**< lskeyset: smallest table, in bits */
+#define LSKEYSET_MIN_BITS 4
+
+#if (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define LSEARCH_KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define LSEARCH_KERNEL_X86 0
+#endif
+
+typedef int32_t (*lsearch_kernel_fn)(const int32_t *, int32_t, int32_t, int32_t);
+
+static int32_t lsearch_kernel_scalar(const int32_t *base, int32_t first, int32_t last, int32_t key);
+
+#if LSEARCH_KERNEL_X86
+static int32_t lsearch_kernel_sse2(const int32_t *base, int32_t first, int32_t last, int32_t key);
+static int32_t lsearch_kernel_avx2(const int32_t *base, int32_t first, int32_t last, int32_t key);
+#endif
+
+static lsearch_kernel_fn lsearch_kernel_select(void);
+
+static int lsindex_compare(const void *c1, const void *c2);
+
+/**
+ *  Kernel chosen on first use -- racing first calls
+ *  all store the same function, so no lock is needed.
+ */
+static lsearch_kernel_fn lsearch_kernel = NULL;
+
+/**
+ *  @brief  Returns the index of the first occurrence of key
+ *          within base[first, last), or -1
+ *
+ *  @param[in]  base    base address of an int32_t array
+ *  @param[in]  first   first index to search (inclusive)
+ *  @param[in]  last    last index to search (exclusive)
+ *  @param[in]  key     value to search for
+ *
+ *  @return     index of key, or -1 if not found
+ */
+int32_t __linear_search_int32__KERNEL__(const int32_t *base, int32_t first, int32_t last, int32_t key) {
+    if (lsearch_kernel == NULL) {
+        lsearch_kernel = lsearch_kernel_select();
+    }
+
+    return lsearch_kernel(base, first, last, key);
+}
+
+/**
+ *  @brief  Returns the name of the kernel that lsearch_int32_kernel uses
+ *
+ *  @return     "avx2", "sse2", or "scalar"
+ */
+const char *__linear_search_int32__KERNEL_NAME__(void) {
+    if (lsearch_kernel == NULL) {
+        lsearch_kernel = lsearch_kernel_select();
+    }
+
+#if LSEARCH_KERNEL_X86
+    if (lsearch_kernel == lsearch_kernel_avx2) {
+        return "avx2";
+    } else if (lsearch_kernel == lsearch_kernel_sse2) {
+        return "sse2";
+    }
+#endif
+
+    return "scalar";
+}
+
+/**
+ *  @brief  Chooses the widest kernel the running CPU supports
+ */
+static lsearch_kernel_fn lsearch_kernel_select(void) {
+#if LSEARCH_KERNEL_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        return lsearch_kernel_avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return lsearch_kernel_sse2;
+    }
+#endif
+
+    return lsearch_kernel_scalar;
+}
+
+/**
+ *  @brief  One element per comparison -- the fallback kernel,
+ *          and the tail loop of the vector kernels
+ */
+static int32_t lsearch_kernel_scalar(const int32_t *base, int32_t first, int32_t last, int32_t key) {
+    int32_t i = 0;
+
+    for (i = first; i < last; i++) {
+        if (base[i] == key) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+#if LSEARCH_KERNEL_X86
+/**
+ *  @brief  16 elements per iteration, as four 128-bit compares
+ *
+ *  The four compare masks are OR'd, so a miss costs one movemask
+ *  and one branch per 16 elements; only on a hit is the
+ *  first matching lane located.
+ */
+static int32_t lsearch_kernel_sse2(const int32_t *base, int32_t first, int32_t last, int32_t key) {
+    const __m128i k = _mm_set1_epi32(key);
+    int32_t i = first;
+
+    for (; i + 16 <= last; i += 16) {
+        const __m128i *block = (const __m128i *)(base + i);
+
+        __m128i c0 = _mm_cmpeq_epi32(_mm_loadu_si128(block + 0), k);
+        __m128i c1 = _mm_cmpeq_epi32(_mm_loadu_si128(block + 1), k);
+        __m128i c2 = _mm_cmpeq_epi32(_mm_loadu_si128(block + 2), k);
+        __m128i c3 = _mm_cmpeq_epi32(_mm_loadu_si128(block + 3), k);
+
+        __m128i any = _mm_or_si128(_mm_or_si128(c0, c1), _mm_or_si128(c2, c3));
+
+        if (_mm_movemask_epi8(any) != 0) {
+            unsigned int mask = (unsigned int)(_mm_movemask_ps(_mm_castsi128_ps(c0)))
+                              | ((unsigned int)(_mm_movemask_ps(_mm_castsi128_ps(c1))) << 4)
+                              | ((unsigned int)(_mm_movemask_ps(_mm_castsi128_ps(c2))) << 8)
+                              | ((unsigned int)(_mm_movemask_ps(_mm_castsi128_ps(c3))) << 12);
+
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return lsearch_kernel_scalar(base, i, last, key);
+}
+
+/**
+ *  @brief  16 elements per iteration, as two 256-bit compares
+ */
+__attribute__((target("avx2")))
+static int32_t lsearch_kernel_avx2(const int32_t *base, int32_t first, int32_t last, int32_t key) {
+    const __m256i k = _mm256_set1_epi32(key);
+    int32_t i = first;
+
+    for (; i + 16 <= last; i += 16) {
+        const __m256i *block = (const __m256i *)(base + i);
+
+        __m256i c0 = _mm256_cmpeq_epi32(_mm256_loadu_si256(block + 0), k);
+        __m256i c1 = _mm256_cmpeq_epi32(_mm256_loadu_si256(block + 1), k);
+
+        if (_mm256_testz_si256(_mm256_or_si256(c0, c1), _mm256_set1_epi32(-1)) == 0) {
+            unsigned int mask = (unsigned int)(_mm256_movemask_ps(_mm256_castsi256_ps(c0)))
+                              | ((unsigned int)(_mm256_movemask_ps(_mm256_castsi256_ps(c1))) << 8);
+
+            return i + __builtin_ctz(mask);
+        }
+    }
+
+    return lsearch_kernel_scalar(base, i, last, key);
+}
+#endif
+
+/**
+ *  @brief  Returns a partition size for an array of capacity elements,
+ *          sized to the machine's cores and caches
+ *
+ *  @param[in]  capacity    element count of the array
+ *
+ *  @return     subcapacity, in [1, capacity]
+ */
+int32_t __linear_search_int32__PARTITION__(size_t capacity) {
+    const size_t width = sizeof(int32_t);
+    const size_t line = workpool_cache_line();
+
+    size_t minimum = workpool_cache_size(1);
+    size_t maximum = workpool_cache_size(2) / 2;
+    size_t length = 0;
+
+    maximum = maximum > minimum ? maximum : minimum;
+
+    length = (capacity * width) / (workpool_cores() * 4);
+    length = length < minimum ? minimum : length;
+    length = length > maximum ? maximum : length;
+
+    /* whole cache lines, so no line is scanned by two workers */
+    length = ((length + line - 1) / line) * line;
+    length /= width;
+
+    length = length < capacity ? length : capacity;
+    return length > 0 ? (int32_t)(length) : 1;
+}
+
+/**
+ *  @brief  Returns the table length (as a power of two)
+ *          to hold nkeys at a load factor of at most 1/2
+ *
+ *  @param[in]  nkeys   number of keys
+ *
+ *  @return     bits, such that the table length is (1 << bits)
+ */
+uint32_t lskeyset_bits(size_t nkeys) {
+    uint32_t bits = LSKEYSET_MIN_BITS;
+
+    while (((size_t)(1) << bits) < nkeys * 2) {
+        ++bits;
+    }
+
+    return bits;
+}
+
+/**
+ *  @brief  Returns the bytes of storage a table of (1 << bits) slots needs
+ *
+ *  @param[in]  bits    as returned by lskeyset_bits
+ */
+size_t lskeyset_bytes(uint32_t bits) {
+    const size_t length = (size_t)(1) << bits;
+    return length * (sizeof(int32_t) + sizeof(int32_t) + sizeof(uint8_t));
+}
+
+/**
+ *  @brief  Constructs an empty set within storage
+ *
+ *  @param[out] set     pointer to lskeyset_t
+ *  @param[in]  storage at least lskeyset_bytes(bits) bytes, suitably aligned for int32_t
+ *  @param[in]  bits    as returned by lskeyset_bits
+ */
+void lskeyset_init(lskeyset_t *set, void *storage, uint32_t bits) {
+    const size_t length = (size_t)(1) << bits;
+
+    set->keys = (int32_t *)(storage);
+    set->found = set->keys + length;
+    set->used = (uint8_t *)(set->found + length);
+    set->bits = bits;
+
+    memset(set->used, 0, length * sizeof *set->used);
+}
+
+/**
+ *  @brief  Inserts key into set, if not already present
+ *
+ *  @param[in]  set     pointer to lskeyset_t
+ *  @param[in]  key     key to insert
+ *
+ *  Precondition: set holds fewer keys than its table has slots.
+ */
+void lskeyset_insert(lskeyset_t *set, int32_t key) {
+    const uint32_t mask = ((uint32_t)(1) << set->bits) - 1;
+    uint32_t slot = LSKEYSET_HASH(key, set->bits);
+
+    while (set->used[slot]) {
+        if (set->keys[slot] == key) {
+            return;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    set->keys[slot] = key;
+    set->found[slot] = -1;
+    set->used[slot] = 1;
+}
+
+/**
+ *  @brief  Returns the lowest index at which key was seen by lskeyset_scan
+ *
+ *  @param[in]  set     pointer to lskeyset_t
+ *  @param[in]  key     key to find
+ *
+ *  @return     index of key, or -1 if key was not seen (or is not in set)
+ */
+int32_t lskeyset_find(const lskeyset_t *set, int32_t key) {
+    const uint32_t mask = ((uint32_t)(1) << set->bits) - 1;
+    uint32_t slot = LSKEYSET_HASH(key, set->bits);
+
+    while (set->used[slot]) {
+        if (set->keys[slot] == key) {
+            return set->found[slot];
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
+/**
+ *  @brief  Looks up every element of base[first, last) in set,
+ *          recording the lowest index seen for each key found
+ *
+ *  @param[in]  set     pointer to lskeyset_t
+ *  @param[in]  base    base address of an int32_t array
+ *  @param[in]  first   first index to scan (inclusive)
+ *  @param[in]  last    last index to scan (exclusive)
+ *
+ *  Safe to call concurrently for any partitions of the same array.
+ */
+void lskeyset_scan(const lskeyset_t *set, const int32_t *base, int32_t first, int32_t last) {
+    const uint32_t mask = ((uint32_t)(1) << set->bits) - 1;
+    const uint32_t bits = set->bits;
+
+    volatile int32_t *found = set->found;
+    int32_t i = 0;
+
+    for (i = first; i < last; i++) {
+        const int32_t value = base[i];
+        uint32_t slot = LSKEYSET_HASH(value, bits);
+
+        while (set->used[slot]) {
+            if (set->keys[slot] == value) {
+                int32_t seen = found[slot];
+
+                /* lower found[slot] to i, unless another partition got lower */
+                while ((seen == -1 || i < seen)
+                       && __sync_bool_compare_and_swap(found + slot, seen, i) == 0) {
+                    seen = found[slot];
+                }
+
+                break;
+            }
+
+            slot = (slot + 1) & mask;
+        }
+    }
+}
+
+/**
+ *  @brief  Builds an index of kind over base[0, capacity)
+ *
+ *  @param[in]  base        base address of an int32_t array
+ *  @param[in]  capacity    element count of base
+ *  @param[in]  kind        LSINDEX_SORTED or LSINDEX_HASH
+ *
+ *  @return     pointer to lsindex_t
+ */
+lsindex_t *lsindex_new(const int32_t *base, size_t capacity, enum lsindex_kind kind) {
+    lsindex_t *index = NULL;
+    size_t i = 0;
+
+    index = malloc(sizeof *index);
+    assert(index);
+
+    index->kind = kind;
+    index->used = NULL;
+    index->bits = 0;
+
+    if (kind == LSINDEX_SORTED) {
+        index->length = capacity;
+
+        index->entries = malloc((capacity > 0 ? capacity : 1) * sizeof *index->entries);
+        assert(index->entries);
+
+        for (i = 0; i < capacity; i++) {
+            index->entries[i].key = base[i];
+            index->entries[i].index = i;
+        }
+
+        /* ties are ordered by index, so the first entry of a key is its first occurrence */
+        qsort(index->entries, capacity, sizeof *index->entries, lsindex_compare);
+    } else {
+        uint32_t mask = 0;
+
+        index->bits = lskeyset_bits(capacity);
+        index->length = (size_t)(1) << index->bits;
+        mask = (uint32_t)(index->length - 1);
+
+        index->entries = malloc(index->length * sizeof *index->entries);
+        assert(index->entries);
+
+        index->used = calloc(index->length, sizeof *index->used);
+        assert(index->used);
+
+        for (i = 0; i < capacity; i++) {
+            uint32_t slot = LSKEYSET_HASH(base[i], index->bits);
+
+            while (index->used[slot] && index->entries[slot].key != base[i]) {
+                slot = (slot + 1) & mask;
+            }
+
+            /* a repeated key keeps its first (lowest) index */
+            if (index->used[slot] == 0) {
+                index->entries[slot].key = base[i];
+                index->entries[slot].index = i;
+                index->used[slot] = 1;
+            }
+        }
+    }
+
+    return index;
+}
+
+/**
+ *  @brief  Releases index
+ *
+ *  @param[out] index   address of a pointer to lsindex_t
+ */
+void lsindex_delete(lsindex_t **index) {
+    if ((*index) == NULL) {
+        return;
+    }
+
+    free((*index)->used);
+    free((*index)->entries);
+
+    free((*index));
+    (*index) = NULL;
+}
+
+/**
+ *  @brief  Returns the index of the first occurrence of key
+ *          within the array index was built from
+ *
+ *  @param[in]  index   pointer to lsindex_t
+ *  @param[in]  key     value to search for
+ *
+ *  @return     index of key, or -1 if not found
+ */
+int32_t lsindex_find(const lsindex_t *index, int32_t key) {
+    if (index->kind == LSINDEX_SORTED) {
+        size_t first = 0;
+        size_t last = index->length;
+
+        /* lower bound -- the first entry whose key is not less than key */
+        while (first < last) {
+            size_t middle = first + ((last - first) / 2);
+
+            if (index->entries[middle].key < key) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+
+        return first < index->length && index->entries[first].key == key ?
+               index->entries[first].index : -1;
+    } else {
+        const uint32_t mask = (uint32_t)(index->length - 1);
+        uint32_t slot = LSKEYSET_HASH(key, index->bits);
+
+        while (index->used[slot]) {
+            if (index->entries[slot].key == key) {
+                return index->entries[slot].index;
+            }
+
+            slot = (slot + 1) & mask;
+        }
+
+        return -1;
+    }
+}
+
+/**
+ *  @brief  qsort comparator for (struct linear_search_entry), by key, then index
+ */
+static int lsindex_compare(const void *c1, const void *c2) {
+    const struct linear_search_entry *e1 = (const struct linear_search_entry *)(c1);
+    const struct linear_search_entry *e2 = (const struct linear_search_entry *)(c2);
+
+    if (e1->key != e2->key) {
+        return e1->key < e2->key ? -1 : 1;
+    }
+
+    return e1->index < e2->index ? -1 : (e1->index > e2->index ? 1 : 0);
+}
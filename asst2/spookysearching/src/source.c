@@ -117,6 +117,9 @@ double variance(double *results, size_t count) {
         sum += results_changed[i];
     }
 
+    free(results_changed);
+    results_changed = NULL;
+
     return (sum / (count - 1));
 }
 
@@ -136,3 +139,122 @@ double standard_deviation(double *results, size_t count) {
 
     return sqrt(variance(results, count));
 }
+
+/**
+ *  Comparator for qsort -- ascending order of double
+ */
+static int compare_double(const void *c1, const void *c2) {
+    const double lhs = *(const double *)(c1);
+    const double rhs = *(const double *)(c2);
+
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+/**
+ *  Return the pth percentile from an array of double,
+ *  interpolating linearly between the two nearest ranks
+ *  (results is left unsorted -- a sorted copy is used)
+ *
+ *  @param[in]  results pointer to double
+ *  @param[in]  count   element count of results
+ *  @param[in]  p       percentile, within [0.0, 100.0]
+ *
+ *  @return pth percentile of elements in results
+ */
+double percentile(double *results, size_t count, double p) {
+    double *sorted = NULL;
+    double rank = 0.0;
+    double value = 0.0;
+
+    size_t lower = 0;
+
+    if (count == 0) {
+        /* sentinel */
+        return -123456789.123456789;
+    }
+
+    sorted = calloc(count, sizeof *sorted);
+    assert(sorted);
+
+    memcpy(sorted, results, count * sizeof *sorted);
+    qsort(sorted, count, sizeof *sorted, compare_double);
+
+    p = p < 0.0 ? 0.0 : (p > 100.0 ? 100.0 : p);
+
+    rank = (p / 100.0) * (count - 1);
+    lower = (size_t)(rank);
+
+    if (lower + 1 < count) {
+        value = sorted[lower] + ((rank - lower) * (sorted[lower + 1] - sorted[lower]));
+    } else {
+        value = sorted[lower];
+    }
+
+    free(sorted);
+    sorted = NULL;
+
+    return value;
+}
+
+/**
+ *  Return median from an array of double
+ *
+ *  @param[in]  results pointer to double
+ *  @param[in]  count   element count of results
+ *
+ *  @return median of elements in results
+ */
+double median(double *results, size_t count) {
+    return percentile(results, count, 50.0);
+}
+
+/**
+ *  Return the half-width of the 95% confidence interval for the mean
+ *  of an array of double, using Student's t distribution --
+ *  the interval is mean(results, count) +/- this value
+ *
+ *  @param[in]  results pointer to double
+ *  @param[in]  count   element count of results
+ *
+ *  @return 95% confidence interval half-width, 0.0 if count < 2
+ */
+double confidence_interval(double *results, size_t count) {
+    /* two-sided t critical values at 95%, for 1 to 30 degrees of freedom */
+    static const double t_table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    /*
+     *  past 30, values at brackets of degrees of freedom -- t decreases
+     *  with df, so between brackets the lower bracket's value is used,
+     *  which widens the interval slightly rather than understating it
+     */
+    static const struct {
+        size_t df;
+        double t;
+    } t_brackets[] = {
+        { 30, 2.042 }, { 40, 2.021 }, { 50, 2.009 }, { 60, 2.000 },
+        { 80, 1.990 }, { 100, 1.984 }, { 120, 1.980 }, { 200, 1.972 },
+        { 500, 1.965 }, { 1000, 1.962 }
+    };
+
+    size_t df = count - 1;
+    double t = 0.0;
+    size_t i = 0;
+
+    if (count < 2) {
+        return 0.0;
+    }
+
+    if (df <= 30) {
+        t = t_table[df - 1];
+    } else {
+        for (i = 0; i < sizeof t_brackets / sizeof *t_brackets && t_brackets[i].df <= df; i++) {
+            t = t_brackets[i].t;
+        }
+    }
+
+    return t * (standard_deviation(results, count) / sqrt((double)(count)));
+}
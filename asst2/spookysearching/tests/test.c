@@ -28,31 +28,45 @@
  *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdarg.h>
-
-#if __STD_VERSION__ >= 19990L
-#include <stdbool.h>
-#include <stdint.h>
-#else
-# define false '\0'
-# define true '0'
-typedef unsigned char bool;
-#endif
-
-#if WIN32 || _WIN32
-#include <windows.h>
-#else
-#include <unistd.h>
-#endif
-
-#include <assert.h>
-#include <string.h>
-#include <strings.h>
-#include <dirent.h>
-#include <fcntl.h>
-#include <pthread.h>
+#include <limits.h>
+
+#include "header.h"
+#include "multitest.h"
+
+/**
+ *  Each search API is checked against search_scalar, a plain scan --
+ *  over arrays with duplicate values, for keys that are present
+ *  (first, last, and interior occurrences) and absent.
+ *  The concurrent functions are those of the backend the test
+ *  was linked with ('make test', or 'make test TEST_BACKEND=proc').
+ */
+
+/**< failed CHECKs so far -- main returns EXIT_FAILURE if nonzero */
+static int test_failures = 0;
+
+#define CHECK(COND)                                                            \
+    do {                                                                       \
+        if (!(COND)) {                                                         \
+            fprintf(stderr, "%s:%d: check failed: %s\n",                       \
+                    __FILE__, __LINE__, #COND);                                \
+            ++test_failures;                                                   \
+        }                                                                      \
+    } while (0)
+
+/**< test: pseudo-random numbers, reproducible across runs */
+static unsigned long test_seed = 1;
+static int32_t test_rand(int32_t n);
+
+/**< test: reference scan, and array construction */
+static int32_t search_scalar(const int32_t *base, int32_t first, int32_t last, int32_t key);
+static void fill_random(int32_t *base, size_t capacity, int32_t range);
+
+/**< test: one function per API */
+static void test_kernel(void);
+static void test_lskeyset(void);
+static void test_lsindex(void);
+static void test_lsearch(void);
+static void test_lsearch_many(void);
 
 /**
  *  @brief  Program execution begins here
@@ -63,8 +77,303 @@ typedef unsigned char bool;
  *  @return     exit status
  */
 int main(int argc, const char *argv[]) {
-    /* Enter source code here... */
+    printf("backend: %s, kernel: %s\n",
+           lsearch_int32_backend(), lsearch_int32_kernel_name());
 
+    test_kernel();
+    test_lskeyset();
+    test_lsindex();
+    test_lsearch();
+    test_lsearch_many();
 
+    lsearch_int32_shutdown();
+
+    if (test_failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", test_failures);
+        return EXIT_FAILURE;
+    }
+
+    printf("all checks passed\n");
     return EXIT_SUCCESS;
 }
+
+/**
+ *  @brief  Returns a pseudo-random int32_t in [0, n)
+ *
+ *  @param[in]  n   upper bound (exclusive)
+ *
+ *  @return     pseudo-random int32_t in [0, n)
+ */
+static int32_t test_rand(int32_t n) {
+    test_seed = (test_seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return (int32_t)((test_seed >> 8) % (unsigned long)(n));
+}
+
+/**
+ *  @brief  Scans base[first, last) for key, one element at a time
+ *
+ *  @param[in]  base    base address of an int32_t array
+ *  @param[in]  first   first index to scan (inclusive)
+ *  @param[in]  last    last index to scan (exclusive)
+ *  @param[in]  key     value to find
+ *
+ *  @return     index of the first occurrence of key, or -1
+ */
+static int32_t search_scalar(const int32_t *base, int32_t first, int32_t last, int32_t key) {
+    int32_t i = 0;
+
+    for (i = first; i < last; i++) {
+        if (base[i] == key) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ *  @brief  Fills base[0, capacity) with values in [0, range)
+ *
+ *  @param[out] base        base address of an int32_t array
+ *  @param[in]  capacity    element count of base
+ *  @param[in]  range       upper bound of the values (exclusive)
+ *
+ *  With range well under capacity, most values occur more than once.
+ */
+static void fill_random(int32_t *base, size_t capacity, int32_t range) {
+    size_t i = 0;
+
+    for (i = 0; i < capacity; i++) {
+        base[i] = test_rand(range);
+    }
+}
+
+/**
+ *  @brief  Checks the kernel over every [first, last) of a short array,
+ *          so each unaligned head/tail of the SIMD loops is covered
+ */
+static void test_kernel(void) {
+    int32_t base[80];
+    int32_t first = 0;
+    int32_t last = 0;
+    int32_t key = 0;
+
+    fill_random(base, 80, 16);
+
+    for (first = 0; first < 80; first++) {
+        for (last = first; last <= 80; last++) {
+            for (key = -1; key <= 16; key++) {
+                CHECK(lsearch_int32_kernel(base, first, last, key)
+                      == search_scalar(base, first, last, key));
+            }
+        }
+    }
+}
+
+/**
+ *  @brief  Checks lskeyset_scan/lskeyset_find against search_scalar,
+ *          with partitions scanned out of order (as workers would)
+ */
+static void test_lskeyset(void) {
+    const size_t capacity = 10000;
+    const int32_t partition = 777;
+    int32_t keys[64];
+    int32_t *base = NULL;
+    void *storage = NULL;
+    lskeyset_t set;
+    uint32_t bits = 0;
+    int32_t first = 0;
+    size_t i = 0;
+
+    base = malloc(sizeof *base * capacity);
+    assert(base);
+    fill_random(base, capacity, 5000);
+
+    /* half the keys are absent; keys[i] repeats keys[i - 8] */
+    for (i = 0; i < 64; i++) {
+        keys[i] = i % 16 < 8 ? test_rand(5000) : 5000 + (int32_t)(i);
+        keys[i] = i >= 32 ? keys[i - 32] : keys[i];
+    }
+
+    bits = lskeyset_bits(64);
+    CHECK(((size_t)(1) << bits) >= 128);
+
+    storage = malloc(lskeyset_bytes(bits));
+    assert(storage);
+
+    lskeyset_init(&set, storage, bits);
+
+    for (i = 0; i < 64; i++) {
+        lskeyset_insert(&set, keys[i]);
+    }
+
+    /* last partition first */
+    for (first = (int32_t)(capacity / partition) * partition; first >= 0; first -= partition) {
+        int32_t last = first + partition;
+        lskeyset_scan(&set, base, first, last < (int32_t)(capacity) ? last : (int32_t)(capacity));
+    }
+
+    for (i = 0; i < 64; i++) {
+        CHECK(lskeyset_find(&set, keys[i]) == search_scalar(base, 0, capacity, keys[i]));
+    }
+
+    /* a key never inserted is not found */
+    CHECK(lskeyset_find(&set, -1) == -1);
+
+    free(storage);
+    free(base);
+}
+
+/**
+ *  @brief  Checks both kinds of lsindex against search_scalar,
+ *          for every value in range (most repeated) and some absent ones
+ */
+static void test_lsindex(void) {
+    const enum lsindex_kind kinds[] = { LSINDEX_SORTED, LSINDEX_HASH };
+    const size_t capacity = 20000;
+    lsindex_t *index = NULL;
+    int32_t *base = NULL;
+    int32_t one = 7;
+    int32_t key = 0;
+    size_t k = 0;
+
+    base = malloc(sizeof *base * capacity);
+    assert(base);
+    fill_random(base, capacity, 3000);
+
+    /* a few negative values, and extremes */
+    base[0] = -5;
+    base[capacity / 2] = INT_MIN;
+    base[capacity - 1] = INT_MAX;
+
+    for (k = 0; k < sizeof kinds / sizeof *kinds; k++) {
+        index = lsindex_new(base, capacity, kinds[k]);
+        CHECK(index != NULL);
+
+        for (key = -10; key < 3010; key++) {
+            CHECK(lsindex_find(index, key) == search_scalar(base, 0, capacity, key));
+        }
+
+        CHECK(lsindex_find(index, INT_MIN) == (int32_t)(capacity / 2));
+        CHECK(lsindex_find(index, INT_MAX) == (int32_t)(capacity - 1));
+
+        lsindex_delete(&index);
+        CHECK(index == NULL);
+
+        /* a single element */
+        index = lsindex_new(&one, 1, kinds[k]);
+        CHECK(lsindex_find(index, 7) == 0);
+        CHECK(lsindex_find(index, 8) == -1);
+        lsindex_delete(&index);
+    }
+
+    free(base);
+}
+
+/**
+ *  @brief  Checks lsearch_int32 against search_scalar, for keys at the
+ *          front, back, and middle of the array, and for an absent key
+ */
+static void test_lsearch(void) {
+    const size_t capacity = 100000;
+    int32_t positions[4];
+    int32_t *base = NULL;
+    int32_t subcapacity = 0;
+    int32_t found = 0;
+    size_t i = 0;
+
+    base = lsearch_int32_alloc(capacity);
+    assert(base);
+
+    /* values in [0, 1000) -- the key 5000 is placed explicitly */
+    fill_random(base, capacity, 1000);
+    subcapacity = lsearch_int32_partition(capacity);
+
+    positions[0] = 0;
+    positions[1] = (int32_t)(capacity) - 1;
+    positions[2] = (int32_t)(capacity) / 2 + 3;
+    positions[3] = -1;
+
+    for (i = 0; i < 4; i++) {
+        if (positions[i] >= 0) {
+            base[positions[i]] = 5000;
+        }
+
+        CHECK(lsearch_int32(base, capacity, subcapacity, 5000) == positions[i]);
+        CHECK(lsearch_int32_control(base, capacity, subcapacity, 5000) == positions[i]);
+
+        if (positions[i] >= 0) {
+            base[positions[i]] = 0;
+        }
+    }
+
+    /* an empty array */
+    CHECK(lsearch_int32(base, 0, subcapacity, 5000) == -1);
+
+    /*
+     *  a repeated value -- partitions race, so any occurrence may be
+     *  returned (only _many/_kernel/lsindex promise the first)
+     */
+    found = lsearch_int32(base, capacity, subcapacity, base[12345]);
+    CHECK(found >= 0 && found < (int32_t)(capacity) && base[found] == base[12345]);
+
+    lsearch_int32_free(base);
+}
+
+/**
+ *  @brief  Checks lsearch_int32_many against search_scalar, for arrays
+ *          from lsearch_int32_alloc and from malloc, with duplicate
+ *          and absent keys
+ */
+static void test_lsearch_many(void) {
+    const size_t capacity = 200000;
+    int32_t keys[100];
+    int32_t out_idx[100];
+    int32_t *arrays[2];
+    size_t nkeys = sizeof keys / sizeof *keys;
+    size_t a = 0;
+    size_t i = 0;
+
+    arrays[0] = lsearch_int32_alloc(capacity);
+    arrays[1] = malloc(sizeof *arrays[1] * capacity);
+    assert(arrays[0] && arrays[1]);
+
+    for (a = 0; a < 2; a++) {
+        fill_random(arrays[a], capacity, 50000);
+
+        /* present, absent (>= 50000), and repeated keys */
+        for (i = 0; i < nkeys; i++) {
+            keys[i] = i % 3 == 2 ? 50000 + test_rand(1000) : arrays[a][test_rand(capacity)];
+        }
+
+        for (i = 0; i < nkeys; i += 10) {
+            keys[i] = keys[nkeys - 1 - i];
+        }
+
+        /* an occurrence in the last element only */
+        keys[1] = 60000;
+        arrays[a][capacity - 1] = 60000;
+
+        for (i = 0; i < nkeys; i++) {
+            out_idx[i] = -2;
+        }
+
+        lsearch_int32_many(arrays[a], capacity, keys, nkeys, out_idx);
+
+        for (i = 0; i < nkeys; i++) {
+            CHECK(out_idx[i] == search_scalar(arrays[a], 0, capacity, keys[i]));
+        }
+
+        /* a single key, and a prefix of the array */
+        lsearch_int32_many(arrays[a], 1000, keys, 1, out_idx);
+        CHECK(out_idx[0] == search_scalar(arrays[a], 0, 1000, keys[0]));
+
+        /* no keys -- out_idx is untouched */
+        out_idx[0] = -2;
+        lsearch_int32_many(arrays[a], capacity, keys, 0, out_idx);
+        CHECK(out_idx[0] == -2);
+    }
+
+    lsearch_int32_free(arrays[0]);
+    free(arrays[1]);
+}
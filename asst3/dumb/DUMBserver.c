@@ -43,6 +43,8 @@
 #include <unistd.h>
 
 #include "network.h"
+#include "shmap.h"
+#include "ulogq.h"
 #include "user.h"
 #include "vptr.h"
 
@@ -51,22 +53,31 @@
 typedef struct entry entry_t;
 struct entry {
     int fd;
-    vptr_t *users;
+    shmap_t *users;
+};
+
+typedef struct opnbx_result opnbx_result_t;
+struct opnbx_result {
+    user_t *user;
+    statcode_t stat;
 };
 
 static void *handler_connection(void *arg);
 static void *handler_client(void *arg);
 
-static statcode_t usr_creat(vptr_t *v, char *arg, int fd);
-static statcode_t usr_opnbx(vptr_t *v, user_t **user, char *arg, int fd, bool *box_open);
-static statcode_t usr_delbx(vptr_t *v, char *arg, int fd);
-static statcode_t usr_gdbye(vptr_t *v, user_t **user, int fd);
+static statcode_t usr_creat(shmap_t *v, char *arg, int fd);
+static statcode_t usr_opnbx(shmap_t *v, user_t **user, char *arg, int fd, bool *box_open);
+static statcode_t usr_delbx(shmap_t *v, char *arg, int fd);
+static statcode_t usr_gdbye(shmap_t *v, user_t **user, int fd);
 static statcode_t usr_putmg(user_t *user, char *arg, int arglen, int fd, bool *box_open);
 static statcode_t usr_nxtmg(user_t *user, int fd, bool *box_open);
 static statcode_t usr_clsbx(user_t **user, int fd, bool *box_open, char *cmdarg);
 static statcode_t usr_usage(int fd);
 static statcode_t usr_error(int fd);
 
+static int usr_opnbx_apply(void *arg, void *result);
+static bool usr_delbx_pred(void *arg, void *result);
+
 /**
  *  @brief  Program execution begins here
  *
@@ -82,7 +93,7 @@ int main(int argc, const char *argv[]) {
     const char *port_str = NULL;
     uint16_t port = 0;
 
-    vptr_t *users = NULL;
+    shmap_t *users = NULL;
     entry_t entry = { -1, NULL };
 
     pthread_t thread_connection;
@@ -98,7 +109,15 @@ int main(int argc, const char *argv[]) {
     port = atoi(port_str);
     ssockfd = ssocket_open(AF_INET, SOCK_STREAM, port, 1024);
 
-    users = vptr_new(4, user_delete);
+    users = shmap_new(SHMAP_SHARDS, user_delete);
+
+    /**
+     *  Per-command log lines are queued, and written by ulogq's flusher,
+     *  rather than written to stdout/stderr by the client handlers.
+     */
+    if (ulogq_start(0) < 0) {
+        fprintf(stderr, "[WARNING] unable to start ulogq -- logging synchronously\n");
+    }
 
     entry.fd = ssockfd;
     entry.users = users;
@@ -114,7 +133,8 @@ int main(int argc, const char *argv[]) {
     pthread_attr_destroy(&attr_connection);
 
     pthread_join(thread_connection, NULL);
-    vptr_delete(&users);
+    ulogq_stop();
+    shmap_delete(&users);
 
     ssocket_close(ssockfd);
 
@@ -131,8 +151,9 @@ static void *handler_connection(void *arg) {
     int i = 0;
     int status = -1;
 
+    /* entries are allocated individually, so growing entry_vec cannot move them */
     struct {
-        entry_t *base;
+        entry_t **base;
         size_t capacity;
         size_t length;
     } entry_vec = { NULL, 4, 0 };
@@ -166,7 +187,7 @@ static void *handler_connection(void *arg) {
         }
 
         if (i == entry_vec.capacity) {
-            entry_t *new_base = NULL;
+            entry_t **new_base = NULL;
             size_t new_capacity = entry_vec.capacity * 2;
 
             new_base = realloc(entry_vec.base, sizeof *new_base * new_capacity);
@@ -181,15 +202,19 @@ static void *handler_connection(void *arg) {
 
         accept_fd = accept(entry_server.fd, (struct sockaddr *)(&client), &len_client);
 
-        entry_vec.base[i].fd = accept_fd;
-        entry_vec.base[i].users = entry_server.users;
+        entry_vec.base[i] = malloc(sizeof *entry_vec.base[i]);
+        assert(entry_vec.base[i]);
+
+        entry_vec.base[i]->fd = accept_fd;
+        entry_vec.base[i]->users = entry_server.users;
 
         pthread_attr_init(&attr);
 
         if ((status = pthread_create(thread_vec.base + i, &attr, handler_client,
-                                     entry_vec.base + i)) < 0) {
-            fprintf(stderr, "[ERROR] %s\n(unable to start client handler thread\n",
-                    strerror(status));
+                                     entry_vec.base[i])) < 0) {
+            ulog_raw(stderr, ULOG_LEVEL_ERROR,
+                     "[ERROR] %s\n(unable to start client handler thread\n",
+                     strerror(status));
             exit(EXIT_FAILURE);
         }
 
@@ -201,11 +226,12 @@ static void *handler_connection(void *arg) {
     }
 
     if (accept_fd < 0) {
-        fprintf(stderr, "[ERROR] %s\n", strerror(accept_fd));
+        ulog_raw(stderr, ULOG_LEVEL_ERROR, "[ERROR] %s\n", strerror(accept_fd));
     }
 
     for (i = 0; i < thread_vec.length; i++) {
         pthread_join(thread_vec.base[i], NULL);
+        free(entry_vec.base[i]);
     }
 
     entry_vec.length = 0;
@@ -250,17 +276,18 @@ static void *handler_client(void *arg) {
     bzero(buffer_out, 256);
 
     description = "connected";
-    printf("%s %s %s\n", datetime_format(datetime), ipaddr(fd, ip), description);
+    ulog_raw(stdout, ULOG_LEVEL_LOG, "%s %s %s\n", datetime_format(datetime),
+             ipaddr(fd, ip), description);
 
     while ((size_read = recv(fd, buffer_in, 256, 0)) > 0) {
         cmdarg = buffer_in;
         cmddumb = cmdarg_interpret(buffer_in, &cmdarg, &arglen);
 
 #ifdef SERVER_DEBUG_MESSAGES
-        printf("client says: %s\n\n", buffer_in);
+        ulog_raw(stdout, ULOG_LEVEL_BUG, "client says: %s\n\n", buffer_in);
 
-        printf("last_cmd = %s_CODENO\n", cmd_dumb[cmddumb]);
-        printf("cmdarg: %s\narglen: %lu\n\n", cmdarg, arglen);
+        ulog_raw(stdout, ULOG_LEVEL_BUG, "last_cmd = %s_CODENO\n", cmd_dumb[cmddumb]);
+        ulog_raw(stdout, ULOG_LEVEL_BUG, "cmdarg: %s\narglen: %lu\n\n", cmdarg, arglen);
 #endif /* SERVER_DEBUG_MESSAGES */
 
         description = cmd_dumb[cmddumb];
@@ -315,18 +342,20 @@ static void *handler_client(void *arg) {
         }
 
         if (stat == _OK_STATNO) {
-            fprintf(stdout, "%s %s %s\n", datetime_format(datetime), ip, description);
+            ulog_raw(stdout, ULOG_LEVEL_LOG, "%s %s %s\n", datetime_format(datetime), ip,
+                     description);
         } else {
             description = statcode[stat];
 
-            fprintf(stderr, "%s %s ER:%s\n", datetime_format(datetime), ip, description);
+            ulog_raw(stderr, ULOG_LEVEL_WARNING, "%s %s ER:%s\n", datetime_format(datetime),
+                     ip, description);
         }
 
         bzero(buffer_in, 256);
         bzero(buffer_out, 256);
 
 #ifdef SERVER_DEBUG_MESSAGES
-        vptr_fprint(entry->users, stdout, user_print);
+        shmap_fprint(entry->users, stdout, user_print);
 #endif /* SERVER_DEBUG_MESSAGES */
 
         if (goodbye) {
@@ -336,13 +365,20 @@ static void *handler_client(void *arg) {
 
     if (exit_graceful == false) {
         description = "disconnected";
-        printf("%s %s %s\n", datetime_format(datetime), ip, description);
+        ulog_raw(stdout, ULOG_LEVEL_LOG, "%s %s %s\n", datetime_format(datetime), ip,
+                 description);
 
         if (user_current && user_active(user_current) && box_open) {
             user_close(user_current);
         }
 
-        vptr_fprint(entry->users, stdout, user_print);
+        /**
+         *  shmap_fprint writes to stdout directly --
+         *  queued lines go out first, so the output stays in order.
+         */
+        ulogq_flush();
+        shmap_fprint(entry->users, stdout, user_print);
+        fflush(stdout);
     }
 
     close(fd);
@@ -362,7 +398,7 @@ static void *handler_client(void *arg) {
  *              EXIST_STATNO    box with name arg already exists in v
  *              _WHAT_STATNO    malformed message
  */
-static statcode_t usr_creat(vptr_t *v, char *arg, int fd) {
+static statcode_t usr_creat(shmap_t *v, char *arg, int fd) {
     statcode_t stat = _OK_STATNO;
     char buffer[256];
 
@@ -371,19 +407,18 @@ static statcode_t usr_creat(vptr_t *v, char *arg, int fd) {
 
     bzero(buffer, 256);
 
-    if (vptr_trylock(v) == 0) {
-        if (in_range && isalpha(arg[0]) != 0) {
-            user_t *user = NULL;
+    if (in_range && isalpha(arg[0]) != 0) {
+        user_t *user = NULL;
 
-            user = user_new(arg);
-            vptr_pushb(v, &user);
+        user = user_new(arg);
 
+        /* only arg's shard is locked -- other clients are not held up */
+        if (shmap_insert(v, arg, &user) == 0) {
             stat = _OK_STATNO;
         } else {
-            stat = _WHAT_STATNO;
+            user_delete(&user);
+            stat = EXIST_STATNO;
         }
-
-        vptr_unlock(v);
     } else {
         stat = _WHAT_STATNO;
     }
@@ -410,11 +445,11 @@ static statcode_t usr_creat(vptr_t *v, char *arg, int fd) {
  *              BOPEN_STATNO        user already has one open box
  *              _WHAT_STATNO        malformed message
  */
-static statcode_t usr_opnbx(vptr_t *v, user_t **user, char *arg, int fd, bool *box_open) {
+static statcode_t usr_opnbx(shmap_t *v, user_t **user, char *arg, int fd, bool *box_open) {
     statcode_t stat = _WHAT_STATNO;
     char buffer[256];
 
-    int found = -1;
+    opnbx_result_t result = { NULL, _WHAT_STATNO };
 
     bzero(buffer, 256);
 
@@ -422,30 +457,18 @@ static statcode_t usr_opnbx(vptr_t *v, user_t **user, char *arg, int fd, bool *b
     if (*(user) || *(box_open)) {
         stat = BOPEN_STATNO;
     } else {
-        /* attempt to find the user, based on arg */
-        found = vptr_search(v, &arg, user_compare);
-
-        /* if the user was found... */
-        if (found >= 0) {
-            user_t *u = NULL;
-
-            /* ...retrieve the user */
-            u = *(user_t **)(vptr_at(v, found));
-
-            /* if the user is in use by another thread */
-            if (user_active(u)) {
-                stat = OPEND_STATNO;
-                /* if the user is not in use by another thread */
-            } else {
-                /* if the user was successfully opened */
-                if (user_open(u) == 0) {
-                    *(user) = u;
-                    *(box_open) = true;
-                    stat = _OK_STATNO;
-                }
-
-                /* if the user could not be opened, due to an error */
+        /**
+         *  attempt to find and open the user, based on arg --
+         *  the user cannot be deleted while usr_opnbx_apply runs
+         */
+        if (shmap_apply(v, arg, usr_opnbx_apply, &result) >= 0) {
+            /* if the user was successfully opened */
+            if (result.user) {
+                *(user) = result.user;
+                *(box_open) = true;
             }
+
+            stat = result.stat;
             /* if the user was not found */
         } else {
             stat = NEXST_STATNO;
@@ -471,44 +494,14 @@ static statcode_t usr_opnbx(vptr_t *v, user_t **user, char *arg, int fd, bool *b
  *              NOTMT_STATNO     box requested is not empty
  *              _WHAT_STATNO     malformed message
  */
-static statcode_t usr_delbx(vptr_t *v, char *arg, int fd) {
+static statcode_t usr_delbx(shmap_t *v, char *arg, int fd) {
     statcode_t stat = _WHAT_STATNO;
     char buffer[256];
 
-    int found = -1;
-
-    user_t *u = NULL;
-
     bzero(buffer, 256);
 
-    /* attempt to find the user, based on arg */
-    found = vptr_search(v, &arg, user_compare);
-
-    if (found >= 0) {
-        /* if the user was found... */
-        u = *(user_t **)(vptr_at(v, found));
-
-        if (user_active(u)) {
-            /* if the user is in use by any thread */
-            stat = OPEND_STATNO;
-        } else {
-            /* if the user is inactive */
-            if (vptr_trylock(v) == 0) {
-                /* if the user vector was successfully locked */
-                if (user_message_count(u) == 0) {
-                    vptr_erase_at(v, found);
-                    stat = _OK_STATNO;
-                } else {
-                    stat = NOTMT_STATNO;
-                }
-
-                vptr_unlock(v);
-            } else {
-                /* if the user vector was not successfully locked */
-                stat = _WHAT_STATNO;
-            }
-        }
-    } else {
+    /* attempt to find the user, based on arg -- erased if usr_delbx_pred allows */
+    if (shmap_erase_if(v, arg, usr_delbx_pred, &stat) < 0) {
         stat = NEXST_STATNO;
     }
 
@@ -528,7 +521,7 @@ static statcode_t usr_delbx(vptr_t *v, char *arg, int fd) {
  *  @return     statcode values:
  *              _OK_STATNO      (no reply will actually be sent)
  */
-static statcode_t usr_gdbye(vptr_t *v, user_t **user, int fd) {
+static statcode_t usr_gdbye(shmap_t *v, user_t **user, int fd) {
     statcode_t stat = _OK_STATNO;
     char buffer[256];
 
@@ -707,3 +700,57 @@ static statcode_t usr_error(int fd) {
 
     return code;
 }
+
+/**
+ *  @brief  Opens the user at arg, if it is not in use by another thread
+ *          (called by shmap_apply, with the user's shard locked)
+ *
+ *  @param[in]  arg     address of a (user_t *)
+ *  @param[out] result  the opened user and statcode (see usr_opnbx)
+ *
+ *  @return     0
+ */
+static int usr_opnbx_apply(void *arg, void *result) {
+    user_t *u = *(user_t **)(arg);
+
+    opnbx_result_t *res = (opnbx_result_t *)(result);
+
+    if (user_active(u)) {
+        /* if the user is in use by another thread */
+        res->stat = OPEND_STATNO;
+    } else if (user_open(u) == 0) {
+        /* if the user was successfully opened */
+        res->user = u;
+        res->stat = _OK_STATNO;
+    } else {
+        /* if the user could not be opened, due to an error */
+        res->stat = _WHAT_STATNO;
+    }
+
+    return 0;
+}
+
+/**
+ *  @brief  Determines if the user at arg may be deleted
+ *          (called by shmap_erase_if, with the user's shard locked)
+ *
+ *  @param[in]  arg     address of a (user_t *)
+ *  @param[out] result  statcode (see usr_delbx)
+ *
+ *  @return     true if the user is inactive and has no messages
+ */
+static bool usr_delbx_pred(void *arg, void *result) {
+    user_t *u = *(user_t **)(arg);
+    statcode_t *stat = (statcode_t *)(result);
+
+    if (user_active(u)) {
+        /* if the user is in use by any thread */
+        *(stat) = OPEND_STATNO;
+    } else if (user_message_count(u) != 0) {
+        *(stat) = NOTMT_STATNO;
+    } else {
+        *(stat) = _OK_STATNO;
+    }
+
+    return *(stat) == _OK_STATNO;
+}
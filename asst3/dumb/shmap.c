@@ -0,0 +1,527 @@
+/**
+ *  @file       shmap.c
+ *  @brief      struct sharded_map source file for Asst3:
+ *              The Decidedly Uncomplicated Message Broker
+ *
+ *  @author     Gemuele Aludino
+ *  @date       14 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ *  pthread_rwlock_t is not declared under -std=c89 alone;
+ *  <string.h> then declares strdup, so it must precede the macro in utils.h.
+ */
+#define _XOPEN_SOURCE 500
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shmap.h"
+
+#define SHMAP_CACHE_LINE 64
+#define SHMAP_BUCKETS 8
+
+#define SHMAP_FNV_OFFSET 2166136261UL
+#define SHMAP_FNV_PRIME 16777619UL
+
+struct shmap_node {
+    struct shmap_node *next;
+    unsigned long hash;
+
+    void *value;
+    char *key;
+};
+
+/**
+ *  Each shard is a chained hash table guarded by its own rwlock --
+ *  lookups on a shard share its lock, and only writers to the same
+ *  shard wait on one another.
+ */
+struct shmap_shard {
+    pthread_rwlock_t lock;
+
+    struct shmap_node **buckets;
+    size_t nbuckets;
+    size_t length;
+};
+
+/**
+ *  Shards are padded to a multiple of the cache line,
+ *  so that taking one shard's lock does not invalidate its neighbor's.
+ */
+union shmap_shard_slot {
+    struct shmap_shard shard;
+    char pad[((sizeof(struct shmap_shard) + SHMAP_CACHE_LINE - 1) / SHMAP_CACHE_LINE)
+             * SHMAP_CACHE_LINE];
+};
+
+struct sharded_map {
+    union shmap_shard_slot *shards; /**< aligned to SHMAP_CACHE_LINE, within shards_raw */
+    void *shards_raw;               /**< address returned by malloc (to be freed) */
+    size_t nshards;
+
+    size_t length;
+
+    void (*dtor)(void *);
+};
+
+static unsigned long shmap_hash(const char *key);
+static struct shmap_shard *shmap_shard(shmap_t *m, unsigned long hash);
+static struct shmap_node **shmap_lookup(struct shmap_shard *s, const char *key, unsigned long hash);
+static void shmap_grow(struct shmap_shard *s);
+static void *shmap_aligned_alloc(size_t size, void **raw);
+
+/**
+ *  @brief  Allocates, constructs, and returns a pointer to shmap_t
+ *
+ *  @param[in]  nshards number of shards (rounded up to a power of two)
+ *  @param[in]  dtor    destroys a value, given its address
+ *
+ *  @return     pointer to shmap_t
+ */
+shmap_t *shmap_new(size_t nshards, void (*dtor)(void *)) {
+    return shmap_init(malloc(sizeof(shmap_t)), nshards, dtor);
+}
+
+/**
+ *  @brief  Destroys every value, then deallocates the map
+ *
+ *  @param[in]  arg     address of a pointer to shmap_t (set to NULL)
+ */
+void shmap_delete(void *arg) {
+    shmap_t **m = (shmap_t **)(arg);
+    free(shmap_deinit((*m)));
+    (*m) = NULL;
+}
+
+/**
+ *  @brief  Constructs an empty map within m
+ *
+ *  @param[out] m       pointer to shmap_t (uninitialized)
+ *  @param[in]  nshards number of shards (rounded up to a power of two)
+ *  @param[in]  dtor    destroys a value, given its address
+ *
+ *  @return     m
+ */
+shmap_t *shmap_init(shmap_t *m, size_t nshards, void (*dtor)(void *)) {
+    size_t i = 0;
+
+    /* shard count is rounded up to a power of two, so a mask selects the shard */
+    m->nshards = 1;
+
+    while (m->nshards < nshards) {
+        m->nshards *= 2;
+    }
+
+    /* calloc only guarantees 16-byte alignment -- padding alone would not keep shards apart */
+    m->shards = shmap_aligned_alloc(m->nshards * sizeof *m->shards, &m->shards_raw);
+
+    for (i = 0; i < m->nshards; i++) {
+        struct shmap_shard *s = &m->shards[i].shard;
+
+        pthread_rwlock_init(&s->lock, NULL);
+
+        s->nbuckets = SHMAP_BUCKETS;
+        s->length = 0;
+
+        s->buckets = calloc(s->nbuckets, sizeof *s->buckets);
+        assert(s->buckets);
+    }
+
+    m->length = 0;
+    m->dtor = dtor;
+
+    return m;
+}
+
+/**
+ *  @brief  Destroys every value, and releases m's shards (but not m)
+ *
+ *  @param[in]  m   pointer to shmap_t
+ *
+ *  @return     m, to be freed by the caller
+ */
+shmap_t *shmap_deinit(shmap_t *m) {
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < m->nshards; i++) {
+        struct shmap_shard *s = &m->shards[i].shard;
+
+        for (j = 0; j < s->nbuckets; j++) {
+            struct shmap_node *node = s->buckets[j];
+
+            while (node) {
+                struct shmap_node *next = node->next;
+
+                m->dtor(&node->value);
+                free(node);
+
+                node = next;
+            }
+        }
+
+        free(s->buckets);
+        s->buckets = NULL;
+
+        pthread_rwlock_destroy(&s->lock);
+    }
+
+    free(m->shards_raw);
+    m->shards_raw = NULL;
+    m->shards = NULL;
+
+    m->nshards = 0;
+    m->length = 0;
+    m->dtor = NULL;
+
+    return m;
+}
+
+/**
+ *  @brief  Inserts the pointer at address arg under key (key is copied)
+ *
+ *  @param[in]  m       pointer to shmap_t
+ *  @param[in]  key     null-terminated key
+ *  @param[in]  arg     address of the pointer to store
+ *
+ *  @return     0 on success, -1 if key is already present (arg is not stored)
+ */
+int shmap_insert(shmap_t *m, const char *key, void *arg) {
+    const unsigned long hash = shmap_hash(key);
+    struct shmap_shard *s = shmap_shard(m, hash);
+
+    struct shmap_node **link = NULL;
+    struct shmap_node *node = NULL;
+
+    int status = 0;
+
+    pthread_rwlock_wrlock(&s->lock);
+
+    if (*(link = shmap_lookup(s, key, hash))) {
+        status = -1;
+    } else {
+        /* the key is stored in the same allocation, after the node */
+        node = malloc(sizeof *node + strlen(key) + 1);
+        assert(node);
+
+        node->next = NULL;
+        node->hash = hash;
+        node->key = strcpy((char *)(node + 1), key);
+        memcpy(&node->value, arg, sizeof node->value);
+
+        *(link) = node;
+
+        ++s->length;
+        __sync_fetch_and_add(&m->length, 1);
+
+        if (s->length > s->nbuckets) {
+            shmap_grow(s);
+        }
+    }
+
+    pthread_rwlock_unlock(&s->lock);
+
+    return status;
+}
+
+/**
+ *  @brief  Erases (and destroys) the value under key
+ *
+ *  @param[in]  m       pointer to shmap_t
+ *  @param[in]  key     null-terminated key
+ *
+ *  @return     0 on success, -1 if key is not present
+ */
+int shmap_erase(shmap_t *m, const char *key) {
+    return shmap_erase_if(m, key, NULL, NULL) == 1 ? 0 : -1;
+}
+
+/**
+ *  @brief  Erases (and destroys) the value under key
+ *          if pred(&value, arg) is true, or pred is NULL
+ *
+ *  @param[in]  m       pointer to shmap_t
+ *  @param[in]  key     null-terminated key
+ *  @param[in]  pred    predicate on the value's address and arg, or NULL
+ *  @param[in]  arg     second argument of pred
+ *
+ *  @return     1 if erased, 0 if pred refused, -1 if key is not present
+ *
+ *  pred runs while the shard is locked for writing.
+ */
+int shmap_erase_if(shmap_t *m, const char *key, bool (*pred)(void *, void *), void *arg) {
+    const unsigned long hash = shmap_hash(key);
+    struct shmap_shard *s = shmap_shard(m, hash);
+
+    struct shmap_node **link = NULL;
+    struct shmap_node *node = NULL;
+
+    int status = -1;
+
+    pthread_rwlock_wrlock(&s->lock);
+
+    if ((node = *(link = shmap_lookup(s, key, hash)))) {
+        status = 0;
+
+        if (pred == NULL || pred(&node->value, arg)) {
+            *(link) = node->next;
+
+            --s->length;
+            __sync_fetch_and_sub(&m->length, 1);
+
+            m->dtor(&node->value);
+            free(node);
+
+            status = 1;
+        }
+    }
+
+    pthread_rwlock_unlock(&s->lock);
+
+    return status;
+}
+
+/**
+ *  @brief  Determines if key is present
+ *
+ *  @param[in]  m       pointer to shmap_t
+ *  @param[in]  key     null-terminated key
+ *
+ *  @return     true if a value is stored under key, false otherwise
+ */
+bool shmap_contains(shmap_t *m, const char *key) {
+    const unsigned long hash = shmap_hash(key);
+    struct shmap_shard *s = shmap_shard(m, hash);
+
+    bool found = false;
+
+    pthread_rwlock_rdlock(&s->lock);
+    found = *(shmap_lookup(s, key, hash)) != NULL;
+    pthread_rwlock_unlock(&s->lock);
+
+    return found;
+}
+
+/**
+ *  @brief  Calls func(&value, arg) for the value under key
+ *
+ *  @param[in]  m       pointer to shmap_t
+ *  @param[in]  key     null-terminated key
+ *  @param[in]  func    function of the value's address and arg
+ *  @param[in]  arg     second argument of func
+ *
+ *  @return     func's result (which should be nonnegative),
+ *              or -1 if key is not present
+ *
+ *  func runs while the shard is locked for reading --
+ *  so the value cannot be erased while func runs.
+ */
+int shmap_apply(shmap_t *m, const char *key, int (*func)(void *, void *), void *arg) {
+    const unsigned long hash = shmap_hash(key);
+    struct shmap_shard *s = shmap_shard(m, hash);
+
+    struct shmap_node *node = NULL;
+
+    int status = -1;
+
+    pthread_rwlock_rdlock(&s->lock);
+
+    if ((node = *(shmap_lookup(s, key, hash)))) {
+        status = func(&node->value, arg);
+    }
+
+    pthread_rwlock_unlock(&s->lock);
+
+    return status;
+}
+
+/**
+ *  @brief  Determines if m holds no values
+ *
+ *  @param[in]  m   pointer to shmap_t
+ *
+ *  @return     true if shmap_size(m) is 0, false otherwise
+ */
+bool shmap_empty(shmap_t *m) { return shmap_size(m) == 0; }
+
+/**
+ *  @brief  Returns the number of values in m, across all shards
+ *
+ *  @param[in]  m   pointer to shmap_t
+ *
+ *  @return     value count
+ */
+size_t shmap_size(shmap_t *m) { return __sync_fetch_and_add(&m->length, 0); }
+
+/**
+ *  @brief  Prints every value of m to dest, one per line
+ *
+ *  @param[in]  m       pointer to shmap_t
+ *  @param[in]  dest    file stream
+ *  @param[in]  print   prints a value, given its address
+ *
+ *  Each shard is locked for reading while it is printed,
+ *  so the output is not a snapshot of the whole map.
+ */
+void shmap_fprint(shmap_t *m, FILE *dest, void (*print)(const void *, FILE *)) {
+    size_t i = 0;
+    size_t j = 0;
+
+    if (shmap_empty(m)) {
+        fprintf(dest, "-- empty --\n");
+    }
+
+    for (i = 0; i < m->nshards; i++) {
+        struct shmap_shard *s = &m->shards[i].shard;
+
+        pthread_rwlock_rdlock(&s->lock);
+
+        for (j = 0; j < s->nbuckets; j++) {
+            struct shmap_node *node = NULL;
+
+            for (node = s->buckets[j]; node; node = node->next) {
+                print(&node->value, dest);
+                fprintf(dest, "\n");
+            }
+        }
+
+        pthread_rwlock_unlock(&s->lock);
+    }
+
+    fprintf(dest, "\n");
+}
+
+/**
+ *  @brief  Returns the FNV-1a hash of key
+ *
+ *  @param[in]  key     null-terminated key
+ *
+ *  @return     hash of key
+ */
+static unsigned long shmap_hash(const char *key) {
+    unsigned long hash = SHMAP_FNV_OFFSET;
+
+    while (*key) {
+        hash ^= (unsigned char)(*key++);
+        hash *= SHMAP_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ *  @brief  Returns the shard that holds keys of the given hash
+ *
+ *  @param[in]  m       pointer to shmap_t
+ *  @param[in]  hash    as returned by shmap_hash
+ *
+ *  @return     pointer to the shard
+ */
+static struct shmap_shard *shmap_shard(shmap_t *m, unsigned long hash) {
+    /* high bits pick the shard, low bits pick the bucket within it */
+    return &m->shards[(hash >> 16) & (m->nshards - 1)].shard;
+}
+
+/**
+ *  @brief  Finds the link to key's node within s (s must be locked)
+ *
+ *  @param[in]  s       pointer to a shard
+ *  @param[in]  key     null-terminated key
+ *  @param[in]  hash    as returned by shmap_hash(key)
+ *
+ *  @return     address of the link to key's node --
+ *              or of the NULL link ending its bucket, if key is not present
+ */
+static struct shmap_node **shmap_lookup(struct shmap_shard *s, const char *key, unsigned long hash) {
+    struct shmap_node **link = &s->buckets[hash & (s->nbuckets - 1)];
+
+    while (*(link) && ((*link)->hash != hash || strcmp((*link)->key, key) != 0)) {
+        link = &(*link)->next;
+    }
+
+    return link;
+}
+
+/**
+ *  @brief  Doubles the bucket count of s, rehashing its nodes
+ *          (s must be locked for writing)
+ *
+ *  @param[in]  s   pointer to a shard
+ */
+static void shmap_grow(struct shmap_shard *s) {
+    size_t new_nbuckets = s->nbuckets * 2;
+    struct shmap_node **new_buckets = NULL;
+
+    size_t i = 0;
+
+    new_buckets = calloc(new_nbuckets, sizeof *new_buckets);
+    assert(new_buckets);
+
+    for (i = 0; i < s->nbuckets; i++) {
+        struct shmap_node *node = s->buckets[i];
+
+        while (node) {
+            struct shmap_node *next = node->next;
+            struct shmap_node **head = &new_buckets[node->hash & (new_nbuckets - 1)];
+
+            node->next = *(head);
+            *(head) = node;
+
+            node = next;
+        }
+    }
+
+    free(s->buckets);
+
+    s->buckets = new_buckets;
+    s->nbuckets = new_nbuckets;
+}
+
+/**
+ *  @brief  Allocates size zeroed bytes, aligned to SHMAP_CACHE_LINE
+ *
+ *  @param[in]  size    number of bytes
+ *  @param[out] raw     receives the address returned by malloc (to be freed)
+ *
+ *  @return     aligned address within raw
+ */
+static void *shmap_aligned_alloc(size_t size, void **raw) {
+    size_t misalignment = 0;
+    char *aligned = NULL;
+
+    (*raw) = malloc(size + SHMAP_CACHE_LINE - 1);
+    assert((*raw));
+
+    misalignment = (size_t)(*raw) % SHMAP_CACHE_LINE;
+    aligned = misalignment == 0 ? (char *)(*raw)
+                                : (char *)(*raw) + (SHMAP_CACHE_LINE - misalignment);
+
+    memset(aligned, 0, size);
+    return aligned;
+}
@@ -0,0 +1,59 @@
+/**
+ *  @file       shmap.h
+ *  @brief      struct sharded_map header file for Asst3:
+ *              The Decidedly Uncomplicated Message Broker
+ *
+ *  @author     Gemuele Aludino
+ *  @date       14 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SHMAP_H
+#define SHMAP_H
+
+#include "utils.h"
+
+#define SHMAP_SHARDS 16
+
+typedef struct sharded_map shmap_t;
+
+shmap_t *shmap_new(size_t nshards, void (*dtor)(void *));
+void shmap_delete(void *arg);
+
+shmap_t *shmap_init(shmap_t *m, size_t nshards, void (*dtor)(void *));
+shmap_t *shmap_deinit(shmap_t *m);
+
+int shmap_insert(shmap_t *m, const char *key, void *arg);
+int shmap_erase(shmap_t *m, const char *key);
+int shmap_erase_if(shmap_t *m, const char *key, bool (*pred)(void *, void *), void *arg);
+
+bool shmap_contains(shmap_t *m, const char *key);
+int shmap_apply(shmap_t *m, const char *key, int (*func)(void *, void *), void *arg);
+
+bool shmap_empty(shmap_t *m);
+size_t shmap_size(shmap_t *m);
+
+void shmap_fprint(shmap_t *m, FILE *dest, void (*print)(const void *, FILE *));
+
+#endif /* SHMAP_H */
@@ -0,0 +1,111 @@
+/**
+ *  @file       ulogq.h
+ *  @brief      asynchronous ulog backend header file for Asst3:
+ *              The Decidedly Uncomplicated Message Broker
+ *
+ *  @author     Gemuele Aludino
+ *  @date       18 Dec 2019
+ *  @copyright  Copyright © 2019 Gemuele Aludino
+ */
+/**
+ *  Copyright © 2019 Gemuele Aludino
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining
+ *  a copy of this software and associated documentation files (the "Software"),
+ *  to deal in the Software without restriction, including without limitation
+ *  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *  and/or sell copies of the Software, and to permit persons to whom the
+ *  Software is furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included
+ *  in all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ *  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ *  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH
+ *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ULOGQ_H
+#define ULOGQ_H
+
+/**
+ *  @file       utils.h
+ *  @brief      Required for ulog, ulog_sink, and enum ulog_level
+ */
+#include "utils.h"
+
+#include <stdlib.h>
+
+/**
+ *  @def        ULOGQ_RING_LENGTH
+ *  @brief      Default number of records in each thread's ring
+ */
+#define ULOGQ_RING_LENGTH 256
+
+/**
+ *  @def        ULOGQ_RECORD_SIZE
+ *  @brief      Size of a record in bytes -- longer lines are truncated
+ */
+#define ULOGQ_RECORD_SIZE 512
+
+/**
+ *  @def        ULOGQ_BATCH_LENGTH
+ *  @brief      Maximum number of records written by a single writev
+ */
+#define ULOGQ_BATCH_LENGTH 64
+
+/**
+ *  @def        ULOGQ_FLUSH_INTERVAL_NSEC
+ *  @brief      How long the flusher sleeps when every ring is empty
+ */
+#define ULOGQ_FLUSH_INTERVAL_NSEC 1000000L
+
+/**
+ *  @def        ULOGQ_ERROR_RETRIES
+ *  @brief      Flush intervals an ERROR may wait on a full/unflushed ring
+ */
+#define ULOGQ_ERROR_RETRIES 100
+
+/**
+ *      While ulogq is running, ulog (and ulog_raw) no longer write to
+ *      their FILE stream: each formatted line is copied into a ring
+ *      owned by the calling thread, and a background thread writes
+ *      the rings out with writev, ULOGQ_BATCH_LENGTH lines at a time.
+ *      Each ring has a single producer (its thread) and a single consumer
+ *      (the flusher), so neither side takes a lock.
+ *
+ *      A thread's ring is claimed on its first message, and handed back
+ *      when the thread exits, to be reused by a later thread.
+ *      Lines from one thread keep their order; lines from different
+ *      threads may interleave differently than they were logged.
+ *
+ *      When a ring is full, a message below ULOG_LEVEL_ERROR is dropped
+ *      (see ulogq_dropped -- the flusher also reports drops to stderr).
+ *      An ERROR waits, up to ULOGQ_ERROR_RETRIES flush intervals,
+ *      for room and then for the flusher to write it, so it is out
+ *      before a subsequent abort (e.g. massert).
+ *
+ *      Messages filtered out by ulog_threshold never reach ulogq.
+ *      ulogq_stop drains every ring; call it once the other threads
+ *      are done logging (e.g. before returning from main).
+ */
+
+/**< ulogq: start/stop the flusher (ring_length of 0 uses ULOGQ_RING_LENGTH) */
+int ulogq_start(size_t ring_length);
+void ulogq_stop(void);
+
+/**< ulogq: wait until every line queued so far is written */
+void ulogq_flush(void);
+
+/**< ulogq: status */
+bool ulogq_running(void);
+unsigned long ulogq_dropped(void);
+
+/**< ulogq: ulog_sink_fn installed by ulogq_start */
+int ulogq_sink(FILE *dest, int level, const char *line, size_t length);
+
+#endif /* ULOGQ_H */
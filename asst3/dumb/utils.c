@@ -28,13 +28,19 @@
  *  THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include "utils.h"
+/**
+ *  vsnprintf is not declared under -std=c89 alone;
+ *  <string.h> then declares strdup, so it must precede the macro in utils.h.
+ */
+#define _XOPEN_SOURCE 500
 
 #include <assert.h>
 #include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "utils.h"
+
 void str_delete(void *arg) {
     char **str = (char **)(arg);
     free((*str));
@@ -110,6 +116,15 @@ char *str_trim(char *to_trim, const char *charset) {
 
 bool ulog_attrs_disable[] = { false, false, false, false, false, false, false };
 
+int ulog_threshold = ULOG_LEVEL_BUG;
+ulog_sink_fn ulog_sink = NULL;
+
+static int ulog_level_of(const char *level);
+static void ulog_puts(char *buffer, size_t size, size_t *length, const char *str);
+static void ulog_append(char *buffer, size_t size, size_t *length, const char *fmt, ...);
+static void ulog_vappend(char *buffer, size_t size, size_t *length, const char *fmt, va_list args);
+static int ulog_write(FILE *dest, int level, const char *line, size_t length);
+
 /**
  *  Utility function for debugging/error messages
  *
@@ -120,7 +135,10 @@ bool ulog_attrs_disable[] = { false, false, false, false, false, false, false };
  *  @param[in]      line        macro __LINE__ is to be used here
  *  @param[in]      fmt         formatting to be used
  *
- *  @return         character count of buffer (from fprintf)
+ *  @return         character count of buffer (0 if level is filtered out)
+ *
+ *  The message is formatted once, directly into a single buffer,
+ *  and handed to ulog_sink (or written to dest, if there is no sink).
  */
 int ulog(FILE *dest,
          const char *level,
@@ -129,143 +147,227 @@ int ulog(FILE *dest,
          long double line,
          const char *fmt,
          ...) {
-
     char buffer[MAXIMUM_STACK_BUFFER_SIZE];
-    char temp[256];
+    const size_t size = sizeof buffer - 1; /**< reserved for the newline */
+    size_t j = 0;
+
+    const int severity = ulog_level_of(level);
 
     const char *color = KNRM;
     const char *blink = "";
 
-    bool found = false;
     bool is_integer = false;
     bool is_currency = *file == '$';
 
-    int j = 0;
-
-    if (streql(level, "[BUG]")) {
-        color = KYEL_b;
-        found = true;
+    if (!ULOG_ENABLED(severity)) {
+        return 0;
     }
 
-    if (found == false) {
-        if (streql(level, "[LOG]")) {
-            color = KCYN_b;
-            found = true;
-        }
-    }
+    switch (severity) {
+    case ULOG_LEVEL_BUG:
+        color = KYEL_b;
+        break;
 
-    if (found == false) {
-        if (streql(level, "[ERROR]")) {
-            color = KRED_b;
-            blink = KBNK;
-            found = true;
-        }
-    }
+    case ULOG_LEVEL_LOG:
+        color = KCYN_b;
+        break;
 
-    if (found == false) {
-        if (streql(level, "[WARNING]")) {
-            color = KMAG_b;
-            blink = KBNK;
-        }
-    }
+    case ULOG_LEVEL_ERROR:
+        color = KRED_b;
+        blink = KBNK;
+        break;
 
-    sprintf(temp, "%Lf", line);
+    case ULOG_LEVEL_WARNING:
+        color = KMAG_b;
+        blink = KBNK;
+        break;
 
-    /* char digit = strchr(temp, '.'); */
+    default:
+        break;
+    }
 
-#if __STD_VERSION__ >= 199901L
-    is_integer = line / (long long int)(line) == 1.000000 || line == 0.00000;
-#else
     is_integer = line / (long int)(line) == 1.000000 || line == 0.00000;
-#endif /* __STDC_VERSION__ >= 199901L */
-
     is_integer = is_currency ? false : is_integer;
 
     if (ulog_attrs_disable[DATE] == false) {
-        char date[1024];
-        sprintf(date, "%s%s%s ", KGRY, __DATE__, KNRM);
-
-        j += sprintf(buffer + j, "%s", date);
+        ulog_puts(buffer, size, &j, KGRY __DATE__ KNRM " ");
     }
 
     if (ulog_attrs_disable[TIME] == false) {
-        char time[1024];
-        sprintf(time, "%s%s%s ", KGRY, __TIME__, KNRM);
-
-        j += sprintf(buffer + j, "%s", time);
+        ulog_puts(buffer, size, &j, KGRY __TIME__ KNRM " ");
     }
 
     if (ulog_attrs_disable[LEVEL] == false) {
-        char leveltype[1024];
-        sprintf(leveltype, "%s%s%s%s ", blink, color, level, KNRM);
-
-        j += sprintf(buffer + j, "%s", leveltype);
+        ulog_puts(buffer, size, &j, blink);
+        ulog_puts(buffer, size, &j, color);
+        ulog_puts(buffer, size, &j, level);
+        ulog_puts(buffer, size, &j, KNRM " ");
     }
 
     if (ulog_attrs_disable[FILENAME] == false && ulog_attrs_disable[LINE]) {
-        char filename[1024];
-        sprintf(filename, "[%s] ", file);
-
-        j += sprintf(buffer + j, "%s", filename);
-    } else if (ulog_attrs_disable[FILENAME] && ulog_attrs_disable[LINE] == false) {
-        char linenumber[1024];
-
+        ulog_puts(buffer, size, &j, "[");
+        ulog_puts(buffer, size, &j, file);
+        ulog_puts(buffer, size, &j, "] ");
+    } else if (ulog_attrs_disable[FILENAME] &&
+               ulog_attrs_disable[LINE] == false) {
         if (is_integer) {
-#if __STD_VERSION__ >= 199901L
-            sprintf(linenumber, "[%lli] ", (long long int)(line));
-#else
-            sprintf(linenumber, "[%li] ", (long int)(line));
-#endif
+            ulog_append(buffer, size, &j, "[%li] ", (long int)(line));
+        } else if (is_currency) {
+            ulog_append(buffer, size, &j, "[%0.2Lf] ", line);
         } else {
-            if (is_currency) {
-                sprintf(linenumber, "[%0.2Lf] ", line);
-            } else {
-                sprintf(linenumber, "[%Lf] ", line);
-            }
+            ulog_append(buffer, size, &j, "[%Lf] ", line);
         }
-
-        j += sprintf(buffer + j, "%s", linenumber);
-    } else if (ulog_attrs_disable[FILENAME] == false && ulog_attrs_disable[LINE] == false) {
-        char fileline[1024];
-
+    } else if (ulog_attrs_disable[FILENAME] == false &&
+               ulog_attrs_disable[LINE] == false) {
         if (is_integer) {
-#if __STD_VERSION__ >= 199901L
-            sprintf(fileline, "[%s:%lli] ", file, (long long int)(line));
-#else
-            sprintf(fileline, "[%s:%li] ", file, (long int)(line));
-#endif
+            ulog_append(buffer, size, &j, "[%s:%li] ", file, (long int)(line));
+        } else if (is_currency) {
+            ulog_append(buffer, size, &j, "[%s%0.2Lf] ", file, line);
         } else {
-            if (is_currency) {
-                sprintf(fileline, "[%s%0.2Lf] ", file, line);
-            } else {
-                sprintf(fileline, "[%s:%Lf] ", file, line);
-            }
+            ulog_append(buffer, size, &j, "[%s:%Lf] ", file, line);
         }
-
-        j += sprintf(buffer + j, "%s", fileline);
     }
 
     if (ulog_attrs_disable[FUNCTION] == false) {
-        char function[1024];
-        sprintf(function, "%s%s", KCYN, func);
-
-        j += sprintf(buffer + j, "%s", function);
+        ulog_puts(buffer, size, &j, KCYN);
+        ulog_puts(buffer, size, &j, func);
     }
 
-    if (ulog_attrs_disable[FUNCTION] == false && ulog_attrs_disable[MESSAGE] == false) {
-        j += sprintf(buffer + j, "%s", " ");
+    if (ulog_attrs_disable[FUNCTION] == false &&
+        ulog_attrs_disable[MESSAGE] == false) {
+        ulog_puts(buffer, size, &j, " ");
     }
 
     if (ulog_attrs_disable[MESSAGE] == false) {
-        char message[4096];
         va_list args;
 
+        ulog_puts(buffer, size, &j, KNRM_b);
+
         va_start(args, fmt);
-        vsprintf(message, fmt, args);
+        ulog_vappend(buffer, size, &j, fmt, args);
         va_end(args);
 
-        j += sprintf(buffer + j, "%s%s%s", KNRM_b, message, KNRM);
+        ulog_puts(buffer, size, &j, KNRM);
+    }
+
+    buffer[j++] = '\n';
+    return ulog_write(dest, severity, buffer, j);
+}
+
+/**
+ *  Writes a message to dest, as is, through the same level filter
+ *  and backend (ulog_sink) as ulog
+ *
+ *  @param[in]      dest        stream destination
+ *  @param[in]      level       a ulog_level (e.g. ULOG_LEVEL_LOG)
+ *  @param[in]      fmt         formatting to be used
+ *
+ *  @return         character count of message (0 if level is filtered out)
+ */
+int ulog_raw(FILE *dest, int level, const char *fmt, ...) {
+    char buffer[MAXIMUM_STACK_BUFFER_SIZE];
+    size_t j = 0;
+    va_list args;
+
+    if (!ULOG_ENABLED(level)) {
+        return 0;
+    }
+
+    va_start(args, fmt);
+    ulog_vappend(buffer, sizeof buffer, &j, fmt, args);
+    va_end(args);
+
+    return ulog_write(dest, level, buffer, j);
+}
+
+/**
+ *  Maps a ulog level string ("[BUG]", "[LOG]", ...) to its ulog_level
+ *
+ *  @param[in]      level       level string, as passed to ulog
+ *
+ *  @return         corresponding ulog_level (custom strings are ULOG_LEVEL_LOG)
+ */
+static int ulog_level_of(const char *level) {
+    if (streql(level, "[ERROR]")) {
+        return ULOG_LEVEL_ERROR;
+    } else if (streql(level, "[WARNING]")) {
+        return ULOG_LEVEL_WARNING;
+    } else if (streql(level, "[BUG]")) {
+        return ULOG_LEVEL_BUG;
+    }
+
+    return ULOG_LEVEL_LOG;
+}
+
+/**
+ *  Copies str into buffer at offset (*length), never past size bytes,
+ *  and advances (*length) -- for the parts of a line that need no formatting
+ *
+ *  @param[out]     buffer      destination
+ *  @param[in]      size        capacity of buffer
+ *  @param[in,out]  length      characters used so far
+ *  @param[in]      str         null terminated string
+ */
+static void ulog_puts(char *buffer, size_t size, size_t *length, const char *str) {
+    size_t n = strlen(str);
+
+    if ((*length) + n >= size) {
+        n = (*length) + 1 < size ? size - (*length) - 1 : 0;
+    }
+
+    memcpy(buffer + (*length), str, n);
+    (*length) += n;
+}
+
+/**
+ *  Formats into buffer at offset (*length), never past size bytes,
+ *  and advances (*length)
+ *
+ *  @param[out]     buffer      destination
+ *  @param[in]      size        capacity of buffer
+ *  @param[in,out]  length      characters used so far
+ *  @param[in]      fmt         formatting to be used
+ */
+static void ulog_append(char *buffer, size_t size, size_t *length, const char *fmt, ...) {
+    va_list args;
+
+    va_start(args, fmt);
+    ulog_vappend(buffer, size, length, fmt, args);
+    va_end(args);
+}
+
+/**
+ *  va_list counterpart of ulog_append -- output is truncated, not overrun
+ */
+static void ulog_vappend(char *buffer, size_t size, size_t *length, const char *fmt, va_list args) {
+    int written = 0;
+
+    if ((*length) + 1 >= size) {
+        return;
+    }
+
+    written = vsnprintf(buffer + (*length), size - (*length), fmt, args);
+
+    if (written > 0) {
+        (*length) += (size_t)(written);
+        (*length) = (*length) < size ? (*length) : size - 1;
+    }
+}
+
+/**
+ *  Delivers a formatted line to ulog_sink, or to dest if there is none
+ *
+ *  @param[in]      dest        stream destination
+ *  @param[in]      level       a ulog_level
+ *  @param[in]      line        formatted characters (not null terminated)
+ *  @param[in]      length      number of characters in line
+ *
+ *  @return         character count written (or queued)
+ */
+static int ulog_write(FILE *dest, int level, const char *line, size_t length) {
+    if (ulog_sink != NULL) {
+        return ulog_sink(dest, level, line, length);
     }
 
-    return fprintf(dest, "%s\n", buffer);
+    return (int)(fwrite(line, 1, length, dest));
 }
@@ -139,6 +139,42 @@ int ulog(FILE *dest,
          const char *fmt,
          ...); /**< user's custom message */
 
+int ulog_raw(FILE *dest, int level, const char *fmt, ...);
+
+/**
+ *  @enum       ulog_level
+ *  @brief      Severities of ulog messages, in ascending order
+ *
+ *  A message is formatted and written only if its level is at or above
+ *  ulog_threshold -- the check happens before any formatting
+ *  (and, for the BUG/LOG/ERROR/WARNING macros, before their arguments
+ *  are evaluated). ULOG_LEVEL_NONE as the threshold silences ulog.
+ */
+enum ulog_level {
+    ULOG_LEVEL_BUG,
+    ULOG_LEVEL_LOG,
+    ULOG_LEVEL_WARNING,
+    ULOG_LEVEL_ERROR,
+    ULOG_LEVEL_NONE
+};
+
+extern int ulog_threshold;
+
+#define ULOG_ENABLED(ULOG_LEVEL) ((ULOG_LEVEL) >= ulog_threshold)
+
+/**
+ *  @typedef    ulog_sink_fn
+ *  @brief      Backend that receives one formatted ulog line
+ *
+ *  line is length bytes long, ends with a newline, and is not
+ *  guaranteed to outlive the call. If ulog_sink is NULL (the default),
+ *  lines are written to dest synchronously. See ulogq.h for
+ *  an asynchronous backend.
+ */
+typedef int (*ulog_sink_fn)(FILE *dest, int level, const char *line, size_t length);
+
+extern ulog_sink_fn ulog_sink;
+
 /**
  *  Unless you would like to create a customized
  *  debugging message, please use the following preprocessor directives.
@@ -211,14 +247,16 @@ ULOG_TOGGLE_ATTR(MESSAGE);
 #if __STDC_VERSION__ >= 199901L
 #ifndef ULOG_DISABLE_BUG
 #define BUG(FILEMACRO, ...)                                                    \
-    ulog(ULOG_STREAM_BUG, "[BUG]", FILEMACRO, __func__, (long int)__LINE__, __VA_ARGS__)
+    (ULOG_ENABLED(ULOG_LEVEL_BUG) ?                                            \
+    ulog(ULOG_STREAM_BUG, "[BUG]", FILEMACRO, __func__, (long int)__LINE__, __VA_ARGS__) : 0)
 #else
 #define BUG(FILEMACRO, ...)
 #endif /* ULOG_DISABLE_BUG */
 #else
 #ifndef ULOG_DISABLE_BUG
 #define BUG(FILEMACRO, MSG)                                                    \
-    ulog(ULOG_STREAM_BUG, "[BUG]", FILEMACRO, __func__, (long int)__LINE__, MSG)
+    (ULOG_ENABLED(ULOG_LEVEL_BUG) ?                                            \
+    ulog(ULOG_STREAM_BUG, "[BUG]", FILEMACRO, __func__, (long int)__LINE__, MSG) : 0)
 #else
 #define BUG(FILEMACRO, MSG)
 #endif /* ULOG_DISABLE_BUG */
@@ -236,14 +274,16 @@ ULOG_TOGGLE_ATTR(MESSAGE);
 #if __STDC_VERSION__ >= 199901L
 #ifndef ULOG_DISABLE_LOG
 #define LOG(FILEMACRO, ...)                                                    \
-    ulog(ULOG_STREAM_LOG, "[LOG]", FILEMACRO, __func__, (long int)__LINE__, __VA_ARGS__)
+    (ULOG_ENABLED(ULOG_LEVEL_LOG) ?                                            \
+    ulog(ULOG_STREAM_LOG, "[LOG]", FILEMACRO, __func__, (long int)__LINE__, __VA_ARGS__) : 0)
 #else
 #define LOG(FILEMACRO, ...)
 #endif /* ULOG_DISABLE_LOG */
 #else
 #ifndef ULOG_DISABLE_LOG
 #define LOG(FILEMACRO, MSG)                                                    \
-    ulog(ULOG_STREAM_LOG, "[LOG]", FILEMACRO, __func__, (long int)__LINE__, MSG)
+    (ULOG_ENABLED(ULOG_LEVEL_LOG) ?                                            \
+    ulog(ULOG_STREAM_LOG, "[LOG]", FILEMACRO, __func__, (long int)__LINE__, MSG) : 0)
 #else
 #define LOG(FILEMACRO, MSG)
 #endif /* ULOG_DISABLE_LOG */
@@ -261,12 +301,14 @@ ULOG_TOGGLE_ATTR(MESSAGE);
 #if __STDC_VERSION__ >= 199901L
 #ifndef ULOG_DISABLE_ERROR
 #define ERROR(FILEMACRO, ...)                                                  \
-    ulog(ULOG_STREAM_ERROR, "[ERROR]", FILEMACRO, __func__, (long int)__LINE__, __VA_ARGS__)
+    (ULOG_ENABLED(ULOG_LEVEL_ERROR) ?                                          \
+    ulog(ULOG_STREAM_ERROR, "[ERROR]", FILEMACRO, __func__, (long int)__LINE__, __VA_ARGS__) : 0)
 #endif /* ULOG_DISABLE_ERROR */
 #else
 #ifndef ULOG_DISABLE_ERROR
 #define ERROR(FILEMACRO, MSG)                                                  \
-    ulog(ULOG_STREAM_ERROR, "[ERROR]", FILEMACRO, __func__, (long int)__LINE__, MSG)
+    (ULOG_ENABLED(ULOG_LEVEL_ERROR) ?                                          \
+    ulog(ULOG_STREAM_ERROR, "[ERROR]", FILEMACRO, __func__, (long int)__LINE__, MSG) : 0)
 #else
 #define ERROR(FILEMACRO, MSG)
 #endif /* ULOG_DISABLE_ERROR */
@@ -279,12 +321,14 @@ ULOG_TOGGLE_ATTR(MESSAGE);
 #if __STDC_VERSION__ >= 199901L
 #ifndef ULOG_DISABLE_WARNING
 #define WARNING(FILEMACRO, ...)                                                \
-    ulog(ULOG_STREAM_WARNING, "[WARNING]", FILEMACRO, __func__, (long int)__LINE__, __VA_ARGS__)
+    (ULOG_ENABLED(ULOG_LEVEL_WARNING) ?                                        \
+    ulog(ULOG_STREAM_WARNING, "[WARNING]", FILEMACRO, __func__, (long int)__LINE__, __VA_ARGS__) : 0)
 #endif /* ULOG_DISABLE_WARNING */
 #else
 #ifndef ULOG_DISABLE_WARNING
 #define WARNING(FILEMACRO, MSG)                                                \
-    ulog(ULOG_STREAM_WARNING, "[WARNING]", FILEMACRO, __func__, (long int)__LINE__, MSG)
+    (ULOG_ENABLED(ULOG_LEVEL_WARNING) ?                                        \
+    ulog(ULOG_STREAM_WARNING, "[WARNING]", FILEMACRO, __func__, (long int)__LINE__, MSG) : 0)
 #else
 #define WARNING(FILEMACRO, MSG)
 #endif /* ULOG_DISABLE_WARNING */